@@ -302,4 +302,15 @@ void clutter_actor_set_implicitly_grabbed (ClutterActor *actor,
 
 AtkStateSet * clutter_actor_get_accessible_state (ClutterActor *actor);
 
+gboolean clutter_actor_can_batch_property (ClutterActor *self,
+                                           GParamSpec   *pspec);
+
+void clutter_actor_set_batched_property (ClutterActor *self,
+                                         GParamSpec   *pspec,
+                                         const double *components);
+
+gboolean clutter_actor_needs_size_request (ClutterActor *self);
+
+gboolean clutter_actor_has_thread_safe_size_request (ClutterActor *self);
+
 G_END_DECLS
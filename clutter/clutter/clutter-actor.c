@@ -507,6 +507,7 @@
 #include "clutter/clutter-effect-private.h"
 #include "clutter/clutter-enum-types.h"
 #include "clutter/clutter-fixed-layout.h"
+#include "clutter/clutter-layout-manager-private.h"
 #include "clutter/clutter-flatten-effect.h"
 #include "clutter/clutter-interval.h"
 #include "clutter/clutter-main.h"
@@ -583,6 +584,19 @@ struct _ClutterActorPrivate
 
   graphene_matrix_t stage_relative_modelview;
 
+  /* matrices derived from stage_relative_modelview; each one remembers
+   * the generation of stage_relative_modelview it was computed from, so
+   * they are only recomputed when they are actually queried
+   */
+  graphene_matrix_t absolute_modelview;
+  graphene_matrix_t absolute_modelview_projection;
+  graphene_matrix_t inverse_stage_relative_modelview;
+  unsigned int stage_relative_generation;
+  unsigned int absolute_modelview_generation;
+  unsigned int absolute_modelview_projection_generation;
+  unsigned int absolute_projection_generation;
+  unsigned int inverse_stage_relative_generation;
+
   float resource_scale;
 
   guint8 opacity;
@@ -748,6 +762,7 @@ struct _ClutterActorPrivate
   guint needs_redraw : 1;
   guint needs_finish_layout : 1;
   guint stage_relative_modelview_valid : 1;
+  guint inverse_stage_relative_modelview_valid : 1;
 };
 
 enum
@@ -2634,6 +2649,112 @@ clutter_actor_apply_relative_transform_to_point (ClutterActor             *self,
                                       &w);
 }
 
+static void
+ensure_stage_relative_modelview (ClutterActor *self,
+                                 ClutterActor *stage)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  if (priv->stage_relative_modelview_valid)
+    return;
+
+  graphene_matrix_init_identity (&priv->stage_relative_modelview);
+
+  if (priv->parent != NULL)
+    {
+      _clutter_actor_apply_relative_transformation_matrix (priv->parent,
+                                                           stage,
+                                                           &priv->stage_relative_modelview);
+    }
+
+  _clutter_actor_apply_modelview_transform (self,
+                                            &priv->stage_relative_modelview);
+
+  priv->stage_relative_modelview_valid = TRUE;
+  priv->stage_relative_generation++;
+}
+
+/* Returns the transformation all the way to eye coordinates, i.e. what
+ * _clutter_actor_apply_relative_transformation_matrix() would apply to
+ * an identity matrix for a %NULL ancestor. */
+static const graphene_matrix_t *
+ensure_absolute_modelview (ClutterActor *self,
+                           ClutterActor *stage)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  ensure_stage_relative_modelview (self, stage);
+
+  if (priv->absolute_modelview_generation != priv->stage_relative_generation)
+    {
+      graphene_matrix_init_identity (&priv->absolute_modelview);
+      _clutter_actor_apply_modelview_transform (stage,
+                                                &priv->absolute_modelview);
+      graphene_matrix_multiply (&priv->stage_relative_modelview,
+                                &priv->absolute_modelview,
+                                &priv->absolute_modelview);
+
+      priv->absolute_modelview_generation = priv->stage_relative_generation;
+    }
+
+  return &priv->absolute_modelview;
+}
+
+static const graphene_matrix_t *
+ensure_absolute_modelview_projection (ClutterActor *self,
+                                      ClutterActor *stage)
+{
+  ClutterActorPrivate *priv = self->priv;
+  unsigned int projection_generation;
+  const graphene_matrix_t *modelview;
+
+  modelview = ensure_absolute_modelview (self, stage);
+  projection_generation =
+    clutter_stage_get_projection_generation (CLUTTER_STAGE (stage));
+
+  if (priv->absolute_modelview_projection_generation !=
+      priv->stage_relative_generation ||
+      priv->absolute_projection_generation != projection_generation)
+    {
+      graphene_matrix_t projection;
+
+      _clutter_stage_get_projection_matrix (CLUTTER_STAGE (stage),
+                                            &projection);
+      graphene_matrix_multiply (modelview,
+                                &projection,
+                                &priv->absolute_modelview_projection);
+
+      priv->absolute_modelview_projection_generation =
+        priv->stage_relative_generation;
+      priv->absolute_projection_generation = projection_generation;
+    }
+
+  return &priv->absolute_modelview_projection;
+}
+
+/* Returns NULL if the stage relative modelview is not invertible */
+static const graphene_matrix_t *
+ensure_inverse_stage_relative_modelview (ClutterActor *self,
+                                         ClutterActor *stage)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  ensure_stage_relative_modelview (self, stage);
+
+  if (priv->inverse_stage_relative_generation != priv->stage_relative_generation)
+    {
+      priv->inverse_stage_relative_modelview_valid =
+        graphene_matrix_inverse (&priv->stage_relative_modelview,
+                                 &priv->inverse_stage_relative_modelview);
+      priv->inverse_stage_relative_generation = priv->stage_relative_generation;
+    }
+
+  if (!priv->inverse_stage_relative_modelview_valid)
+    return NULL;
+
+  return &priv->inverse_stage_relative_modelview;
+}
+
 static gboolean
 _clutter_actor_fully_transform_vertices (ClutterActor             *self,
                                          const graphene_point3d_t *vertices_in,
@@ -2641,7 +2762,6 @@ _clutter_actor_fully_transform_vertices (ClutterActor             *self,
                                          int                       n_vertices)
 {
   ClutterActor *stage;
-  graphene_matrix_t modelview;
   graphene_matrix_t projection;
   float viewport[4];
 
@@ -2654,20 +2774,32 @@ _clutter_actor_fully_transform_vertices (ClutterActor             *self,
   if (stage == NULL)
     return FALSE;
 
-  /* Note: we pass NULL as the ancestor because we don't just want the modelview
-   * that gets us to stage coordinates, we want to go all the way to eye
-   * coordinates */
-  clutter_actor_get_relative_transformation_matrix (self, NULL, &modelview);
-
-  /* Fetch the projection and viewport */
-  _clutter_stage_get_projection_matrix (CLUTTER_STAGE (stage), &projection);
   _clutter_stage_get_viewport (CLUTTER_STAGE (stage),
                                &viewport[0],
                                &viewport[1],
                                &viewport[2],
                                &viewport[3]);
 
-  _clutter_util_fully_transform_vertices (&modelview,
+  /* Boxes go through the cached modelview-projection matrix; this
+   * gives the same results _clutter_util_fully_transform_vertices()
+   * would, minus a matrix multiplication per query */
+  if (n_vertices >= 4)
+    {
+      _clutter_util_project_vertices (ensure_absolute_modelview_projection (self,
+                                                                            stage),
+                                      viewport,
+                                      vertices_in,
+                                      vertices_out,
+                                      n_vertices);
+      return TRUE;
+    }
+
+  _clutter_stage_get_projection_matrix (CLUTTER_STAGE (stage), &projection);
+
+  /* Note: we use the eye coordinates modelview because we don't just want
+   * the modelview that gets us to stage coordinates */
+  _clutter_util_fully_transform_vertices (ensure_absolute_modelview (self,
+                                                                     stage),
                                           &projection,
                                           viewport,
                                           vertices_in,
@@ -2729,6 +2861,19 @@ clutter_actor_get_relative_transformation_matrix (ClutterActor      *self,
                                                   ClutterActor      *ancestor,
                                                   graphene_matrix_t *matrix)
 {
+  ClutterActor *stage = NULL;
+
+  if (ancestor == NULL)
+    stage = _clutter_actor_get_stage_internal (self);
+
+  if (stage != NULL)
+    {
+      graphene_matrix_init_from_matrix (matrix,
+                                        ensure_absolute_modelview (self,
+                                                                   stage));
+      return;
+    }
+
   graphene_matrix_init_identity (matrix);
 
   _clutter_actor_apply_relative_transformation_matrix (self, ancestor, matrix);
@@ -2975,8 +3120,8 @@ _clutter_actor_apply_relative_transformation_matrix (ClutterActor      *self,
 {
   ClutterActorPrivate *priv = self->priv;
   ClutterActor *stage = _clutter_actor_get_stage_internal (self);
-  graphene_matrix_t ancestor_modelview;
-  graphene_matrix_t inverse_ancestor_modelview;
+  const graphene_matrix_t *inverse_ancestor_modelview;
+  const graphene_matrix_t *ancestor_modelview;
 
   /* Note we terminate before ever calling stage->apply_transform()
    * since that would conceptually be relative to the underlying
@@ -2985,22 +3130,7 @@ _clutter_actor_apply_relative_transformation_matrix (ClutterActor      *self,
   if (self == ancestor)
     return;
 
-  if (!priv->stage_relative_modelview_valid)
-    {
-      graphene_matrix_init_identity (&priv->stage_relative_modelview);
-
-      if (priv->parent != NULL)
-        {
-          _clutter_actor_apply_relative_transformation_matrix (priv->parent,
-                                                               stage,
-                                                               &priv->stage_relative_modelview);
-        }
-
-      _clutter_actor_apply_modelview_transform (self,
-                                                &priv->stage_relative_modelview);
-
-      priv->stage_relative_modelview_valid = TRUE;
-    }
+  ensure_stage_relative_modelview (self, stage);
 
   if (ancestor == NULL)
     {
@@ -3021,26 +3151,25 @@ _clutter_actor_apply_relative_transformation_matrix (ClutterActor      *self,
       return;
     }
 
-  graphene_matrix_init_identity (&ancestor_modelview);
-  _clutter_actor_apply_relative_transformation_matrix (ancestor,
-                                                       stage,
-                                                       &ancestor_modelview);
+  ensure_stage_relative_modelview (ancestor, stage);
+  ancestor_modelview = &ancestor->priv->stage_relative_modelview;
 
   if (graphene_matrix_near (&priv->stage_relative_modelview,
-                            &ancestor_modelview,
+                            ancestor_modelview,
                             FLT_EPSILON))
     return;
 
-  if (graphene_matrix_is_identity (&ancestor_modelview))
+  if (graphene_matrix_is_identity (ancestor_modelview))
     {
       graphene_matrix_multiply (&priv->stage_relative_modelview, matrix, matrix);
       return;
     }
 
-  if (graphene_matrix_inverse (&ancestor_modelview,
-                               &inverse_ancestor_modelview))
+  inverse_ancestor_modelview =
+    ensure_inverse_stage_relative_modelview (ancestor, stage);
+  if (inverse_ancestor_modelview != NULL)
     {
-      graphene_matrix_multiply (&inverse_ancestor_modelview, matrix, matrix);
+      graphene_matrix_multiply (inverse_ancestor_modelview, matrix, matrix);
       graphene_matrix_multiply (&priv->stage_relative_modelview, matrix, matrix);
       return;
     }
@@ -8549,6 +8678,50 @@ clutter_actor_get_preferred_height (ClutterActor *self,
   CLUTTER_UNSET_PRIVATE_FLAGS (self, CLUTTER_IN_PREF_HEIGHT);
 }
 
+gboolean
+clutter_actor_needs_size_request (ClutterActor *self)
+{
+  return self->priv->needs_width_request || self->priv->needs_height_request;
+}
+
+/*< private >
+ * clutter_actor_has_thread_safe_size_request:
+ * @self: a #ClutterActor
+ *
+ * Checks whether the size request of @self only depends on state of @self
+ * and of its children, and doesn't run any code outside of Clutter
+ * itself, i.e. no overridden size request virtual functions, no
+ * constraints and no content size. The children themselves are not
+ * checked.
+ *
+ * Return value: %TRUE if the preferred size of @self can be computed
+ *   off the main thread
+ */
+gboolean
+clutter_actor_has_thread_safe_size_request (ClutterActor *self)
+{
+  ClutterActorClass *klass = CLUTTER_ACTOR_GET_CLASS (self);
+  ClutterActorPrivate *priv = self->priv;
+
+  if (klass->get_preferred_width != clutter_actor_real_get_preferred_width ||
+      klass->get_preferred_height != clutter_actor_real_get_preferred_height)
+    return FALSE;
+
+  if (priv->constraints != NULL &&
+      _clutter_meta_group_peek_metas (priv->constraints) != NULL)
+    return FALSE;
+
+  if (priv->request_mode == CLUTTER_REQUEST_CONTENT_SIZE &&
+      priv->content != NULL)
+    return FALSE;
+
+  if (priv->layout_manager != NULL &&
+      !clutter_layout_manager_has_thread_safe_size_requests (priv->layout_manager))
+    return FALSE;
+
+  return TRUE;
+}
+
 /**
  * clutter_actor_get_allocation_box:
  * @self: A #ClutterActor
@@ -12491,6 +12664,177 @@ clutter_animatable_iface_init (ClutterAnimatableInterface *iface)
   iface->get_actor = clutter_actor_get_actor;
 }
 
+/*< private >
+ * clutter_actor_can_batch_property:
+ * @self: a #ClutterActor
+ * @pspec: the #GParamSpec of an animatable property of @self
+ *
+ * Checks whether the animatable property described by @pspec can be
+ * set with clutter_actor_set_batched_property(), bypassing the
+ * #ClutterAnimatable implementation of @self.
+ *
+ * This is only the case for the float, double, unsigned integer, point
+ * and color properties of #ClutterActor itself, and only if subclasses
+ * did not override the #ClutterAnimatable implementation.
+ *
+ * Return value: %TRUE if the property can be batched
+ */
+gboolean
+clutter_actor_can_batch_property (ClutterActor *self,
+                                  GParamSpec   *pspec)
+{
+  ClutterAnimatableInterface *iface;
+
+  if (pspec->owner_type != CLUTTER_TYPE_ACTOR ||
+      (pspec->flags & CLUTTER_PARAM_ANIMATABLE) == 0)
+    return FALSE;
+
+  iface = CLUTTER_ANIMATABLE_GET_IFACE (self);
+  if (iface->set_final_state != clutter_actor_set_final_state ||
+      iface->interpolate_value != NULL)
+    return FALSE;
+
+  switch (pspec->param_id)
+    {
+    case PROP_X:
+    case PROP_Y:
+    case PROP_POSITION:
+    case PROP_WIDTH:
+    case PROP_HEIGHT:
+    case PROP_Z_POSITION:
+    case PROP_OPACITY:
+    case PROP_BACKGROUND_COLOR:
+    case PROP_PIVOT_POINT:
+    case PROP_PIVOT_POINT_Z:
+    case PROP_TRANSLATION_X:
+    case PROP_TRANSLATION_Y:
+    case PROP_TRANSLATION_Z:
+    case PROP_SCALE_X:
+    case PROP_SCALE_Y:
+    case PROP_SCALE_Z:
+    case PROP_ROTATION_ANGLE_X:
+    case PROP_ROTATION_ANGLE_Y:
+    case PROP_ROTATION_ANGLE_Z:
+    case PROP_MARGIN_TOP:
+    case PROP_MARGIN_BOTTOM:
+    case PROP_MARGIN_LEFT:
+    case PROP_MARGIN_RIGHT:
+      return TRUE;
+
+    default:
+      return FALSE;
+    }
+}
+
+/*< private >
+ * clutter_actor_set_batched_property:
+ * @self: a #ClutterActor
+ * @pspec: a #GParamSpec accepted by clutter_actor_can_batch_property()
+ * @components: the components of the new value, as computed by the
+ *   default #ClutterInterval interpolation of the property value type
+ *
+ * Sets an animatable property from the components of its value, with the
+ * same conversions that setting the value through the #ClutterAnimatable
+ * implementation would apply, but without going through a #GValue.
+ */
+void
+clutter_actor_set_batched_property (ClutterActor *self,
+                                    GParamSpec   *pspec,
+                                    const double *components)
+{
+  GObject *obj = G_OBJECT (self);
+
+  g_object_freeze_notify (obj);
+
+  switch (pspec->param_id)
+    {
+    case PROP_X:
+      clutter_actor_set_x_internal (self, (float) components[0]);
+      break;
+
+    case PROP_Y:
+      clutter_actor_set_y_internal (self, (float) components[0]);
+      break;
+
+    case PROP_POSITION:
+      clutter_actor_set_position_internal (self,
+                                           &GRAPHENE_POINT_INIT ((float) components[0],
+                                                                 (float) components[1]));
+      break;
+
+    case PROP_WIDTH:
+      clutter_actor_set_width_internal (self, (float) components[0]);
+      break;
+
+    case PROP_HEIGHT:
+      clutter_actor_set_height_internal (self, (float) components[0]);
+      break;
+
+    case PROP_Z_POSITION:
+      clutter_actor_set_z_position_internal (self, (float) components[0]);
+      break;
+
+    case PROP_OPACITY:
+      clutter_actor_set_opacity_internal (self, (unsigned int) components[0]);
+      break;
+
+    case PROP_BACKGROUND_COLOR:
+      {
+        CoglColor color = {
+          .red = (uint8_t) components[0],
+          .green = (uint8_t) components[1],
+          .blue = (uint8_t) components[2],
+          .alpha = (uint8_t) components[3],
+        };
+
+        clutter_actor_set_background_color_internal (self, &color);
+      }
+      break;
+
+    case PROP_PIVOT_POINT:
+      clutter_actor_set_pivot_point_internal (self,
+                                              &GRAPHENE_POINT_INIT ((float) components[0],
+                                                                    (float) components[1]));
+      break;
+
+    case PROP_PIVOT_POINT_Z:
+      clutter_actor_set_pivot_point_z_internal (self, (float) components[0]);
+      break;
+
+    case PROP_TRANSLATION_X:
+    case PROP_TRANSLATION_Y:
+    case PROP_TRANSLATION_Z:
+      clutter_actor_set_translation_internal (self,
+                                              (float) components[0],
+                                              pspec);
+      break;
+
+    case PROP_SCALE_X:
+    case PROP_SCALE_Y:
+    case PROP_SCALE_Z:
+      clutter_actor_set_scale_factor_internal (self, components[0], pspec);
+      break;
+
+    case PROP_ROTATION_ANGLE_X:
+    case PROP_ROTATION_ANGLE_Y:
+    case PROP_ROTATION_ANGLE_Z:
+      clutter_actor_set_rotation_angle_internal (self, components[0], pspec);
+      break;
+
+    case PROP_MARGIN_TOP:
+    case PROP_MARGIN_BOTTOM:
+    case PROP_MARGIN_LEFT:
+    case PROP_MARGIN_RIGHT:
+      clutter_actor_set_margin_internal (self, (float) components[0], pspec);
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+
+  g_object_thaw_notify (obj);
+}
+
 /**
  * clutter_actor_transform_stage_point:
  * @self: A #ClutterActor
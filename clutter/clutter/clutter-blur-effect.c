@@ -29,14 +29,22 @@
  *
  * #ClutterBlurEffect is a sub-class of #ClutterEffect that allows blurring a
  * actor and its contents.
+ *
+ * The blurred contents are kept in an offscreen from the context pool until
+ * the actor is redrawn, so painting an actor that didn't change only draws
+ * that texture instead of sampling the offscreen texture nine times per
+ * pixel again.
  */
 #include "config.h"
 
 #include "clutter/clutter-blur-effect.h"
 
+#include <math.h>
+
 #include "cogl/cogl.h"
 
 #include "clutter/clutter-debug.h"
+#include "clutter/clutter-paint-nodes.h"
 #include "clutter/clutter-private.h"
 
 #define BLUR_PADDING    2
@@ -70,6 +78,12 @@ typedef struct _ClutterBlurEffectPrivate
   gint pixel_step_uniform;
 
   CoglPipeline *pipeline;
+
+  /* The result of the last blur, valid until the actor is redrawn or
+   * the offscreen texture is replaced; it goes back to the pool then */
+  CoglOffscreen *blurred_offscreen;
+  CoglPipeline *blurred_pipeline;
+  gboolean blurred_valid;
 } ClutterBlurEffectPrivate;
 
 
@@ -77,6 +91,80 @@ G_DEFINE_TYPE_WITH_PRIVATE (ClutterBlurEffect,
                             clutter_blur_effect,
                             CLUTTER_TYPE_OFFSCREEN_EFFECT);
 
+static void
+release_blurred_offscreen (ClutterBlurEffect *self)
+{
+  ClutterBlurEffectPrivate *priv =
+    clutter_blur_effect_get_instance_private (self);
+
+  priv->blurred_valid = FALSE;
+
+  if (!priv->blurred_offscreen)
+    return;
+
+  /* The texture may be handed out to someone else once released */
+  cogl_pipeline_set_layer_null_texture (priv->blurred_pipeline, 0);
+  g_clear_pointer (&priv->blurred_offscreen, cogl_offscreen_release);
+}
+
+static gboolean
+ensure_blurred_offscreen (ClutterBlurEffect *self,
+                          CoglTexture       *texture)
+{
+  ClutterBlurEffectPrivate *priv =
+    clutter_blur_effect_get_instance_private (self);
+  g_autoptr (GError) error = NULL;
+  CoglTexture *blurred_texture;
+  CoglContext *ctx;
+  int width, height;
+
+  width = cogl_texture_get_width (texture);
+  height = cogl_texture_get_height (texture);
+
+  if (priv->blurred_offscreen)
+    {
+      blurred_texture = cogl_offscreen_get_texture (priv->blurred_offscreen);
+
+      if ((int) cogl_texture_get_width (blurred_texture) == width &&
+          (int) cogl_texture_get_height (blurred_texture) == height)
+        return TRUE;
+    }
+
+  release_blurred_offscreen (self);
+
+  ctx = cogl_texture_get_context (texture);
+  priv->blurred_offscreen = cogl_offscreen_new_pooled (ctx,
+                                                       COGL_PIXEL_FORMAT_ANY,
+                                                       width, height,
+                                                       &error);
+  if (!priv->blurred_offscreen)
+    {
+      g_warning ("Unable to allocate blur effect offscreen: %s",
+                 error->message);
+      return FALSE;
+    }
+
+  cogl_framebuffer_orthographic (COGL_FRAMEBUFFER (priv->blurred_offscreen),
+                                 0.0, 0.0,
+                                 (float) width, (float) height,
+                                 0.0, 1.0);
+
+  if (!priv->blurred_pipeline)
+    {
+      priv->blurred_pipeline = cogl_pipeline_new (ctx);
+      cogl_pipeline_set_static_name (priv->blurred_pipeline,
+                                     "ClutterBlurEffect (blurred)");
+    }
+
+  /* Pooled offscreens come with premultiplied textures, like the
+   * offscreen effect's own */
+  blurred_texture = cogl_offscreen_get_texture (priv->blurred_offscreen);
+  cogl_pipeline_set_layer_texture (priv->blurred_pipeline, 0,
+                                   blurred_texture);
+
+  return TRUE;
+}
+
 static CoglPipeline *
 clutter_blur_effect_create_pipeline (ClutterOffscreenEffect *effect,
                                      CoglTexture            *texture)
@@ -85,6 +173,9 @@ clutter_blur_effect_create_pipeline (ClutterOffscreenEffect *effect,
   ClutterBlurEffectPrivate *priv =
     clutter_blur_effect_get_instance_private (blur_effect);
 
+  /* A new offscreen texture means new contents */
+  release_blurred_offscreen (blur_effect);
+
   if (priv->pixel_step_uniform > -1)
     {
       float pixel_step[2];
@@ -108,6 +199,110 @@ clutter_blur_effect_create_pipeline (ClutterOffscreenEffect *effect,
   return g_object_ref (priv->pipeline);
 }
 
+static void
+clutter_blur_effect_paint_target (ClutterOffscreenEffect *effect,
+                                  ClutterPaintNode       *node,
+                                  ClutterPaintContext    *paint_context)
+{
+  ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (effect);
+  ClutterBlurEffectPrivate *priv =
+    clutter_blur_effect_get_instance_private (self);
+  ClutterOffscreenEffectClass *parent_class =
+    CLUTTER_OFFSCREEN_EFFECT_CLASS (clutter_blur_effect_parent_class);
+  ClutterPaintNode *pipeline_node;
+  ClutterPaintNode *layer_node;
+  CoglFramebuffer *framebuffer;
+  ClutterActor *actor;
+  CoglPipelineFilter filter;
+  CoglTexture *texture;
+  ClutterActorBox box;
+  float paint_opacity;
+  CoglColor color;
+
+  texture = clutter_offscreen_effect_get_texture (effect);
+  if (G_UNLIKELY (clutter_paint_debug_flags &
+                  CLUTTER_DEBUG_DISABLE_BLUR_CACHE) ||
+      !ensure_blurred_offscreen (self, texture))
+    {
+      release_blurred_offscreen (self);
+      parent_class->paint_target (effect, node, paint_context);
+      return;
+    }
+
+  actor = clutter_actor_meta_get_actor (CLUTTER_ACTOR_META (effect));
+  box = (ClutterActorBox) {
+    0.f, 0.f,
+    (float) cogl_texture_get_width (texture),
+    (float) cogl_texture_get_height (texture),
+  };
+
+  /* Same filtering as the offscreen effect would have used for the
+   * offscreen texture itself */
+  if (fmodf (clutter_actor_get_real_resource_scale (actor), 1.0f) == 0)
+    filter = COGL_PIPELINE_FILTER_NEAREST;
+  else
+    filter = COGL_PIPELINE_FILTER_LINEAR;
+
+  cogl_pipeline_set_layer_filters (priv->blurred_pipeline, 0, filter, filter);
+
+  paint_opacity = clutter_actor_get_paint_opacity (actor) / 255.0f;
+  cogl_color_init_from_4f (&color,
+                           paint_opacity, paint_opacity,
+                           paint_opacity, paint_opacity);
+  cogl_pipeline_set_color (priv->blurred_pipeline, &color);
+
+  if (priv->blurred_valid)
+    {
+      pipeline_node = clutter_pipeline_node_new (priv->blurred_pipeline);
+      clutter_paint_node_set_static_name (pipeline_node,
+                                          G_OBJECT_TYPE_NAME (effect));
+      clutter_paint_node_add_child (node, pipeline_node);
+      clutter_paint_node_add_rectangle (pipeline_node, &box);
+      clutter_paint_node_unref (pipeline_node);
+      return;
+    }
+
+  /* Blur into the cached texture, and draw the result from there */
+  framebuffer = COGL_FRAMEBUFFER (priv->blurred_offscreen);
+  layer_node = clutter_layer_node_new_to_framebuffer (framebuffer,
+                                                      priv->blurred_pipeline);
+  clutter_paint_node_set_static_name (layer_node, G_OBJECT_TYPE_NAME (effect));
+  clutter_paint_node_add_child (node, layer_node);
+  clutter_paint_node_add_rectangle (layer_node, &box);
+
+  /* The offscreen pipeline may still carry the opacity of an earlier
+   * uncached paint; the cached result must not */
+  cogl_color_init_from_4f (&color, 1.0f, 1.0f, 1.0f, 1.0f);
+  cogl_pipeline_set_color (priv->pipeline, &color);
+
+  pipeline_node = clutter_pipeline_node_new (priv->pipeline);
+  clutter_paint_node_set_static_name (pipeline_node,
+                                      "ClutterBlurEffect (blur)");
+  clutter_paint_node_add_child (layer_node, pipeline_node);
+  clutter_paint_node_add_rectangle (pipeline_node, &box);
+  clutter_paint_node_unref (pipeline_node);
+  clutter_paint_node_unref (layer_node);
+
+  priv->blurred_valid = TRUE;
+}
+
+static void
+clutter_blur_effect_paint (ClutterEffect           *effect,
+                           ClutterPaintNode        *node,
+                           ClutterPaintContext     *paint_context,
+                           ClutterEffectPaintFlags  flags)
+{
+  ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (effect);
+  ClutterEffectClass *parent_class =
+    CLUTTER_EFFECT_CLASS (clutter_blur_effect_parent_class);
+
+  /* The offscreen effect is going to redraw the actor */
+  if (flags & CLUTTER_EFFECT_PAINT_ACTOR_DIRTY)
+    release_blurred_offscreen (self);
+
+  parent_class->paint (effect, node, paint_context, flags);
+}
+
 static gboolean
 clutter_blur_effect_modify_paint_volume (ClutterEffect      *effect,
                                          ClutterPaintVolume *volume)
@@ -137,7 +332,9 @@ clutter_blur_effect_dispose (GObject *gobject)
   ClutterBlurEffectPrivate *priv =
     clutter_blur_effect_get_instance_private (self);
 
+  release_blurred_offscreen (self);
   g_clear_object (&priv->pipeline);
+  g_clear_object (&priv->blurred_pipeline);
 
   G_OBJECT_CLASS (clutter_blur_effect_parent_class)->dispose (gobject);
 }
@@ -152,9 +349,11 @@ clutter_blur_effect_class_init (ClutterBlurEffectClass *klass)
   gobject_class->dispose = clutter_blur_effect_dispose;
 
   effect_class->modify_paint_volume = clutter_blur_effect_modify_paint_volume;
+  effect_class->paint = clutter_blur_effect_paint;
 
   offscreen_class = CLUTTER_OFFSCREEN_EFFECT_CLASS (klass);
   offscreen_class->create_pipeline = clutter_blur_effect_create_pipeline;
+  offscreen_class->paint_target = clutter_blur_effect_paint_target;
 }
 
 static void
@@ -19,19 +19,30 @@
 
 #include <glib-object.h>
 
+#include "clutter/clutter-enums.h"
+#include "clutter/clutter-macros.h"
 #include "cogl/cogl.h"
 
 G_BEGIN_DECLS
 
 typedef struct _ClutterBlur ClutterBlur;
 
+CLUTTER_EXPORT_TEST
 ClutterBlur * clutter_blur_new (CoglTexture *texture,
                                 float        radius);
 
+CLUTTER_EXPORT_TEST
+ClutterBlur * clutter_blur_new_with_mode (CoglTexture     *texture,
+                                          float            radius,
+                                          ClutterBlurMode  mode);
+
+CLUTTER_EXPORT_TEST
 void clutter_blur_apply (ClutterBlur *blur);
 
+CLUTTER_EXPORT_TEST
 CoglTexture * clutter_blur_get_texture (ClutterBlur *blur);
 
+CLUTTER_EXPORT_TEST
 void clutter_blur_free (ClutterBlur *blur);
 
 G_END_DECLS
@@ -67,6 +67,21 @@
  *
  * https://developer.nvidia.com/gpugems/GPUGems3/gpugems3_ch40.html
  *
+ * ## Dual filter mode
+ *
+ * With %CLUTTER_BLUR_MODE_DUAL_FILTER, the texture is instead blurred by a
+ * chain of passes that each halve the size of the image while sampling
+ * around every pixel, followed by as many passes doubling it back to the
+ * original size; the "dual Kawase" blur described by Marius Bjørge in
+ * "Bandwidth-Efficient Rendering" (SIGGRAPH 2015):
+ *
+ * https://community.arm.com/cfs-file/__key/communityserver-blogs-components-weblogfiles/00-00-00-20-66/siggraph2015_2D00_mmg_2D00_marius_2D00_slides.pdf
+ *
+ * Every pass reads a handful of texels, and most of them operate on small
+ * textures, so the cost barely grows with the radius. The number of passes
+ * and the sampling offset are chosen so that the variance of the whole chain
+ * matches the variance of the gaussian blur with the same radius.
+ *
  */
 
 static const char *gaussian_blur_glsl_declarations =
@@ -108,9 +123,44 @@ static const char *gaussian_blur_glsl =
 "                                                                          \n"
 "  cogl_texel = ret / gauss_coefficient_total;                             \n";
 
+static const char *dual_filter_glsl_declarations =
+"uniform vec2 half_pixel;                                                  \n"
+"uniform float offset;                                                     \n";
+
+static const char *dual_filter_downsample_glsl =
+"  vec2 uv = vec2 (cogl_tex_coord.st);                                     \n"
+"  vec2 step = half_pixel * offset;                                        \n"
+"                                                                          \n"
+"  vec4 sum = texture2D (cogl_sampler, uv) * 4.0;                          \n"
+"  sum += texture2D (cogl_sampler, uv - step);                             \n"
+"  sum += texture2D (cogl_sampler, uv + step);                             \n"
+"  sum += texture2D (cogl_sampler, uv + vec2 (step.x, -step.y));           \n"
+"  sum += texture2D (cogl_sampler, uv - vec2 (step.x, -step.y));           \n"
+"                                                                          \n"
+"  cogl_texel = sum / 8.0;                                                 \n";
+
+static const char *dual_filter_upsample_glsl =
+"  vec2 uv = vec2 (cogl_tex_coord.st);                                     \n"
+"  vec2 step = half_pixel * offset;                                        \n"
+"                                                                          \n"
+"  vec4 sum = texture2D (cogl_sampler, uv + vec2 (-step.x * 2.0, 0.0));    \n"
+"  sum += texture2D (cogl_sampler, uv + vec2 (-step.x, step.y)) * 2.0;     \n"
+"  sum += texture2D (cogl_sampler, uv + vec2 (0.0, step.y * 2.0));         \n"
+"  sum += texture2D (cogl_sampler, uv + step) * 2.0;                       \n"
+"  sum += texture2D (cogl_sampler, uv + vec2 (step.x * 2.0, 0.0));         \n"
+"  sum += texture2D (cogl_sampler, uv + vec2 (step.x, -step.y)) * 2.0;     \n"
+"  sum += texture2D (cogl_sampler, uv + vec2 (0.0, -step.y * 2.0));        \n"
+"  sum += texture2D (cogl_sampler, uv - step) * 2.0;                       \n"
+"                                                                          \n"
+"  cogl_texel = sum / 12.0;                                                \n";
+
 #define MIN_DOWNSCALE_SIZE 256.f
 #define MAX_SIGMA 6.f
 
+#define MAX_DUAL_FILTER_ITERATIONS 8
+#define MAX_DUAL_FILTER_OFFSET 3.f
+#define MIN_DUAL_FILTER_SIZE 8.f
+
 enum
 {
   VERTICAL,
@@ -128,10 +178,17 @@ typedef struct
 struct _ClutterBlur
 {
   CoglTexture *source_texture;
+  ClutterBlurMode mode;
   float sigma;
   float downscale_factor;
 
   BlurPass pass[2];
+
+  /* One downsampling pass per iteration, followed by as many upsampling
+   * passes back to the source size */
+  BlurPass dual_filter_pass[2 * MAX_DUAL_FILTER_ITERATIONS];
+  int n_dual_filter_iterations;
+  float dual_filter_offset;
 };
 
 static CoglPipeline*
@@ -171,6 +228,86 @@ create_blur_pipeline (CoglContext *ctx)
   return cogl_pipeline_copy (blur_pipeline);
 }
 
+static CoglPipeline *
+create_dual_filter_pipeline (CoglContext *ctx,
+                             gboolean     upsample)
+{
+  static CoglPipelineKey downsample_pipeline_key =
+    "clutter-blur-dual-filter-downsample-pipeline-private";
+  static CoglPipelineKey upsample_pipeline_key =
+    "clutter-blur-dual-filter-upsample-pipeline-private";
+  CoglPipelineKey *pipeline_key;
+  CoglPipeline *blur_pipeline;
+
+  pipeline_key = upsample ? &upsample_pipeline_key : &downsample_pipeline_key;
+  blur_pipeline = cogl_context_get_named_pipeline (ctx, pipeline_key);
+
+  if (G_UNLIKELY (blur_pipeline == NULL))
+    {
+      CoglSnippet *snippet;
+
+      blur_pipeline = cogl_pipeline_new (ctx);
+      cogl_pipeline_set_static_name (blur_pipeline,
+                                     upsample ?
+                                     "ClutterBlur (dual filter upsample)" :
+                                     "ClutterBlur (dual filter downsample)");
+      cogl_pipeline_set_layer_null_texture (blur_pipeline, 0);
+      cogl_pipeline_set_layer_filters (blur_pipeline,
+                                       0,
+                                       COGL_PIPELINE_FILTER_LINEAR,
+                                       COGL_PIPELINE_FILTER_LINEAR);
+      cogl_pipeline_set_layer_wrap_mode (blur_pipeline,
+                                         0,
+                                         COGL_PIPELINE_WRAP_MODE_CLAMP_TO_EDGE);
+
+      snippet = cogl_snippet_new (COGL_SNIPPET_HOOK_TEXTURE_LOOKUP,
+                                  dual_filter_glsl_declarations,
+                                  NULL);
+      cogl_snippet_set_replace (snippet,
+                                upsample ?
+                                dual_filter_upsample_glsl :
+                                dual_filter_downsample_glsl);
+      cogl_pipeline_add_layer_snippet (blur_pipeline, 0, snippet);
+      g_object_unref (snippet);
+
+      cogl_context_set_named_pipeline (ctx, pipeline_key, blur_pipeline);
+    }
+
+  return cogl_pipeline_copy (blur_pipeline);
+}
+
+static void
+update_dual_filter_uniforms (ClutterBlur *blur,
+                             BlurPass    *pass)
+{
+  int half_pixel_uniform;
+  int offset_uniform;
+
+  half_pixel_uniform =
+    cogl_pipeline_get_uniform_location (pass->pipeline, "half_pixel");
+  if (half_pixel_uniform > -1)
+    {
+      float half_pixel[2] = {
+        0.5f / cogl_texture_get_width (pass->texture),
+        0.5f / cogl_texture_get_height (pass->texture),
+      };
+
+      cogl_pipeline_set_uniform_float (pass->pipeline,
+                                       half_pixel_uniform,
+                                       2, 1,
+                                       half_pixel);
+    }
+
+  offset_uniform = cogl_pipeline_get_uniform_location (pass->pipeline,
+                                                       "offset");
+  if (offset_uniform > -1)
+    {
+      cogl_pipeline_set_uniform_1f (pass->pipeline,
+                                    offset_uniform,
+                                    blur->dual_filter_offset);
+    }
+}
+
 static void
 update_blur_uniforms (ClutterBlur *blur,
                       BlurPass    *pass)
@@ -221,6 +358,14 @@ update_blur_uniforms (ClutterBlur *blur,
     }
 }
 
+static void
+release_framebuffer (CoglFramebuffer *framebuffer)
+{
+  /* Hands pooled offscreens back to the context, so the next blur of the
+   * same size doesn't need to allocate new textures */
+  cogl_offscreen_release (COGL_OFFSCREEN (framebuffer));
+}
+
 static gboolean
 create_fbo (ClutterBlur *blur,
             CoglContext *ctx,
@@ -230,29 +375,32 @@ create_fbo (ClutterBlur *blur,
   float scaled_width;
   float height;
   float width;
+  CoglOffscreen *offscreen;
+  g_autoptr (GError) error = NULL;
 
   g_clear_object (&pass->texture);
-  g_clear_object (&pass->framebuffer);
+  g_clear_pointer (&pass->framebuffer, release_framebuffer);
 
   width = cogl_texture_get_width (blur->source_texture);
   height = cogl_texture_get_height (blur->source_texture);
   scaled_width = floorf (width / blur->downscale_factor);
   scaled_height = floorf (height / blur->downscale_factor);
 
-  pass->texture = cogl_texture_2d_new_with_size (ctx,
-                                                 (int) scaled_width,
-                                                 (int) scaled_height);
-  if (!pass->texture)
-    return FALSE;
-
-  pass->framebuffer =
-    COGL_FRAMEBUFFER (cogl_offscreen_new_with_texture (pass->texture));
-  if (!pass->framebuffer)
+  offscreen = cogl_offscreen_new_pooled (ctx,
+                                         COGL_PIXEL_FORMAT_ANY,
+                                         (int) scaled_width,
+                                         (int) scaled_height,
+                                         &error);
+  if (!offscreen)
     {
-      g_warning ("%s: Unable to create an Offscreen buffer", G_STRLOC);
+      g_warning ("%s: Unable to create an Offscreen buffer: %s",
+                 G_STRLOC, error->message);
       return FALSE;
     }
 
+  pass->framebuffer = COGL_FRAMEBUFFER (offscreen);
+  pass->texture = g_object_ref (cogl_offscreen_get_texture (offscreen));
+
   cogl_framebuffer_orthographic (pass->framebuffer,
                                  0.0, 0.0,
                                  scaled_width,
@@ -279,6 +427,128 @@ setup_blur_pass (ClutterBlur *blur,
   return TRUE;
 }
 
+static gboolean
+setup_dual_filter_pass (BlurPass    *pass,
+                        gboolean     upsample,
+                        CoglTexture *texture,
+                        CoglTexture *target,
+                        int          width,
+                        int          height)
+{
+  CoglContext *context = cogl_texture_get_context (texture);
+
+  pass->pipeline = create_dual_filter_pipeline (context, upsample);
+  cogl_pipeline_set_layer_texture (pass->pipeline, 0, texture);
+
+  if (target)
+    {
+      pass->texture = g_object_ref (target);
+      pass->framebuffer =
+        COGL_FRAMEBUFFER (cogl_offscreen_new_with_texture (pass->texture));
+    }
+  else
+    {
+      g_autoptr (GError) error = NULL;
+      CoglOffscreen *offscreen;
+
+      offscreen = cogl_offscreen_new_pooled (context,
+                                             COGL_PIXEL_FORMAT_ANY,
+                                             width, height,
+                                             &error);
+      if (!offscreen)
+        {
+          g_warning ("%s: Unable to create an Offscreen buffer: %s",
+                     G_STRLOC, error->message);
+          return FALSE;
+        }
+
+      pass->framebuffer = COGL_FRAMEBUFFER (offscreen);
+      pass->texture = g_object_ref (cogl_offscreen_get_texture (offscreen));
+    }
+
+  cogl_framebuffer_orthographic (pass->framebuffer,
+                                 0.0, 0.0,
+                                 (float) cogl_texture_get_width (pass->texture),
+                                 (float) cogl_texture_get_height (pass->texture),
+                                 0.0, 1.0);
+  return TRUE;
+}
+
+static gboolean
+setup_dual_filter_passes (ClutterBlur *blur)
+{
+  int width = cogl_texture_get_width (blur->source_texture);
+  int height = cogl_texture_get_height (blur->source_texture);
+  int n_iterations = blur->n_dual_filter_iterations;
+  CoglTexture *texture = blur->source_texture;
+  int i;
+
+  /* Downsample into textures of half, a quarter, … of the source size */
+  for (i = 0; i < n_iterations; i++)
+    {
+      BlurPass *pass = &blur->dual_filter_pass[i];
+
+      if (!setup_dual_filter_pass (pass, FALSE, texture, NULL,
+                                   MAX (width >> (i + 1), 1),
+                                   MAX (height >> (i + 1), 1)))
+        return FALSE;
+
+      texture = pass->texture;
+    }
+
+  /* And upsample back, reusing the textures of the way down, except for
+   * the last pass which has the size of the source */
+  for (i = 0; i < n_iterations; i++)
+    {
+      BlurPass *pass = &blur->dual_filter_pass[n_iterations + i];
+      int level = n_iterations - i - 1;
+      CoglTexture *target;
+
+      target = level > 0 ? blur->dual_filter_pass[level - 1].texture : NULL;
+
+      if (!setup_dual_filter_pass (pass, TRUE, texture, target,
+                                   width, height))
+        return FALSE;
+
+      texture = pass->texture;
+    }
+
+  for (i = 0; i < 2 * n_iterations; i++)
+    update_dual_filter_uniforms (blur, &blur->dual_filter_pass[i]);
+
+  return TRUE;
+}
+
+static float
+calculate_dual_filter_offset (float sigma,
+                              int   n_iterations)
+{
+  /* At level k, in source pixels, a downsampling pass adds a variance of
+   * offset² · 4^k / 2 and an upsampling pass one of offset² · 4^k / 3.
+   * Pick the offset that makes the sum over all levels match sigma² */
+  return sigma / sqrtf (5.f / 18.f * (powf (4.f, (float) n_iterations) - 1.f));
+}
+
+static int
+calculate_dual_filter_iterations (float width,
+                                  float height,
+                                  float sigma)
+{
+  int n_iterations = 1;
+
+  /* Go one level deeper for as long as the offset would be too large to
+   * avoid sampling artifacts, and the smallest texture doesn't get too
+   * small */
+  while (n_iterations < MAX_DUAL_FILTER_ITERATIONS &&
+         calculate_dual_filter_offset (sigma, n_iterations) >
+           MAX_DUAL_FILTER_OFFSET &&
+         width / (float) (1 << (n_iterations + 1)) >= MIN_DUAL_FILTER_SIZE &&
+         height / (float) (1 << (n_iterations + 1)) >= MIN_DUAL_FILTER_SIZE)
+    n_iterations++;
+
+  return n_iterations;
+}
+
 static float
 calculate_downscale_factor (float width,
                             float height,
@@ -330,7 +600,65 @@ clear_blur_pass (BlurPass *pass)
 {
   g_clear_object (&pass->pipeline);
   g_clear_object (&pass->texture);
-  g_clear_object (&pass->framebuffer);
+  g_clear_pointer (&pass->framebuffer, release_framebuffer);
+}
+
+static void
+clear_blur_passes (ClutterBlur *blur)
+{
+  int i;
+
+  clear_blur_pass (&blur->pass[VERTICAL]);
+  clear_blur_pass (&blur->pass[HORIZONTAL]);
+
+  for (i = 0; i < G_N_ELEMENTS (blur->dual_filter_pass); i++)
+    clear_blur_pass (&blur->dual_filter_pass[i]);
+}
+
+static gboolean
+setup_blur_passes (ClutterBlur *blur)
+{
+  BlurPass *hpass;
+  BlurPass *vpass;
+
+  switch (blur->mode)
+    {
+    case CLUTTER_BLUR_MODE_GAUSSIAN:
+      vpass = &blur->pass[VERTICAL];
+      hpass = &blur->pass[HORIZONTAL];
+
+      return setup_blur_pass (blur, vpass, VERTICAL, blur->source_texture) &&
+             setup_blur_pass (blur, hpass, HORIZONTAL, vpass->texture);
+
+    case CLUTTER_BLUR_MODE_DUAL_FILTER:
+      return setup_dual_filter_passes (blur);
+    }
+
+  g_assert_not_reached ();
+}
+
+static void
+update_blur_parameters (ClutterBlur *blur)
+{
+  float width = (float) cogl_texture_get_width (blur->source_texture);
+  float height = (float) cogl_texture_get_height (blur->source_texture);
+
+  switch (blur->mode)
+    {
+    case CLUTTER_BLUR_MODE_GAUSSIAN:
+      blur->downscale_factor = calculate_downscale_factor (width,
+                                                           height,
+                                                           blur->sigma);
+      break;
+
+    case CLUTTER_BLUR_MODE_DUAL_FILTER:
+      blur->n_dual_filter_iterations =
+        calculate_dual_filter_iterations (width, height, blur->sigma);
+      blur->dual_filter_offset =
+        calculate_dual_filter_offset (blur->sigma,
+                                      blur->n_dual_filter_iterations);
+      break;
+    }
 }
 
 /**
@@ -338,41 +666,50 @@ clear_blur_pass (BlurPass *pass)
  * @texture: a #CoglTexture
  * @sigma: blur sigma
  *
- * Creates a new #ClutterBlur.
+ * Creates a new #ClutterBlur using %CLUTTER_BLUR_MODE_GAUSSIAN.
  *
  * Returns: (transfer full) (nullable): A newly created #ClutterBlur
  */
 ClutterBlur *
 clutter_blur_new (CoglTexture *texture,
                   float        radius)
+{
+  return clutter_blur_new_with_mode (texture, radius,
+                                     CLUTTER_BLUR_MODE_GAUSSIAN);
+}
+
+/**
+ * clutter_blur_new_with_mode:
+ * @texture: a #CoglTexture
+ * @radius: blur radius
+ * @mode: the blur algorithm to use
+ *
+ * Creates a new #ClutterBlur using @mode. Blurs with the same radius look
+ * alike regardless of the mode.
+ *
+ * Returns: (transfer full) (nullable): A newly created #ClutterBlur
+ */
+ClutterBlur *
+clutter_blur_new_with_mode (CoglTexture     *texture,
+                            float            radius,
+                            ClutterBlurMode  mode)
 {
   ClutterBlur *blur;
-  unsigned int height;
-  unsigned int width;
-  BlurPass *hpass;
-  BlurPass *vpass;
 
   g_return_val_if_fail (texture != NULL, NULL);
   g_return_val_if_fail (radius >= 0.0f, NULL);
 
-  width = cogl_texture_get_width (texture);
-  height = cogl_texture_get_height (texture);
-
   blur = g_new0 (ClutterBlur, 1);
+  blur->mode = mode;
   blur->sigma = radius / 2.0f;
   blur->source_texture = g_object_ref (texture);
-  blur->downscale_factor = calculate_downscale_factor (width,
-                                                       height,
-                                                       blur->sigma);
+  blur->downscale_factor = 1.f;
+  update_blur_parameters (blur);
 
   if (G_APPROX_VALUE (blur->sigma, 0.0f, FLT_EPSILON))
     goto out;
 
-  vpass = &blur->pass[VERTICAL];
-  hpass = &blur->pass[HORIZONTAL];
-
-  if (!setup_blur_pass (blur, vpass, VERTICAL, texture) ||
-      !setup_blur_pass (blur, hpass, HORIZONTAL, vpass->texture))
+  if (!setup_blur_passes (blur))
     {
       clutter_blur_free (blur);
       return NULL;
@@ -392,11 +729,23 @@ out:
 void
 clutter_blur_apply (ClutterBlur *blur)
 {
+  int i;
+
   if (G_APPROX_VALUE (blur->sigma, 0.0, FLT_EPSILON))
     return;
 
-  apply_blur_pass (&blur->pass[VERTICAL]);
-  apply_blur_pass (&blur->pass[HORIZONTAL]);
+  switch (blur->mode)
+    {
+    case CLUTTER_BLUR_MODE_GAUSSIAN:
+      apply_blur_pass (&blur->pass[VERTICAL]);
+      apply_blur_pass (&blur->pass[HORIZONTAL]);
+      break;
+
+    case CLUTTER_BLUR_MODE_DUAL_FILTER:
+      for (i = 0; i < 2 * blur->n_dual_filter_iterations; i++)
+        apply_blur_pass (&blur->dual_filter_pass[i]);
+      break;
+    }
 }
 
 /**
@@ -413,8 +762,18 @@ clutter_blur_get_texture (ClutterBlur *blur)
 {
   if (G_APPROX_VALUE (blur->sigma, 0.0, FLT_EPSILON))
     return blur->source_texture;
-  else
-    return blur->pass[HORIZONTAL].texture;
+
+  switch (blur->mode)
+    {
+    case CLUTTER_BLUR_MODE_GAUSSIAN:
+      return blur->pass[HORIZONTAL].texture;
+
+    case CLUTTER_BLUR_MODE_DUAL_FILTER:
+      return
+        blur->dual_filter_pass[2 * blur->n_dual_filter_iterations - 1].texture;
+    }
+
+  g_assert_not_reached ();
 }
 
 /**
@@ -428,8 +787,7 @@ clutter_blur_free (ClutterBlur *blur)
 {
   g_assert (blur);
 
-  clear_blur_pass (&blur->pass[VERTICAL]);
-  clear_blur_pass (&blur->pass[HORIZONTAL]);
+  clear_blur_passes (blur);
   g_clear_object (&blur->source_texture);
   g_free (blur);
 }
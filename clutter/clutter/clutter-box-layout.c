@@ -55,6 +55,7 @@
 #include "clutter/clutter-actor-private.h"
 #include "clutter/clutter-debug.h"
 #include "clutter/clutter-enum-types.h"
+#include "clutter/clutter-layout-manager-private.h"
 #include "clutter/clutter-layout-meta.h"
 #include "clutter/clutter-private.h"
 #include "clutter/clutter-types.h"
@@ -929,6 +930,8 @@ clutter_box_layout_class_init (ClutterBoxLayoutClass *klass)
   layout_class->allocate = clutter_box_layout_allocate;
   layout_class->set_container = clutter_box_layout_set_container;
 
+  clutter_layout_manager_class_set_thread_safe_size_requests (layout_class);
+
   /**
    * ClutterBoxLayout:orientation:
    *
@@ -52,12 +52,15 @@ struct _ClutterContext
   ClutterSettings *settings;
 
   gboolean show_fps;
+  gboolean parallel_layout;
 };
 
 ClutterStageManager * clutter_context_get_stage_manager (ClutterContext *context);
 
 gboolean clutter_context_get_show_fps (ClutterContext *context);
 
+gboolean clutter_context_get_parallel_layout (ClutterContext *context);
+
 #ifdef HAVE_FONTS
 PangoRenderer * clutter_context_get_font_renderer (ClutterContext *context);
 
@@ -38,6 +38,7 @@
 #endif
 
 static gboolean clutter_show_fps = FALSE;
+static gboolean clutter_parallel_layout = FALSE;
 static gboolean clutter_enable_accessibility = TRUE;
 
 #ifdef CLUTTER_ENABLE_DEBUG
@@ -82,6 +83,9 @@ static const GDebugKey clutter_paint_debug_keys[] = {
   { "disable-dynamic-max-render-time", CLUTTER_DEBUG_DISABLE_DYNAMIC_MAX_RENDER_TIME },
   { "max-render-time", CLUTTER_DEBUG_PAINT_MAX_RENDER_TIME },
   { "disable-triple-buffering", CLUTTER_DEBUG_DISABLE_TRIPLE_BUFFERING },
+  { "disable-threaded-glyphs", CLUTTER_DEBUG_DISABLE_THREADED_GLYPHS },
+  { "disable-batched-transitions", CLUTTER_DEBUG_DISABLE_BATCHED_TRANSITIONS },
+  { "disable-blur-cache", CLUTTER_DEBUG_DISABLE_BLUR_CACHE },
 };
 
 typedef struct _ClutterContextPrivate
@@ -261,6 +265,10 @@ init_clutter_debug (ClutterContext *context)
   if (env_string)
     clutter_show_fps = TRUE;
 
+  env_string = g_getenv ("CLUTTER_PARALLEL_LAYOUT");
+  if (env_string)
+    clutter_parallel_layout = TRUE;
+
   env_string = g_getenv ("CLUTTER_DISABLE_ACCESSIBILITY");
   if (env_string)
     clutter_enable_accessibility = FALSE;
@@ -279,6 +287,7 @@ clutter_context_new (ClutterBackendConstructor   backend_constructor,
 
   init_clutter_debug (context);
   context->show_fps = clutter_show_fps;
+  context->parallel_layout = clutter_parallel_layout;
 
   context->backend = backend_constructor (context, user_data);
   context->settings = g_object_new (CLUTTER_TYPE_SETTINGS, NULL);
@@ -404,6 +413,12 @@ clutter_context_get_show_fps (ClutterContext *context)
   return context->show_fps;
 }
 
+gboolean
+clutter_context_get_parallel_layout (ClutterContext *context)
+{
+  return context->parallel_layout;
+}
+
 ClutterSettings *
 clutter_context_get_settings (ClutterContext *context)
 {
@@ -467,6 +467,54 @@ clutter_ease_cubic_bezier (double t,
   return y_for_t (t_for_x (p, x_1, x_2), y_1, y_2);
 }
 
+/*< private >
+ * clutter_ease_get_cubic_bezier_for_mode:
+ * @mode: an animation mode
+ * @x_1: (out): return location for the X coordinate of the first control point
+ * @y_1: (out): return location for the Y coordinate of the first control point
+ * @x_2: (out): return location for the X coordinate of the second control point
+ * @y_2: (out): return location for the Y coordinate of the second control point
+ *
+ * Retrieves the control points of the cubic Bézier curve that the
+ * CSS-like %CLUTTER_EASE, %CLUTTER_EASE_IN, %CLUTTER_EASE_OUT and
+ * %CLUTTER_EASE_IN_OUT modes are defined with.
+ *
+ * Return value: %TRUE if @mode is one of the modes above
+ */
+gboolean
+clutter_ease_get_cubic_bezier_for_mode (ClutterAnimationMode  mode,
+                                        double               *x_1,
+                                        double               *y_1,
+                                        double               *x_2,
+                                        double               *y_2)
+{
+  static const struct {
+    ClutterAnimationMode mode;
+    double x_1, y_1, x_2, y_2;
+  } css_curves[] = {
+    { CLUTTER_EASE,        0.25, 0.1, 0.25, 1.0 },
+    { CLUTTER_EASE_IN,     0.42, 0.0, 1.0,  1.0 },
+    { CLUTTER_EASE_OUT,    0.0,  0.0, 0.58, 1.0 },
+    { CLUTTER_EASE_IN_OUT, 0.42, 0.0, 0.58, 1.0 },
+  };
+  int i;
+
+  for (i = 0; i < G_N_ELEMENTS (css_curves); i++)
+    {
+      if (css_curves[i].mode != mode)
+        continue;
+
+      *x_1 = css_curves[i].x_1;
+      *y_1 = css_curves[i].y_1;
+      *x_2 = css_curves[i].x_2;
+      *y_2 = css_curves[i].y_2;
+
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
 /*< private >
  * _clutter_animation_modes:
  *
@@ -553,3 +601,163 @@ clutter_easing_for_mode (ClutterAnimationMode mode,
 
   return _clutter_animation_modes[mode].func (t, d);
 }
+
+/*< private >
+ * clutter_easing_for_mode_batch:
+ * @mode: an animation mode, other than %CLUTTER_CUSTOM_MODE, %CLUTTER_STEPS
+ *   and %CLUTTER_CUBIC_BEZIER, which need parameters
+ * @t: (array length=n): the elapsed times
+ * @d: (array length=n): the total durations
+ * @progress: (array length=n) (out caller-allocates): return location
+ *   for the progress values
+ * @n: the number of values
+ *
+ * Evaluates the easing function for @mode on @n pairs of elapsed time
+ * and duration, with the same results a #ClutterTimeline using @mode
+ * would compute for each of them.
+ *
+ * Unlike calling clutter_easing_for_mode() in a loop, the mode is only
+ * dispatched once, which lets the easing function be inlined into, and
+ * vectorized together with, the loop over the values.
+ */
+void
+clutter_easing_for_mode_batch (ClutterAnimationMode  mode,
+                               const double         *t,
+                               const double         *d,
+                               double               *progress,
+                               unsigned int          n)
+{
+  double x_1, y_1, x_2, y_2;
+  unsigned int i;
+
+#define EASE_BATCH(func) \
+  G_STMT_START { \
+    for (i = 0; i < n; i++) \
+      progress[i] = func (t[i], d[i]); \
+  } G_STMT_END
+
+  switch (mode)
+    {
+    case CLUTTER_LINEAR:
+      EASE_BATCH (clutter_linear);
+      break;
+    case CLUTTER_EASE_IN_QUAD:
+      EASE_BATCH (clutter_ease_in_quad);
+      break;
+    case CLUTTER_EASE_OUT_QUAD:
+      EASE_BATCH (clutter_ease_out_quad);
+      break;
+    case CLUTTER_EASE_IN_OUT_QUAD:
+      EASE_BATCH (clutter_ease_in_out_quad);
+      break;
+    case CLUTTER_EASE_IN_CUBIC:
+      EASE_BATCH (clutter_ease_in_cubic);
+      break;
+    case CLUTTER_EASE_OUT_CUBIC:
+      EASE_BATCH (clutter_ease_out_cubic);
+      break;
+    case CLUTTER_EASE_IN_OUT_CUBIC:
+      EASE_BATCH (clutter_ease_in_out_cubic);
+      break;
+    case CLUTTER_EASE_IN_QUART:
+      EASE_BATCH (clutter_ease_in_quart);
+      break;
+    case CLUTTER_EASE_OUT_QUART:
+      EASE_BATCH (clutter_ease_out_quart);
+      break;
+    case CLUTTER_EASE_IN_OUT_QUART:
+      EASE_BATCH (clutter_ease_in_out_quart);
+      break;
+    case CLUTTER_EASE_IN_QUINT:
+      EASE_BATCH (clutter_ease_in_quint);
+      break;
+    case CLUTTER_EASE_OUT_QUINT:
+      EASE_BATCH (clutter_ease_out_quint);
+      break;
+    case CLUTTER_EASE_IN_OUT_QUINT:
+      EASE_BATCH (clutter_ease_in_out_quint);
+      break;
+    case CLUTTER_EASE_IN_SINE:
+      EASE_BATCH (clutter_ease_in_sine);
+      break;
+    case CLUTTER_EASE_OUT_SINE:
+      EASE_BATCH (clutter_ease_out_sine);
+      break;
+    case CLUTTER_EASE_IN_OUT_SINE:
+      EASE_BATCH (clutter_ease_in_out_sine);
+      break;
+    case CLUTTER_EASE_IN_EXPO:
+      EASE_BATCH (clutter_ease_in_expo);
+      break;
+    case CLUTTER_EASE_OUT_EXPO:
+      EASE_BATCH (clutter_ease_out_expo);
+      break;
+    case CLUTTER_EASE_IN_OUT_EXPO:
+      EASE_BATCH (clutter_ease_in_out_expo);
+      break;
+    case CLUTTER_EASE_IN_CIRC:
+      EASE_BATCH (clutter_ease_in_circ);
+      break;
+    case CLUTTER_EASE_OUT_CIRC:
+      EASE_BATCH (clutter_ease_out_circ);
+      break;
+    case CLUTTER_EASE_IN_OUT_CIRC:
+      EASE_BATCH (clutter_ease_in_out_circ);
+      break;
+    case CLUTTER_EASE_IN_ELASTIC:
+      EASE_BATCH (clutter_ease_in_elastic);
+      break;
+    case CLUTTER_EASE_OUT_ELASTIC:
+      EASE_BATCH (clutter_ease_out_elastic);
+      break;
+    case CLUTTER_EASE_IN_OUT_ELASTIC:
+      EASE_BATCH (clutter_ease_in_out_elastic);
+      break;
+    case CLUTTER_EASE_IN_BACK:
+      EASE_BATCH (clutter_ease_in_back);
+      break;
+    case CLUTTER_EASE_OUT_BACK:
+      EASE_BATCH (clutter_ease_out_back);
+      break;
+    case CLUTTER_EASE_IN_OUT_BACK:
+      EASE_BATCH (clutter_ease_in_out_back);
+      break;
+    case CLUTTER_EASE_IN_BOUNCE:
+      EASE_BATCH (clutter_ease_in_bounce);
+      break;
+    case CLUTTER_EASE_OUT_BOUNCE:
+      EASE_BATCH (clutter_ease_out_bounce);
+      break;
+    case CLUTTER_EASE_IN_OUT_BOUNCE:
+      EASE_BATCH (clutter_ease_in_out_bounce);
+      break;
+
+    case CLUTTER_STEP_START:
+      for (i = 0; i < n; i++)
+        progress[i] = clutter_ease_steps_start (t[i], d[i], 1);
+      break;
+
+    case CLUTTER_STEP_END:
+      for (i = 0; i < n; i++)
+        progress[i] = clutter_ease_steps_end (t[i], d[i], 1);
+      break;
+
+    case CLUTTER_EASE:
+    case CLUTTER_EASE_IN:
+    case CLUTTER_EASE_OUT:
+    case CLUTTER_EASE_IN_OUT:
+      clutter_ease_get_cubic_bezier_for_mode (mode, &x_1, &y_1, &x_2, &y_2);
+
+      for (i = 0; i < n; i++)
+        {
+          progress[i] = clutter_ease_cubic_bezier (t[i], d[i],
+                                                   x_1, y_1, x_2, y_2);
+        }
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+
+#undef EASE_BATCH
+}
@@ -26,6 +26,13 @@ double                  clutter_easing_for_mode                 (ClutterAnimatio
                                                                  double               t,
                                                                  double               d);
 
+G_GNUC_INTERNAL
+void                    clutter_easing_for_mode_batch           (ClutterAnimationMode  mode,
+                                                                 const double         *t,
+                                                                 const double         *d,
+                                                                 double               *progress,
+                                                                 unsigned int          n);
+
 G_GNUC_INTERNAL
 double  clutter_linear                  (double t,
                                          double d);
@@ -136,4 +143,11 @@ double  clutter_ease_cubic_bezier       (double t,
                                          double x_2,
                                          double y_2);
 
+G_GNUC_INTERNAL
+gboolean clutter_ease_get_cubic_bezier_for_mode (ClutterAnimationMode  mode,
+                                                 double               *x_1,
+                                                 double               *y_1,
+                                                 double               *x_2,
+                                                 double               *y_2);
+
 G_END_DECLS
@@ -1153,4 +1153,21 @@ typedef enum /*< prefix=CLUTTER_GESTURE_STATE >*/
   CLUTTER_N_GESTURE_STATES
 } ClutterGestureState;
 
+/**
+ * ClutterBlurMode:
+ * @CLUTTER_BLUR_MODE_GAUSSIAN: A separable gaussian blur, applied to a
+ *   downscaled copy of the contents at large radii
+ * @CLUTTER_BLUR_MODE_DUAL_FILTER: A dual filter ("dual Kawase") blur, made
+ *   of a chain of downsampling and upsampling passes. Much cheaper than
+ *   %CLUTTER_BLUR_MODE_GAUSSIAN at large radii, but only approximates a
+ *   gaussian
+ *
+ * The algorithm used to blur contents.
+ */
+typedef enum
+{
+  CLUTTER_BLUR_MODE_GAUSSIAN,
+  CLUTTER_BLUR_MODE_DUAL_FILTER,
+} ClutterBlurMode;
+
 G_END_DECLS
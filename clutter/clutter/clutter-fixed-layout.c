@@ -37,6 +37,7 @@
 
 #include "clutter/clutter-debug.h"
 #include "clutter/clutter-fixed-layout.h"
+#include "clutter/clutter-layout-manager-private.h"
 #include "clutter/clutter-private.h"
 
 G_DEFINE_TYPE (ClutterFixedLayout,
@@ -163,6 +164,8 @@ clutter_fixed_layout_class_init (ClutterFixedLayoutClass *klass)
   manager_class->get_preferred_height =
     clutter_fixed_layout_get_preferred_height;
   manager_class->allocate = clutter_fixed_layout_allocate;
+
+  clutter_layout_manager_class_set_thread_safe_size_requests (manager_class);
 }
 
 static void
@@ -31,6 +31,7 @@
 #include "clutter/clutter-main.h"
 #include "clutter/clutter-private.h"
 #include "clutter/clutter-timeline-private.h"
+#include "clutter/clutter-transition-batch.h"
 #include "cogl/cogl-trace.h"
 
 enum
@@ -154,6 +155,7 @@ struct _ClutterFrameClock
   int inhibit_count;
 
   GList *timelines;
+  ClutterTransitionBatch *transition_batch;
 
   int n_missed_frames;
   int64_t missed_frame_report_time_us;
@@ -344,6 +346,33 @@ advance_timelines (ClutterFrameClock *frame_clock,
   timelines = g_list_copy (frame_clock->timelines);
   g_list_foreach (timelines, (GFunc) g_object_ref, NULL);
 
+  /* Property transitions in the middle of an animation are advanced all
+   * at once, before any other timeline. This is only done for ticks
+   * that don't emit any signal, so nothing changes beyond the order
+   * timelines are advanced in, which is arbitrary anyway.
+   */
+  if (!(clutter_paint_debug_flags & CLUTTER_DEBUG_DISABLE_BATCHED_TRANSITIONS))
+    {
+      l = timelines;
+      while (l)
+        {
+          GList *next = l->next;
+          ClutterTimeline *timeline = l->data;
+
+          if (clutter_transition_batch_add (frame_clock->transition_batch,
+                                            timeline,
+                                            time_us / 1000))
+            {
+              timelines = g_list_delete_link (timelines, l);
+              g_object_unref (timeline);
+            }
+
+          l = next;
+        }
+
+      clutter_transition_batch_run (frame_clock->transition_batch);
+    }
+
   for (l = timelines; l; l = l->next)
     {
       ClutterTimeline *timeline = l->data;
@@ -1837,6 +1866,7 @@ clutter_frame_clock_new (float                            refresh_rate,
   frame_clock->output_name = g_strdup (output_name);
 
   frame_clock->deferred_times = g_queue_new ();
+  frame_clock->transition_batch = clutter_transition_batch_new ();
 
   return frame_clock;
 }
@@ -1883,6 +1913,9 @@ clutter_frame_clock_dispose (GObject *object)
     g_queue_free_full (g_steal_pointer (&frame_clock->deferred_times), g_free);
   frame_clock->deferred_times = NULL;
 
+  g_clear_pointer (&frame_clock->transition_batch,
+                   clutter_transition_batch_free);
+
   g_clear_object (&frame_clock->driver);
 
   G_OBJECT_CLASS (clutter_frame_clock_parent_class)->dispose (object);
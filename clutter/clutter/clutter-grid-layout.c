@@ -36,6 +36,7 @@
 #include "clutter/clutter-actor-private.h"
 #include "clutter/clutter-debug.h"
 #include "clutter/clutter-enum-types.h"
+#include "clutter/clutter-layout-manager-private.h"
 #include "clutter/clutter-layout-meta.h"
 #include "clutter/clutter-private.h"
 
@@ -1539,6 +1540,8 @@ clutter_grid_layout_class_init (ClutterGridLayoutClass *klass)
   layout_class->allocate = clutter_grid_layout_allocate;
   layout_class->get_child_meta_type = clutter_grid_layout_get_child_meta_type;
 
+  clutter_layout_manager_class_set_thread_safe_size_requests (layout_class);
+
   /**
    * ClutterGridLayout:orientation:
    *
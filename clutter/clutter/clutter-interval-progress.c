@@ -164,3 +164,33 @@ clutter_interval_register_progress_funcs (void)
   clutter_interval_register_progress_func (COGL_TYPE_COLOR,
                                            cogl_color_progress);
 }
+
+/*
+ * clutter_interval_has_default_progress_func:
+ * @value_type: a #GType
+ *
+ * Checks whether intervals of @value_type are still interpolated the
+ * way Clutter does it out of the box, i.e. that no progress function
+ * was registered for @value_type, or the one registered is the default
+ * one of Clutter.
+ */
+gboolean
+clutter_interval_has_default_progress_func (GType value_type)
+{
+  ClutterProgressFunc func = _clutter_get_progress_function (value_type);
+
+  if (value_type == GRAPHENE_TYPE_MATRIX)
+    return func == graphene_matrix_progress;
+  else if (value_type == GRAPHENE_TYPE_POINT)
+    return func == graphene_point_progress;
+  else if (value_type == GRAPHENE_TYPE_POINT3D)
+    return func == graphene_point3d_progress;
+  else if (value_type == GRAPHENE_TYPE_RECT)
+    return func == graphene_rect_progress;
+  else if (value_type == GRAPHENE_TYPE_SIZE)
+    return func == graphene_size_progress;
+  else if (value_type == COGL_TYPE_COLOR)
+    return func == cogl_color_progress;
+  else
+    return func == NULL;
+}
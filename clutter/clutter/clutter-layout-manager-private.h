@@ -0,0 +1,35 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026 Red Hat Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "clutter/clutter-layout-manager.h"
+
+G_BEGIN_DECLS
+
+void clutter_layout_manager_class_set_thread_safe_size_requests (ClutterLayoutManagerClass *klass);
+
+gboolean clutter_layout_manager_has_thread_safe_size_requests (ClutterLayoutManager *manager);
+
+void clutter_layout_manager_ensure_child_metas (ClutterLayoutManager *manager,
+                                                ClutterActor         *container);
+
+G_END_DECLS
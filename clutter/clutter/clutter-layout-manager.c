@@ -94,7 +94,7 @@
 #include <gobject/gvaluecollector.h>
 
 #include "clutter/clutter-debug.h"
-#include "clutter/clutter-layout-manager.h"
+#include "clutter/clutter-layout-manager-private.h"
 #include "clutter/clutter-layout-meta.h"
 #include "clutter/clutter-marshal.h"
 #include "clutter/clutter-private.h"
@@ -119,6 +119,7 @@ G_DEFINE_ABSTRACT_TYPE (ClutterLayoutManager,
                         G_TYPE_INITIALLY_UNOWNED)
 
 static GQuark quark_layout_meta  = 0;
+static GQuark quark_thread_safe_size_requests = 0;
 
 static guint manager_signals[LAST_SIGNAL] = { 0, };
 
@@ -259,6 +260,8 @@ clutter_layout_manager_class_init (ClutterLayoutManagerClass *klass)
 {
   quark_layout_meta =
     g_quark_from_static_string ("clutter-layout-manager-child-meta");
+  quark_thread_safe_size_requests =
+    g_quark_from_static_string ("clutter-layout-manager-thread-safe-size-requests");
 
   klass->get_preferred_width = layout_manager_real_get_preferred_width;
   klass->get_preferred_height = layout_manager_real_get_preferred_height;
@@ -533,6 +536,58 @@ clutter_layout_manager_get_child_meta (ClutterLayoutManager *manager,
   return get_child_meta (manager, container, actor);
 }
 
+/*< private >
+ * clutter_layout_manager_class_set_thread_safe_size_requests:
+ * @klass: a #ClutterLayoutManagerClass
+ *
+ * Declares that the size requests of layout managers of exactly this
+ * type only look at the container, its children and their layout metas,
+ * so that the preferred size of containers using it can be computed off
+ * the main thread.
+ *
+ * This is not inherited: sub-classes may override the size request
+ * virtual functions and have to opt in on their own.
+ */
+void
+clutter_layout_manager_class_set_thread_safe_size_requests (ClutterLayoutManagerClass *klass)
+{
+  g_type_set_qdata (G_TYPE_FROM_CLASS (klass),
+                    quark_thread_safe_size_requests,
+                    GINT_TO_POINTER (TRUE));
+}
+
+gboolean
+clutter_layout_manager_has_thread_safe_size_requests (ClutterLayoutManager *manager)
+{
+  return g_type_get_qdata (G_OBJECT_TYPE (manager),
+                           quark_thread_safe_size_requests) != NULL;
+}
+
+/*< private >
+ * clutter_layout_manager_ensure_child_metas:
+ * @manager: a #ClutterLayoutManager
+ * @container: the [type@Clutter.Actor] using @manager
+ *
+ * Creates the layout metas of all the children of @container that don't
+ * have one yet, so that size requests running off the main thread only
+ * ever have to look them up.
+ */
+void
+clutter_layout_manager_ensure_child_metas (ClutterLayoutManager *manager,
+                                           ClutterActor         *container)
+{
+  ClutterLayoutManagerClass *klass = CLUTTER_LAYOUT_MANAGER_GET_CLASS (manager);
+  ClutterActor *child;
+
+  if (klass->get_child_meta_type (manager) == G_TYPE_INVALID)
+    return;
+
+  for (child = clutter_actor_get_first_child (container);
+       child != NULL;
+       child = clutter_actor_get_next_sibling (child))
+    get_child_meta (manager, container, child);
+}
+
 static inline gboolean
 layout_set_property_internal (ClutterLayoutManager *manager,
                               GObject              *gobject,
@@ -78,6 +78,9 @@ typedef enum
   CLUTTER_DEBUG_DISABLE_DYNAMIC_MAX_RENDER_TIME = 1 << 9,
   CLUTTER_DEBUG_PAINT_MAX_RENDER_TIME           = 1 << 10,
   CLUTTER_DEBUG_DISABLE_TRIPLE_BUFFERING        = 1 << 11,
+  CLUTTER_DEBUG_DISABLE_THREADED_GLYPHS         = 1 << 12,
+  CLUTTER_DEBUG_DISABLE_BATCHED_TRANSITIONS     = 1 << 13,
+  CLUTTER_DEBUG_DISABLE_BLUR_CACHE              = 1 << 14,
 } ClutterDrawDebugFlag;
 
 /**
@@ -129,6 +129,19 @@ G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (ClutterOffscreenEffect,
                                      clutter_offscreen_effect,
                                      CLUTTER_TYPE_EFFECT)
 
+static void
+release_offscreen (ClutterOffscreenEffect *self)
+{
+  ClutterOffscreenEffectPrivate *priv =
+    clutter_offscreen_effect_get_instance_private (self);
+
+  /* The texture of a pooled offscreen may be handed out to someone else
+   * once the offscreen is released, so nothing may keep using it */
+  g_clear_object (&priv->pipeline);
+  g_clear_object (&priv->texture);
+  g_clear_pointer (&priv->offscreen, cogl_offscreen_release);
+}
+
 static void
 clutter_offscreen_effect_set_actor (ClutterActorMeta *meta,
                                     ClutterActor     *actor)
@@ -142,7 +155,7 @@ clutter_offscreen_effect_set_actor (ClutterActorMeta *meta,
   meta_class->set_actor (meta, actor);
 
   /* clear out the previous state */
-  g_clear_object (&priv->offscreen);
+  release_offscreen (self);
 
   /* we keep a back pointer here, to avoid going through the ActorMeta */
   priv->actor = clutter_actor_meta_get_actor (meta);
@@ -266,39 +279,53 @@ update_fbo (ClutterEffect *effect,
       return TRUE;
     }
 
-  g_clear_object (&priv->texture);
-  g_clear_object (&priv->offscreen);
+  release_offscreen (self);
 
   context = clutter_actor_get_context (priv->actor);
   backend = clutter_context_get_backend (context);
   cogl_context = clutter_backend_get_cogl_context (backend);
-  priv->texture =
-    clutter_offscreen_effect_create_texture (self, cogl_context,
-                                             target_width, target_height);
-  if (priv->texture == NULL)
-    return FALSE;
 
-  priv->target_width = target_width;
-  priv->target_height = target_height;
+  /* Plain textures can be recycled from the pool, which saves allocating
+   * new ones on every frame while the actor is being resized */
+  if (offscreen_class->create_texture ==
+      clutter_offscreen_effect_real_create_texture)
+    {
+      offscreen = cogl_offscreen_new_pooled (cogl_context,
+                                             COGL_PIXEL_FORMAT_ANY,
+                                             MAX (target_width, 1),
+                                             MAX (target_height, 1),
+                                             &error);
+      if (offscreen)
+        priv->texture = g_object_ref (cogl_offscreen_get_texture (offscreen));
+    }
+  else
+    {
+      priv->texture =
+        clutter_offscreen_effect_create_texture (self, cogl_context,
+                                                 target_width, target_height);
+      if (priv->texture == NULL)
+        return FALSE;
+
+      offscreen = cogl_offscreen_new_with_texture (priv->texture);
+      if (!cogl_framebuffer_allocate (COGL_FRAMEBUFFER (offscreen), &error))
+        g_clear_object (&offscreen);
+    }
 
-  offscreen = cogl_offscreen_new_with_texture (priv->texture);
-  if (!cogl_framebuffer_allocate (COGL_FRAMEBUFFER (offscreen), &error))
+  if (!offscreen)
     {
       g_warning ("Failed to create offscreen effect framebuffer: %s",
                  error->message);
 
-      g_object_unref (offscreen);
-      g_clear_object (&priv->pipeline);
-
       priv->target_width = 0;
       priv->target_height = 0;
 
       return FALSE;
     }
 
+  priv->target_width = target_width;
+  priv->target_height = target_height;
   priv->offscreen = offscreen;
 
-  g_clear_object (&priv->pipeline);
   priv->pipeline = offscreen_class->create_pipeline (self, priv->texture);
 
   return TRUE;
@@ -417,7 +444,7 @@ clutter_offscreen_effect_pre_paint (ClutterEffect       *effect,
   return TRUE;
 
 disable_effect:
-  g_clear_object (&priv->offscreen);
+  release_offscreen (self);
   return FALSE;
 }
 
@@ -562,7 +589,7 @@ clutter_offscreen_effect_paint (ClutterEffect           *effect,
   if (flags & CLUTTER_EFFECT_PAINT_BYPASS_EFFECT)
     {
       add_actor_node (self, node, -1);
-      g_clear_object (&priv->offscreen);
+      release_offscreen (self);
       return;
     }
 
@@ -585,7 +612,7 @@ clutter_offscreen_effect_set_enabled (ClutterActorMeta *meta,
   ClutterOffscreenEffectPrivate *priv =
     clutter_offscreen_effect_get_instance_private (offscreen_effect);
 
-  g_clear_object (&priv->offscreen);
+  release_offscreen (offscreen_effect);
 
   parent_class->set_enabled (meta, is_enabled);
 }
@@ -597,9 +624,7 @@ clutter_offscreen_effect_finalize (GObject *gobject)
   ClutterOffscreenEffectPrivate *priv =
     clutter_offscreen_effect_get_instance_private (self);
 
-  g_clear_object (&priv->offscreen);
-  g_clear_object (&priv->texture);
-  g_clear_object (&priv->pipeline);
+  release_offscreen (self);
 
   G_OBJECT_CLASS (clutter_offscreen_effect_parent_class)->finalize (gobject);
 }
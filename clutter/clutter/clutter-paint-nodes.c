@@ -1390,9 +1390,19 @@ static void
 clutter_blur_node_finalize (ClutterPaintNode *node)
 {
   ClutterBlurNode *blur_node = CLUTTER_BLUR_NODE (node);
+  ClutterLayerNode *layer_node = CLUTTER_LAYER_NODE (node);
 
   g_clear_pointer (&blur_node->blur, clutter_blur_free);
 
+  /* Blur nodes are usually created again for the next frame at the same
+   * size, so give the offscreen back for it to be reused */
+  if (layer_node->offscreen)
+    {
+      CoglFramebuffer *offscreen = g_steal_pointer (&layer_node->offscreen);
+
+      cogl_offscreen_release (COGL_OFFSCREEN (offscreen));
+    }
+
   CLUTTER_PAINT_NODE_CLASS (clutter_blur_node_parent_class)->finalize (node);
 }
 
@@ -1417,7 +1427,7 @@ clutter_blur_node_init (ClutterBlurNode *blur_node)
  * @height: height of the blur layer
  * @radius: radius (in pixels) of the blur
  *
- * Creates a new #ClutterBlurNode.
+ * Creates a new #ClutterBlurNode, using %CLUTTER_BLUR_MODE_GAUSSIAN.
  *
  * Children of this node will be painted inside a separate framebuffer,
  * which will be blurred and painted on the current draw framebuffer.
@@ -1430,8 +1440,33 @@ clutter_blur_node_new (unsigned int width,
                        unsigned int height,
                        float        radius)
 {
-  g_autoptr (CoglOffscreen) offscreen = NULL;
-  g_autoptr (CoglTexture) texture = NULL;
+  return clutter_blur_node_new_with_mode (width, height, radius,
+                                          CLUTTER_BLUR_MODE_GAUSSIAN);
+}
+
+/**
+ * clutter_blur_node_new_with_mode:
+ * @width width of the blur layer
+ * @height: height of the blur layer
+ * @radius: radius (in pixels) of the blur
+ * @mode: the blur algorithm to use
+ *
+ * Creates a new #ClutterBlurNode, blurring with @mode. The radius looks
+ * about the same with every mode.
+ *
+ * Children of this node will be painted inside a separate framebuffer,
+ * which will be blurred and painted on the current draw framebuffer.
+ *
+ * Return value: (transfer full): the newly created #ClutterBlurNode.
+ *   Use clutter_paint_node_unref() when done.
+ */
+ClutterPaintNode *
+clutter_blur_node_new_with_mode (unsigned int    width,
+                                 unsigned int    height,
+                                 float           radius,
+                                 ClutterBlurMode mode)
+{
+  CoglOffscreen *offscreen;
   g_autoptr (GError) error = NULL;
   ClutterLayerNode *layer_node;
   ClutterBlurNode *blur_node;
@@ -1446,29 +1481,31 @@ clutter_blur_node_new (unsigned int width,
   backend = clutter_context_get_backend (context);
   cogl_context = clutter_backend_get_cogl_context (backend);
   blur_node = _clutter_paint_node_create (CLUTTER_TYPE_BLUR_NODE);
-  texture = cogl_texture_2d_new_with_size (cogl_context, width, height);
-
-  cogl_texture_set_premultiplied (texture, TRUE);
+  layer_node = CLUTTER_LAYER_NODE (blur_node);
 
-  offscreen = cogl_offscreen_new_with_texture (texture);
-  if (!cogl_framebuffer_allocate (COGL_FRAMEBUFFER (offscreen), &error))
+  offscreen = cogl_offscreen_new_pooled (cogl_context,
+                                         COGL_PIXEL_FORMAT_ANY,
+                                         width, height,
+                                         &error);
+  if (!offscreen)
     {
       g_warning ("Unable to allocate paint node offscreen: %s",
                  error->message);
       goto out;
     }
 
-  blur = clutter_blur_new (texture, radius);
+  blur = clutter_blur_new_with_mode (cogl_offscreen_get_texture (offscreen),
+                                     radius, mode);
   blur_node->blur = blur;
 
   if (!blur)
     {
       g_warning ("Failed to create blur pipeline");
+      cogl_offscreen_release (offscreen);
       goto out;
     }
 
-  layer_node = CLUTTER_LAYER_NODE (blur_node);
-  layer_node->offscreen = COGL_FRAMEBUFFER (g_steal_pointer (&offscreen));
+  layer_node->offscreen = COGL_FRAMEBUFFER (offscreen);
   layer_node->pipeline = cogl_pipeline_copy (default_texture_pipeline);
   cogl_pipeline_set_layer_filters (layer_node->pipeline, 0,
                                    COGL_PIPELINE_FILTER_LINEAR,
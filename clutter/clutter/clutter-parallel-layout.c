@@ -0,0 +1,325 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026 Red Hat Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Computes the preferred sizes of independent actor subtrees on worker
+ * threads before a relayout, so that the allocation pass that follows on
+ * the main thread mostly hits the size request caches.
+ *
+ * A subtree is only handed out if the size request of every actor in it
+ * is thread-safe, see clutter_actor_has_thread_safe_size_request(): this
+ * rules out anything that could run code outside of Clutter, like
+ * overridden vfuncs, constraints, or layout managers that haven't opted
+ * in. Every subtree is owned by exactly one thread while the main thread
+ * is blocked waiting for all of them, so the only state written, the
+ * size request caches of the actors, is never shared.
+ *
+ * Each subtree gets the same queries clutter_actor_get_preferred_size()
+ * does, which is what the allocation of most children starts with.
+ */
+
+#include "config.h"
+
+#include "clutter/clutter-parallel-layout.h"
+
+#include "clutter/clutter-actor-private.h"
+#include "clutter/clutter-debug.h"
+#include "clutter/clutter-layout-manager-private.h"
+#include "clutter/clutter-private.h"
+#include "cogl/cogl-trace.h"
+
+#define MAX_LAYOUT_WORKERS 8
+
+/* Below this, the relayout is not worth waking up other threads for */
+#define MIN_ACTORS_FOR_PARALLEL_LAYOUT 256
+
+/* Smallest subtree handed out on its own */
+#define MIN_ACTORS_PER_TASK 16
+
+typedef struct _LayoutNode
+{
+  ClutterActor *actor;
+
+  /* Nodes are stored depth first; this is the number of nodes of the
+   * subtree rooted here, including itself */
+  unsigned int n_nodes;
+
+  gboolean thread_safe;
+} LayoutNode;
+
+struct _ClutterParallelLayout
+{
+  GThreadPool *pool;
+  int n_workers;
+
+  GArray *nodes;
+  GPtrArray *tasks;
+
+  int next_task;
+
+  GMutex mutex;
+  GCond cond;
+  int n_pending_workers;
+};
+
+static void
+run_tasks (ClutterParallelLayout *layout)
+{
+  int task_index;
+
+  while ((task_index = g_atomic_int_add (&layout->next_task, 1)) <
+         (int) layout->tasks->len)
+    {
+      ClutterActor *actor = g_ptr_array_index (layout->tasks, task_index);
+
+      clutter_actor_get_preferred_size (actor, NULL, NULL, NULL, NULL);
+    }
+}
+
+static void
+layout_worker_func (gpointer data,
+                    gpointer user_data)
+{
+  ClutterParallelLayout *layout = data;
+
+  run_tasks (layout);
+
+  g_mutex_lock (&layout->mutex);
+  layout->n_pending_workers--;
+  g_cond_signal (&layout->cond);
+  g_mutex_unlock (&layout->mutex);
+}
+
+ClutterParallelLayout *
+clutter_parallel_layout_new (void)
+{
+  ClutterParallelLayout *layout;
+
+  layout = g_new0 (ClutterParallelLayout, 1);
+  layout->n_workers = CLAMP (g_get_num_processors () - 1,
+                             0, MAX_LAYOUT_WORKERS);
+  layout->nodes = g_array_new (FALSE, FALSE, sizeof (LayoutNode));
+  layout->tasks = g_ptr_array_new ();
+
+  g_mutex_init (&layout->mutex);
+  g_cond_init (&layout->cond);
+
+  return layout;
+}
+
+void
+clutter_parallel_layout_free (ClutterParallelLayout *layout)
+{
+  if (layout->pool)
+    g_thread_pool_free (layout->pool, FALSE, TRUE);
+
+  g_array_free (layout->nodes, TRUE);
+  g_ptr_array_free (layout->tasks, TRUE);
+
+  g_cond_clear (&layout->cond);
+  g_mutex_clear (&layout->mutex);
+
+  g_free (layout);
+}
+
+/* Clean actors answer size requests from their cache, but may still have
+ * to recompute them for a size they haven't been asked for before */
+static gboolean
+subtree_is_thread_safe (ClutterActor *actor)
+{
+  ClutterLayoutManager *manager;
+  ClutterActor *child;
+
+  if (!clutter_actor_has_thread_safe_size_request (actor))
+    return FALSE;
+
+  manager = clutter_actor_get_layout_manager (actor);
+  if (manager != NULL)
+    clutter_layout_manager_ensure_child_metas (manager, actor);
+
+  for (child = clutter_actor_get_first_child (actor);
+       child != NULL;
+       child = clutter_actor_get_next_sibling (child))
+    {
+      if (!subtree_is_thread_safe (child))
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+/* Adds a node for @actor and for every actor below it that needs a size
+ * request */
+static void
+collect_nodes (ClutterParallelLayout *layout,
+               ClutterActor          *actor)
+{
+  LayoutNode node = { .actor = actor };
+  ClutterLayoutManager *manager;
+  ClutterActor *child;
+  unsigned int index;
+  gboolean thread_safe;
+
+  index = layout->nodes->len;
+  g_array_append_val (layout->nodes, node);
+
+  thread_safe = clutter_actor_has_thread_safe_size_request (actor);
+
+  manager = clutter_actor_get_layout_manager (actor);
+  if (thread_safe && manager != NULL)
+    clutter_layout_manager_ensure_child_metas (manager, actor);
+
+  for (child = clutter_actor_get_first_child (actor);
+       child != NULL;
+       child = clutter_actor_get_next_sibling (child))
+    {
+      unsigned int child_index = layout->nodes->len;
+
+      if (!clutter_actor_needs_size_request (child))
+        {
+          thread_safe = thread_safe && subtree_is_thread_safe (child);
+          continue;
+        }
+
+      collect_nodes (layout, child);
+
+      thread_safe = thread_safe &&
+        g_array_index (layout->nodes, LayoutNode, child_index).thread_safe;
+    }
+
+  g_array_index (layout->nodes, LayoutNode, index).n_nodes =
+    layout->nodes->len - index;
+  g_array_index (layout->nodes, LayoutNode, index).thread_safe = thread_safe;
+}
+
+/* Hands out the largest thread-safe subtrees that aren't bigger than
+ * @max_task_size; whatever is left is done by the allocation pass */
+static void
+collect_tasks (ClutterParallelLayout *layout,
+               unsigned int           index,
+               unsigned int           max_task_size)
+{
+  LayoutNode *node = &g_array_index (layout->nodes, LayoutNode, index);
+  unsigned int end = index + node->n_nodes;
+  unsigned int child_index;
+
+  if (node->thread_safe && node->n_nodes <= max_task_size)
+    {
+      g_ptr_array_add (layout->tasks, node->actor);
+      return;
+    }
+
+  for (child_index = index + 1; child_index < end; )
+    {
+      LayoutNode *child_node =
+        &g_array_index (layout->nodes, LayoutNode, child_index);
+
+      collect_tasks (layout, child_index, max_task_size);
+      child_index += child_node->n_nodes;
+    }
+}
+
+static int
+clutter_parallel_layout_get_n_workers (ClutterParallelLayout *layout)
+{
+  g_autoptr (GError) error = NULL;
+
+  if (layout->n_workers == 0)
+    return 0;
+
+  if (!layout->pool)
+    {
+      layout->pool = g_thread_pool_new (layout_worker_func, NULL,
+                                        layout->n_workers,
+                                        FALSE,
+                                        &error);
+      if (!layout->pool)
+        {
+          g_warning ("Failed to create layout threads: %s", error->message);
+          layout->n_workers = 0;
+          return 0;
+        }
+    }
+
+  /* The calling thread takes part in the layout too */
+  return MIN (layout->n_workers, (int) layout->tasks->len - 1);
+}
+
+void
+clutter_parallel_layout_prefetch (ClutterParallelLayout *layout,
+                                  ClutterActor          *root)
+{
+  unsigned int n_actors;
+  unsigned int max_task_size;
+  int n_workers;
+  int i;
+
+  if (layout->n_workers == 0 || !clutter_actor_needs_size_request (root))
+    return;
+
+  COGL_TRACE_BEGIN_SCOPED (ParallelLayout,
+                           "Clutter::ParallelLayout::prefetch()");
+
+  collect_nodes (layout, root);
+
+  n_actors = layout->nodes->len;
+  if (n_actors < MIN_ACTORS_FOR_PARALLEL_LAYOUT)
+    goto out;
+
+  /* A few tasks per thread, so that uneven subtrees still balance out */
+  max_task_size = MAX (MIN_ACTORS_PER_TASK,
+                       n_actors / ((layout->n_workers + 1) * 4));
+  collect_tasks (layout, 0, max_task_size);
+
+  if (layout->tasks->len < 2)
+    goto out;
+
+  n_workers = clutter_parallel_layout_get_n_workers (layout);
+
+  CLUTTER_NOTE (LAYOUT,
+                "Computing size requests of %u subtrees (%u dirty actors) "
+                "using %d threads",
+                layout->tasks->len, n_actors, n_workers + 1);
+
+  layout->next_task = 0;
+  layout->n_pending_workers = n_workers;
+
+  for (i = 0; i < n_workers; i++)
+    {
+      if (!g_thread_pool_push (layout->pool, layout, NULL))
+        {
+          g_mutex_lock (&layout->mutex);
+          layout->n_pending_workers--;
+          g_mutex_unlock (&layout->mutex);
+        }
+    }
+
+  run_tasks (layout);
+
+  g_mutex_lock (&layout->mutex);
+  while (layout->n_pending_workers > 0)
+    g_cond_wait (&layout->cond, &layout->mutex);
+  g_mutex_unlock (&layout->mutex);
+
+out:
+  g_array_set_size (layout->nodes, 0);
+  g_ptr_array_set_size (layout->tasks, 0);
+}
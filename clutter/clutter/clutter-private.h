@@ -121,6 +121,12 @@ void  _clutter_util_fully_transform_vertices (const graphene_matrix_t  *modelvie
                                               graphene_point3d_t       *vertices_out,
                                               int                       n_vertices);
 
+void  _clutter_util_project_vertices (const graphene_matrix_t  *modelview_projection,
+                                      const float              *viewport,
+                                      const graphene_point3d_t *vertices_in,
+                                      graphene_point3d_t       *vertices_out,
+                                      int                       n_vertices);
+
 typedef enum _ClutterCullResult
 {
   CLUTTER_CULL_RESULT_UNKNOWN,
@@ -134,10 +140,12 @@ gboolean        _clutter_run_progress_function  (GType gtype,
                                                  const GValue *final,
                                                  gdouble progress,
                                                  GValue *retval);
+ClutterProgressFunc _clutter_get_progress_function (GType gtype);
 
 void            clutter_timeline_cancel_delay (ClutterTimeline *timeline);
 
 void clutter_interval_register_progress_funcs (void);
+gboolean clutter_interval_has_default_progress_func (GType value_type);
 
 static inline void
 clutter_round_to_256ths (float *f)
@@ -30,7 +30,7 @@
 
 #include "config.h"
 
-#include "clutter/clutter-property-transition.h"
+#include "clutter/clutter-property-transition-private.h"
 
 #include "clutter/clutter-animatable.h"
 #include "clutter/clutter-debug.h"
@@ -192,6 +192,41 @@ clutter_property_transition_compute_value (ClutterTransition *transition,
   g_value_unset (&value);
 }
 
+/*< private >
+ * clutter_property_transition_prepare_frame:
+ * @transition: a #ClutterPropertyTransition
+ *
+ * Makes sure the interval of @transition is ready for computing the
+ * value of the next frame, like the #ClutterTransitionClass.compute_value()
+ * implementation does.
+ *
+ * Return value: (transfer none) (nullable): the #GParamSpec of the
+ *   animated property, or %NULL if no value would be computed
+ */
+GParamSpec *
+clutter_property_transition_prepare_frame (ClutterPropertyTransition *transition)
+{
+  ClutterPropertyTransitionPrivate *priv =
+    clutter_property_transition_get_instance_private (transition);
+  ClutterTransition *base = CLUTTER_TRANSITION (transition);
+  ClutterAnimatable *animatable;
+  ClutterInterval *interval;
+
+  if (priv->pspec == NULL)
+    return NULL;
+
+  animatable = clutter_transition_get_animatable (base);
+  interval = clutter_transition_get_interval (base);
+  if (animatable == NULL || interval == NULL)
+    return NULL;
+
+  clutter_property_transition_ensure_interval (transition,
+                                               animatable,
+                                               interval);
+
+  return priv->pspec;
+}
+
 static void
 clutter_property_transition_set_property (GObject      *gobject,
                                           guint         prop_id,
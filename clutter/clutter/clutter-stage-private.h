@@ -76,6 +76,7 @@ ClutterStageWindow *_clutter_stage_get_window            (ClutterStage
 void                _clutter_stage_get_projection_matrix (ClutterStage          *stage,
                                                           graphene_matrix_t     *projection);
 void                _clutter_stage_dirty_projection      (ClutterStage          *stage);
+unsigned int        clutter_stage_get_projection_generation (ClutterStage       *stage);
 void                _clutter_stage_get_viewport          (ClutterStage          *stage,
                                                           float                 *x,
                                                           float                 *y,
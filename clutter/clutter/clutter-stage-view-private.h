@@ -23,7 +23,8 @@
 
 CLUTTER_EXPORT
 void clutter_stage_view_after_paint (ClutterStageView *view,
-                                     MtkRegion        *redraw_clip);
+                                     MtkRegion        *redraw_clip,
+                                     MtkRegion        *repair_clip);
 
 CLUTTER_EXPORT
 void clutter_stage_view_before_swap_buffer (ClutterStageView *view,
@@ -558,9 +558,22 @@ init_shadowfb (ClutterStageView *view)
   return;
 }
 
+/*
+ * clutter_stage_view_after_paint:
+ * @view: a #ClutterStageView
+ * @redraw_clip: the region of the stage that was painted this frame
+ * @repair_clip: the region of the stage the onscreen back buffer lacks,
+ *   i.e. @redraw_clip extended by the damage of the frames since the back
+ *   buffer was last used
+ *
+ * The offscreen and the shadow framebuffer retain their contents between
+ * frames, so only the freshly painted @redraw_clip needs to be copied into
+ * them, while whatever ends up in the onscreen must cover @repair_clip.
+ */
 void
 clutter_stage_view_after_paint (ClutterStageView *view,
-                                MtkRegion        *redraw_clip)
+                                MtkRegion        *redraw_clip,
+                                MtkRegion        *repair_clip)
 {
   ClutterStageViewPrivate *priv =
     clutter_stage_view_get_instance_private (view);
@@ -586,7 +599,7 @@ clutter_stage_view_after_paint (ClutterStageView *view,
                                          priv->offscreen_pipeline,
                                          priv->offscreen,
                                          priv->framebuffer,
-                                         redraw_clip);
+                                         repair_clip);
         }
     }
 }
@@ -64,6 +64,7 @@
 #include "clutter/clutter-mutter.h"
 #include "clutter/clutter-paint-context-private.h"
 #include "clutter/clutter-paint-volume-private.h"
+#include "clutter/clutter-parallel-layout.h"
 #include "clutter/clutter-pick-context-private.h"
 #include "clutter/clutter-private.h"
 #include "clutter/clutter-seat-private.h"
@@ -101,6 +102,10 @@ typedef struct _ClutterStagePrivate
   graphene_matrix_t view;
   float viewport[4];
 
+  /* bumped every time the projection changes, so that actors can tell
+   * whether their cached projected matrices are still up to date */
+  unsigned int projection_generation;
+
   ClutterGrab *topmost_grab;
   ClutterGrabState grab_state;
 
@@ -108,6 +113,9 @@ typedef struct _ClutterStagePrivate
 
   GSList *pending_relayouts;
 
+  /* only set if CLUTTER_PARALLEL_LAYOUT is */
+  ClutterParallelLayout *parallel_layout;
+
   int update_freeze_count;
 
   gboolean update_scheduled;
@@ -959,6 +967,9 @@ clutter_stage_maybe_relayout (ClutterActor *actor)
 
       CLUTTER_SET_PRIVATE_FLAGS (queued_actor, CLUTTER_IN_RELAYOUT);
 
+      if (priv->parallel_layout)
+        clutter_parallel_layout_prefetch (priv->parallel_layout, queued_actor);
+
       clutter_actor_get_fixed_position (queued_actor, &x, &y);
       clutter_actor_allocate_preferred_size (queued_actor, x, y);
 
@@ -1239,6 +1250,9 @@ clutter_stage_constructed (GObject *gobject)
 
   priv->all_active_gestures = g_ptr_array_sized_new (64);
 
+  if (clutter_context_get_parallel_layout (context))
+    priv->parallel_layout = clutter_parallel_layout_new ();
+
   clutter_actor_set_background_color (CLUTTER_ACTOR (self),
                                       &default_stage_color);
 
@@ -1361,6 +1375,8 @@ clutter_stage_finalize (GObject *object)
   g_assert (priv->all_active_gestures->len == 0);
   g_ptr_array_free (priv->all_active_gestures, TRUE);
 
+  g_clear_pointer (&priv->parallel_layout, clutter_parallel_layout_free);
+
   G_OBJECT_CLASS (clutter_stage_parent_class)->finalize (object);
 }
 
@@ -1716,6 +1732,7 @@ clutter_stage_set_perspective (ClutterStage       *stage,
                                     priv->perspective.z_far);
   graphene_matrix_inverse (&priv->projection,
                            &priv->inverse_projection);
+  priv->projection_generation++;
 
   _clutter_stage_dirty_projection (stage);
   clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
@@ -1765,6 +1782,14 @@ _clutter_stage_get_projection_matrix (ClutterStage      *stage,
   *projection = priv->projection;
 }
 
+unsigned int
+clutter_stage_get_projection_generation (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = clutter_stage_get_instance_private (stage);
+
+  return priv->projection_generation;
+}
+
 /* This simply provides a simple mechanism for us to ensure that
  * the projection matrix gets re-asserted before painting.
  *
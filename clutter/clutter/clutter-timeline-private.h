@@ -25,5 +25,12 @@
 
 void                    _clutter_timeline_advance                       (ClutterTimeline    *timeline,
                                                                          int64_t             tick_time);
+CLUTTER_EXPORT_TEST
 void                    _clutter_timeline_do_tick                       (ClutterTimeline    *timeline,
                                                                          int64_t             tick_time);
+
+gboolean                clutter_timeline_can_batch_tick                 (ClutterTimeline      *timeline,
+                                                                         int64_t               tick_time,
+                                                                         ClutterAnimationMode *progress_mode);
+void                    clutter_timeline_do_batched_tick                (ClutterTimeline    *timeline,
+                                                                         int64_t             tick_time);
@@ -193,6 +193,10 @@ enum
 static guint timeline_signals[LAST_SIGNAL] = { 0, };
 
 static void update_frame_clock (ClutterTimeline *timeline);
+static double clutter_timeline_progress_func (ClutterTimeline *timeline,
+                                              double           elapsed,
+                                              double           duration,
+                                              gpointer         user_data);
 
 
 G_DEFINE_TYPE_WITH_CODE (ClutterTimeline, clutter_timeline, G_TYPE_OBJECT,
@@ -1793,6 +1797,100 @@ _clutter_timeline_do_tick (ClutterTimeline *timeline,
     }
 }
 
+/*< private >
+ * clutter_timeline_can_batch_tick:
+ * @timeline: a #ClutterTimeline
+ * @tick_time: time of advance
+ * @progress_mode: (out): return location for the mode to compute the
+ *   progress with
+ *
+ * Checks whether advancing @timeline to @tick_time is a plain frame in
+ * the middle of the timeline: no marker is hit, the timeline does not
+ * complete, and nothing besides the class handler is connected to the
+ * #ClutterTimeline::new-frame signal. Such a tick can be split into
+ * clutter_timeline_do_batched_tick(), which only updates the elapsed time,
+ * and the work of the class handler, done by the caller.
+ *
+ * @progress_mode is set to the easing mode the progress can be computed
+ * with by clutter_easing_for_mode_batch(), or to %CLUTTER_CUSTOM_MODE
+ * if clutter_timeline_get_progress() has to be used.
+ *
+ * Return value: %TRUE if the tick can be batched
+ */
+gboolean
+clutter_timeline_can_batch_tick (ClutterTimeline      *timeline,
+                                 int64_t               tick_time,
+                                 ClutterAnimationMode *progress_mode)
+{
+  ClutterTimelinePrivate *priv =
+    clutter_timeline_get_instance_private (timeline);
+  int64_t msecs, elapsed_time;
+
+  if (!priv->is_playing || priv->waiting_first_tick)
+    return FALSE;
+
+  msecs = tick_time - priv->last_frame_time;
+  if (msecs <= 0)
+    return FALSE;
+
+  if (priv->markers_by_name != NULL &&
+      g_hash_table_size (priv->markers_by_name) > 0)
+    return FALSE;
+
+  if (priv->direction == CLUTTER_TIMELINE_FORWARD)
+    elapsed_time = priv->elapsed_time + msecs;
+  else
+    elapsed_time = priv->elapsed_time - msecs;
+
+  if (elapsed_time <= 0 || elapsed_time >= priv->duration)
+    return FALSE;
+
+  if (g_signal_has_handler_pending (timeline,
+                                    timeline_signals[NEW_FRAME],
+                                    0, FALSE))
+    return FALSE;
+
+  if (priv->progress_func == NULL)
+    *progress_mode = CLUTTER_LINEAR;
+  else if (priv->progress_func == clutter_timeline_progress_func &&
+           priv->progress_mode != CLUTTER_STEPS &&
+           priv->progress_mode != CLUTTER_CUBIC_BEZIER)
+    *progress_mode = priv->progress_mode;
+  else
+    *progress_mode = CLUTTER_CUSTOM_MODE;
+
+  return TRUE;
+}
+
+/*< private >
+ * clutter_timeline_do_batched_tick:
+ * @timeline: a #ClutterTimeline
+ * @tick_time: time of advance
+ *
+ * Advances @timeline to @tick_time like _clutter_timeline_do_tick(), but
+ * without emitting any signal. Must only be called if
+ * clutter_timeline_can_batch_tick() returned %TRUE for the same
+ * @tick_time, and no code ran in between.
+ */
+void
+clutter_timeline_do_batched_tick (ClutterTimeline *timeline,
+                                  int64_t          tick_time)
+{
+  ClutterTimelinePrivate *priv =
+    clutter_timeline_get_instance_private (timeline);
+  int64_t msecs;
+
+  msecs = tick_time - priv->last_frame_time;
+
+  priv->last_frame_time += msecs;
+  priv->msecs_delta = msecs;
+
+  if (priv->direction == CLUTTER_TIMELINE_FORWARD)
+    priv->elapsed_time += priv->msecs_delta;
+  else
+    priv->elapsed_time -= priv->msecs_delta;
+}
+
 /**
  * clutter_timeline_add_marker:
  * @timeline: a #ClutterTimeline
@@ -2280,20 +2378,18 @@ clutter_timeline_progress_func (ClutterTimeline   *timeline,
                                         priv->cb_2.x, priv->cb_2.y);
 
     case CLUTTER_EASE:
-      return clutter_ease_cubic_bezier (elapsed, duration,
-                                        0.25, 0.1, 0.25, 1.0);
-
     case CLUTTER_EASE_IN:
-      return clutter_ease_cubic_bezier (elapsed, duration,
-                                        0.42, 0.0, 1.0, 1.0);
-
     case CLUTTER_EASE_OUT:
-      return clutter_ease_cubic_bezier (elapsed, duration,
-                                        0.0, 0.0, 0.58, 1.0);
-
     case CLUTTER_EASE_IN_OUT:
-      return clutter_ease_cubic_bezier (elapsed, duration,
-                                        0.42, 0.0, 0.58, 1.0);
+      {
+        double x_1, y_1, x_2, y_2;
+
+        clutter_ease_get_cubic_bezier_for_mode (priv->progress_mode,
+                                                &x_1, &y_1, &x_2, &y_2);
+
+        return clutter_ease_cubic_bezier (elapsed, duration,
+                                          x_1, y_1, x_2, y_2);
+      }
 
     default:
       break;
@@ -0,0 +1,484 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026 Red Hat Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * A transition batch advances many property transitions of actors in
+ * one go. Instead of emitting ::new-frame on every timeline, and boxing
+ * every interpolated value in a GValue on its way to the actor, the
+ * elapsed time and the interval end points of all transitions are
+ * gathered in flat arrays. Easing functions are then evaluated once per
+ * easing mode for all transitions using it, values are interpolated in a
+ * single loop, and the results are written to the actor fields directly.
+ *
+ * Only ticks that would not do anything beyond computing and setting the
+ * new value are batched, i.e. no marker is hit, the timeline does not
+ * complete, and nobody else is listening to ::new-frame. All other ticks,
+ * like the first and the last one of every transition, go through
+ * _clutter_timeline_do_tick() as usual.
+ */
+
+#include "config.h"
+
+#include "clutter/clutter-transition-batch.h"
+
+#include "clutter/clutter-actor-private.h"
+#include "clutter/clutter-debug.h"
+#include "clutter/clutter-easing.h"
+#include "clutter/clutter-interval.h"
+#include "clutter/clutter-private.h"
+#include "clutter/clutter-property-transition-private.h"
+#include "clutter/clutter-timeline-private.h"
+#include "clutter/clutter-transition.h"
+#include "cogl/cogl-trace.h"
+
+#define MAX_COMPONENTS 4
+
+typedef struct _BatchEntry
+{
+  /* Both owned by the batch until it is run */
+  ClutterTimeline *timeline;
+  ClutterActor *actor;
+
+  ClutterInterval *interval;
+  GParamSpec *pspec;
+
+  ClutterAnimationMode mode;
+  gboolean is_point;
+
+  unsigned int elapsed_time;
+
+  unsigned int first_component;
+  unsigned int n_components;
+} BatchEntry;
+
+struct _ClutterTransitionBatch
+{
+  int64_t tick_time;
+
+  GArray *entries;
+
+  /* Indexed by entry, sorted by easing mode */
+  GArray *sorted_entries;
+  GArray *sorted_elapsed;
+  GArray *sorted_durations;
+  GArray *sorted_progress;
+
+  /* Indexed by entry */
+  GArray *progress;
+
+  /* Indexed by value component */
+  GArray *component_entries;
+  GArray *from;
+  GArray *to;
+  GArray *values;
+};
+
+ClutterTransitionBatch *
+clutter_transition_batch_new (void)
+{
+  ClutterTransitionBatch *batch;
+
+  batch = g_new0 (ClutterTransitionBatch, 1);
+  batch->entries = g_array_new (FALSE, FALSE, sizeof (BatchEntry));
+  batch->sorted_entries = g_array_new (FALSE, FALSE, sizeof (unsigned int));
+  batch->sorted_elapsed = g_array_new (FALSE, FALSE, sizeof (double));
+  batch->sorted_durations = g_array_new (FALSE, FALSE, sizeof (double));
+  batch->sorted_progress = g_array_new (FALSE, FALSE, sizeof (double));
+  batch->progress = g_array_new (FALSE, FALSE, sizeof (double));
+  batch->component_entries = g_array_new (FALSE, FALSE, sizeof (unsigned int));
+  batch->from = g_array_new (FALSE, FALSE, sizeof (double));
+  batch->to = g_array_new (FALSE, FALSE, sizeof (double));
+  batch->values = g_array_new (FALSE, FALSE, sizeof (double));
+
+  return batch;
+}
+
+static void
+clutter_transition_batch_clear (ClutterTransitionBatch *batch)
+{
+  unsigned int i;
+
+  for (i = 0; i < batch->entries->len; i++)
+    {
+      BatchEntry *entry = &g_array_index (batch->entries, BatchEntry, i);
+
+      g_object_unref (entry->timeline);
+      g_object_unref (entry->actor);
+    }
+
+  g_array_set_size (batch->entries, 0);
+  g_array_set_size (batch->component_entries, 0);
+  g_array_set_size (batch->from, 0);
+  g_array_set_size (batch->to, 0);
+}
+
+void
+clutter_transition_batch_free (ClutterTransitionBatch *batch)
+{
+  clutter_transition_batch_clear (batch);
+
+  g_array_unref (batch->entries);
+  g_array_unref (batch->sorted_entries);
+  g_array_unref (batch->sorted_elapsed);
+  g_array_unref (batch->sorted_durations);
+  g_array_unref (batch->sorted_progress);
+  g_array_unref (batch->progress);
+  g_array_unref (batch->component_entries);
+  g_array_unref (batch->from);
+  g_array_unref (batch->to);
+  g_array_unref (batch->values);
+  g_free (batch);
+}
+
+/* Matches what clutter_interval_compute_value() reads from each value
+ * type, so that interpolating the components gives the same result */
+static unsigned int
+get_value_components (const GValue *value,
+                      double       *components)
+{
+  GType value_type = G_VALUE_TYPE (value);
+
+  if (value_type == G_TYPE_FLOAT)
+    {
+      components[0] = g_value_get_float (value);
+      return 1;
+    }
+  else if (value_type == G_TYPE_DOUBLE)
+    {
+      components[0] = g_value_get_double (value);
+      return 1;
+    }
+  else if (value_type == G_TYPE_UINT)
+    {
+      components[0] = g_value_get_uint (value);
+      return 1;
+    }
+  else if (value_type == GRAPHENE_TYPE_POINT)
+    {
+      const graphene_point_t *point = g_value_get_boxed (value);
+
+      if (point == NULL)
+        return 0;
+
+      components[0] = point->x;
+      components[1] = point->y;
+      return 2;
+    }
+  else if (value_type == COGL_TYPE_COLOR)
+    {
+      const CoglColor *color = cogl_value_get_color (value);
+
+      if (color == NULL)
+        return 0;
+
+      components[0] = color->red;
+      components[1] = color->green;
+      components[2] = color->blue;
+      components[3] = color->alpha;
+      return 4;
+    }
+
+  return 0;
+}
+
+/*
+ * clutter_transition_batch_add:
+ * @batch: a #ClutterTransitionBatch
+ * @timeline: a #ClutterTimeline attached to the frame clock being advanced
+ * @tick_time: the time the frame clock is advancing timelines to
+ *
+ * Adds the next tick of @timeline to @batch, if it is a transition of an
+ * actor property whose tick can be batched.
+ *
+ * Return value: %TRUE if @timeline will be advanced by
+ *   clutter_transition_batch_run(), and %FALSE if it has to be advanced
+ *   by the caller
+ */
+gboolean
+clutter_transition_batch_add (ClutterTransitionBatch *batch,
+                              ClutterTimeline        *timeline,
+                              int64_t                 tick_time)
+{
+  ClutterTransition *transition;
+  ClutterAnimatable *animatable;
+  ClutterInterval *interval;
+  ClutterAnimationMode mode;
+  GParamSpec *pspec;
+  GType value_type;
+  double from[MAX_COMPONENTS];
+  double to[MAX_COMPONENTS];
+  unsigned int n_components;
+  unsigned int entry_index;
+  BatchEntry entry;
+  unsigned int i;
+
+  /* Subclasses may compute their values in different ways */
+  if (G_OBJECT_TYPE (timeline) != CLUTTER_TYPE_PROPERTY_TRANSITION)
+    return FALSE;
+
+  if (!clutter_timeline_can_batch_tick (timeline, tick_time, &mode))
+    return FALSE;
+
+  transition = CLUTTER_TRANSITION (timeline);
+  animatable = clutter_transition_get_animatable (transition);
+  interval = clutter_transition_get_interval (transition);
+
+  if (!CLUTTER_IS_ACTOR (animatable) ||
+      interval == NULL ||
+      G_OBJECT_TYPE (interval) != CLUTTER_TYPE_INTERVAL)
+    return FALSE;
+
+  pspec =
+    clutter_property_transition_prepare_frame (CLUTTER_PROPERTY_TRANSITION (transition));
+  if (pspec == NULL)
+    return FALSE;
+
+  /* Anything that would need a conversion of the interpolated value, or
+   * a custom interpolation, is left to the generic code */
+  value_type = clutter_interval_get_value_type (interval);
+  if (value_type != G_PARAM_SPEC_VALUE_TYPE (pspec) ||
+      !clutter_interval_has_default_progress_func (value_type) ||
+      !clutter_actor_can_batch_property (CLUTTER_ACTOR (animatable), pspec))
+    return FALSE;
+
+  n_components =
+    get_value_components (clutter_interval_peek_initial_value (interval),
+                          from);
+  if (n_components == 0 ||
+      get_value_components (clutter_interval_peek_final_value (interval),
+                            to) != n_components)
+    return FALSE;
+
+  batch->tick_time = tick_time;
+
+  entry = (BatchEntry) {
+    .timeline = g_object_ref (timeline),
+    .actor = g_object_ref (CLUTTER_ACTOR (animatable)),
+    .interval = interval,
+    .pspec = pspec,
+    .mode = mode,
+    .is_point = value_type == GRAPHENE_TYPE_POINT,
+    .first_component = batch->from->len,
+    .n_components = n_components,
+  };
+
+  entry_index = batch->entries->len;
+  g_array_append_val (batch->entries, entry);
+
+  g_array_append_vals (batch->from, from, n_components);
+  g_array_append_vals (batch->to, to, n_components);
+  for (i = 0; i < n_components; i++)
+    g_array_append_val (batch->component_entries, entry_index);
+
+  return TRUE;
+}
+
+static void
+compute_progress (ClutterTransitionBatch *batch)
+{
+  unsigned int counts[CLUTTER_ANIMATION_LAST] = { 0, };
+  unsigned int offsets[CLUTTER_ANIMATION_LAST];
+  unsigned int n_entries = batch->entries->len;
+  unsigned int *sorted_entries;
+  double *sorted_elapsed;
+  double *sorted_durations;
+  double *sorted_progress;
+  double *progress;
+  unsigned int offset;
+  unsigned int i;
+  int mode;
+
+  g_array_set_size (batch->sorted_entries, n_entries);
+  g_array_set_size (batch->sorted_elapsed, n_entries);
+  g_array_set_size (batch->sorted_durations, n_entries);
+  g_array_set_size (batch->sorted_progress, n_entries);
+  g_array_set_size (batch->progress, n_entries);
+
+  sorted_entries = (unsigned int *) batch->sorted_entries->data;
+  sorted_elapsed = (double *) batch->sorted_elapsed->data;
+  sorted_durations = (double *) batch->sorted_durations->data;
+  sorted_progress = (double *) batch->sorted_progress->data;
+  progress = (double *) batch->progress->data;
+
+  /* Group the entries by easing mode, so every easing function only
+   * needs to be dispatched once */
+  for (i = 0; i < n_entries; i++)
+    counts[g_array_index (batch->entries, BatchEntry, i).mode]++;
+
+  for (mode = 0, offset = 0; mode < CLUTTER_ANIMATION_LAST; mode++)
+    {
+      offsets[mode] = offset;
+      offset += counts[mode];
+    }
+
+  for (i = 0; i < n_entries; i++)
+    {
+      BatchEntry *entry = &g_array_index (batch->entries, BatchEntry, i);
+      unsigned int slot = offsets[entry->mode]++;
+
+      sorted_entries[slot] = i;
+      sorted_elapsed[slot] = entry->elapsed_time;
+      sorted_durations[slot] =
+        clutter_timeline_get_duration (entry->timeline);
+    }
+
+  for (mode = 0, offset = 0; mode < CLUTTER_ANIMATION_LAST; mode++)
+    {
+      if (counts[mode] == 0)
+        continue;
+
+      if (mode == CLUTTER_CUSTOM_MODE)
+        {
+          for (i = offset; i < offset + counts[mode]; i++)
+            {
+              BatchEntry *entry = &g_array_index (batch->entries, BatchEntry,
+                                                  sorted_entries[i]);
+
+              sorted_progress[i] =
+                clutter_timeline_get_progress (entry->timeline);
+            }
+        }
+      else
+        {
+          clutter_easing_for_mode_batch (mode,
+                                         sorted_elapsed + offset,
+                                         sorted_durations + offset,
+                                         sorted_progress + offset,
+                                         counts[mode]);
+        }
+
+      offset += counts[mode];
+    }
+
+  for (i = 0; i < n_entries; i++)
+    progress[sorted_entries[i]] = sorted_progress[i];
+}
+
+static void
+compute_values (ClutterTransitionBatch *batch)
+{
+  unsigned int n_components = batch->from->len;
+  const unsigned int *component_entries =
+    (const unsigned int *) batch->component_entries->data;
+  const double *progress = (const double *) batch->progress->data;
+  const double *from = (const double *) batch->from->data;
+  const double *to = (const double *) batch->to->data;
+  double *values;
+  unsigned int i;
+
+  g_array_set_size (batch->values, n_components);
+  values = (double *) batch->values->data;
+
+  /* The same computation ClutterInterval does for numbers, and that
+   * the default progress function does for colors */
+  for (i = 0; i < n_components; i++)
+    {
+      double factor = progress[component_entries[i]];
+
+      values[i] = (factor * (to[i] - from[i])) + from[i];
+    }
+
+  /* Points are interpolated by graphene, which rounds differently */
+  for (i = 0; i < batch->entries->len; i++)
+    {
+      BatchEntry *entry = &g_array_index (batch->entries, BatchEntry, i);
+      unsigned int c = entry->first_component;
+      graphene_point_t res;
+
+      if (!entry->is_point)
+        continue;
+
+      graphene_point_interpolate (&GRAPHENE_POINT_INIT ((float) from[c],
+                                                        (float) from[c + 1]),
+                                  &GRAPHENE_POINT_INIT ((float) to[c],
+                                                        (float) to[c + 1]),
+                                  progress[i],
+                                  &res);
+
+      values[c] = res.x;
+      values[c + 1] = res.y;
+    }
+}
+
+/* Setting the value of one entry emits notifications, whose handlers might
+ * have stopped, rewound or detached the transition of another entry in the
+ * meantime. The value computed for that entry is then outdated. */
+static gboolean
+is_entry_current (BatchEntry *entry)
+{
+  ClutterTransition *transition = CLUTTER_TRANSITION (entry->timeline);
+
+  return (clutter_timeline_is_playing (entry->timeline) &&
+          clutter_timeline_get_elapsed_time (entry->timeline) == entry->elapsed_time &&
+          clutter_transition_get_animatable (transition) == CLUTTER_ANIMATABLE (entry->actor) &&
+          clutter_transition_get_interval (transition) == entry->interval);
+}
+
+/*
+ * clutter_transition_batch_run:
+ * @batch: a #ClutterTransitionBatch
+ *
+ * Advances all timelines added to @batch since it was last run, and sets
+ * the new values of their properties.
+ */
+void
+clutter_transition_batch_run (ClutterTransitionBatch *batch)
+{
+  const double *values;
+  unsigned int i;
+
+  if (batch->entries->len == 0)
+    return;
+
+  COGL_TRACE_BEGIN_SCOPED (RunBatch, "Clutter::TransitionBatch::run()");
+
+  CLUTTER_NOTE (ANIMATION, "Advancing %u batched transitions",
+                batch->entries->len);
+
+  /* No signal is emitted while advancing, so no code can run in between
+   * the checks done when adding entries and this */
+  for (i = 0; i < batch->entries->len; i++)
+    {
+      BatchEntry *entry = &g_array_index (batch->entries, BatchEntry, i);
+
+      clutter_timeline_do_batched_tick (entry->timeline, batch->tick_time);
+      entry->elapsed_time = clutter_timeline_get_elapsed_time (entry->timeline);
+    }
+
+  compute_progress (batch);
+  compute_values (batch);
+
+  values = (const double *) batch->values->data;
+
+  for (i = 0; i < batch->entries->len; i++)
+    {
+      BatchEntry *entry = &g_array_index (batch->entries, BatchEntry, i);
+
+      if (!is_entry_current (entry))
+        continue;
+
+      clutter_actor_set_batched_property (entry->actor,
+                                          entry->pspec,
+                                          values + entry->first_component);
+    }
+
+  clutter_transition_batch_clear (batch);
+}
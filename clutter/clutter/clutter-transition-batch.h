@@ -0,0 +1,42 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026 Red Hat Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+#include "clutter/clutter-timeline.h"
+
+typedef struct _ClutterTransitionBatch ClutterTransitionBatch;
+
+CLUTTER_EXPORT_TEST
+ClutterTransitionBatch * clutter_transition_batch_new (void);
+
+CLUTTER_EXPORT_TEST
+void clutter_transition_batch_free (ClutterTransitionBatch *batch);
+
+CLUTTER_EXPORT_TEST
+gboolean clutter_transition_batch_add (ClutterTransitionBatch *batch,
+                                       ClutterTimeline        *timeline,
+                                       int64_t                 tick_time);
+
+CLUTTER_EXPORT_TEST
+void clutter_transition_batch_run (ClutterTransitionBatch *batch);
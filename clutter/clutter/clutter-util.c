@@ -46,50 +46,14 @@ typedef struct
   float w;
 } ClutterVertex4;
 
-void
-_clutter_util_fully_transform_vertices (const graphene_matrix_t  *modelview,
-                                        const graphene_matrix_t  *projection,
-                                        const float              *viewport,
-                                        const graphene_point3d_t *vertices_in,
-                                        graphene_point3d_t       *vertices_out,
-                                        int                       n_vertices)
+static void
+vertices_to_window_coords (const ClutterVertex4 *vertices_tmp,
+                           const float          *viewport,
+                           graphene_point3d_t   *vertices_out,
+                           int                   n_vertices)
 {
-  graphene_matrix_t modelview_projection;
-  ClutterVertex4 *vertices_tmp;
   int i;
 
-  vertices_tmp = g_alloca (sizeof (ClutterVertex4) * n_vertices);
-
-  if (n_vertices >= 4)
-    {
-      /* XXX: we should find a way to cache this per actor */
-      graphene_matrix_multiply (modelview, projection, &modelview_projection);
-
-      cogl_graphene_matrix_project_points_f3 (&modelview_projection,
-                                              sizeof (graphene_point3d_t),
-                                              vertices_in,
-                                              sizeof (ClutterVertex4),
-                                              vertices_tmp,
-                                              n_vertices);
-    }
-  else
-    {
-      cogl_graphene_matrix_transform_points (modelview,
-                                             3,
-                                             sizeof (graphene_point3d_t),
-                                             vertices_in,
-                                             sizeof (ClutterVertex4),
-                                             vertices_tmp,
-                                             n_vertices);
-
-      cogl_graphene_matrix_project_points_f3 (projection,
-                                              sizeof (ClutterVertex4),
-                                              vertices_tmp,
-                                              sizeof (ClutterVertex4),
-                                              vertices_tmp,
-                                              n_vertices);
-    }
-
   for (i = 0; i < n_vertices; i++)
     {
       ClutterVertex4 vertex_tmp = vertices_tmp[i];
@@ -108,6 +72,74 @@ _clutter_util_fully_transform_vertices (const graphene_matrix_t  *modelview,
     }
 }
 
+/* Like _clutter_util_fully_transform_vertices(), for callers that
+ * already have the combined modelview-projection matrix at hand; the
+ * results are identical to the ones of the former for n_vertices >= 4.
+ */
+void
+_clutter_util_project_vertices (const graphene_matrix_t  *modelview_projection,
+                                const float              *viewport,
+                                const graphene_point3d_t *vertices_in,
+                                graphene_point3d_t       *vertices_out,
+                                int                       n_vertices)
+{
+  ClutterVertex4 *vertices_tmp;
+
+  vertices_tmp = g_alloca (sizeof (ClutterVertex4) * n_vertices);
+
+  cogl_graphene_matrix_project_points_f3 (modelview_projection,
+                                          sizeof (graphene_point3d_t),
+                                          vertices_in,
+                                          sizeof (ClutterVertex4),
+                                          vertices_tmp,
+                                          n_vertices);
+
+  vertices_to_window_coords (vertices_tmp, viewport, vertices_out, n_vertices);
+}
+
+void
+_clutter_util_fully_transform_vertices (const graphene_matrix_t  *modelview,
+                                        const graphene_matrix_t  *projection,
+                                        const float              *viewport,
+                                        const graphene_point3d_t *vertices_in,
+                                        graphene_point3d_t       *vertices_out,
+                                        int                       n_vertices)
+{
+  graphene_matrix_t modelview_projection;
+  ClutterVertex4 *vertices_tmp;
+
+  if (n_vertices >= 4)
+    {
+      graphene_matrix_multiply (modelview, projection, &modelview_projection);
+
+      _clutter_util_project_vertices (&modelview_projection,
+                                      viewport,
+                                      vertices_in,
+                                      vertices_out,
+                                      n_vertices);
+      return;
+    }
+
+  vertices_tmp = g_alloca (sizeof (ClutterVertex4) * n_vertices);
+
+  cogl_graphene_matrix_transform_points (modelview,
+                                         3,
+                                         sizeof (graphene_point3d_t),
+                                         vertices_in,
+                                         sizeof (ClutterVertex4),
+                                         vertices_tmp,
+                                         n_vertices);
+
+  cogl_graphene_matrix_project_points_f3 (projection,
+                                          sizeof (ClutterVertex4),
+                                          vertices_tmp,
+                                          sizeof (ClutterVertex4),
+                                          vertices_tmp,
+                                          n_vertices);
+
+  vertices_to_window_coords (vertices_tmp, viewport, vertices_out, n_vertices);
+}
+
 typedef struct
 {
   GType value_type;
@@ -161,6 +193,26 @@ out:
   return res;
 }
 
+ClutterProgressFunc
+_clutter_get_progress_function (GType gtype)
+{
+  ProgressData *pdata;
+  ClutterProgressFunc func = NULL;
+
+  G_LOCK (progress_funcs);
+
+  if (progress_funcs != NULL)
+    {
+      pdata = g_hash_table_lookup (progress_funcs, g_type_name (gtype));
+      if (pdata != NULL)
+        func = pdata->func;
+    }
+
+  G_UNLOCK (progress_funcs);
+
+  return func;
+}
+
 static void
 progress_data_destroy (gpointer data_)
 {
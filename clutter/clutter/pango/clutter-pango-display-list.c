@@ -462,6 +462,24 @@ clutter_pango_display_list_render (CoglFramebuffer          *fb,
     }
 }
 
+gboolean
+clutter_pango_display_list_uses_texture (ClutterPangoDisplayList *dl,
+                                         CoglTexture             *texture)
+{
+  GSList *l;
+
+  for (l = dl->nodes; l; l = l->next)
+    {
+      PangoDisplayListNode *node = l->data;
+
+      if (node->type == PANGO_DISPLAY_LIST_TEXTURE &&
+          node->d.texture.texture == texture)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
 static void
 clutter_pango_display_list_node_free (PangoDisplayListNode *node)
 {
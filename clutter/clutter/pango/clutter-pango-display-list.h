@@ -76,6 +76,9 @@ void clutter_pango_display_list_render (CoglFramebuffer         *framebuffer,
                                         ClutterColorState       *target_color_state,
                                         const CoglColor         *color);
 
+gboolean clutter_pango_display_list_uses_texture (ClutterPangoDisplayList *dl,
+                                                  CoglTexture             *texture);
+
 void clutter_pango_display_list_free (ClutterPangoDisplayList *dl);
 
 G_END_DECLS
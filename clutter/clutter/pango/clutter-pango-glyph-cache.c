@@ -31,6 +31,7 @@
 #include <cairo-ft.h>
 #include <glib.h>
 #include <pango/pangocairo.h>
+#include <stdlib.h>
 
 #include "clutter/clutter-debug.h"
 #include "clutter/pango/clutter-pango-glyph-cache.h"
@@ -44,29 +45,51 @@ struct _ClutterPangoGlyphCache
      particular font is already cached */
   GHashTable       *hash_table;
 
-  /* List of CoglAtlases */
-  GSList           *atlases;
+  /* Paged atlases for glyphs with and without colors, created on
+     demand */
+  CoglAtlas        *alpha_atlas;
+  CoglAtlas        *color_atlas;
 
-  /* List of callbacks to invoke when an atlas is reorganized */
-  GHookList reorganize_callbacks;
+  /* Number of nested clutter_pango_glyph_cache_pin_used_glyphs() */
+  unsigned int n_pins;
 
-  /* TRUE if we've ever stored a texture in the global atlas. This is
-     used to make sure we only register one callback to listen for
-     global atlas reorganizations */
-  gboolean using_global_atlas;
+  /* List of callbacks to invoke when the glyphs of an atlas page are
+     evicted */
+  GHookList evict_callbacks;
+  /* Page texture the evict callbacks were last invoked for */
+  CoglTexture *evicted_texture;
 
   /* True if some of the glyphs are dirty. This is used as an
      optimization in clutter_pango_glyph_cache_set_dirty_glyphs to avoid
      iterating the hash table if we know none of them are dirty */
   gboolean has_dirty_glyphs;
+
+  /* Worker threads rasterizing dirty glyphs, created on first use */
+  GThreadPool *raster_pool;
+  int n_raster_workers;
 };
 
 typedef struct _PangoGlyphCacheKey
 {
   PangoFont  *font;
   PangoGlyph glyph;
+
+  /* The key is what gets stored in the atlas, so it can be removed
+     from the hash table when its atlas page is evicted */
+  PangoGlyphCacheValue *value;
 } PangoGlyphCacheKey;
 
+/* Each atlas page is 1MB, so this bounds the memory used for glyphs
+   of each kind, apart from glyphs larger than a page and pages pinned
+   by a layout that doesn't fit. Glyphs on the least recently used page
+   are dropped to make space for new ones */
+#define MAX_ATLAS_PAGES 4
+
+/* Rasterizing fewer dirty glyphs than this is cheaper than waking up
+   the worker threads */
+#define MIN_GLYPHS_FOR_THREADED_RASTERIZATION 32
+#define MAX_RASTER_WORKERS 4
+
 static void
 clutter_pango_glyph_cache_value_free (PangoGlyphCacheValue *value)
 {
@@ -124,42 +147,36 @@ clutter_pango_glyph_cache_new (CoglContext *ctx)
      (GDestroyNotify) clutter_pango_glyph_cache_key_free,
      (GDestroyNotify) clutter_pango_glyph_cache_value_free);
 
-  cache->atlases = NULL;
-  g_hook_list_init (&cache->reorganize_callbacks, sizeof (GHook));
+  cache->alpha_atlas = NULL;
+  cache->color_atlas = NULL;
+  g_hook_list_init (&cache->evict_callbacks, sizeof (GHook));
+  cache->evicted_texture = NULL;
 
   cache->has_dirty_glyphs = FALSE;
 
-  cache->using_global_atlas = FALSE;
+  cache->raster_pool = NULL;
+  cache->n_raster_workers = CLAMP (g_get_num_processors () - 1,
+                                   0, MAX_RASTER_WORKERS);
 
   return cache;
 }
 
-static void
-clutter_pango_glyph_cache_reorganize_cb (void *user_data)
-{
-  ClutterPangoGlyphCache *cache = user_data;
-
-  g_hook_list_invoke (&cache->reorganize_callbacks, FALSE);
-}
-
 void
 clutter_pango_glyph_cache_free (ClutterPangoGlyphCache *cache)
 {
-  if (cache->using_global_atlas)
-    {
-      cogl_atlas_texture_remove_reorganize_callback (
-                                  cache->ctx,
-                                  clutter_pango_glyph_cache_reorganize_cb, cache);
-    }
-
-  g_slist_foreach (cache->atlases, (GFunc) g_object_unref, NULL);
-  g_clear_pointer (&cache->atlases, g_slist_free);
   cache->has_dirty_glyphs = FALSE;
 
   g_hash_table_remove_all (cache->hash_table);
   g_clear_pointer (&cache->hash_table, g_hash_table_unref);
 
-  g_hook_list_clear (&cache->reorganize_callbacks);
+  g_clear_object (&cache->alpha_atlas);
+  g_clear_object (&cache->color_atlas);
+
+  g_hook_list_clear (&cache->evict_callbacks);
+  g_clear_object (&cache->evicted_texture);
+
+  if (cache->raster_pool)
+    g_thread_pool_free (cache->raster_pool, FALSE, TRUE);
 
   g_free (cache);
 }
@@ -169,7 +186,8 @@ clutter_pango_glyph_cache_update_position_cb (void               *user_data,
                                               CoglTexture        *new_texture,
                                               const MtkRectangle *rect)
 {
-  PangoGlyphCacheValue *value = user_data;
+  PangoGlyphCacheKey *key = user_data;
+  PangoGlyphCacheValue *value = key->value;
   float tex_width, tex_height;
 
   g_clear_object (&value->texture);
@@ -191,94 +209,109 @@ clutter_pango_glyph_cache_update_position_cb (void               *user_data,
 }
 
 static gboolean
-clutter_pango_glyph_cache_add_to_global_atlas (ClutterPangoGlyphCache  *cache,
-                                               PangoFont               *font,
-                                               PangoGlyph               glyph,
-                                               PangoGlyphCacheValue    *value)
+font_has_color_glyphs (const PangoFont *font)
 {
-  CoglTexture *texture;
-  GError *ignore_error = NULL;
+  cairo_scaled_font_t *scaled_font;
+  gboolean has_color = FALSE;
 
-  texture = cogl_atlas_texture_new_with_size (cache->ctx,
-                                              value->draw_width,
-                                              value->draw_height);
-  if (!cogl_texture_allocate (texture, &ignore_error))
+  scaled_font = pango_cairo_font_get_scaled_font ((PangoCairoFont *) font);
+
+  if (cairo_scaled_font_get_type (scaled_font) == CAIRO_FONT_TYPE_FT)
     {
-      g_error_free (ignore_error);
-      return FALSE;
+      FT_Face ft_face = cairo_ft_scaled_font_lock_face (scaled_font);
+      has_color = (FT_HAS_COLOR (ft_face) != 0);
+      cairo_ft_scaled_font_unlock_face (scaled_font);
     }
 
-  value->texture = texture;
-  value->tx1 = 0;
-  value->ty1 = 0;
-  value->tx2 = 1;
-  value->ty2 = 1;
-  value->tx_pixel = 0;
-  value->ty_pixel = 0;
-
-  /* The first time we store a texture in the global atlas we'll
-     register for notifications when the global atlas is reorganized
-     so we can forward the notification on as a glyph
-     reorganization */
-  if (!cache->using_global_atlas)
+  return has_color;
+}
+
+static void
+clutter_pango_glyph_cache_evict_marshaller (GHook    *hook,
+                                            gpointer  marshal_data)
+{
+  ClutterPangoGlyphCacheEvictFunc func = hook->func;
+
+  func (marshal_data, hook->data);
+}
+
+static void
+clutter_pango_glyph_cache_evict_cb (void        *rect_data,
+                                    CoglTexture *texture,
+                                    void        *user_data)
+{
+  ClutterPangoGlyphCache *cache = user_data;
+  PangoGlyphCacheKey *key = rect_data;
+
+  CLUTTER_NOTE (PANGO, "evicting glyph %i", key->glyph);
+
+  /* This is called for every glyph of the page, but the callbacks only
+     need to know about the page once. A reference is kept so that a
+     new page can't end up at the same address */
+  if (texture != cache->evicted_texture)
     {
-      cogl_atlas_texture_add_reorganize_callback
-        (cache->ctx,
-         clutter_pango_glyph_cache_reorganize_cb, cache);
-      cache->using_global_atlas = TRUE;
+      g_set_object (&cache->evicted_texture, texture);
+      g_hook_list_marshal (&cache->evict_callbacks, FALSE,
+                           clutter_pango_glyph_cache_evict_marshaller,
+                           texture);
     }
 
-  return TRUE;
+  g_hash_table_remove (cache->hash_table, key);
 }
 
-static gboolean
-clutter_pango_glyph_cache_add_to_local_atlas (ClutterPangoGlyphCache  *cache,
-                                              CoglContext             *context,
-                                              PangoFont               *font,
-                                              PangoGlyph               glyph,
-                                              PangoGlyphCacheValue    *value)
+static CoglAtlas *
+clutter_pango_glyph_cache_ensure_atlas (ClutterPangoGlyphCache *cache,
+                                        CoglContext            *context,
+                                        gboolean                has_color)
 {
-  CoglAtlas *atlas = NULL;
-  GSList *l;
-
-  /* Look for an atlas that can reserve the space */
-  for (l = cache->atlases; l; l = l->next)
-    if (cogl_atlas_reserve_space (l->data,
-                                  value->draw_width + 1,
-                                  value->draw_height + 1,
-                                  value))
-      {
-        atlas = l->data;
-        break;
-      }
-
-  /* If we couldn't find one then start a new atlas */
-  if (atlas == NULL)
-    {
-      atlas = cogl_atlas_new (context,
-                              COGL_PIXEL_FORMAT_A_8,
-                              COGL_ATLAS_CLEAR_TEXTURE |
-                              COGL_ATLAS_DISABLE_MIGRATION,
-                              clutter_pango_glyph_cache_update_position_cb);
-      CLUTTER_NOTE (PANGO, "Created new atlas for glyphs: %p", atlas);
-      /* If we still can't reserve space then something has gone
-         seriously wrong so we'll just give up */
-      if (!cogl_atlas_reserve_space (atlas,
-                                     value->draw_width + 1,
-                                     value->draw_height + 1,
-                                     value))
-        {
-          g_object_unref (atlas);
-          return FALSE;
-        }
+  CoglAtlas **atlas = has_color ? &cache->color_atlas : &cache->alpha_atlas;
+
+  if (*atlas)
+    return *atlas;
+
+  /* Pages have a fixed size and are never reorganized, so glyphs
+     don't have to be redrawn, except when a page is evicted */
+  *atlas = cogl_atlas_new_paged (context,
+                                 has_color ? COGL_PIXEL_FORMAT_RGBA_8888_PRE :
+                                             COGL_PIXEL_FORMAT_A_8,
+                                 COGL_ATLAS_CLEAR_TEXTURE,
+                                 MAX_ATLAS_PAGES,
+                                 clutter_pango_glyph_cache_update_position_cb,
+                                 clutter_pango_glyph_cache_evict_cb,
+                                 cache);
+  CLUTTER_NOTE (PANGO, "Created new %s atlas for glyphs: %p",
+                has_color ? "color" : "alpha", *atlas);
+
+  if (cache->n_pins > 0)
+    cogl_atlas_pin_used_pages (*atlas);
+
+  return *atlas;
+}
+
+void
+clutter_pango_glyph_cache_pin_used_glyphs (ClutterPangoGlyphCache *cache)
+{
+  if (cache->n_pins++ > 0)
+    return;
 
-      cogl_atlas_add_reorganize_callback
-        (atlas, clutter_pango_glyph_cache_reorganize_cb, NULL, cache);
+  if (cache->alpha_atlas)
+    cogl_atlas_pin_used_pages (cache->alpha_atlas);
+  if (cache->color_atlas)
+    cogl_atlas_pin_used_pages (cache->color_atlas);
+}
 
-      cache->atlases = g_slist_prepend (cache->atlases, atlas);
-    }
+void
+clutter_pango_glyph_cache_unpin_glyphs (ClutterPangoGlyphCache *cache)
+{
+  g_return_if_fail (cache->n_pins > 0);
+
+  if (--cache->n_pins > 0)
+    return;
 
-  return TRUE;
+  if (cache->alpha_atlas)
+    cogl_atlas_unpin_pages (cache->alpha_atlas);
+  if (cache->color_atlas)
+    cogl_atlas_unpin_pages (cache->color_atlas);
 }
 
 PangoGlyphCacheValue *
@@ -296,7 +329,14 @@ clutter_pango_glyph_cache_lookup (ClutterPangoGlyphCache *cache,
 
   value = g_hash_table_lookup (cache->hash_table, &lookup_key);
 
-  if (create && value == NULL)
+  if (value && value->texture)
+    {
+      CoglAtlas *atlas = value->has_color ? cache->color_atlas :
+                                            cache->alpha_atlas;
+
+      cogl_atlas_mark_used (atlas, value->texture);
+    }
+  else if (create && value == NULL)
     {
       PangoGlyphCacheKey *key;
       PangoRectangle ink_rect;
@@ -304,6 +344,11 @@ clutter_pango_glyph_cache_lookup (ClutterPangoGlyphCache *cache,
       value = g_new0 (PangoGlyphCacheValue, 1);
       value->texture = NULL;
 
+      key = g_new0 (PangoGlyphCacheKey, 1);
+      key->font = g_object_ref (font);
+      key->glyph = glyph;
+      key->value = value;
+
       pango_font_get_glyph_extents (font, glyph, &ink_rect, NULL);
       pango_extents_to_pixels (&ink_rect, NULL);
 
@@ -318,18 +363,24 @@ clutter_pango_glyph_cache_lookup (ClutterPangoGlyphCache *cache,
         value->dirty = FALSE;
       else
         {
-          /* Try adding the glyph to the global atlas... */
-          if (!clutter_pango_glyph_cache_add_to_global_atlas (cache,
-                                                              font,
-                                                              glyph,
-                                                              value) &&
-              /* If it fails try the local atlas */
-              !clutter_pango_glyph_cache_add_to_local_atlas (cache,
-                                                             context,
-                                                             font,
-                                                             glyph,
-                                                             value))
+          CoglAtlas *atlas;
+          gboolean reserved;
+
+          value->has_color = font_has_color_glyphs (font);
+
+          atlas = clutter_pango_glyph_cache_ensure_atlas (cache,
+                                                          context,
+                                                          value->has_color);
+          reserved = cogl_atlas_reserve_space (atlas,
+                                               value->draw_width + 1,
+                                               value->draw_height + 1,
+                                               key);
+          /* Evicted pages are done with once the space is reserved */
+          g_clear_object (&cache->evicted_texture);
+
+          if (!reserved)
             {
+              clutter_pango_glyph_cache_key_free (key);
               clutter_pango_glyph_cache_value_free (value);
               return NULL;
             }
@@ -338,154 +389,419 @@ clutter_pango_glyph_cache_lookup (ClutterPangoGlyphCache *cache,
           cache->has_dirty_glyphs = TRUE;
         }
 
-      key = g_new0 (PangoGlyphCacheKey, 1);
-      key->font = g_object_ref (font);
-      key->glyph = glyph;
-
       g_hash_table_insert (cache->hash_table, key, value);
     }
 
   return value;
 }
 
-static gboolean
-font_has_color_glyphs (const PangoFont *font)
+typedef struct _DirtyGlyph
+{
+  PangoGlyphCacheKey *key;
+  PangoGlyphCacheValue *value;
+} DirtyGlyph;
+
+/* A run of dirty glyphs sharing the same font. Runs are the unit of
+   work handed out to the rasterizing threads, so that each thread
+   mostly sticks to one font and contends less on its FreeType face */
+typedef struct _GlyphRun
 {
   cairo_scaled_font_t *scaled_font;
-  gboolean has_color = FALSE;
+  unsigned int first;
+  unsigned int n_glyphs;
+} GlyphRun;
 
-  scaled_font = pango_cairo_font_get_scaled_font ((PangoCairoFont *) font);
+typedef struct _RasterJob
+{
+  /* Staging bitmap shared by all threads, covering the bounds of the
+     dirty glyphs in the texture. Every glyph is clipped to its own
+     rectangle, and the rectangles don't overlap, so the threads never
+     write the same pixels. Only the pixels of the glyphs are ever
+     written, so that the staging memory grows with the dirty glyphs,
+     not with their bounds */
+  uint8_t *data;
+  cairo_format_t format;
+  int width;
+  int height;
+  int stride;
+
+  DirtyGlyph *glyphs;
+  MtkRectangle *rects;
+  GlyphRun *runs;
+  int n_runs;
+
+  int next_run;
+
+  GMutex mutex;
+  GCond cond;
+  int n_pending_workers;
+} RasterJob;
 
-  if (cairo_scaled_font_get_type (scaled_font) == CAIRO_FONT_TYPE_FT)
+static void
+clutter_pango_glyph_cache_collect_dirty_glyphs_cb (void *key_ptr,
+                                                   void *value_ptr,
+                                                   void *user_data)
+{
+  PangoGlyphCacheValue *value = value_ptr;
+  GHashTable *dirty_glyphs_by_texture = user_data;
+  DirtyGlyph dirty_glyph;
+  GArray *dirty_glyphs;
+
+  if (!value->dirty)
+    return;
+
+  /* Glyphs that don't take up any space will end up without a
+    texture. These should never become dirty so they shouldn't end up
+    here */
+  g_return_if_fail (value->texture != NULL);
+
+  dirty_glyphs = g_hash_table_lookup (dirty_glyphs_by_texture, value->texture);
+  if (!dirty_glyphs)
     {
-      FT_Face ft_face = cairo_ft_scaled_font_lock_face (scaled_font);
-      has_color = (FT_HAS_COLOR (ft_face) != 0);
-      cairo_ft_scaled_font_unlock_face (scaled_font);
+      dirty_glyphs = g_array_new (FALSE, FALSE, sizeof (DirtyGlyph));
+      g_hash_table_insert (dirty_glyphs_by_texture,
+                           value->texture, dirty_glyphs);
     }
 
-  return has_color;
+  dirty_glyph.key = key_ptr;
+  dirty_glyph.value = value;
+  g_array_append_val (dirty_glyphs, dirty_glyph);
+}
+
+static int
+compare_dirty_glyphs_by_font (const void *a,
+                              const void *b)
+{
+  const DirtyGlyph *dirty_glyph_a = a;
+  const DirtyGlyph *dirty_glyph_b = b;
+  uintptr_t font_a = (uintptr_t) dirty_glyph_a->key->font;
+  uintptr_t font_b = (uintptr_t) dirty_glyph_b->key->font;
+
+  return (font_a > font_b) - (font_a < font_b);
 }
 
 static void
-clutter_pango_glyph_cache_set_dirty_glyphs_cb (void *key_ptr,
-                                               void *value_ptr,
-                                               void *user_data)
+raster_job_draw_runs (RasterJob *job)
 {
-  PangoGlyphCacheKey *key = key_ptr;
-  PangoGlyphCacheValue *value = value_ptr;
   cairo_surface_t *surface;
   cairo_t *cr;
-  cairo_scaled_font_t *scaled_font;
-  cairo_glyph_t cairo_glyph;
-  cairo_format_t format_cairo;
-  CoglPixelFormat format_cogl;
+  int run_index;
+
+  surface = cairo_image_surface_create_for_data (job->data,
+                                                 job->format,
+                                                 job->width,
+                                                 job->height,
+                                                 job->stride);
+  cr = cairo_create (surface);
 
-  if (value->dirty)
+  cairo_set_source_rgba (cr, 1.0, 1.0, 1.0, 1.0);
+
+  while ((run_index = g_atomic_int_add (&job->next_run, 1)) < job->n_runs)
     {
-      CLUTTER_NOTE (PANGO, "redrawing glyph %i", key->glyph);
+      GlyphRun *run = &job->runs[run_index];
+      unsigned int i;
 
-      /* Glyphs that don't take up any space will end up without a
-        texture. These should never become dirty so they shouldn't end up
-        here */
-      g_return_if_fail (value->texture != NULL);
+      cairo_set_scaled_font (cr, run->scaled_font);
 
-      if (cogl_texture_get_format (value->texture) == COGL_PIXEL_FORMAT_A_8)
+      for (i = run->first; i < run->first + run->n_glyphs; i++)
         {
-          format_cairo = CAIRO_FORMAT_A8;
-          format_cogl = COGL_PIXEL_FORMAT_A_8;
+          PangoGlyphCacheValue *value = job->glyphs[i].value;
+          MtkRectangle *rect = &job->rects[i];
+          cairo_glyph_t cairo_glyph;
+
+          /* Keep the glyph from bleeding into its neighbours */
+          cairo_save (cr);
+          cairo_rectangle (cr, rect->x, rect->y, rect->width, rect->height);
+          cairo_clip (cr);
+
+          /* The staging bitmap is not cleared up front */
+          cairo_set_operator (cr, CAIRO_OPERATOR_CLEAR);
+          cairo_paint (cr);
+          cairo_set_operator (cr, CAIRO_OPERATOR_OVER);
+
+          cairo_glyph.x = rect->x - value->draw_x;
+          cairo_glyph.y = rect->y - value->draw_y;
+          /* The PangoCairo glyph numbers directly map to Cairo glyph
+            numbers */
+          cairo_glyph.index = job->glyphs[i].key->glyph;
+          cairo_show_glyphs (cr, &cairo_glyph, 1);
+
+          cairo_restore (cr);
         }
-      else
+    }
+
+  cairo_destroy (cr);
+  cairo_surface_flush (surface);
+  cairo_surface_destroy (surface);
+}
+
+static void
+raster_worker_func (gpointer data,
+                    gpointer user_data)
+{
+  RasterJob *job = data;
+
+  raster_job_draw_runs (job);
+
+  g_mutex_lock (&job->mutex);
+  job->n_pending_workers--;
+  g_cond_signal (&job->cond);
+  g_mutex_unlock (&job->mutex);
+}
+
+static int
+clutter_pango_glyph_cache_get_n_raster_workers (ClutterPangoGlyphCache *cache,
+                                                unsigned int            n_glyphs,
+                                                int                     n_runs)
+{
+  g_autoptr (GError) error = NULL;
+
+  if (G_UNLIKELY (clutter_paint_debug_flags &
+                  CLUTTER_DEBUG_DISABLE_THREADED_GLYPHS))
+    return 0;
+
+  if (n_glyphs < MIN_GLYPHS_FOR_THREADED_RASTERIZATION || n_runs < 2)
+    return 0;
+
+  if (cache->n_raster_workers == 0)
+    return 0;
+
+  if (!cache->raster_pool)
+    {
+      cache->raster_pool = g_thread_pool_new (raster_worker_func, NULL,
+                                              cache->n_raster_workers,
+                                              FALSE,
+                                              &error);
+      if (!cache->raster_pool)
+        {
+          g_warning ("Failed to create glyph rasterization threads: %s",
+                     error->message);
+          cache->n_raster_workers = 0;
+          return 0;
+        }
+    }
+
+  /* The calling thread takes part in rasterizing too */
+  return MIN (cache->n_raster_workers, n_runs - 1);
+}
+
+static void
+clutter_pango_glyph_cache_rasterize (ClutterPangoGlyphCache *cache,
+                                     RasterJob              *job,
+                                     unsigned int            n_glyphs)
+{
+  int n_workers;
+  int i;
+
+  n_workers = clutter_pango_glyph_cache_get_n_raster_workers (cache,
+                                                              n_glyphs,
+                                                              job->n_runs);
+
+  CLUTTER_NOTE (PANGO, "Rasterizing %u glyphs in %d runs using %d threads",
+                n_glyphs, job->n_runs, n_workers + 1);
+
+  if (n_workers == 0)
+    {
+      raster_job_draw_runs (job);
+      return;
+    }
+
+  g_mutex_init (&job->mutex);
+  g_cond_init (&job->cond);
+  job->n_pending_workers = n_workers;
+
+  for (i = 0; i < n_workers; i++)
+    {
+      if (!g_thread_pool_push (cache->raster_pool, job, NULL))
         {
-          format_cairo = CAIRO_FORMAT_ARGB32;
+          g_mutex_lock (&job->mutex);
+          job->n_pending_workers--;
+          g_mutex_unlock (&job->mutex);
+        }
+    }
+
+  raster_job_draw_runs (job);
+
+  /* Glyphs must be complete before the staging bitmap is uploaded */
+  g_mutex_lock (&job->mutex);
+  while (job->n_pending_workers > 0)
+    g_cond_wait (&job->cond, &job->mutex);
+  g_mutex_unlock (&job->mutex);
+
+  g_cond_clear (&job->cond);
+  g_mutex_clear (&job->mutex);
+}
+
+static void
+clutter_pango_glyph_cache_upload_dirty_glyphs (ClutterPangoGlyphCache *cache,
+                                               CoglTexture            *texture,
+                                               GArray                 *dirty_glyphs)
+{
+  g_autofree MtkRectangle *rects = NULL;
+  g_autofree GlyphRun *runs = NULL;
+  g_autofree uint8_t *data = NULL;
+  g_autoptr (GError) error = NULL;
+  RasterJob job = { 0 };
+  MtkRectangle bounds = { 0 };
+  cairo_format_t format_cairo;
+  CoglPixelFormat format_cogl;
+  int n_runs = 0;
+  int stride;
+  unsigned int i;
+
+  if (cogl_texture_get_format (texture) == COGL_PIXEL_FORMAT_A_8)
+    {
+      format_cairo = CAIRO_FORMAT_A8;
+      format_cogl = COGL_PIXEL_FORMAT_A_8;
+    }
+  else
+    {
+      format_cairo = CAIRO_FORMAT_ARGB32;
 
-          /* Cairo stores the data in native byte order as ARGB but Cogl's
-            pixel formats specify the actual byte order. Therefore we
-            need to use a different format depending on the
-            architecture */
+      /* Cairo stores the data in native byte order as ARGB but Cogl's
+        pixel formats specify the actual byte order. Therefore we
+        need to use a different format depending on the
+        architecture */
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
-          format_cogl = COGL_PIXEL_FORMAT_BGRA_8888_PRE;
+      format_cogl = COGL_PIXEL_FORMAT_BGRA_8888_PRE;
 #else
-          format_cogl = COGL_PIXEL_FORMAT_ARGB_8888_PRE;
+      format_cogl = COGL_PIXEL_FORMAT_ARGB_8888_PRE;
 #endif
+    }
+
+  g_array_sort (dirty_glyphs, compare_dirty_glyphs_by_font);
+
+  rects = g_new (MtkRectangle, dirty_glyphs->len);
+  runs = g_new (GlyphRun, dirty_glyphs->len);
+
+  for (i = 0; i < dirty_glyphs->len; i++)
+    {
+      DirtyGlyph *dirty_glyph = &g_array_index (dirty_glyphs, DirtyGlyph, i);
+      PangoGlyphCacheValue *value = dirty_glyph->value;
+      PangoFont *font = dirty_glyph->key->font;
+
+      rects[i] = (MtkRectangle) {
+        .x = value->tx_pixel,
+        .y = value->ty_pixel,
+        .width = value->draw_width,
+        .height = value->draw_height,
+      };
+
+      if (i == 0)
+        bounds = rects[i];
+      else
+        mtk_rectangle_union (&bounds, &rects[i], &bounds);
+
+      /* Pango fonts are not thread-safe, so the scaled font is looked
+         up here, once per font */
+      if (i == 0 ||
+          g_array_index (dirty_glyphs, DirtyGlyph, i - 1).key->font != font)
+        {
+          runs[n_runs++] = (GlyphRun) {
+            .scaled_font =
+              pango_cairo_font_get_scaled_font (PANGO_CAIRO_FONT (font)),
+            .first = i,
+          };
         }
 
-      surface = cairo_image_surface_create (format_cairo,
-                                            value->draw_width,
-                                            value->draw_height);
-      cr = cairo_create (surface);
-
-      scaled_font = pango_cairo_font_get_scaled_font (PANGO_CAIRO_FONT (key->font));
-      cairo_set_scaled_font (cr, scaled_font);
-
-      cairo_set_source_rgba (cr, 1.0, 1.0, 1.0, 1.0);
-
-      cairo_glyph.x = -value->draw_x;
-      cairo_glyph.y = -value->draw_y;
-      /* The PangoCairo glyph numbers directly map to Cairo glyph
-        numbers */
-      cairo_glyph.index = key->glyph;
-      cairo_show_glyphs (cr, &cairo_glyph, 1);
-
-      cairo_destroy (cr);
-      cairo_surface_flush (surface);
-
-      /* Copy the glyph to the texture */
-      cogl_texture_set_region (value->texture,
-                              0, /* src_x */
-                              0, /* src_y */
-                              value->tx_pixel, /* dst_x */
-                              value->ty_pixel, /* dst_y */
-                              value->draw_width, /* dst_width */
-                              value->draw_height, /* dst_height */
-                              value->draw_width, /* width */
-                              value->draw_height, /* height */
-                              format_cogl,
-                              cairo_image_surface_get_stride (surface),
-                              cairo_image_surface_get_data (surface));
-
-      cairo_surface_destroy (surface);
-
-      value->has_color = font_has_color_glyphs (key->font);
+      runs[n_runs - 1].n_glyphs++;
+
+      CLUTTER_NOTE (PANGO, "redrawing glyph %i", dirty_glyph->key->glyph);
+
       value->dirty = FALSE;
     }
+
+  for (i = 0; i < dirty_glyphs->len; i++)
+    {
+      rects[i].x -= bounds.x;
+      rects[i].y -= bounds.y;
+    }
+
+  /* Not cleared, so that only the pages under the glyphs are touched */
+  stride = cairo_format_stride_for_width (format_cairo, bounds.width);
+  data = g_malloc (stride * bounds.height);
+
+  job = (RasterJob) {
+    .data = data,
+    .format = format_cairo,
+    .width = bounds.width,
+    .height = bounds.height,
+    .stride = stride,
+    .glyphs = (DirtyGlyph *) dirty_glyphs->data,
+    .rects = rects,
+    .runs = runs,
+    .n_runs = n_runs,
+  };
+  clutter_pango_glyph_cache_rasterize (cache, &job, dirty_glyphs->len);
+
+  /* Copy all the glyphs to the texture at once. The staging bitmap is
+     undefined between glyphs, so the rectangles must not be merged */
+  if (!cogl_texture_set_regions (texture,
+                                 bounds.width,
+                                 bounds.height,
+                                 format_cogl,
+                                 stride,
+                                 data,
+                                 bounds.x, /* dst_x */
+                                 bounds.y, /* dst_y */
+                                 rects,
+                                 dirty_glyphs->len,
+                                 COGL_TEXTURE_SET_REGIONS_FLAG_NONE,
+                                 &error))
+    g_warning ("Failed to upload glyphs: %s", error->message);
 }
 
 void
 clutter_pango_glyph_cache_set_dirty_glyphs (ClutterPangoGlyphCache *cache)
 {
+  g_autoptr (GHashTable) dirty_glyphs_by_texture = NULL;
+  GHashTableIter iter;
+  CoglTexture *texture;
+  GArray *dirty_glyphs;
+
   /* If we know that there are no dirty glyphs then we can shortcut
      out early */
   if (!cache->has_dirty_glyphs)
     return;
 
+  dirty_glyphs_by_texture =
+    g_hash_table_new_full (NULL, NULL,
+                           NULL, (GDestroyNotify) g_array_unref);
+
   g_hash_table_foreach (cache->hash_table,
-                        clutter_pango_glyph_cache_set_dirty_glyphs_cb,
-                        NULL);
+                        clutter_pango_glyph_cache_collect_dirty_glyphs_cb,
+                        dirty_glyphs_by_texture);
+
+  g_hash_table_iter_init (&iter, dirty_glyphs_by_texture);
+  while (g_hash_table_iter_next (&iter,
+                                 (gpointer *) &texture,
+                                 (gpointer *) &dirty_glyphs))
+    clutter_pango_glyph_cache_upload_dirty_glyphs (cache, texture, dirty_glyphs);
 
   cache->has_dirty_glyphs = FALSE;
 }
 
 void
-clutter_pango_glyph_cache_add_reorganize_callback (ClutterPangoGlyphCache *cache,
-                                                   GHookFunc               func,
-                                                   void                   *user_data)
+clutter_pango_glyph_cache_add_evict_callback (ClutterPangoGlyphCache          *cache,
+                                              ClutterPangoGlyphCacheEvictFunc  func,
+                                              void                            *user_data)
 {
-  GHook *hook = g_hook_alloc (&cache->reorganize_callbacks);
+  GHook *hook = g_hook_alloc (&cache->evict_callbacks);
   hook->func = func;
   hook->data = user_data;
-  g_hook_prepend (&cache->reorganize_callbacks, hook);
+  g_hook_prepend (&cache->evict_callbacks, hook);
 }
 
 void
-clutter_pango_glyph_cache_remove_reorganize_callback (ClutterPangoGlyphCache *cache,
-                                                      GHookFunc               func,
-                                                      void                   *user_data)
+clutter_pango_glyph_cache_remove_evict_callback (ClutterPangoGlyphCache          *cache,
+                                                 ClutterPangoGlyphCacheEvictFunc  func,
+                                                 void                            *user_data)
 {
-  GHook *hook = g_hook_find_func_data (&cache->reorganize_callbacks,
+  GHook *hook = g_hook_find_func_data (&cache->evict_callbacks,
                                        FALSE,
                                        func,
                                        user_data);
 
   if (hook)
-    g_hook_destroy_link (&cache->reorganize_callbacks, hook);
+    g_hook_destroy_link (&cache->evict_callbacks, hook);
 }
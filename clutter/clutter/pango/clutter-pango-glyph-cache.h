@@ -37,6 +37,9 @@ G_BEGIN_DECLS
 
 typedef struct _ClutterPangoGlyphCache ClutterPangoGlyphCache;
 
+typedef void (* ClutterPangoGlyphCacheEvictFunc) (CoglTexture *texture,
+                                                  void        *user_data);
+
 typedef struct
 {
   CoglTexture *texture;
@@ -54,8 +57,8 @@ typedef struct
   int draw_width;
   int draw_height;
 
-  /* This will be set to TRUE when the glyph atlas is reorganized
-     which means the glyph will need to be redrawn */
+  /* This will be set to TRUE when the glyph has been given a new
+     position in the atlas which means it needs to be redrawn */
   guint dirty : 1;
   /* Set to TRUE if the glyph has colors (eg. emoji) */
   guint has_color : 1;
@@ -71,13 +74,22 @@ PangoGlyphCacheValue * clutter_pango_glyph_cache_lookup (ClutterPangoGlyphCache
                                                          PangoFont              *font,
                                                          PangoGlyph              glyph);
 
-void clutter_pango_glyph_cache_add_reorganize_callback (ClutterPangoGlyphCache *cache,
-                                                        GHookFunc               func,
-                                                        void                   *user_data);
+/* Glyphs looked up or created until the matching unpin are not evicted,
+   so that they are all still there when a layout gets drawn */
+void clutter_pango_glyph_cache_pin_used_glyphs (ClutterPangoGlyphCache *cache);
+
+void clutter_pango_glyph_cache_unpin_glyphs (ClutterPangoGlyphCache *cache);
+
+/* The callback is invoked with the texture of each atlas page whose
+   glyphs get evicted, so that anything drawing from it can be
+   rebuilt */
+void clutter_pango_glyph_cache_add_evict_callback (ClutterPangoGlyphCache          *cache,
+                                                   ClutterPangoGlyphCacheEvictFunc  func,
+                                                   void                            *user_data);
 
-void clutter_pango_glyph_cache_remove_reorganize_callback (ClutterPangoGlyphCache *cache,
-                                                           GHookFunc               func,
-                                                           void                   *user_data);
+void clutter_pango_glyph_cache_remove_evict_callback (ClutterPangoGlyphCache          *cache,
+                                                      ClutterPangoGlyphCacheEvictFunc  func,
+                                                      void                            *user_data);
 
 void clutter_pango_glyph_cache_set_dirty_glyphs (ClutterPangoGlyphCache *cache);
 
@@ -231,14 +231,17 @@ clutter_pango_layout_get_qdata_key (void)
   return key;
 }
 
+static void clutter_pango_layout_qdata_texture_evicted (CoglTexture *texture,
+                                                        void        *user_data);
+
 static void
 clutter_pango_layout_qdata_forget_display_list (PangoLayoutQdata *qdata)
 {
   if (qdata->display_list)
     {
-      clutter_pango_glyph_cache_remove_reorganize_callback
+      clutter_pango_glyph_cache_remove_evict_callback
         (qdata->renderer->glyph_cache,
-        (GHookFunc) clutter_pango_layout_qdata_forget_display_list,
+        clutter_pango_layout_qdata_texture_evicted,
         qdata);
 
       clutter_pango_display_list_free (qdata->display_list);
@@ -247,6 +250,17 @@ clutter_pango_layout_qdata_forget_display_list (PangoLayoutQdata *qdata)
     }
 }
 
+static void
+clutter_pango_layout_qdata_texture_evicted (CoglTexture *texture,
+                                            void        *user_data)
+{
+  PangoLayoutQdata *qdata = user_data;
+
+  /* Only layouts drawing glyphs from the evicted page need rebuilding */
+  if (clutter_pango_display_list_uses_texture (qdata->display_list, texture))
+    clutter_pango_layout_qdata_forget_display_list (qdata);
+}
+
 static void
 clutter_pango_render_qdata_destroy (PangoLayoutQdata *qdata)
 {
@@ -302,11 +316,11 @@ clutter_show_layout (ClutterContext    *context,
       qdata->display_list =
         clutter_pango_display_list_new (renderer->pipeline_cache);
 
-      /* Register for notification of when the glyph cache changes so
-         we can rebuild the display list */
-      clutter_pango_glyph_cache_add_reorganize_callback
+      /* Register for notification of when glyphs are evicted from the
+         glyph cache so we can rebuild the display list */
+      clutter_pango_glyph_cache_add_evict_callback
         (renderer->glyph_cache,
-        (GHookFunc) clutter_pango_layout_qdata_forget_display_list,
+        clutter_pango_layout_qdata_texture_evicted,
         qdata);
 
       renderer->display_list = qdata->display_list;
@@ -385,6 +399,7 @@ clutter_ensure_glyph_cache_for_layout (ClutterContext *context,
                                        PangoLayout    *layout)
 {
   PangoRenderer *renderer;
+  ClutterPangoGlyphCache *glyph_cache;
   PangoLayoutIter *iter;
 
   renderer = clutter_context_get_font_renderer (context);
@@ -394,6 +409,12 @@ clutter_ensure_glyph_cache_for_layout (ClutterContext *context,
   if ((iter = pango_layout_get_iter (layout)) == NULL)
     return;
 
+  glyph_cache = CLUTTER_PANGO_RENDERER (renderer)->glyph_cache;
+
+  /* Adding a glyph must not evict the page of another glyph of the
+     same layout, or it would be drawn as a box */
+  clutter_pango_glyph_cache_pin_used_glyphs (glyph_cache);
+
   do
     {
       PangoLayoutLine *line;
@@ -404,11 +425,13 @@ clutter_ensure_glyph_cache_for_layout (ClutterContext *context,
     }
   while (pango_layout_iter_next_line (iter));
 
+  clutter_pango_glyph_cache_unpin_glyphs (glyph_cache);
+
   pango_layout_iter_free (iter);
 
   /* Now that we know all of the positions are settled we'll fill in
      any dirty glyphs */
-  clutter_pango_glyph_cache_set_dirty_glyphs (CLUTTER_PANGO_RENDERER (renderer)->glyph_cache);
+  clutter_pango_glyph_cache_set_dirty_glyphs (glyph_cache);
 }
 
 static void
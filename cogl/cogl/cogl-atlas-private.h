@@ -46,6 +46,13 @@ struct _CoglAtlas
 
   GHookList pre_reorganize_callbacks;
   GHookList post_reorganize_callbacks;
+
+  /* Only used by paged atlases, most recently used page first */
+  GQueue pages;
+  unsigned int max_pages;
+  CoglAtlasEvictCallback evict_cb;
+  void *evict_user_data;
+  unsigned int n_pins;
 };
 
 void
@@ -47,8 +47,29 @@
 
 #include <stdlib.h>
 
+typedef struct _CoglAtlasPage
+{
+  CoglRectangleMap *map;
+  CoglTexture *texture;
+  gboolean pinned;
+} CoglAtlasPage;
+
 G_DEFINE_FINAL_TYPE (CoglAtlas, cogl_atlas, G_TYPE_OBJECT);
 
+/* Link of the page in the pages queue, set on the texture of the page,
+   so that the page of a texture is found without searching */
+static GQuark page_link_quark = 0;
+
+static void
+_cogl_atlas_page_free (CoglAtlasPage *page)
+{
+  /* The texture may outlive the page if its user keeps it around */
+  g_object_set_qdata (G_OBJECT (page->texture), page_link_quark, NULL);
+  g_clear_object (&page->texture);
+  g_clear_pointer (&page->map, _cogl_rectangle_map_free);
+  g_free (page);
+}
+
 static void
 cogl_atlas_dispose (GObject *object)
 {
@@ -60,9 +81,10 @@ cogl_atlas_dispose (GObject *object)
   atlas->context->atlases = g_slist_remove (atlas->context->atlases, atlas);
 
   g_clear_object (&atlas->texture);
-  g_clear_object (&atlas->context);
   if (atlas->map)
     _cogl_rectangle_map_free (atlas->map);
+  g_queue_clear_full (&atlas->pages, (GDestroyNotify) _cogl_atlas_page_free);
+  g_clear_object (&atlas->context);
 
   g_hook_list_clear (&atlas->pre_reorganize_callbacks);
   g_hook_list_clear (&atlas->post_reorganize_callbacks);
@@ -73,6 +95,7 @@ cogl_atlas_dispose (GObject *object)
 static void
 cogl_atlas_init (CoglAtlas *atlas)
 {
+  g_queue_init (&atlas->pages);
 }
 
 static void
@@ -81,6 +104,8 @@ cogl_atlas_class_init (CoglAtlasClass *class)
   GObjectClass *object_class = G_OBJECT_CLASS (class);
 
   object_class->dispose = cogl_atlas_dispose;
+
+  page_link_quark = g_quark_from_static_string ("-cogl-atlas-page-link");
 }
 
 CoglAtlas *
@@ -103,6 +128,27 @@ cogl_atlas_new (CoglContext                     *context,
   return atlas;
 }
 
+CoglAtlas *
+cogl_atlas_new_paged (CoglContext                     *context,
+                      CoglPixelFormat                  texture_format,
+                      CoglAtlasFlags                   flags,
+                      unsigned int                     max_pages,
+                      CoglAtlasUpdatePositionCallback  update_position_cb,
+                      CoglAtlasEvictCallback           evict_cb,
+                      void                            *evict_user_data)
+{
+  CoglAtlas *atlas;
+
+  g_return_val_if_fail (max_pages > 0, NULL);
+
+  atlas = cogl_atlas_new (context, texture_format, flags, update_position_cb);
+  atlas->max_pages = max_pages;
+  atlas->evict_cb = evict_cb;
+  atlas->evict_user_data = evict_user_data;
+
+  return atlas;
+}
+
 typedef struct _CoglAtlasRepositionData
 {
   /* The current user data for this texture */
@@ -394,6 +440,177 @@ _cogl_atlas_notify_post_reorganize (CoglAtlas *atlas)
   g_hook_list_invoke (&atlas->post_reorganize_callbacks, FALSE);
 }
 
+static CoglAtlasPage *
+_cogl_atlas_page_new (CoglAtlas    *atlas,
+                      unsigned int  width,
+                      unsigned int  height)
+{
+  CoglAtlasPage *page;
+  unsigned int page_width, page_height;
+  CoglTexture *texture;
+
+  _cogl_atlas_get_initial_size (atlas->context,
+                                atlas->texture_format,
+                                &page_width, &page_height);
+
+  /* A rectangle that doesn't fit in a page gets a texture of its own,
+     which is otherwise handled like any other page */
+  if (width > page_width || height > page_height)
+    {
+      page_width = width;
+      page_height = height;
+    }
+
+  texture = _cogl_atlas_create_texture (atlas, page_width, page_height);
+  if (!texture)
+    return NULL;
+
+  page = g_new0 (CoglAtlasPage, 1);
+  page->map = _cogl_rectangle_map_new (page_width, page_height, NULL);
+  page->texture = texture;
+
+  COGL_NOTE (ATLAS, "%p: Added atlas page %p sized %ux%u",
+             atlas, page, page_width, page_height);
+
+  return page;
+}
+
+static void
+_cogl_atlas_page_mark_used (CoglAtlas     *atlas,
+                            CoglAtlasPage *page)
+{
+  if (atlas->n_pins > 0)
+    page->pinned = TRUE;
+}
+
+typedef struct _CoglAtlasEvictData
+{
+  CoglAtlas *atlas;
+  CoglTexture *texture;
+} CoglAtlasEvictData;
+
+static void
+_cogl_atlas_evict_rectangle_cb (const MtkRectangle *rectangle,
+                                void               *rect_data,
+                                void               *user_data)
+{
+  CoglAtlasEvictData *data = user_data;
+  CoglAtlas *atlas = data->atlas;
+
+  atlas->evict_cb (rect_data, data->texture, atlas->evict_user_data);
+}
+
+static GList *
+_cogl_atlas_find_evictable_page (CoglAtlas *atlas)
+{
+  GList *l;
+
+  for (l = atlas->pages.tail; l; l = l->prev)
+    {
+      CoglAtlasPage *page = l->data;
+
+      if (!page->pinned)
+        return l;
+    }
+
+  return NULL;
+}
+
+static void
+_cogl_atlas_evict_page (CoglAtlas *atlas,
+                        GList     *link)
+{
+  CoglAtlasPage *page = link->data;
+
+  COGL_NOTE (ATLAS, "%p: Evicting atlas page %p with %i textures",
+             atlas, page,
+             _cogl_rectangle_map_get_n_rectangles (page->map));
+
+  /* Only the rectangles of the evicted page are affected, so rather
+     than notifying a reorganization, which invalidates everything
+     positioned in the atlas, only they are reported */
+  if (atlas->evict_cb)
+    {
+      CoglAtlasEvictData data = {
+        .atlas = atlas,
+        .texture = page->texture,
+      };
+
+      _cogl_rectangle_map_foreach (page->map,
+                                   _cogl_atlas_evict_rectangle_cb,
+                                   &data);
+    }
+
+  g_queue_delete_link (&atlas->pages, link);
+  _cogl_atlas_page_free (page);
+}
+
+static gboolean
+_cogl_atlas_reserve_space_paged (CoglAtlas    *atlas,
+                                 unsigned int  width,
+                                 unsigned int  height,
+                                 void         *user_data)
+{
+  CoglAtlasPage *page = NULL;
+  MtkRectangle new_position;
+  GList *l;
+
+  for (l = atlas->pages.head; l; l = l->next)
+    {
+      CoglAtlasPage *candidate = l->data;
+
+      if (_cogl_rectangle_map_add (candidate->map, width, height,
+                                   user_data,
+                                   &new_position))
+        {
+          page = candidate;
+          g_queue_unlink (&atlas->pages, l);
+          g_queue_push_head_link (&atlas->pages, l);
+          break;
+        }
+    }
+
+  if (!page)
+    {
+      /* The new page uses a fresh texture rather than the one of an
+         evicted page, so that no stale data is left around the new
+         rectangles. It is created first so nothing gets evicted if it
+         can't be */
+      page = _cogl_atlas_page_new (atlas, width, height);
+      if (!page)
+        {
+          COGL_NOTE (ATLAS, "%p: Could not create an atlas page", atlas);
+          return FALSE;
+        }
+
+      /* Pinned pages are kept, so the atlas temporarily grows beyond
+         its maximum while everything is pinned, and shrinks back on
+         the next evictions */
+      while (atlas->pages.length >= atlas->max_pages &&
+             (l = _cogl_atlas_find_evictable_page (atlas)))
+        _cogl_atlas_evict_page (atlas, l);
+
+      g_queue_push_head (&atlas->pages, page);
+      g_object_set_qdata (G_OBJECT (page->texture), page_link_quark,
+                          atlas->pages.head);
+
+      if (!_cogl_rectangle_map_add (page->map, width, height,
+                                    user_data,
+                                    &new_position))
+        {
+          COGL_NOTE (ATLAS, "%p: Could not fit texture in the atlas",
+                     atlas);
+          return FALSE;
+        }
+    }
+
+  _cogl_atlas_page_mark_used (atlas, page);
+
+  atlas->update_position_cb (user_data, page->texture, &new_position);
+
+  return TRUE;
+}
+
 gboolean
 cogl_atlas_reserve_space (CoglAtlas             *atlas,
                           unsigned int           width,
@@ -407,6 +624,9 @@ cogl_atlas_reserve_space (CoglAtlas             *atlas,
   gboolean ret;
   MtkRectangle new_position;
 
+  if (atlas->max_pages > 0)
+    return _cogl_atlas_reserve_space_paged (atlas, width, height, user_data);
+
   /* Check if we can fit the rectangle into the existing map */
   if (atlas->map &&
       _cogl_rectangle_map_add (atlas->map, width, height,
@@ -660,6 +880,57 @@ _cogl_atlas_copy_rectangle (CoglAtlas *atlas,
   return tex;
 }
 
+void
+cogl_atlas_mark_used (CoglAtlas   *atlas,
+                      CoglTexture *texture)
+{
+  GList *l;
+
+  l = g_object_get_qdata (G_OBJECT (texture), page_link_quark);
+  if (!l)
+    return;
+
+  if (l != atlas->pages.head)
+    {
+      g_queue_unlink (&atlas->pages, l);
+      g_queue_push_head_link (&atlas->pages, l);
+    }
+  _cogl_atlas_page_mark_used (atlas, l->data);
+}
+
+void
+cogl_atlas_pin_used_pages (CoglAtlas *atlas)
+{
+  atlas->n_pins++;
+}
+
+void
+cogl_atlas_unpin_pages (CoglAtlas *atlas)
+{
+  GList *l;
+
+  g_return_if_fail (atlas->n_pins > 0);
+
+  if (--atlas->n_pins > 0)
+    return;
+
+  for (l = atlas->pages.head; l; l = l->next)
+    {
+      CoglAtlasPage *page = l->data;
+
+      page->pinned = FALSE;
+    }
+}
+
+unsigned int
+cogl_atlas_get_n_pages (CoglAtlas *atlas)
+{
+  if (atlas->max_pages > 0)
+    return atlas->pages.length;
+  else
+    return atlas->texture ? 1 : 0;
+}
+
 void
 cogl_atlas_add_reorganize_callback (CoglAtlas            *atlas,
                                     GHookFunc             pre_callback,
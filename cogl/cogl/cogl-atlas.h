@@ -35,6 +35,11 @@ typedef void
                                      CoglTexture        *new_texture,
                                      const MtkRectangle *rect);
 
+typedef void
+(* CoglAtlasEvictCallback) (void        *rect_data,
+                            CoglTexture *texture,
+                            void        *user_data);
+
 typedef enum
 {
   COGL_ATLAS_CLEAR_TEXTURE     = (1 << 0),
@@ -60,12 +65,63 @@ cogl_atlas_new (CoglContext                    *context,
                 CoglAtlasFlags                  flags,
                 CoglAtlasUpdatePositionCallback update_position_cb);
 
+/**
+ * cogl_atlas_new_paged: (skip)
+ * @max_pages: the maximum number of textures backing the atlas
+ * @evict_cb: called for every rectangle of a page that is evicted
+ * @evict_user_data: user data passed to @evict_cb
+ *
+ * Creates an atlas made of fixed size pages, one texture each. Pages
+ * are never resized, so rectangles are never migrated. A rectangle
+ * larger than a page gets a page of its own. When all @max_pages pages
+ * are full, the least recently used page is evicted to make space,
+ * calling @evict_cb for each rectangle it contained, along with the
+ * texture of the page. As the other pages are left untouched, the
+ * reorganize callbacks are never invoked.
+ */
+COGL_EXPORT CoglAtlas *
+cogl_atlas_new_paged (CoglContext                    *context,
+                      CoglPixelFormat                 texture_format,
+                      CoglAtlasFlags                  flags,
+                      unsigned int                    max_pages,
+                      CoglAtlasUpdatePositionCallback update_position_cb,
+                      CoglAtlasEvictCallback          evict_cb,
+                      void                           *evict_user_data);
+
 COGL_EXPORT gboolean
 cogl_atlas_reserve_space (CoglAtlas             *atlas,
                           unsigned int           width,
                           unsigned int           height,
                           void                  *user_data);
 
+/**
+ * cogl_atlas_mark_used:
+ * @texture: a texture previously passed to the update position callback
+ *
+ * Marks the page backed by @texture as the most recently used one,
+ * making it the last candidate for eviction.
+ */
+COGL_EXPORT void
+cogl_atlas_mark_used (CoglAtlas   *atlas,
+                      CoglTexture *texture);
+
+/**
+ * cogl_atlas_pin_used_pages:
+ *
+ * Until the matching cogl_atlas_unpin_pages(), pages that space is
+ * reserved in or that are marked as used are never evicted. If all
+ * pages are pinned, the atlas grows beyond its maximum number of pages
+ * instead. Calls can be nested.
+ */
+COGL_EXPORT void
+cogl_atlas_pin_used_pages (CoglAtlas *atlas);
+
+COGL_EXPORT void
+cogl_atlas_unpin_pages (CoglAtlas *atlas);
+
+COGL_EXPORT unsigned int
+cogl_atlas_get_n_pages (CoglAtlas *atlas);
+
 /**
  * cogl_atlas_add_reorganize_callback: (skip)
  */
@@ -33,7 +33,9 @@
 #include "cogl/driver/gl/cogl-driver-gl-private.h"
 #include "cogl/cogl-private.h"
 #include "cogl/cogl-bitmap-private.h"
+#include "cogl/cogl-bitmap-simd.h"
 #include "cogl/cogl-context-private.h"
+#include "cogl/cogl-debug.h"
 #include "cogl/cogl-texture-private.h"
 #include "cogl/cogl-half-float.h"
 
@@ -576,6 +578,9 @@ _cogl_bitmap_convert_into_bitmap (CoglBitmap *src_bmp,
   CoglPixelFormat dst_format;
   MediumType medium_type;
   gboolean need_premult;
+  CoglBitmapSimdConverter simd_converter;
+  gboolean use_simd;
+  int src_bpp, dst_bpp;
 
   src_format = cogl_bitmap_get_format (src_bmp);
   src_rowstride = cogl_bitmap_get_rowstride (src_bmp);
@@ -637,25 +642,49 @@ _cogl_bitmap_convert_into_bitmap (CoglBitmap *src_bmp,
 
   medium_type = determine_medium_size (dst_format);
 
+  use_simd =
+    (!COGL_DEBUG_ENABLED (COGL_DEBUG_DISABLE_SIMD_CONVERSION) &&
+     cogl_bitmap_simd_converter_init (&simd_converter, src_format, dst_format));
+  src_bpp = cogl_pixel_format_get_bytes_per_pixel (src_format, 0);
+  dst_bpp = cogl_pixel_format_get_bytes_per_pixel (dst_format, 0);
+
   /* Allocate a buffer to hold a temporary RGBA row */
   tmp_row = g_malloc (width * calculate_medium_size_pixel_size (medium_type));
 
-  /* FIXME: Optimize */
   for (y = 0; y < height; y++)
     {
+      int row_width = width;
+
       src = src_data + y * src_rowstride;
       dst = dst_data + y * dst_rowstride;
 
+      /* Let the SIMD kernels convert as much of the row as they can,
+         the generic code below takes care of the remaining pixels */
+      if (use_simd)
+        {
+          int n_converted;
+
+          n_converted =
+            cogl_bitmap_simd_converter_convert_row (&simd_converter,
+                                                    src, dst, width);
+          if (n_converted == width)
+            continue;
+
+          src += n_converted * src_bpp;
+          dst += n_converted * dst_bpp;
+          row_width -= n_converted;
+        }
+
       switch (medium_type)
         {
         case MEDIUM_TYPE_8:
-          _cogl_unpack_8 (src_format, src, tmp_row, width);
+          _cogl_unpack_8 (src_format, src, tmp_row, row_width);
           break;
         case MEDIUM_TYPE_16:
-          _cogl_unpack_16 (src_format, src, tmp_row, width);
+          _cogl_unpack_16 (src_format, src, tmp_row, row_width);
           break;
         case MEDIUM_TYPE_FLOAT:
-          _cogl_unpack_float (src_format, src, tmp_row, width);
+          _cogl_unpack_float (src_format, src, tmp_row, row_width);
           break;
         }
 
@@ -667,13 +696,13 @@ _cogl_bitmap_convert_into_bitmap (CoglBitmap *src_bmp,
               switch (medium_type)
                 {
                 case MEDIUM_TYPE_8:
-                  _cogl_bitmap_premult_unpacked_span_8 (tmp_row, width);
+                  _cogl_bitmap_premult_unpacked_span_8 (tmp_row, row_width);
                   break;
                 case MEDIUM_TYPE_16:
-                  _cogl_bitmap_premult_unpacked_span_16 (tmp_row, width);
+                  _cogl_bitmap_premult_unpacked_span_16 (tmp_row, row_width);
                   break;
                 case MEDIUM_TYPE_FLOAT:
-                  _cogl_bitmap_premult_unpacked_span_float (tmp_row, width);
+                  _cogl_bitmap_premult_unpacked_span_float (tmp_row, row_width);
                   break;
                 }
             }
@@ -682,13 +711,13 @@ _cogl_bitmap_convert_into_bitmap (CoglBitmap *src_bmp,
               switch (medium_type)
                 {
                 case MEDIUM_TYPE_8:
-                  _cogl_bitmap_unpremult_unpacked_span_8 (tmp_row, width);
+                  _cogl_bitmap_unpremult_unpacked_span_8 (tmp_row, row_width);
                   break;
                 case MEDIUM_TYPE_16:
-                  _cogl_bitmap_unpremult_unpacked_span_16 (tmp_row, width);
+                  _cogl_bitmap_unpremult_unpacked_span_16 (tmp_row, row_width);
                   break;
                 case MEDIUM_TYPE_FLOAT:
-                  _cogl_bitmap_unpremult_unpacked_span_float (tmp_row, width);
+                  _cogl_bitmap_unpremult_unpacked_span_float (tmp_row, row_width);
                   break;
                 }
             }
@@ -697,13 +726,13 @@ _cogl_bitmap_convert_into_bitmap (CoglBitmap *src_bmp,
       switch (medium_type)
         {
         case MEDIUM_TYPE_8:
-          _cogl_pack_8 (dst_format, tmp_row, dst, width);
+          _cogl_pack_8 (dst_format, tmp_row, dst, row_width);
           break;
         case MEDIUM_TYPE_16:
-          _cogl_pack_16 (dst_format, tmp_row, dst, width);
+          _cogl_pack_16 (dst_format, tmp_row, dst, row_width);
           break;
         case MEDIUM_TYPE_FLOAT:
-          _cogl_pack_float (dst_format, tmp_row, dst, width);
+          _cogl_pack_float (dst_format, tmp_row, dst, row_width);
           break;
         }
     }
@@ -843,6 +872,8 @@ _cogl_bitmap_unpremult (CoglBitmap *bmp,
   CoglPixelFormat format;
   int width, height;
   int rowstride;
+  CoglBitmapSimdConverter simd_converter;
+  gboolean use_simd;
 
   format = cogl_bitmap_get_format (bmp);
   width = cogl_bitmap_get_width (bmp);
@@ -864,10 +895,30 @@ _cogl_bitmap_unpremult (CoglBitmap *bmp,
   else
     tmp_row = g_malloc (sizeof (uint16_t) * 4 * width);
 
+  use_simd =
+    (tmp_row == NULL &&
+     !COGL_DEBUG_ENABLED (COGL_DEBUG_DISABLE_SIMD_CONVERSION) &&
+     cogl_bitmap_simd_converter_init (&simd_converter,
+                                      format | COGL_PREMULT_BIT,
+                                      format & ~COGL_PREMULT_BIT));
+
   for (y = 0; y < height; y++)
     {
+      int row_width = width;
+
       p = (uint8_t*) data + y * rowstride;
 
+      if (use_simd)
+        {
+          int n_converted;
+
+          n_converted =
+            cogl_bitmap_simd_converter_convert_row (&simd_converter,
+                                                    p, p, width);
+          p += n_converted * 4;
+          row_width -= n_converted;
+        }
+
       if (tmp_row)
         {
           _cogl_unpack_16 (format, p, tmp_row, width);
@@ -878,7 +929,7 @@ _cogl_bitmap_unpremult (CoglBitmap *bmp,
         {
           if (format & COGL_AFIRST_BIT)
             {
-              for (x = 0; x < width; x++)
+              for (x = 0; x < row_width; x++)
                 {
                   if (p[0] == 0)
                     _cogl_unpremult_alpha_0 (p);
@@ -888,7 +939,7 @@ _cogl_bitmap_unpremult (CoglBitmap *bmp,
                 }
             }
           else
-            _cogl_bitmap_unpremult_unpacked_span_8 (p, width);
+            _cogl_bitmap_unpremult_unpacked_span_8 (p, row_width);
         }
     }
 
@@ -911,6 +962,8 @@ _cogl_bitmap_premult (CoglBitmap *bmp,
   CoglPixelFormat format;
   int width, height;
   int rowstride;
+  CoglBitmapSimdConverter simd_converter;
+  gboolean use_simd;
 
   format = cogl_bitmap_get_format (bmp);
   width = cogl_bitmap_get_width (bmp);
@@ -931,10 +984,30 @@ _cogl_bitmap_premult (CoglBitmap *bmp,
   else
     tmp_row = g_malloc (sizeof (uint16_t) * 4 * width);
 
+  use_simd =
+    (tmp_row == NULL &&
+     !COGL_DEBUG_ENABLED (COGL_DEBUG_DISABLE_SIMD_CONVERSION) &&
+     cogl_bitmap_simd_converter_init (&simd_converter,
+                                      format & ~COGL_PREMULT_BIT,
+                                      format | COGL_PREMULT_BIT));
+
   for (y = 0; y < height; y++)
     {
+      int row_width = width;
+
       p = (uint8_t*) data + y * rowstride;
 
+      if (use_simd)
+        {
+          int n_converted;
+
+          n_converted =
+            cogl_bitmap_simd_converter_convert_row (&simd_converter,
+                                                    p, p, width);
+          p += n_converted * 4;
+          row_width -= n_converted;
+        }
+
       if (tmp_row)
         {
           _cogl_unpack_16 (format, p, tmp_row, width);
@@ -945,14 +1018,14 @@ _cogl_bitmap_premult (CoglBitmap *bmp,
         {
           if (format & COGL_AFIRST_BIT)
             {
-              for (x = 0; x < width; x++)
+              for (x = 0; x < row_width; x++)
                 {
                   _cogl_premult_alpha_first (p);
                   p += 4;
                 }
             }
           else
-            _cogl_bitmap_premult_unpacked_span_8 (p, width);
+            _cogl_bitmap_premult_unpacked_span_8 (p, row_width);
         }
     }
 
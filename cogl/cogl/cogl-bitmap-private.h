@@ -106,16 +106,16 @@ _cogl_bitmap_convert_for_upload (CoglBitmap *src_bmp,
                                  CoglPixelFormat internal_format,
                                  GError **error);
 
-gboolean
+COGL_EXPORT_TEST gboolean
 _cogl_bitmap_convert_into_bitmap (CoglBitmap *src_bmp,
                                   CoglBitmap *dst_bmp,
                                   GError **error);
 
-gboolean
+COGL_EXPORT_TEST gboolean
 _cogl_bitmap_unpremult (CoglBitmap *dst_bmp,
                         GError **error);
 
-gboolean
+COGL_EXPORT_TEST gboolean
 _cogl_bitmap_premult (CoglBitmap *dst_bmp,
                       GError **error);
 
@@ -0,0 +1,543 @@
+/*
+ * Cogl
+ *
+ * A Low Level GPU Graphics and Utilities API
+ *
+ * Copyright (C) 2026 Red Hat Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ */
+
+/*
+ * The kernels in here have to produce exactly the same results as the
+ * generic unpack, (un)premultiply and pack functions in
+ * cogl-bitmap-conversion.c, so that which one ends up being used never
+ * makes a visible difference. They are selected at runtime based on
+ * the detected CPU capabilities, except for NEON which is always
+ * available on aarch64.
+ */
+
+#include "config.h"
+
+#include "cogl/cogl-bitmap-simd.h"
+#include "cogl/cogl-cpu-caps.h"
+
+#include <string.h>
+
+#if defined(__x86_64) && defined(__GNUC__)
+#include <immintrin.h>
+#define COGL_BITMAP_SIMD_X86
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define COGL_BITMAP_SIMD_NEON
+#endif
+
+typedef struct
+{
+  /* Position of the red, green, blue and alpha (or padding) components */
+  uint8_t position[4];
+  gboolean has_alpha;
+  gboolean is_half_float;
+} PixelLayout;
+
+static gboolean
+get_pixel_layout (CoglPixelFormat  format,
+                  PixelLayout     *layout)
+{
+  static const uint8_t rgba[4] = { 0, 1, 2, 3 };
+  static const uint8_t bgra[4] = { 2, 1, 0, 3 };
+  static const uint8_t argb[4] = { 1, 2, 3, 0 };
+  static const uint8_t abgr[4] = { 3, 2, 1, 0 };
+  const uint8_t *position;
+
+  switch (format)
+    {
+    case COGL_PIXEL_FORMAT_RGBX_8888:
+    case COGL_PIXEL_FORMAT_RGBA_8888:
+    case COGL_PIXEL_FORMAT_RGBA_8888_PRE:
+    case COGL_PIXEL_FORMAT_RGBX_FP_16161616:
+    case COGL_PIXEL_FORMAT_RGBA_FP_16161616:
+    case COGL_PIXEL_FORMAT_RGBA_FP_16161616_PRE:
+      position = rgba;
+      break;
+    case COGL_PIXEL_FORMAT_BGRX_8888:
+    case COGL_PIXEL_FORMAT_BGRA_8888:
+    case COGL_PIXEL_FORMAT_BGRA_8888_PRE:
+    case COGL_PIXEL_FORMAT_BGRX_FP_16161616:
+    case COGL_PIXEL_FORMAT_BGRA_FP_16161616:
+    case COGL_PIXEL_FORMAT_BGRA_FP_16161616_PRE:
+      position = bgra;
+      break;
+    case COGL_PIXEL_FORMAT_XRGB_8888:
+    case COGL_PIXEL_FORMAT_ARGB_8888:
+    case COGL_PIXEL_FORMAT_ARGB_8888_PRE:
+    case COGL_PIXEL_FORMAT_XRGB_FP_16161616:
+    case COGL_PIXEL_FORMAT_ARGB_FP_16161616:
+    case COGL_PIXEL_FORMAT_ARGB_FP_16161616_PRE:
+      position = argb;
+      break;
+    case COGL_PIXEL_FORMAT_XBGR_8888:
+    case COGL_PIXEL_FORMAT_ABGR_8888:
+    case COGL_PIXEL_FORMAT_ABGR_8888_PRE:
+    case COGL_PIXEL_FORMAT_XBGR_FP_16161616:
+    case COGL_PIXEL_FORMAT_ABGR_FP_16161616:
+    case COGL_PIXEL_FORMAT_ABGR_FP_16161616_PRE:
+      position = abgr;
+      break;
+    default:
+      return FALSE;
+    }
+
+  memcpy (layout->position, position, sizeof (layout->position));
+  layout->has_alpha = !!(format & COGL_A_BIT);
+  layout->is_half_float = cogl_pixel_format_get_bytes_per_pixel (format, 0) == 8;
+
+  return TRUE;
+}
+
+#ifdef COGL_BITMAP_SIMD_X86
+
+static int __attribute__ ((target ("ssse3")))
+swizzle_row_ssse3 (const CoglBitmapSimdConverter *converter,
+                   const uint8_t                 *src,
+                   uint8_t                       *dst,
+                   int                            width)
+{
+  __m128i shuffle = _mm_loadu_si128 ((const __m128i *) converter->shuffle);
+  __m128i alpha_or = _mm_loadu_si128 ((const __m128i *) converter->alpha_or);
+  int x;
+
+  for (x = 0; x + 4 <= width; x += 4)
+    {
+      __m128i pixels = _mm_loadu_si128 ((const __m128i *) (src + x * 4));
+
+      pixels = _mm_or_si128 (_mm_shuffle_epi8 (pixels, shuffle), alpha_or);
+      _mm_storeu_si128 ((__m128i *) (dst + x * 4), pixels);
+    }
+
+  return x;
+}
+
+static int __attribute__ ((target ("avx2")))
+swizzle_row_avx2 (const CoglBitmapSimdConverter *converter,
+                  const uint8_t                 *src,
+                  uint8_t                       *dst,
+                  int                            width)
+{
+  __m256i shuffle =
+    _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i *) converter->shuffle));
+  __m256i alpha_or =
+    _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i *) converter->alpha_or));
+  int x;
+
+  for (x = 0; x + 8 <= width; x += 8)
+    {
+      __m256i pixels = _mm256_loadu_si256 ((const __m256i *) (src + x * 4));
+
+      pixels = _mm256_or_si256 (_mm256_shuffle_epi8 (pixels, shuffle),
+                                alpha_or);
+      _mm256_storeu_si256 ((__m256i *) (dst + x * 4), pixels);
+    }
+
+  return x;
+}
+
+/* Same as the MULT() macro used by the generic code, i.e. the no
+ * division form of floor((c * a + 128) / 255), on 16 bit lanes. */
+static inline __m256i __attribute__ ((target ("avx2")))
+premult_8_pixels_avx2 (__m256i pixels,
+                       __m256i alpha_shuffle,
+                       __m256i alpha_mask)
+{
+  __m256i zero = _mm256_setzero_si256 ();
+  __m256i half = _mm256_set1_epi16 (128);
+  __m256i alpha = _mm256_shuffle_epi8 (pixels, alpha_shuffle);
+  __m256i lo, hi;
+
+  lo = _mm256_mullo_epi16 (_mm256_unpacklo_epi8 (pixels, zero),
+                           _mm256_unpacklo_epi8 (alpha, zero));
+  hi = _mm256_mullo_epi16 (_mm256_unpackhi_epi8 (pixels, zero),
+                           _mm256_unpackhi_epi8 (alpha, zero));
+  lo = _mm256_add_epi16 (lo, half);
+  hi = _mm256_add_epi16 (hi, half);
+  lo = _mm256_srli_epi16 (_mm256_add_epi16 (lo, _mm256_srli_epi16 (lo, 8)), 8);
+  hi = _mm256_srli_epi16 (_mm256_add_epi16 (hi, _mm256_srli_epi16 (hi, 8)), 8);
+
+  return _mm256_blendv_epi8 (_mm256_packus_epi16 (lo, hi), pixels, alpha_mask);
+}
+
+/* Computes (c * 255) / a like the generic code, keeping only the low
+ * byte of the result just like its store to an 8 bit component does.
+ * The float quotient is correctly rounded and thus can only ever end
+ * up one above the truncated integer quotient, which is corrected for
+ * afterwards. */
+static inline __m256i __attribute__ ((target ("avx2")))
+unpremult_components_avx2 (__m256i components,
+                           __m256i alpha)
+{
+  __m256i zero = _mm256_setzero_si256 ();
+  __m256i zero_alpha = _mm256_cmpeq_epi32 (alpha, zero);
+  __m256i numerator;
+  __m256i quotient;
+
+  alpha = _mm256_max_epi32 (alpha, _mm256_set1_epi32 (1));
+  numerator = _mm256_mullo_epi32 (components, _mm256_set1_epi32 (255));
+  quotient = _mm256_cvttps_epi32 (_mm256_div_ps (_mm256_cvtepi32_ps (numerator),
+                                                 _mm256_cvtepi32_ps (alpha)));
+  quotient = _mm256_add_epi32 (quotient,
+                               _mm256_cmpgt_epi32 (_mm256_mullo_epi32 (quotient,
+                                                                       alpha),
+                                                   numerator));
+  quotient = _mm256_and_si256 (quotient, _mm256_set1_epi32 (0xff));
+
+  return _mm256_andnot_si256 (zero_alpha, quotient);
+}
+
+static inline __m128i __attribute__ ((target ("avx2")))
+unpremult_4_pixels_avx2 (__m128i pixels,
+                         __m128i alpha_shuffle,
+                         __m128i alpha_mask)
+{
+  __m128i alpha = _mm_shuffle_epi8 (pixels, alpha_shuffle);
+  __m256i lo, hi, packed;
+
+  lo = unpremult_components_avx2 (_mm256_cvtepu8_epi32 (pixels),
+                                  _mm256_cvtepu8_epi32 (alpha));
+  hi = unpremult_components_avx2 (_mm256_cvtepu8_epi32 (_mm_srli_si128 (pixels, 8)),
+                                  _mm256_cvtepu8_epi32 (_mm_srli_si128 (alpha, 8)));
+
+  /* Packing works within each 128 bit lane, so put the four pixels
+   * back in order before narrowing them down to bytes */
+  packed = _mm256_permute4x64_epi64 (_mm256_packus_epi32 (lo, hi),
+                                     _MM_SHUFFLE (3, 1, 2, 0));
+  return _mm_blendv_epi8 (_mm_packus_epi16 (_mm256_castsi256_si128 (packed),
+                                            _mm256_extracti128_si256 (packed, 1)),
+                          pixels,
+                          alpha_mask);
+}
+
+static int __attribute__ ((target ("avx2")))
+swizzle_premult_row_avx2 (const CoglBitmapSimdConverter *converter,
+                          const uint8_t                 *src,
+                          uint8_t                       *dst,
+                          int                            width)
+{
+  __m256i shuffle =
+    _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i *) converter->shuffle));
+  __m256i alpha_shuffle =
+    _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i *) converter->alpha_shuffle));
+  __m256i alpha_mask =
+    _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i *) converter->alpha_mask));
+  int x;
+
+  for (x = 0; x + 8 <= width; x += 8)
+    {
+      __m256i pixels = _mm256_loadu_si256 ((const __m256i *) (src + x * 4));
+
+      pixels = _mm256_shuffle_epi8 (pixels, shuffle);
+      pixels = premult_8_pixels_avx2 (pixels, alpha_shuffle, alpha_mask);
+      _mm256_storeu_si256 ((__m256i *) (dst + x * 4), pixels);
+    }
+
+  return x;
+}
+
+static int __attribute__ ((target ("avx2")))
+swizzle_unpremult_row_avx2 (const CoglBitmapSimdConverter *converter,
+                            const uint8_t                 *src,
+                            uint8_t                       *dst,
+                            int                            width)
+{
+  __m128i shuffle = _mm_loadu_si128 ((const __m128i *) converter->shuffle);
+  __m128i alpha_shuffle =
+    _mm_loadu_si128 ((const __m128i *) converter->alpha_shuffle);
+  __m128i alpha_mask = _mm_loadu_si128 ((const __m128i *) converter->alpha_mask);
+  int x;
+
+  for (x = 0; x + 4 <= width; x += 4)
+    {
+      __m128i pixels = _mm_loadu_si128 ((const __m128i *) (src + x * 4));
+
+      pixels = _mm_shuffle_epi8 (pixels, shuffle);
+      pixels = unpremult_4_pixels_avx2 (pixels, alpha_shuffle, alpha_mask);
+      _mm_storeu_si128 ((__m128i *) (dst + x * 4), pixels);
+    }
+
+  return x;
+}
+
+/* Matches UNPACK_BYTE() followed by PACK_SHORT() of the float medium */
+static int __attribute__ ((target ("ssse3,sse4.1,avx,f16c")))
+unorm8_to_half_row_f16c (const CoglBitmapSimdConverter *converter,
+                         const uint8_t                 *src,
+                         uint8_t                       *dst,
+                         int                            width)
+{
+  __m128i shuffle = _mm_loadu_si128 ((const __m128i *) converter->shuffle);
+  __m128i alpha_or = _mm_loadu_si128 ((const __m128i *) converter->alpha_or);
+  __m128 max = _mm_set1_ps (255.0f);
+  int x;
+
+  for (x = 0; x + 4 <= width; x += 4)
+    {
+      __m128i pixels = _mm_loadu_si128 ((const __m128i *) (src + x * 4));
+      int i;
+
+      pixels = _mm_or_si128 (_mm_shuffle_epi8 (pixels, shuffle), alpha_or);
+
+      for (i = 0; i < 4; i++)
+        {
+          __m128 components = _mm_cvtepi32_ps (_mm_cvtepu8_epi32 (pixels));
+
+          components = _mm_div_ps (components, max);
+          _mm_storel_epi64 ((__m128i *) (dst + (x + i) * 8),
+                            _mm_cvtps_ph (components, _MM_FROUND_TO_NEAREST_INT));
+          pixels = _mm_srli_si128 (pixels, 4);
+        }
+    }
+
+  return x;
+}
+
+/* Matches UNPACK_SHORT() of the 8 bit medium, which clamps the value
+ * to [0, 1] (turning NaN into 1) and then truncates it */
+static inline __m128i __attribute__ ((target ("sse4.1,avx,f16c")))
+half_to_unorm8_components_f16c (const uint8_t *src)
+{
+  __m128 components;
+
+  components = _mm_cvtph_ps (_mm_loadl_epi64 ((const __m128i *) src));
+  components = _mm_max_ps (_mm_min_ps (components, _mm_set1_ps (1.0f)),
+                           _mm_setzero_ps ());
+
+  return _mm_cvttps_epi32 (_mm_mul_ps (components, _mm_set1_ps (255.0f)));
+}
+
+static int __attribute__ ((target ("ssse3,sse4.1,avx,f16c")))
+half_to_unorm8_row_f16c (const CoglBitmapSimdConverter *converter,
+                         const uint8_t                 *src,
+                         uint8_t                       *dst,
+                         int                            width)
+{
+  __m128i shuffle = _mm_loadu_si128 ((const __m128i *) converter->shuffle);
+  __m128i alpha_or = _mm_loadu_si128 ((const __m128i *) converter->alpha_or);
+  int x;
+
+  for (x = 0; x + 4 <= width; x += 4)
+    {
+      const uint8_t *p = src + x * 8;
+      __m128i lo, hi, pixels;
+
+      lo = _mm_packus_epi32 (half_to_unorm8_components_f16c (p),
+                             half_to_unorm8_components_f16c (p + 8));
+      hi = _mm_packus_epi32 (half_to_unorm8_components_f16c (p + 16),
+                             half_to_unorm8_components_f16c (p + 24));
+      pixels = _mm_packus_epi16 (lo, hi);
+
+      pixels = _mm_or_si128 (_mm_shuffle_epi8 (pixels, shuffle), alpha_or);
+      _mm_storeu_si128 ((__m128i *) (dst + x * 4), pixels);
+    }
+
+  return x;
+}
+
+#endif /* COGL_BITMAP_SIMD_X86 */
+
+#ifdef COGL_BITMAP_SIMD_NEON
+
+static int
+swizzle_row_neon (const CoglBitmapSimdConverter *converter,
+                  const uint8_t                 *src,
+                  uint8_t                       *dst,
+                  int                            width)
+{
+  /* Out of range indices, such as 0x80, give 0 with TBL */
+  uint8x16_t shuffle = vld1q_u8 (converter->shuffle);
+  uint8x16_t alpha_or = vld1q_u8 (converter->alpha_or);
+  int x;
+
+  for (x = 0; x + 4 <= width; x += 4)
+    {
+      uint8x16_t pixels = vld1q_u8 (src + x * 4);
+
+      pixels = vorrq_u8 (vqtbl1q_u8 (pixels, shuffle), alpha_or);
+      vst1q_u8 (dst + x * 4, pixels);
+    }
+
+  return x;
+}
+
+static inline uint8x8_t
+premult_component_neon (uint8x8_t component,
+                        uint8x8_t alpha)
+{
+  uint16x8_t t = vmull_u8 (component, alpha);
+
+  /* ((t + 128) + ((t + 128) >> 8)) >> 8 */
+  return vraddhn_u16 (t, vrshrq_n_u16 (t, 8));
+}
+
+static int
+swizzle_premult_row_neon (const CoglBitmapSimdConverter *converter,
+                          const uint8_t                 *src,
+                          uint8_t                       *dst,
+                          int                            width)
+{
+  uint8x16_t shuffle = vld1q_u8 (converter->shuffle);
+  uint8x16_t alpha_shuffle = vld1q_u8 (converter->alpha_shuffle);
+  uint8x16_t alpha_mask = vld1q_u8 (converter->alpha_mask);
+  int x;
+
+  for (x = 0; x + 4 <= width; x += 4)
+    {
+      uint8x16_t pixels = vld1q_u8 (src + x * 4);
+      uint8x16_t alpha;
+      uint8x16_t premultiplied;
+
+      pixels = vqtbl1q_u8 (pixels, shuffle);
+      alpha = vqtbl1q_u8 (pixels, alpha_shuffle);
+      premultiplied =
+        vcombine_u8 (premult_component_neon (vget_low_u8 (pixels),
+                                             vget_low_u8 (alpha)),
+                     premult_component_neon (vget_high_u8 (pixels),
+                                             vget_high_u8 (alpha)));
+      vst1q_u8 (dst + x * 4, vbslq_u8 (alpha_mask, pixels, premultiplied));
+    }
+
+  return x;
+}
+
+#endif /* COGL_BITMAP_SIMD_NEON */
+
+static CoglBitmapSimdRowFunc
+choose_row_func (const PixelLayout *src_layout,
+                 const PixelLayout *dst_layout,
+                 gboolean           need_premult,
+                 gboolean           premultiply)
+{
+  if (src_layout->is_half_float || dst_layout->is_half_float)
+    {
+      if (need_premult)
+        return NULL;
+
+#ifdef COGL_BITMAP_SIMD_X86
+      if (cogl_cpu_has_cap (COGL_CPU_CAP_F16C) &&
+          cogl_cpu_has_cap (COGL_CPU_CAP_SSSE3) &&
+          cogl_cpu_has_cap (COGL_CPU_CAP_SSE4_1))
+        {
+          if (src_layout->is_half_float)
+            return half_to_unorm8_row_f16c;
+          else
+            return unorm8_to_half_row_f16c;
+        }
+#endif
+
+      return NULL;
+    }
+
+#ifdef COGL_BITMAP_SIMD_X86
+  if (cogl_cpu_has_cap (COGL_CPU_CAP_AVX2))
+    {
+      if (!need_premult)
+        return swizzle_row_avx2;
+      else if (premultiply)
+        return swizzle_premult_row_avx2;
+      else
+        return swizzle_unpremult_row_avx2;
+    }
+
+  if (cogl_cpu_has_cap (COGL_CPU_CAP_SSSE3) && !need_premult)
+    return swizzle_row_ssse3;
+#endif
+
+#ifdef COGL_BITMAP_SIMD_NEON
+  if (!need_premult)
+    return swizzle_row_neon;
+  else if (premultiply)
+    return swizzle_premult_row_neon;
+#endif
+
+  return NULL;
+}
+
+gboolean
+cogl_bitmap_simd_converter_init (CoglBitmapSimdConverter *converter,
+                                 CoglPixelFormat          src_format,
+                                 CoglPixelFormat          dst_format)
+{
+  PixelLayout src_layout;
+  PixelLayout dst_layout;
+  gboolean need_premult;
+  int i, c;
+
+  if (!get_pixel_layout (src_format, &src_layout) ||
+      !get_pixel_layout (dst_format, &dst_layout))
+    return FALSE;
+
+  /* Half float to half float conversions aren't worth it */
+  if (src_layout.is_half_float && dst_layout.is_half_float)
+    return FALSE;
+
+  need_premult = ((src_format & COGL_PREMULT_BIT) !=
+                  (dst_format & COGL_PREMULT_BIT) &&
+                  src_layout.has_alpha && dst_layout.has_alpha);
+
+  converter->row_func = choose_row_func (&src_layout, &dst_layout,
+                                         need_premult,
+                                         !!(dst_format & COGL_PREMULT_BIT));
+  if (!converter->row_func)
+    return FALSE;
+
+  memset (converter->alpha_or, 0, sizeof (converter->alpha_or));
+  memset (converter->alpha_mask, 0, sizeof (converter->alpha_mask));
+
+  for (i = 0; i < 4; i++)
+    {
+      int dst_alpha = i * 4 + dst_layout.position[3];
+
+      for (c = 0; c < 3; c++)
+        {
+          converter->shuffle[i * 4 + dst_layout.position[c]] =
+            i * 4 + src_layout.position[c];
+        }
+
+      /* Missing alpha is always read and written as fully opaque */
+      if (src_layout.has_alpha && dst_layout.has_alpha)
+        {
+          converter->shuffle[dst_alpha] = i * 4 + src_layout.position[3];
+        }
+      else
+        {
+          converter->shuffle[dst_alpha] = 0x80;
+          converter->alpha_or[dst_alpha] = 0xff;
+        }
+
+      for (c = 0; c < 4; c++)
+        converter->alpha_shuffle[i * 4 + c] = dst_alpha;
+      converter->alpha_mask[dst_alpha] = 0xff;
+    }
+
+  return TRUE;
+}
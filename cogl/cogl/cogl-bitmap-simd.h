@@ -0,0 +1,83 @@
+/*
+ * Cogl
+ *
+ * A Low Level GPU Graphics and Utilities API
+ *
+ * Copyright (C) 2026 Red Hat Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ */
+
+#pragma once
+
+#include "cogl/cogl-pixel-format.h"
+
+#include <glib.h>
+#include <stdint.h>
+
+typedef struct _CoglBitmapSimdConverter CoglBitmapSimdConverter;
+
+typedef int (* CoglBitmapSimdRowFunc) (const CoglBitmapSimdConverter *converter,
+                                       const uint8_t                 *src,
+                                       uint8_t                       *dst,
+                                       int                            width);
+
+/*
+ * Converts rows between pairs of 32 bit RGBA-like formats, optionally
+ * (un)premultiplying them on the way, and between those and their
+ * half float counterparts. All tables describe four 8 bit pixels and
+ * are laid out in destination component order.
+ */
+struct _CoglBitmapSimdConverter
+{
+  CoglBitmapSimdRowFunc row_func;
+
+  /* Source byte for each destination byte, 0x80 to clear it */
+  uint8_t shuffle[16];
+  /* Bytes to set after shuffling, for alpha components missing on
+   * either side of the conversion */
+  uint8_t alpha_or[16];
+  /* The alpha byte of the pixel each destination byte belongs to */
+  uint8_t alpha_shuffle[16];
+  /* 0xff for the alpha bytes, which premultiplication leaves alone */
+  uint8_t alpha_mask[16];
+};
+
+gboolean cogl_bitmap_simd_converter_init (CoglBitmapSimdConverter *converter,
+                                          CoglPixelFormat          src_format,
+                                          CoglPixelFormat          dst_format);
+
+/*
+ * Converts as many pixels from the beginning of the row as the
+ * selected kernel can handle at once, and returns how many that were.
+ * The remainder is left to the generic code. Converting in place is
+ * supported as long as the source and destination pixel sizes match.
+ */
+static inline int
+cogl_bitmap_simd_converter_convert_row (const CoglBitmapSimdConverter *converter,
+                                        const uint8_t                 *src,
+                                        uint8_t                       *dst,
+                                        int                            width)
+{
+  return converter->row_func (converter, src, dst, width);
+}
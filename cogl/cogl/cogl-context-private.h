@@ -47,6 +47,7 @@
 #include "cogl/cogl-sampler-cache-private.h"
 #include "cogl/cogl-framebuffer-private.h"
 #include "cogl/cogl-offscreen-private.h"
+#include "cogl/cogl-offscreen-pool-private.h"
 #include "cogl/cogl-onscreen-private.h"
 #include "cogl/cogl-private.h"
 #include "cogl/winsys/cogl-winsys-private.h"
@@ -227,6 +228,8 @@ struct _CoglContext
 
   GHashTable *named_pipelines;
 
+  CoglOffscreenPool *offscreen_pool;
+
   /* This defines a list of function pointers that Cogl uses from
      either GL or GLES. All functions are accessed indirectly through
      these pointers rather than linking to them directly */
@@ -66,6 +66,8 @@ cogl_context_dispose (GObject *object)
   CoglContext *context = COGL_CONTEXT (object);
   const CoglWinsysVtable *winsys = _cogl_context_get_winsys (context);
 
+  g_clear_pointer (&context->offscreen_pool, cogl_offscreen_pool_free);
+
   winsys->context_deinit (context);
 
   if (context->default_gl_texture_2d_tex)
@@ -358,6 +360,8 @@ cogl_context_new (CoglDisplay *display,
   context->named_pipelines =
     g_hash_table_new_full (NULL, NULL, NULL, g_object_unref);
 
+  context->offscreen_pool = cogl_offscreen_pool_new (context);
+
   return context;
 }
 
@@ -60,8 +60,9 @@ xgetbv (void)
 }
 
 static inline void
-cpuid (uint32_t  ax,
-       uint32_t *p)
+cpuid_count (uint32_t  ax,
+             uint32_t  cx,
+             uint32_t *p)
 {
 #ifdef __GCC_ASM_FLAG_OUTPUTS__
    __asm __volatile (
@@ -70,7 +71,8 @@ cpuid (uint32_t  ax,
        "=b" (p[1]),
        "=c" (p[2]),
        "=d" (p[3])
-     : "0" (ax)
+     : "0" (ax),
+       "2" (cx)
    );
 #else
    p[0] = 0;
@@ -79,6 +81,13 @@ cpuid (uint32_t  ax,
    p[3] = 0;
 #endif
 }
+
+static inline void
+cpuid (uint32_t  ax,
+       uint32_t *p)
+{
+  cpuid_count (ax, 0, p);
+}
 #endif
 
 void
@@ -101,6 +110,20 @@ cogl_init_cpu_caps (void)
                  ((xgetbv () & 6) == 6));   /* XMM & YMM */
       if (((regs2[2] >> 29) & 1) && has_avx)
         cogl_cpu_caps |= COGL_CPU_CAP_F16C;
+      if ((regs2[2] >> 9) & 1)
+        cogl_cpu_caps |= COGL_CPU_CAP_SSSE3;
+      if ((regs2[2] >> 19) & 1)
+        cogl_cpu_caps |= COGL_CPU_CAP_SSE4_1;
+
+      if (regs[0] >= 0x00000007)
+        {
+          uint32_t regs7[4];
+
+          cpuid_count (0x00000007, 0, regs7);
+
+          if (((regs7[1] >> 5) & 1) && has_avx)
+            cogl_cpu_caps |= COGL_CPU_CAP_AVX2;
+        }
     }
 #endif
 }
@@ -37,6 +37,9 @@
 typedef enum _CoglCpuCaps
 {
   COGL_CPU_CAP_F16C = 1 << 0,
+  COGL_CPU_CAP_SSSE3 = 1 << 1,
+  COGL_CPU_CAP_SSE4_1 = 1 << 2,
+  COGL_CPU_CAP_AVX2 = 1 << 3,
 } CoglCpuCaps;
 
 COGL_EXPORT
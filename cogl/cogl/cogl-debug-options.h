@@ -156,6 +156,12 @@ OPT (DISABLE_FAST_READ_PIXEL,
      N_("Disable read pixel optimization"),
      N_("Disable optimization for reading 1px for simple "
         "scenes of opaque rectangles"))
+OPT (DISABLE_SIMD_CONVERSION,
+     N_("Root Cause"),
+     "disable-simd-conversion",
+     N_("Disable SIMD pixel conversion"),
+     N_("Always use the generic code paths when converting or "
+        "premultiplying bitmaps on the CPU"))
 OPT (CLIPPING,
      N_("Cogl Tracing"),
      "clipping",
@@ -190,3 +196,15 @@ OPT (STENCILLING,
      N_("Stencil every clip entry"),
      N_("Disables optimizations that usually avoid stencilling when it's not "
         "needed. This exercises more of the stencilling logic than usual."))
+OPT (OFFSCREEN_POOL,
+     N_("Cogl Tracing"),
+     "offscreen-pool",
+     N_("Trace the offscreen pool"),
+     N_("Logs how many offscreen allocations the offscreen pool avoided and "
+        "how much memory it holds on to"))
+OPT (DISABLE_OFFSCREEN_POOL,
+     N_("Root Cause"),
+     "disable-offscreen-pool",
+     N_("Disable the offscreen pool"),
+     N_("Always allocate new offscreen framebuffers instead of recycling "
+        "released ones"))
@@ -63,6 +63,7 @@ static const GDebugKey cogl_log_debug_keys[] = {
   { "winsys", COGL_DEBUG_WINSYS },
   { "performance", COGL_DEBUG_PERFORMANCE },
   { "textures", COGL_DEBUG_TEXTURES },
+  { "offscreen-pool", COGL_DEBUG_OFFSCREEN_POOL },
 };
 static const int n_cogl_log_debug_keys =
   G_N_ELEMENTS (cogl_log_debug_keys);
@@ -80,6 +81,8 @@ static const GDebugKey cogl_behavioural_debug_keys[] = {
   { "disable-software-clip", COGL_DEBUG_DISABLE_SOFTWARE_CLIP},
   { "disable-program-caches", COGL_DEBUG_DISABLE_PROGRAM_CACHES},
   { "disable-fast-read-pixel", COGL_DEBUG_DISABLE_FAST_READ_PIXEL},
+  { "disable-simd-conversion", COGL_DEBUG_DISABLE_SIMD_CONVERSION},
+  { "disable-offscreen-pool", COGL_DEBUG_DISABLE_OFFSCREEN_POOL},
   { "sync-primitive", COGL_DEBUG_SYNC_PRIMITIVE },
   { "sync-frame", COGL_DEBUG_SYNC_FRAME},
   { "stencilling", COGL_DEBUG_STENCILLING },
@@ -67,6 +67,7 @@ typedef enum
   COGL_DEBUG_DISABLE_SOFTWARE_CLIP,
   COGL_DEBUG_DISABLE_PROGRAM_CACHES,
   COGL_DEBUG_DISABLE_FAST_READ_PIXEL,
+  COGL_DEBUG_DISABLE_SIMD_CONVERSION,
   COGL_DEBUG_CLIPPING,
   COGL_DEBUG_WINSYS,
   COGL_DEBUG_PERFORMANCE,
@@ -74,6 +75,8 @@ typedef enum
   COGL_DEBUG_SYNC_FRAME,
   COGL_DEBUG_TEXTURES,
   COGL_DEBUG_STENCILLING,
+  COGL_DEBUG_OFFSCREEN_POOL,
+  COGL_DEBUG_DISABLE_OFFSCREEN_POOL,
 
   COGL_DEBUG_N_FLAGS
 } CoglDebugFlags;
@@ -155,6 +155,10 @@ void
 _cogl_framebuffer_add_dependency (CoglFramebuffer *framebuffer,
                                   CoglFramebuffer *dependency);
 
+gboolean
+_cogl_framebuffer_has_dependency (CoglFramebuffer *framebuffer,
+                                  CoglFramebuffer *dependency);
+
 COGL_EXPORT_TEST void
 _cogl_framebuffer_flush_journal (CoglFramebuffer *framebuffer);
 
@@ -859,6 +859,16 @@ _cogl_framebuffer_add_dependency (CoglFramebuffer *framebuffer,
     g_list_prepend (priv->deps, g_object_ref (dependency));
 }
 
+gboolean
+_cogl_framebuffer_has_dependency (CoglFramebuffer *framebuffer,
+                                  CoglFramebuffer *dependency)
+{
+  CoglFramebufferPrivate *priv =
+    cogl_framebuffer_get_instance_private (framebuffer);
+
+  return g_list_find (priv->deps, dependency) != NULL;
+}
+
 void
 _cogl_framebuffer_flush_journal (CoglFramebuffer *framebuffer)
 {
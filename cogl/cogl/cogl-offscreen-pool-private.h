@@ -0,0 +1,81 @@
+/*
+ * Cogl
+ *
+ * A Low Level GPU Graphics and Utilities API
+ *
+ * Copyright (C) 2026 Red Hat Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "cogl/cogl-context.h"
+#include "cogl/cogl-offscreen.h"
+
+typedef struct _CoglOffscreenPool CoglOffscreenPool;
+
+typedef struct _CoglOffscreenPoolStats
+{
+  /* Offscreens that had to be allocated from scratch */
+  unsigned int n_allocated;
+  /* Offscreens handed out again instead of being allocated */
+  unsigned int n_reused;
+  /* Offscreens dropped to stay within the budget or because they
+   * went unused for too long */
+  unsigned int n_evicted;
+
+  unsigned int n_pooled;
+  size_t pooled_bytes;
+} CoglOffscreenPoolStats;
+
+CoglOffscreenPool *
+cogl_offscreen_pool_new (CoglContext *context);
+
+void
+cogl_offscreen_pool_free (CoglOffscreenPool *pool);
+
+CoglOffscreen *
+cogl_offscreen_pool_acquire (CoglOffscreenPool  *pool,
+                             CoglPixelFormat     format,
+                             int                 width,
+                             int                 height,
+                             GError            **error);
+
+void
+cogl_offscreen_pool_release (CoglOffscreenPool *pool,
+                             CoglOffscreen     *offscreen);
+
+COGL_EXPORT_TEST
+void
+cogl_offscreen_pool_trim (CoglOffscreenPool *pool,
+                          int64_t            now_us);
+
+COGL_EXPORT_TEST
+void
+cogl_offscreen_pool_set_budget (CoglOffscreenPool *pool,
+                                size_t             max_bytes);
+
+COGL_EXPORT_TEST
+void
+cogl_offscreen_pool_get_stats (CoglOffscreenPool      *pool,
+                               CoglOffscreenPoolStats *stats);
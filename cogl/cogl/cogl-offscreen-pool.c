@@ -0,0 +1,500 @@
+/*
+ * Cogl
+ *
+ * A Low Level GPU Graphics and Utilities API
+ *
+ * Copyright (C) 2026 Red Hat Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+/*
+ * Offscreen framebuffers used as intermediate render targets, e.g. by
+ * offscreen effects or blur passes, tend to be thrown away and created
+ * again at the same size many times in a row; every frame of a resize
+ * animation, or every frame for paint nodes that only live for a
+ * single paint. Allocating a texture and a framebuffer object each time
+ * is expensive, so offscreens given back to the context are kept
+ * around in this pool and handed out again to the next request for the
+ * same format and size.
+ *
+ * Whether an offscreen is handed out or sitting in the pool is tracked
+ * explicitly; releasing it gives up any claim on it and its texture.
+ * Drawing that samples from the texture may still be pending in the
+ * journal of another framebuffer though, so the journals depending on
+ * the offscreen are flushed before it is handed out again, making sure
+ * that drawing reaches the GPU before anything new is rendered into the
+ * texture.
+ *
+ * The pool is kept within a memory budget by evicting the offscreens
+ * that have been sitting in it the longest, and offscreens that went
+ * unused for a few seconds are dropped entirely.
+ */
+
+#include "config.h"
+
+#include "cogl/cogl-offscreen-pool-private.h"
+#include "cogl/cogl-context-private.h"
+#include "cogl/cogl-debug.h"
+#include "cogl/cogl-framebuffer-private.h"
+#include "cogl/cogl-texture-private.h"
+
+#define DEFAULT_BUDGET_BYTES (64 * 1024 * 1024)
+#define MAX_AGE_US (3 * G_USEC_PER_SEC)
+#define TRIM_INTERVAL_S 1
+
+typedef struct _PoolKey
+{
+  CoglPixelFormat format;
+  int width;
+  int height;
+} PoolKey;
+
+/* Attached to every offscreen allocated by the pool */
+typedef struct _PoolItem
+{
+  PoolKey key;
+  gboolean checked_out;
+} PoolItem;
+
+typedef struct _PoolBucket
+{
+  PoolKey key;
+
+  /* PoolEntry, most recently released first */
+  GQueue entries;
+} PoolBucket;
+
+typedef struct _PoolEntry
+{
+  PoolBucket *bucket;
+  CoglOffscreen *offscreen;
+  size_t n_bytes;
+  int64_t release_time_us;
+
+  GList bucket_link;
+  GList lru_link;
+} PoolEntry;
+
+struct _CoglOffscreenPool
+{
+  CoglContext *context;
+
+  /* PoolKey -> PoolBucket */
+  GHashTable *buckets;
+
+  /* PoolEntry, most recently released first */
+  GQueue lru;
+
+  size_t pooled_bytes;
+  size_t max_bytes;
+
+  unsigned int trim_source_id;
+
+  CoglOffscreenPoolStats stats;
+  int64_t last_report_time_us;
+};
+
+static GQuark pool_item_quark;
+
+static unsigned int
+pool_key_hash (gconstpointer data)
+{
+  const PoolKey *key = data;
+
+  return (key->format * 31 + key->width) * 31 + key->height;
+}
+
+static gboolean
+pool_key_equal (gconstpointer a,
+                gconstpointer b)
+{
+  const PoolKey *key_a = a;
+  const PoolKey *key_b = b;
+
+  return (key_a->format == key_b->format &&
+          key_a->width == key_b->width &&
+          key_a->height == key_b->height);
+}
+
+static void
+report_stats (CoglOffscreenPool *pool)
+{
+  COGL_NOTE (OFFSCREEN_POOL,
+             "%u offscreens allocated, %u allocations avoided, "
+             "%u evicted, %u pooled (%zu KiB of %zu KiB)",
+             pool->stats.n_allocated,
+             pool->stats.n_reused,
+             pool->stats.n_evicted,
+             g_queue_get_length (&pool->lru),
+             pool->pooled_bytes / 1024,
+             pool->max_bytes / 1024);
+}
+
+static void
+maybe_report_stats (CoglOffscreenPool *pool,
+                    int64_t            now_us)
+{
+  if (G_LIKELY (!COGL_DEBUG_ENABLED (COGL_DEBUG_OFFSCREEN_POOL)))
+    return;
+
+  if (now_us - pool->last_report_time_us < G_USEC_PER_SEC)
+    return;
+
+  pool->last_report_time_us = now_us;
+  report_stats (pool);
+}
+
+static void
+remove_entry (CoglOffscreenPool *pool,
+              PoolEntry         *entry)
+{
+  PoolBucket *bucket = entry->bucket;
+
+  g_queue_unlink (&bucket->entries, &entry->bucket_link);
+  g_queue_unlink (&pool->lru, &entry->lru_link);
+  pool->pooled_bytes -= entry->n_bytes;
+
+  if (g_queue_is_empty (&bucket->entries))
+    g_hash_table_remove (pool->buckets, &bucket->key);
+
+  g_free (entry);
+}
+
+static void
+evict_entry (CoglOffscreenPool *pool,
+             PoolEntry         *entry)
+{
+  COGL_NOTE (OFFSCREEN_POOL, "Evicting %dx%d offscreen %p",
+             entry->bucket->key.width,
+             entry->bucket->key.height,
+             entry->offscreen);
+
+  g_object_unref (entry->offscreen);
+  remove_entry (pool, entry);
+  pool->stats.n_evicted++;
+}
+
+static void
+enforce_budget (CoglOffscreenPool *pool)
+{
+  while (pool->pooled_bytes > pool->max_bytes)
+    evict_entry (pool, g_queue_peek_tail (&pool->lru));
+}
+
+static gboolean
+trim_cb (gpointer user_data)
+{
+  CoglOffscreenPool *pool = user_data;
+
+  cogl_offscreen_pool_trim (pool, g_get_monotonic_time ());
+
+  if (g_queue_is_empty (&pool->lru))
+    {
+      pool->trim_source_id = 0;
+      return G_SOURCE_REMOVE;
+    }
+
+  return G_SOURCE_CONTINUE;
+}
+
+static size_t
+calculate_n_bytes (CoglTexture *texture)
+{
+  CoglPixelFormat format = cogl_texture_get_format (texture);
+  int bpp;
+
+  bpp = format == COGL_PIXEL_FORMAT_ANY ?
+    4 : cogl_pixel_format_get_bytes_per_pixel (format, 0);
+
+  return ((size_t) cogl_texture_get_width (texture) *
+          cogl_texture_get_height (texture) *
+          bpp);
+}
+
+static CoglOffscreen *
+allocate_offscreen (CoglOffscreenPool  *pool,
+                    CoglPixelFormat     format,
+                    int                 width,
+                    int                 height,
+                    GError            **error)
+{
+  g_autoptr (CoglTexture) texture = NULL;
+  g_autoptr (CoglOffscreen) offscreen = NULL;
+
+  if (format == COGL_PIXEL_FORMAT_ANY)
+    texture = cogl_texture_2d_new_with_size (pool->context, width, height);
+  else
+    texture = cogl_texture_2d_new_with_format (pool->context,
+                                               width, height,
+                                               format);
+
+  offscreen = cogl_offscreen_new_with_texture (texture);
+  if (!cogl_framebuffer_allocate (COGL_FRAMEBUFFER (offscreen), error))
+    return NULL;
+
+  pool->stats.n_allocated++;
+
+  return g_steal_pointer (&offscreen);
+}
+
+static void
+flush_pending_rendering (CoglOffscreenPool *pool,
+                         CoglOffscreen     *offscreen)
+{
+  CoglFramebuffer *framebuffer = COGL_FRAMEBUFFER (offscreen);
+  GList *l;
+
+  /* Only framebuffers with drawing sampling from the texture still
+   * pending in their journal depend on the offscreen */
+  for (l = pool->context->framebuffers; l; l = l->next)
+    {
+      if (_cogl_framebuffer_has_dependency (l->data, framebuffer))
+        _cogl_framebuffer_flush_journal (l->data);
+    }
+
+  _cogl_framebuffer_flush_journal (framebuffer);
+}
+
+static void
+reset_offscreen (CoglOffscreenPool *pool,
+                 CoglOffscreen     *offscreen,
+                 int                width,
+                 int                height)
+{
+  CoglFramebuffer *framebuffer = COGL_FRAMEBUFFER (offscreen);
+
+  /* Leave the texture the way a newly allocated offscreen has it, the
+   * previous user may have changed its mipmapping, filters or
+   * premultiplied state */
+  _cogl_texture_reset (cogl_offscreen_get_texture (offscreen));
+
+  cogl_framebuffer_set_viewport (framebuffer, 0, 0, width, height);
+  cogl_framebuffer_set_projection_matrix (framebuffer,
+                                          &pool->context->identity_matrix);
+  cogl_framebuffer_set_modelview_matrix (framebuffer,
+                                         &pool->context->identity_matrix);
+}
+
+CoglOffscreen *
+cogl_offscreen_pool_acquire (CoglOffscreenPool  *pool,
+                             CoglPixelFormat     format,
+                             int                 width,
+                             int                 height,
+                             GError            **error)
+{
+  CoglOffscreen *offscreen;
+  PoolKey key = { format, width, height };
+  PoolBucket *bucket;
+  PoolEntry *entry;
+  PoolItem *item;
+  int64_t now_us;
+
+  if (width <= 0 || height <= 0)
+    {
+      g_set_error (error, COGL_TEXTURE_ERROR, COGL_TEXTURE_ERROR_SIZE,
+                   "Invalid offscreen size %dx%d", width, height);
+      return NULL;
+    }
+
+  if (G_UNLIKELY (COGL_DEBUG_ENABLED (COGL_DEBUG_DISABLE_OFFSCREEN_POOL)))
+    return allocate_offscreen (pool, format, width, height, error);
+
+  now_us = g_get_monotonic_time ();
+  cogl_offscreen_pool_trim (pool, now_us);
+
+  bucket = g_hash_table_lookup (pool->buckets, &key);
+  entry = bucket ? g_queue_peek_head (&bucket->entries) : NULL;
+  if (entry)
+    {
+      offscreen = entry->offscreen;
+      remove_entry (pool, entry);
+
+      item = g_object_get_qdata (G_OBJECT (offscreen), pool_item_quark);
+      item->checked_out = TRUE;
+
+      /* Pending drawing may still sample from the texture */
+      flush_pending_rendering (pool, offscreen);
+
+      reset_offscreen (pool, offscreen, width, height);
+      pool->stats.n_reused++;
+      maybe_report_stats (pool, now_us);
+
+      return offscreen;
+    }
+
+  offscreen = allocate_offscreen (pool, format, width, height, error);
+  if (!offscreen)
+    return NULL;
+
+  item = g_new0 (PoolItem, 1);
+  item->key = key;
+  item->checked_out = TRUE;
+  g_object_set_qdata_full (G_OBJECT (offscreen), pool_item_quark,
+                           item, g_free);
+  maybe_report_stats (pool, now_us);
+
+  return offscreen;
+}
+
+void
+cogl_offscreen_pool_release (CoglOffscreenPool *pool,
+                             CoglOffscreen     *offscreen)
+{
+  PoolItem *item;
+  PoolBucket *bucket;
+  PoolEntry *entry;
+  size_t n_bytes;
+  int64_t now_us;
+
+  item = g_object_get_qdata (G_OBJECT (offscreen), pool_item_quark);
+  if (item)
+    {
+      g_return_if_fail (item->checked_out);
+      item->checked_out = FALSE;
+    }
+
+  if (!item ||
+      G_UNLIKELY (COGL_DEBUG_ENABLED (COGL_DEBUG_DISABLE_OFFSCREEN_POOL)))
+    {
+      g_object_unref (offscreen);
+      return;
+    }
+
+  n_bytes = calculate_n_bytes (cogl_offscreen_get_texture (offscreen));
+  if (n_bytes > pool->max_bytes)
+    {
+      g_object_unref (offscreen);
+      return;
+    }
+
+  bucket = g_hash_table_lookup (pool->buckets, &item->key);
+  if (!bucket)
+    {
+      bucket = g_new0 (PoolBucket, 1);
+      bucket->key = item->key;
+      g_hash_table_insert (pool->buckets, &bucket->key, bucket);
+    }
+
+  now_us = g_get_monotonic_time ();
+
+  entry = g_new0 (PoolEntry, 1);
+  entry->bucket = bucket;
+  entry->offscreen = offscreen;
+  entry->n_bytes = n_bytes;
+  entry->release_time_us = now_us;
+  entry->bucket_link.data = entry;
+  entry->lru_link.data = entry;
+
+  g_queue_push_head_link (&bucket->entries, &entry->bucket_link);
+  g_queue_push_head_link (&pool->lru, &entry->lru_link);
+  pool->pooled_bytes += n_bytes;
+
+  enforce_budget (pool);
+  cogl_offscreen_pool_trim (pool, now_us);
+
+  if (!pool->trim_source_id)
+    {
+      pool->trim_source_id = g_timeout_add_seconds (TRIM_INTERVAL_S,
+                                                    trim_cb, pool);
+      g_source_set_name_by_id (pool->trim_source_id,
+                               "[cogl] offscreen pool trim");
+    }
+}
+
+/* Drops all offscreens that have been sitting unused in the pool for
+ * too long */
+void
+cogl_offscreen_pool_trim (CoglOffscreenPool *pool,
+                          int64_t            now_us)
+{
+  PoolEntry *entry;
+
+  while ((entry = g_queue_peek_tail (&pool->lru)) &&
+         now_us - entry->release_time_us > MAX_AGE_US)
+    evict_entry (pool, entry);
+
+  maybe_report_stats (pool, now_us);
+}
+
+void
+cogl_offscreen_pool_set_budget (CoglOffscreenPool *pool,
+                                size_t             max_bytes)
+{
+  pool->max_bytes = max_bytes;
+  enforce_budget (pool);
+}
+
+void
+cogl_offscreen_pool_get_stats (CoglOffscreenPool      *pool,
+                               CoglOffscreenPoolStats *stats)
+{
+  *stats = pool->stats;
+  stats->n_pooled = g_queue_get_length (&pool->lru);
+  stats->pooled_bytes = pool->pooled_bytes;
+}
+
+static void
+pool_bucket_free (gpointer data)
+{
+  PoolBucket *bucket = data;
+
+  g_warn_if_fail (g_queue_is_empty (&bucket->entries));
+  g_free (bucket);
+}
+
+CoglOffscreenPool *
+cogl_offscreen_pool_new (CoglContext *context)
+{
+  CoglOffscreenPool *pool;
+
+  if (!pool_item_quark)
+    pool_item_quark = g_quark_from_static_string ("-cogl-offscreen-pool-item");
+
+  pool = g_new0 (CoglOffscreenPool, 1);
+  pool->context = context;
+  pool->buckets = g_hash_table_new_full (pool_key_hash, pool_key_equal,
+                                         NULL, pool_bucket_free);
+  g_queue_init (&pool->lru);
+  pool->max_bytes = DEFAULT_BUDGET_BYTES;
+
+  return pool;
+}
+
+void
+cogl_offscreen_pool_free (CoglOffscreenPool *pool)
+{
+  PoolEntry *entry;
+
+  if (G_UNLIKELY (COGL_DEBUG_ENABLED (COGL_DEBUG_OFFSCREEN_POOL)))
+    report_stats (pool);
+
+  while ((entry = g_queue_peek_tail (&pool->lru)))
+    {
+      g_object_unref (entry->offscreen);
+      remove_entry (pool, entry);
+    }
+
+  g_clear_handle_id (&pool->trim_source_id, g_source_remove);
+  g_hash_table_destroy (pool->buckets);
+  g_free (pool);
+}
@@ -97,6 +97,33 @@ cogl_offscreen_get_texture_level (CoglOffscreen *offscreen)
   return offscreen->texture_level;
 }
 
+CoglOffscreen *
+cogl_offscreen_new_pooled (CoglContext      *context,
+                           CoglPixelFormat   format,
+                           int               width,
+                           int               height,
+                           GError          **error)
+{
+  return cogl_offscreen_pool_acquire (context->offscreen_pool,
+                                      format, width, height,
+                                      error);
+}
+
+void
+cogl_offscreen_release (CoglOffscreen *offscreen)
+{
+  CoglFramebuffer *framebuffer = COGL_FRAMEBUFFER (offscreen);
+  CoglContext *context = cogl_framebuffer_get_context (framebuffer);
+
+  if (!context->offscreen_pool)
+    {
+      g_object_unref (offscreen);
+      return;
+    }
+
+  cogl_offscreen_pool_release (context->offscreen_pool, offscreen);
+}
+
 static gboolean
 cogl_offscreen_allocate (CoglFramebuffer  *framebuffer,
                          GError          **error)
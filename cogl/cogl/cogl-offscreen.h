@@ -98,4 +98,44 @@ cogl_offscreen_new_with_texture (CoglTexture *texture);
 COGL_EXPORT CoglTexture *
 cogl_offscreen_get_texture (CoglOffscreen *offscreen);
 
+/**
+ * cogl_offscreen_new_pooled:
+ * @context: A #CoglContext pointer
+ * @format: The pixel format of the texture, or %COGL_PIXEL_FORMAT_ANY
+ *   for the same format as cogl_texture_2d_new_with_size() would use
+ * @width: Width of the texture in pixels
+ * @height: Height of the texture in pixels
+ * @error: A #GError return location.
+ *
+ * Returns an allocated offscreen framebuffer backed by a #CoglTexture2D
+ * of exactly @width by @height pixels. Offscreens previously given back
+ * with cogl_offscreen_release() are recycled when possible, which avoids
+ * allocating new textures when intermediate render targets of the same
+ * size are needed over and over again.
+ *
+ * The contents of the texture are undefined, and the viewport and
+ * the projection and modelview matrices are reset to their defaults.
+ *
+ * Return value: (transfer full): a #CoglOffscreen, or %NULL on failure
+ */
+COGL_EXPORT CoglOffscreen *
+cogl_offscreen_new_pooled (CoglContext      *context,
+                           CoglPixelFormat   format,
+                           int               width,
+                           int               height,
+                           GError          **error);
+
+/**
+ * cogl_offscreen_release:
+ * @offscreen: (transfer full): A #CoglOffscreen
+ *
+ * Drops the reference to @offscreen. If @offscreen was created with
+ * cogl_offscreen_new_pooled(), it is kept around to be handed out again
+ * by a later call to cogl_offscreen_new_pooled(), so neither @offscreen
+ * nor its texture may be used by the caller afterwards. Drawing already
+ * done with the texture is not affected.
+ */
+COGL_EXPORT void
+cogl_offscreen_release (CoglOffscreen *offscreen);
+
 G_END_DECLS
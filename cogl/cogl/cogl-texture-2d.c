@@ -233,6 +233,21 @@ _cogl_texture_2d_pre_paint (CoglTexture *tex, CoglTexturePrePaintFlags flags)
     }
 }
 
+static void
+_cogl_texture_2d_reset (CoglTexture *tex)
+{
+  CoglTexture2D *tex_2d = COGL_TEXTURE_2D (tex);
+  CoglTextureDriver *tex_driver = cogl_texture_get_driver (tex);
+  CoglTextureDriverClass *tex_driver_klass =
+    COGL_TEXTURE_DRIVER_GET_CLASS (tex_driver);
+
+  tex_2d->auto_mipmap = TRUE;
+  tex_2d->mipmaps_dirty = TRUE;
+
+  if (tex_driver_klass->texture_2d_reset)
+    tex_driver_klass->texture_2d_reset (tex_driver, tex_2d);
+}
+
 static void
 _cogl_texture_2d_ensure_non_quad_rendering (CoglTexture *tex)
 {
@@ -276,6 +291,60 @@ _cogl_texture_2d_set_region (CoglTexture *tex,
   return TRUE;
 }
 
+static gboolean
+_cogl_texture_2d_set_regions (CoglTexture        *tex,
+                              const MtkRectangle *rects,
+                              int                 n_rects,
+                              int                 dst_x,
+                              int                 dst_y,
+                              int                 level,
+                              CoglBitmap         *bmp,
+                              GError            **error)
+{
+  CoglTexture2D *tex_2d = COGL_TEXTURE_2D (tex);
+  CoglTextureDriver *tex_driver = cogl_texture_get_driver (tex);
+  CoglTextureDriverClass *tex_driver_klass =
+    COGL_TEXTURE_DRIVER_GET_CLASS (tex_driver);
+
+  if (tex_driver_klass->texture_2d_copy_regions_from_bitmap)
+    {
+      if (!tex_driver_klass->texture_2d_copy_regions_from_bitmap (tex_driver,
+                                                                  tex_2d,
+                                                                  rects,
+                                                                  n_rects,
+                                                                  bmp,
+                                                                  dst_x,
+                                                                  dst_y,
+                                                                  level,
+                                                                  error))
+        return FALSE;
+    }
+  else
+    {
+      int i;
+
+      for (i = 0; i < n_rects; i++)
+        {
+          if (!tex_driver_klass->texture_2d_copy_from_bitmap (tex_driver,
+                                                              tex_2d,
+                                                              rects[i].x,
+                                                              rects[i].y,
+                                                              rects[i].width,
+                                                              rects[i].height,
+                                                              bmp,
+                                                              dst_x + rects[i].x,
+                                                              dst_y + rects[i].y,
+                                                              level,
+                                                              error))
+            return FALSE;
+        }
+    }
+
+  tex_2d->mipmaps_dirty = TRUE;
+
+  return TRUE;
+}
+
 static gboolean
 _cogl_texture_2d_is_get_data_supported (CoglTexture *tex)
 {
@@ -329,6 +398,7 @@ cogl_texture_2d_class_init (CoglTexture2DClass *klass)
 
   texture_class->allocate = _cogl_texture_2d_allocate;
   texture_class->set_region = _cogl_texture_2d_set_region;
+  texture_class->set_regions = _cogl_texture_2d_set_regions;
   texture_class->is_get_data_supported = _cogl_texture_2d_is_get_data_supported;
   texture_class->get_data = _cogl_texture_2d_get_data;
   texture_class->is_sliced = _cogl_texture_2d_is_sliced;
@@ -338,6 +408,7 @@ cogl_texture_2d_class_init (CoglTexture2DClass *klass)
   texture_class->get_gl_texture = _cogl_texture_2d_get_gl_texture;
   texture_class->gl_flush_legacy_texobj_filters = _cogl_texture_2d_gl_flush_legacy_texobj_filters;
   texture_class->pre_paint = _cogl_texture_2d_pre_paint;
+  texture_class->reset = _cogl_texture_2d_reset;
   texture_class->ensure_non_quad_rendering = _cogl_texture_2d_ensure_non_quad_rendering;
   texture_class->gl_flush_legacy_texobj_wrap_modes = _cogl_texture_2d_gl_flush_legacy_texobj_wrap_modes;
   texture_class->get_format = _cogl_texture_2d_get_format;
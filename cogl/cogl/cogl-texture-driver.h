@@ -34,6 +34,7 @@
 
 #include "cogl/cogl-pixel-format.h"
 #include "cogl/cogl-types.h"
+#include "mtk/mtk.h"
 
 typedef struct _CoglDriver CoglDriver;
 
@@ -87,6 +88,14 @@ struct _CoglTextureDriverClass
   void (* texture_2d_generate_mipmap) (CoglTextureDriver *driver,
                                        CoglTexture2D     *tex_2d);
 
+  /* Restores any driver specific state of the given 2D texture to
+  * what it is right after allocation
+  *
+  * This is optional
+  */
+  void (* texture_2d_reset) (CoglTextureDriver *driver,
+                             CoglTexture2D     *tex_2d);
+
   /* Initialize the specified region of storage of the given texture
   * with the contents of the specified bitmap region
   *
@@ -105,6 +114,23 @@ struct _CoglTextureDriverClass
                                             int                level,
                                             GError           **error);
 
+  /* Like texture_2d_copy_from_bitmap but for multiple regions of the
+  * same bitmap, each written at its own position offset by dst_x and
+  * dst_y. This allows the bitmap conversion, texture binding and pixel
+  * store setup to be shared between all regions.
+  *
+  * This is optional
+  */
+  gboolean (* texture_2d_copy_regions_from_bitmap) (CoglTextureDriver  *driver,
+                                                    CoglTexture2D      *tex_2d,
+                                                    const MtkRectangle *rects,
+                                                    int                 n_rects,
+                                                    CoglBitmap         *bitmap,
+                                                    int                 dst_x,
+                                                    int                 dst_y,
+                                                    int                 level,
+                                                    GError            **error);
+
   gboolean (* texture_2d_is_get_data_supported) (CoglTextureDriver *driver,
                                                  CoglTexture2D     *tex_2d);
 
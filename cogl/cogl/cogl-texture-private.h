@@ -133,6 +133,19 @@ struct _CoglTextureClass
                            CoglBitmap  *bitmap,
                            GError     **error);
 
+  /* Optional batched variant of set_region. Each rectangle is read
+     from the bitmap at its own position and written at the same
+     position offset by dst_x and dst_y. Textures that don't implement
+     this get one set_region call per rectangle. */
+  gboolean (* set_regions) (CoglTexture        *tex,
+                            const MtkRectangle *rects,
+                            int                 n_rects,
+                            int                 dst_x,
+                            int                 dst_y,
+                            int                 level,
+                            CoglBitmap         *bitmap,
+                            GError            **error);
+
   gboolean (* is_get_data_supported) (CoglTexture *texture);
 
   /* This should copy the image data of the texture into @data. The
@@ -174,6 +187,10 @@ struct _CoglTextureClass
 
   void (* pre_paint) (CoglTexture             *tex,
                       CoglTexturePrePaintFlags flags);
+
+  /* Optional. Restores the state a newly allocated texture has, so
+     that it can be handed out to a new user */
+  void (* reset) (CoglTexture *tex);
   void (* ensure_non_quad_rendering) (CoglTexture *tex);
 
   /* OpenGL driver specific virtual function */
@@ -191,6 +208,9 @@ _cogl_texture_can_hardware_repeat (CoglTexture *texture);
 void
 _cogl_texture_pre_paint (CoglTexture *texture, CoglTexturePrePaintFlags flags);
 
+void
+_cogl_texture_reset (CoglTexture *texture);
+
 /*
  * This determines a CoglPixelFormat according to texture::components
  * and texture::premultiplied (i.e. the user required components and
@@ -276,9 +296,11 @@ gboolean
 _cogl_texture_needs_premult_conversion (CoglPixelFormat src_format,
                                         CoglPixelFormat dst_format);
 
+COGL_EXPORT_TEST
 int
 _cogl_texture_get_n_levels (CoglTexture *texture);
 
+COGL_EXPORT_TEST
 void
 cogl_texture_set_max_level (CoglTexture *texture,
                             int          max_level);
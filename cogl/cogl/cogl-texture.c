@@ -428,6 +428,20 @@ _cogl_texture_pre_paint (CoglTexture *texture, CoglTexturePrePaintFlags flags)
                                                flags);
 }
 
+void
+_cogl_texture_reset (CoglTexture *texture)
+{
+  CoglTexturePrivate *priv =
+    cogl_texture_get_instance_private (texture);
+  CoglTextureClass *klass = COGL_TEXTURE_GET_CLASS (texture);
+
+  priv->max_level_requested = 1000; /* OpenGL default GL_TEXTURE_MAX_LEVEL */
+  priv->premultiplied = TRUE;
+
+  if (klass->reset)
+    klass->reset (texture);
+}
+
 gboolean
 _cogl_texture_set_region_from_bitmap (CoglTexture *texture,
                                       int src_x,
@@ -579,6 +593,198 @@ cogl_texture_set_region (CoglTexture *texture,
   return status;
 }
 
+/* Uploading a rectangle has a fixed cost (pixel store state changes and
+ * a separate glTexSubImage2D call) which roughly amounts to transferring
+ * this many additional pixels. Two rectangles are merged when their
+ * bounding box wastes fewer pixels than that. */
+#define REGION_MERGE_SLACK_PIXELS 4096
+
+/* Number of previously coalesced rectangles each rectangle is checked
+ * against, bounding the cost of coalescing fragmented regions. */
+#define REGION_MERGE_WINDOW 8
+
+static int
+compare_rects_by_position (const void *a,
+                           const void *b)
+{
+  const MtkRectangle *rect_a = a;
+  const MtkRectangle *rect_b = b;
+
+  if (rect_a->y != rect_b->y)
+    return rect_a->y < rect_b->y ? -1 : 1;
+  if (rect_a->x != rect_b->x)
+    return rect_a->x < rect_b->x ? -1 : 1;
+
+  return 0;
+}
+
+static gboolean
+should_merge_rects (const MtkRectangle *rect_a,
+                    const MtkRectangle *rect_b,
+                    MtkRectangle       *bounds)
+{
+  mtk_rectangle_union (rect_a, rect_b, bounds);
+
+  return (mtk_rectangle_area (bounds) <=
+          mtk_rectangle_area (rect_a) +
+          mtk_rectangle_area (rect_b) +
+          REGION_MERGE_SLACK_PIXELS);
+}
+
+static int
+coalesce_upload_regions (MtkRectangle *rects,
+                         int           n_rects)
+{
+  int n_merged = 0;
+  int i;
+
+  /* Sorted, rectangles close to each other are only a few apart, so each
+   * one is merged into one of the last few coalesced ones, in one sweep. */
+  qsort (rects, n_rects, sizeof (MtkRectangle), compare_rects_by_position);
+
+  for (i = 0; i < n_rects; i++)
+    {
+      MtkRectangle rect = rects[i];
+      gboolean merged = FALSE;
+      int j;
+
+      for (j = n_merged - 1;
+           j >= 0 && j >= n_merged - REGION_MERGE_WINDOW;
+           j--)
+        {
+          MtkRectangle bounds;
+
+          if (should_merge_rects (&rects[j], &rect, &bounds))
+            {
+              rects[j] = bounds;
+              merged = TRUE;
+              break;
+            }
+        }
+
+      if (!merged)
+        rects[n_merged++] = rect;
+    }
+
+  return n_merged;
+}
+
+gboolean
+cogl_texture_set_regions (CoglTexture                 *texture,
+                          int                          width,
+                          int                          height,
+                          CoglPixelFormat              format,
+                          unsigned int                 rowstride,
+                          const uint8_t               *data,
+                          int                          dst_x,
+                          int                          dst_y,
+                          const MtkRectangle          *rects,
+                          int                          n_rects,
+                          CoglTextureSetRegionsFlags   flags,
+                          GError                     **error)
+{
+  CoglContext *ctx;
+  CoglTextureClass *klass;
+  g_autofree MtkRectangle *upload_rects = NULL;
+  int n_upload_rects;
+  CoglBitmap *source_bmp;
+  gboolean ret = TRUE;
+  int i;
+
+  g_return_val_if_fail (COGL_IS_TEXTURE (texture), FALSE);
+
+  if (format == COGL_PIXEL_FORMAT_ANY ||
+      cogl_pixel_format_get_n_planes (format) != 1)
+    {
+      g_set_error (error,
+                   COGL_TEXTURE_ERROR,
+                   COGL_TEXTURE_ERROR_FORMAT,
+                   "Regions can only be set from single plane formats");
+      return FALSE;
+    }
+
+  if (n_rects < 0)
+    {
+      g_set_error (error,
+                   COGL_TEXTURE_ERROR,
+                   COGL_TEXTURE_ERROR_BAD_PARAMETER,
+                   "Invalid number of regions %d", n_rects);
+      return FALSE;
+    }
+
+  if (n_rects == 0)
+    return TRUE;
+
+  for (i = 0; i < n_rects; i++)
+    {
+      if (rects[i].x < 0 || rects[i].y < 0 ||
+          rects[i].width <= 0 || rects[i].height <= 0 ||
+          rects[i].x + rects[i].width > width ||
+          rects[i].y + rects[i].height > height)
+        {
+          g_set_error (error,
+                       COGL_TEXTURE_ERROR,
+                       COGL_TEXTURE_ERROR_BAD_PARAMETER,
+                       "Region %d,%d %dx%d is outside of the %dx%d source",
+                       rects[i].x, rects[i].y,
+                       rects[i].width, rects[i].height,
+                       width, height);
+          return FALSE;
+        }
+    }
+
+  /* Assert that the storage for this texture has been allocated */
+  if (!cogl_texture_allocate (texture, error))
+    return FALSE;
+
+  /* Rowstride from width if none specified */
+  if (rowstride == 0)
+    rowstride = cogl_pixel_format_get_bytes_per_pixel (format, 0) * width;
+
+  upload_rects = g_memdup2 (rects, n_rects * sizeof (MtkRectangle));
+  if (flags & COGL_TEXTURE_SET_REGIONS_FLAG_ALLOW_MERGE)
+    n_upload_rects = coalesce_upload_regions (upload_rects, n_rects);
+  else
+    n_upload_rects = n_rects;
+
+  ctx = cogl_texture_get_context (texture);
+  source_bmp = cogl_bitmap_new_for_data (ctx,
+                                         width, height,
+                                         format,
+                                         rowstride,
+                                         (uint8_t *) data);
+
+  klass = COGL_TEXTURE_GET_CLASS (texture);
+  if (klass->set_regions)
+    {
+      ret = klass->set_regions (texture,
+                                upload_rects, n_upload_rects,
+                                dst_x, dst_y,
+                                0, /* level */
+                                source_bmp,
+                                error);
+    }
+  else
+    {
+      for (i = 0; i < n_upload_rects && ret; i++)
+        {
+          const MtkRectangle *rect = &upload_rects[i];
+
+          ret = klass->set_region (texture,
+                                   rect->x, rect->y,
+                                   dst_x + rect->x, dst_y + rect->y,
+                                   rect->width, rect->height,
+                                   0, /* level */
+                                   source_bmp,
+                                   error);
+        }
+    }
+
+  g_object_unref (source_bmp);
+
+  return ret;
+}
+
 gboolean
 cogl_texture_set_data (CoglTexture *texture,
                        CoglPixelFormat format,
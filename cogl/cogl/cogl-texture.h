@@ -38,6 +38,7 @@
 #include "cogl/cogl-pixel-buffer.h"
 #include "cogl/cogl-pixel-format.h"
 #include "cogl/cogl-bitmap.h"
+#include "mtk/mtk.h"
 
 #include <glib-object.h>
 
@@ -114,6 +115,21 @@ typedef enum _CoglTextureComponents
   COGL_TEXTURE_COMPONENTS_DEPTH
 } CoglTextureComponents;
 
+/**
+ * CoglTextureSetRegionsFlags:
+ * @COGL_TEXTURE_SET_REGIONS_FLAG_NONE: Upload exactly the given rectangles
+ * @COGL_TEXTURE_SET_REGIONS_FLAG_ALLOW_MERGE: Rectangles close to each other
+ *   may be uploaded as their bounding box when that is cheaper than uploading
+ *   them separately. Only pass this if the source data in between is valid.
+ *
+ * See cogl_texture_set_regions().
+ */
+typedef enum _CoglTextureSetRegionsFlags
+{
+  COGL_TEXTURE_SET_REGIONS_FLAG_NONE = 0,
+  COGL_TEXTURE_SET_REGIONS_FLAG_ALLOW_MERGE = 1 << 0,
+} CoglTextureSetRegionsFlags;
+
 /**
  * cogl_texture_set_components:
  * @texture: a #CoglTexture pointer.
@@ -329,6 +345,48 @@ cogl_texture_set_region (CoglTexture *texture,
                          unsigned int rowstride,
                          const uint8_t *data);
 
+/**
+ * cogl_texture_set_regions:
+ * @texture: a #CoglTexture.
+ * @width: width of source data buffer.
+ * @height: height of source data buffer.
+ * @format: the #CoglPixelFormat used in the source buffer.
+ * @rowstride: rowstride of source buffer (computed from width if none
+ *   specified)
+ * @data: (array): the actual pixel data.
+ * @dst_x: horizontal offset of the source buffer within @texture.
+ * @dst_y: vertical offset of the source buffer within @texture.
+ * @rects: (array length=n_rects): rectangles of the source buffer to
+ *   upload.
+ * @n_rects: number of rectangles in @rects.
+ * @flags: #CoglTextureSetRegionsFlags
+ * @error: return location for a #GError or %NULL.
+ *
+ * Sets the pixels of multiple rectangular subregions of @texture from a
+ * single in-memory buffer. Each rectangle is read from @data at its own
+ * position and written to @texture at the same position offset by @dst_x
+ * and @dst_y.
+ *
+ * This is equivalent to calling cogl_texture_set_region() once per
+ * rectangle, but lets the driver upload all of them with a single texture
+ * bind and pixel store setup.
+ *
+ * Return value: %TRUE if the upload was successful, and %FALSE otherwise
+ */
+COGL_EXPORT gboolean
+cogl_texture_set_regions (CoglTexture                 *texture,
+                          int                          width,
+                          int                          height,
+                          CoglPixelFormat              format,
+                          unsigned int                 rowstride,
+                          const uint8_t               *data,
+                          int                          dst_x,
+                          int                          dst_y,
+                          const MtkRectangle          *rects,
+                          int                          n_rects,
+                          CoglTextureSetRegionsFlags   flags,
+                          GError                     **error);
+
 /**
  * cogl_texture_set_data:
  * @texture a #CoglTexture.
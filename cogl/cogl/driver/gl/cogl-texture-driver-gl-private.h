@@ -79,6 +79,24 @@ struct _CoglTextureDriverGLClass
                                        GLuint               source_gl_type,
                                        GError             **error);
 
+  /*
+   * Like upload_subregion_to_gl but uploads several regions of
+   * source_bmp, each to its own position offset by dst_x and dst_y,
+   * binding the bitmap and the texture only once.
+   */
+  gboolean (* upload_subregions_to_gl) (CoglTextureDriverGL *driver,
+                                        CoglContext         *ctx,
+                                        CoglTexture         *texture,
+                                        const MtkRectangle  *rects,
+                                        int                  n_rects,
+                                        int                  dst_x,
+                                        int                  dst_y,
+                                        int                  level,
+                                        CoglBitmap          *source_bmp,
+                                        GLuint               source_gl_format,
+                                        GLuint               source_gl_type,
+                                        GError             **error);
+
   /*
    * Replaces the contents of the GL texture with the entire bitmap. On
    * GL this just directly calls glTexImage2D, but under GLES it needs
@@ -476,6 +476,16 @@ cogl_texture_driver_gl_texture_2d_generate_mipmap (CoglTextureDriver *driver,
   GE( ctx, glGenerateMipmap (gl_target) );
 }
 
+static void
+cogl_texture_driver_gl_texture_2d_reset (CoglTextureDriver *driver,
+                                         CoglTexture2D     *tex_2d)
+{
+  /* Same non mipmapped filters as set when the texture is attached to a
+   * framebuffer object, see cogl-gl-framebuffer-fbo.c */
+  _cogl_texture_gl_flush_legacy_texobj_filters (COGL_TEXTURE (tex_2d),
+                                                GL_NEAREST, GL_NEAREST);
+}
+
 static gboolean
 cogl_texture_driver_gl_texture_2d_copy_from_bitmap (CoglTextureDriver *tex_driver,
                                                     CoglTexture2D     *tex_2d,
@@ -545,6 +555,103 @@ cogl_texture_driver_gl_texture_2d_copy_from_bitmap (CoglTextureDriver *tex_drive
   return status;
 }
 
+static gboolean
+cogl_texture_driver_gl_texture_2d_copy_regions_from_bitmap (CoglTextureDriver  *tex_driver,
+                                                            CoglTexture2D      *tex_2d,
+                                                            const MtkRectangle *rects,
+                                                            int                 n_rects,
+                                                            CoglBitmap         *bmp,
+                                                            int                 dst_x,
+                                                            int                 dst_y,
+                                                            int                 level,
+                                                            GError            **error)
+{
+  CoglTexture *tex = COGL_TEXTURE (tex_2d);
+  CoglContext *ctx = cogl_texture_get_context (tex);
+  CoglDriver *driver = cogl_context_get_driver (ctx);
+  CoglDriverGL *driver_gl = COGL_DRIVER_GL (driver);
+  CoglDriverGLClass *driver_klass = COGL_DRIVER_GL_GET_CLASS (driver_gl);
+  CoglTextureDriverGL *tex_driver_gl =
+    COGL_TEXTURE_DRIVER_GL (tex_driver);
+  CoglTextureDriverGLClass *tex_driver_klass =
+    COGL_TEXTURE_DRIVER_GL_GET_CLASS (tex_driver_gl);
+  CoglBitmap *upload_bmp;
+  CoglPixelFormat upload_format;
+  GLenum gl_format;
+  GLenum gl_type;
+  gboolean status = TRUE;
+
+  /* Convert the bitmap once for all regions rather than once per
+   * region as repeated texture_2d_copy_from_bitmap calls would do */
+  upload_bmp =
+    _cogl_bitmap_convert_for_upload (bmp,
+                                     cogl_texture_get_format (tex),
+                                     error);
+  if (upload_bmp == NULL)
+    return FALSE;
+
+  upload_format = cogl_bitmap_get_format (upload_bmp);
+
+  /* Only support single plane formats */
+  if (upload_format == COGL_PIXEL_FORMAT_ANY ||
+      cogl_pixel_format_get_n_planes (upload_format) != 1)
+    {
+      g_object_unref (upload_bmp);
+      return FALSE;
+    }
+
+  driver_klass->pixel_format_to_gl (driver_gl,
+                                    ctx,
+                                    upload_format,
+                                    NULL, /* internal gl format */
+                                    &gl_format,
+                                    &gl_type);
+
+  if (cogl_texture_get_max_level_set (tex) < level)
+    cogl_texture_gl_set_max_level (tex, level);
+
+  if (tex_driver_klass->upload_subregions_to_gl)
+    {
+      status = tex_driver_klass->upload_subregions_to_gl (tex_driver_gl,
+                                                          ctx,
+                                                          tex,
+                                                          rects, n_rects,
+                                                          dst_x, dst_y,
+                                                          level,
+                                                          upload_bmp,
+                                                          gl_format,
+                                                          gl_type,
+                                                          error);
+    }
+  else
+    {
+      int i;
+
+      for (i = 0; i < n_rects && status; i++)
+        {
+          status =
+            tex_driver_klass->upload_subregion_to_gl (tex_driver_gl,
+                                                      ctx,
+                                                      tex,
+                                                      rects[i].x,
+                                                      rects[i].y,
+                                                      dst_x + rects[i].x,
+                                                      dst_y + rects[i].y,
+                                                      rects[i].width,
+                                                      rects[i].height,
+                                                      level,
+                                                      upload_bmp,
+                                                      gl_format,
+                                                      gl_type,
+                                                      error);
+        }
+    }
+
+  g_object_unref (upload_bmp);
+
+  return status;
+}
+
 static void
 cogl_texture_driver_gl_class_init (CoglTextureDriverGLClass *klass)
 {
@@ -555,7 +662,9 @@ cogl_texture_driver_gl_class_init (CoglTextureDriverGLClass *klass)
   driver_klass->texture_2d_allocate = cogl_texture_driver_gl_texture_2d_allocate;
   driver_klass->texture_2d_copy_from_framebuffer = cogl_texture_driver_gl_texture_2d_copy_from_framebuffer;
   driver_klass->texture_2d_generate_mipmap = cogl_texture_driver_gl_texture_2d_generate_mipmap;
+  driver_klass->texture_2d_reset = cogl_texture_driver_gl_texture_2d_reset;
   driver_klass->texture_2d_copy_from_bitmap = cogl_texture_driver_gl_texture_2d_copy_from_bitmap;
+  driver_klass->texture_2d_copy_regions_from_bitmap = cogl_texture_driver_gl_texture_2d_copy_regions_from_bitmap;
 }
 
 static void
@@ -257,6 +257,111 @@ cogl_texture_driver_gl3_upload_subregion_to_gl (CoglTextureDriverGL  *driver,
   return status;
 }
 
+static gboolean
+cogl_texture_driver_gl3_upload_subregions_to_gl (CoglTextureDriverGL  *driver,
+                                                 CoglContext          *ctx,
+                                                 CoglTexture          *texture,
+                                                 const MtkRectangle   *rects,
+                                                 int                   n_rects,
+                                                 int                   dst_x,
+                                                 int                   dst_y,
+                                                 int                   level,
+                                                 CoglBitmap           *source_bmp,
+                                                 GLuint                source_gl_format,
+                                                 GLuint                source_gl_type,
+                                                 GError              **error)
+{
+  GLenum gl_target;
+  GLuint gl_handle;
+  uint8_t *data;
+  CoglPixelFormat source_format = cogl_bitmap_get_format (source_bmp);
+  int bpp;
+  gboolean status = TRUE;
+  GError *internal_error = NULL;
+  int level_width;
+  int level_height;
+  int i;
+
+  g_return_val_if_fail (source_format != COGL_PIXEL_FORMAT_ANY, FALSE);
+  g_return_val_if_fail (cogl_pixel_format_get_n_planes (source_format) == 1,
+                        FALSE);
+
+  bpp = cogl_pixel_format_get_bytes_per_pixel (source_format, 0);
+  cogl_texture_get_gl_texture (texture, &gl_handle, &gl_target);
+
+  data = _cogl_bitmap_gl_bind (source_bmp, COGL_BUFFER_ACCESS_READ, 0, &internal_error);
+
+  /* NB: _cogl_bitmap_gl_bind() may return NULL when successful so we
+   * have to explicitly check the cogl error pointer to catch
+   * problems... */
+  if (internal_error)
+    {
+      g_propagate_error (error, internal_error);
+      return FALSE;
+    }
+
+  /* The row length and alignment only depend on the source bitmap so
+   * they are shared by all regions; only the skip offsets change */
+  prep_gl_for_pixels_upload_full (ctx,
+                                  cogl_bitmap_get_rowstride (source_bmp),
+                                  0,
+                                  0, 0,
+                                  bpp);
+
+  _cogl_bind_gl_texture_transient (ctx, gl_target, gl_handle);
+
+  /* Clear any GL errors */
+  _cogl_gl_util_clear_gl_errors (ctx);
+
+  _cogl_texture_get_level_size (texture,
+                                level,
+                                &level_width,
+                                &level_height,
+                                NULL);
+
+  /* GL gets upset if you use glTexSubImage2D to initialize the
+   * contents of a mipmap level so if this is the first time
+   * we've seen a request to upload to this level we call
+   * glTexImage2D first to assert that the storage for this
+   * level exists.
+   */
+  if (cogl_texture_get_max_level_set (texture) < level)
+    {
+      ctx->glTexImage2D (gl_target,
+                         level,
+                         _cogl_texture_gl_get_format (texture),
+                         level_width,
+                         level_height,
+                         0,
+                         source_gl_format,
+                         source_gl_type,
+                         NULL);
+    }
+
+  for (i = 0; i < n_rects; i++)
+    {
+      const MtkRectangle *rect = &rects[i];
+
+      GE( ctx, glPixelStorei (GL_UNPACK_SKIP_PIXELS, rect->x) );
+      GE( ctx, glPixelStorei (GL_UNPACK_SKIP_ROWS, rect->y) );
+
+      ctx->glTexSubImage2D (gl_target,
+                            level,
+                            dst_x + rect->x, dst_y + rect->y,
+                            rect->width, rect->height,
+                            source_gl_format,
+                            source_gl_type,
+                            data);
+    }
+
+  if (_cogl_gl_util_catch_out_of_memory (ctx, error))
+    status = FALSE;
+
+  _cogl_bitmap_gl_unbind (source_bmp);
+
+  return status;
+}
+
 static gboolean
 cogl_texture_driver_gl3_upload_to_gl (CoglTextureDriverGL *driver,
                                       CoglContext         *ctx,
@@ -423,6 +528,7 @@ cogl_texture_driver_gl3_class_init (CoglTextureDriverGL3Class *klass)
 
   driver_gl_klass->gen = cogl_texture_driver_gl3_gen;
   driver_gl_klass->upload_subregion_to_gl = cogl_texture_driver_gl3_upload_subregion_to_gl;
+  driver_gl_klass->upload_subregions_to_gl = cogl_texture_driver_gl3_upload_subregions_to_gl;
   driver_gl_klass->upload_to_gl = cogl_texture_driver_gl3_upload_to_gl;
   driver_gl_klass->gl_get_tex_image = cogl_texture_driver_gl3_gl_get_tex_image;
   driver_gl_klass->find_best_gl_get_data_format = cogl_texture_driver_gl3_find_best_gl_get_data_format;
@@ -78,7 +78,8 @@ struct _CoglTexturePixmapX11
   Damage damage;
   CoglTexturePixmapX11ReportLevel damage_report_level;
   gboolean damage_owned;
-  MtkRectangle damage_rect;
+  gboolean damage_subtract_pending;
+  MtkRegion *damage_region;
 
   void *winsys;
 
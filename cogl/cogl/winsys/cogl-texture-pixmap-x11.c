@@ -63,6 +63,10 @@
 #include <string.h>
 #include <math.h>
 
+/* Past this many rectangles, the damage region is reduced to its extents,
+ * keeping both tracking it and fetching it from the server cheap */
+#define MAX_DAMAGE_RECTS 16
+
 G_DEFINE_FINAL_TYPE (CoglTexturePixmapX11, cogl_texture_pixmap_x11, COGL_TYPE_TEXTURE)
 
 static const CoglWinsysVtable *
@@ -83,16 +87,31 @@ _cogl_xlib_get_damage_base (CoglContext *ctx)
   return xlib_renderer->damage_base;
 }
 
+static void
+add_damage_rect (CoglTexturePixmapX11 *tex_pixmap,
+                 const MtkRectangle   *rect)
+{
+  mtk_region_union_rectangle (tex_pixmap->damage_region, rect);
+
+  if (mtk_region_num_rectangles (tex_pixmap->damage_region) > MAX_DAMAGE_RECTS)
+    {
+      MtkRectangle extents;
+
+      extents = mtk_region_get_extents (tex_pixmap->damage_region);
+      g_clear_pointer (&tex_pixmap->damage_region, mtk_region_unref);
+      tex_pixmap->damage_region = mtk_region_create_rectangle (&extents);
+    }
+}
+
 static void
 process_damage_event (CoglTexturePixmapX11 *tex_pixmap,
                       XDamageNotifyEvent *damage_event)
 {
   CoglTexture *tex = COGL_TEXTURE (tex_pixmap);
   Display *display;
-  enum
-{ DO_NOTHING, NEEDS_SUBTRACT, NEED_BOUNDING_BOX } handle_mode;
   const CoglWinsysVtable *winsys;
   CoglContext *ctx;
+  MtkRectangle tex_rect;
   MtkRectangle damage_rect;
 
   ctx = cogl_texture_get_context (COGL_TEXTURE (tex_pixmap));
@@ -100,6 +119,10 @@ process_damage_event (CoglTexturePixmapX11 *tex_pixmap,
 
   COGL_NOTE (TEXTURE_PIXMAP, "Damage event received for %p", tex_pixmap);
 
+  tex_rect = MTK_RECTANGLE_INIT (0, 0,
+                                 cogl_texture_get_width (tex),
+                                 cogl_texture_get_height (tex));
+
   switch (tex_pixmap->damage_report_level)
     {
     case COGL_TEXTURE_PIXMAP_X11_DAMAGE_RAW_RECTANGLES:
@@ -107,80 +130,72 @@ process_damage_event (CoglTexturePixmapX11 *tex_pixmap,
          at all because the damage area is directly given in the event
          struct and the reporting of events is not affected by
          clearing the damage region */
-      handle_mode = DO_NOTHING;
+      damage_rect = MTK_RECTANGLE_INIT (damage_event->area.x,
+                                        damage_event->area.y,
+                                        damage_event->area.width,
+                                        damage_event->area.height);
+      add_damage_rect (tex_pixmap, &damage_rect);
       break;
 
     case COGL_TEXTURE_PIXMAP_X11_DAMAGE_DELTA_RECTANGLES:
-    case COGL_TEXTURE_PIXMAP_X11_DAMAGE_NON_EMPTY:
-      /* For delta rectangles and non empty we'll query the damage
-         region for the bounding box */
-      handle_mode = NEED_BOUNDING_BOX;
+    case COGL_TEXTURE_PIXMAP_X11_DAMAGE_BOUNDING_BOX:
+      /* The event contains either exactly what was newly damaged, or the
+         bounding box of everything damaged since the last subtraction,
+         so there is no need to ask the server about the region. The
+         subtraction only needs to happen before the texture is next
+         updated, so one is done per update rather than per event, and
+         no more events are sent for areas already known to be damaged
+         until then. */
+      damage_rect = MTK_RECTANGLE_INIT (damage_event->area.x,
+                                        damage_event->area.y,
+                                        damage_event->area.width,
+                                        damage_event->area.height);
+      add_damage_rect (tex_pixmap, &damage_rect);
+      tex_pixmap->damage_subtract_pending = TRUE;
       break;
 
-    case COGL_TEXTURE_PIXMAP_X11_DAMAGE_BOUNDING_BOX:
-      /* For bounding box we need to clear the damage region but we
-         don't actually care what it was because the damage event
-         itself contains the bounding box of the region */
-      handle_mode = NEEDS_SUBTRACT;
+    case COGL_TEXTURE_PIXMAP_X11_DAMAGE_NON_EMPTY:
+      /* If the damage already covers the whole rectangle then we don't
+         need to request the region because we're going to update the
+         whole texture anyway. */
+      if (mtk_region_contains_rectangle (tex_pixmap->damage_region,
+                                         &tex_rect) == MTK_REGION_OVERLAP_IN)
+        {
+          tex_pixmap->damage_subtract_pending = TRUE;
+        }
+      else
+        {
+          XserverRegion parts;
+          XRectangle *r_damage;
+          int r_count;
+          int i;
+
+          /* Only a single event is sent until the region is subtracted,
+             so we need to extract the damage region from the server */
+          parts = XFixesCreateRegion (display, 0, 0);
+          XDamageSubtract (display, tex_pixmap->damage, None, parts);
+          r_damage = XFixesFetchRegion (display, parts, &r_count);
+
+          for (i = 0; i < r_count; i++)
+            {
+              damage_rect = MTK_RECTANGLE_INIT (r_damage[i].x,
+                                                r_damage[i].y,
+                                                r_damage[i].width,
+                                                r_damage[i].height);
+              add_damage_rect (tex_pixmap, &damage_rect);
+            }
+
+          if (r_damage)
+            XFree (r_damage);
+
+          XFixesDestroyRegion (display, parts);
+        }
       break;
 
     default:
       g_assert_not_reached ();
     }
 
-  /* If the damage already covers the whole rectangle then we don't
-     need to request the bounding box of the region because we're
-     going to update the whole texture anyway. */
-  damage_rect = MTK_RECTANGLE_INIT (0, 0,
-                                    cogl_texture_get_width (tex),
-                                    cogl_texture_get_height (tex));
-  if (mtk_rectangle_equal (&tex_pixmap->damage_rect, &damage_rect))
-    {
-      if (handle_mode != DO_NOTHING)
-        XDamageSubtract (display, tex_pixmap->damage, None, None);
-    }
-  else if (handle_mode == NEED_BOUNDING_BOX)
-    {
-      XserverRegion parts;
-      int r_count;
-      XRectangle r_bounds;
-      XRectangle *r_damage;
-
-      /* We need to extract the damage region so we can get the
-         bounding box */
-
-      parts = XFixesCreateRegion (display, 0, 0);
-      XDamageSubtract (display, tex_pixmap->damage, None, parts);
-      r_damage = XFixesFetchRegionAndBounds (display,
-                                             parts,
-                                             &r_count,
-                                             &r_bounds);
-      damage_rect = MTK_RECTANGLE_INIT (r_bounds.x, r_bounds.y,
-                                        r_bounds.width, r_bounds.height);
-      mtk_rectangle_union (&tex_pixmap->damage_rect,
-                           &damage_rect,
-                           &tex_pixmap->damage_rect);
-      if (r_damage)
-        XFree (r_damage);
-
-      XFixesDestroyRegion (display, parts);
-    }
-  else
-    {
-      if (handle_mode == NEEDS_SUBTRACT)
-        /* We still need to subtract from the damage region but we
-           don't care what the region actually was */
-        XDamageSubtract (display, tex_pixmap->damage, None, None);
-
-      damage_rect = MTK_RECTANGLE_INIT (damage_event->area.x,
-                                        damage_event->area.y,
-                                        damage_event->area.width,
-                                        damage_event->area.height);
-      mtk_rectangle_union (&tex_pixmap->damage_rect,
-                           &damage_rect,
-                           &tex_pixmap->damage_rect);
-    }
-
   if (tex_pixmap->winsys)
     {
       /* If we're using the texture from pixmap extension then there's no
@@ -274,6 +289,8 @@ cogl_texture_pixmap_x11_dispose (GObject *object)
   if (tex_pixmap->tex)
     g_object_unref (tex_pixmap->tex);
 
+  g_clear_pointer (&tex_pixmap->damage_region, mtk_region_unref);
+
   if (tex_pixmap->winsys)
     {
       const CoglWinsysVtable *winsys =
@@ -541,7 +558,8 @@ _cogl_util_pixel_format_from_masks (unsigned long r_mask,
 }
 
 static void
-_cogl_texture_pixmap_x11_update_image_texture (CoglTexturePixmapX11 *tex_pixmap)
+update_image_texture_rect (CoglTexturePixmapX11 *tex_pixmap,
+                           const MtkRectangle   *rect)
 {
   CoglTexture *tex = COGL_TEXTURE (tex_pixmap);
   Display *display;
@@ -559,31 +577,10 @@ _cogl_texture_pixmap_x11_update_image_texture (CoglTexturePixmapX11 *tex_pixmap)
   display = cogl_xlib_renderer_get_display (ctx->display->renderer);
   visual = tex_pixmap->visual;
 
-  /* If the damage region is empty then there's nothing to do */
-  if (tex_pixmap->damage_rect.x == tex_pixmap->damage_rect.width)
-    return;
-
-  x = tex_pixmap->damage_rect.x;
-  y = tex_pixmap->damage_rect.y;
-  width = tex_pixmap->damage_rect.width;
-  height = tex_pixmap->damage_rect.height;
-
-  /* We lazily create the texture the first time it is needed in case
-     this texture can be entirely handled using the GLX texture
-     instead */
-  if (tex_pixmap->tex == NULL)
-    {
-      CoglPixelFormat texture_format;
-
-      texture_format = (tex_pixmap->depth >= 32
-                        ? COGL_PIXEL_FORMAT_RGBA_8888_PRE
-                        : COGL_PIXEL_FORMAT_RGB_888);
-
-      tex_pixmap->tex = create_fallback_texture (ctx,
-                                                 cogl_texture_get_width (tex),
-                                                 cogl_texture_get_height (tex),
-                                                 texture_format);
-    }
+  x = rect->x;
+  y = rect->y;
+  width = rect->width;
+  height = rect->height;
 
   if (tex_pixmap->image == NULL)
     {
@@ -678,8 +675,51 @@ _cogl_texture_pixmap_x11_update_image_texture (CoglTexturePixmapX11 *tex_pixmap)
      temporary one with no data allocated so we can just XFree it */
   if (tex_pixmap->shm_info.shmid != -1)
     XFree (image);
+}
+
+static void
+_cogl_texture_pixmap_x11_update_image_texture (CoglTexturePixmapX11 *tex_pixmap)
+{
+  CoglTexture *tex = COGL_TEXTURE (tex_pixmap);
+  CoglContext *ctx;
+  int i, n_rects;
+
+  /* If the damage region is empty then there's nothing to do */
+  if (mtk_region_is_empty (tex_pixmap->damage_region))
+    return;
+
+  ctx = cogl_texture_get_context (COGL_TEXTURE (tex_pixmap));
+
+  /* We lazily create the texture the first time it is needed in case
+     this texture can be entirely handled using the GLX texture
+     instead */
+  if (tex_pixmap->tex == NULL)
+    {
+      CoglPixelFormat texture_format;
 
-  memset (&tex_pixmap->damage_rect, 0, sizeof (MtkRectangle));
+      texture_format = (tex_pixmap->depth >= 32
+                        ? COGL_PIXEL_FORMAT_RGBA_8888_PRE
+                        : COGL_PIXEL_FORMAT_RGB_888);
+
+      tex_pixmap->tex = create_fallback_texture (ctx,
+                                                 cogl_texture_get_width (tex),
+                                                 cogl_texture_get_height (tex),
+                                                 texture_format);
+    }
+
+  /* Only what was damaged is fetched, one rectangle at a time; the
+     number of rectangles is bounded by add_damage_rect() */
+  n_rects = mtk_region_num_rectangles (tex_pixmap->damage_region);
+  for (i = 0; i < n_rects; i++)
+    {
+      MtkRectangle rect;
+
+      rect = mtk_region_get_rectangle (tex_pixmap->damage_region, i);
+      update_image_texture_rect (tex_pixmap, &rect);
+    }
+
+  g_clear_pointer (&tex_pixmap->damage_region, mtk_region_unref);
+  tex_pixmap->damage_region = mtk_region_create ();
 }
 
 static void
@@ -690,6 +730,18 @@ _cogl_texture_pixmap_x11_update (CoglTexturePixmapX11 *tex_pixmap,
   if (stereo_mode == COGL_TEXTURE_PIXMAP_RIGHT)
     tex_pixmap = tex_pixmap->left;
 
+  /* Subtract the damage before refreshing the texture, so that anything
+     drawn after this point is reported again */
+  if (tex_pixmap->damage_subtract_pending)
+    {
+      CoglContext *ctx = cogl_texture_get_context (COGL_TEXTURE (tex_pixmap));
+      Display *display =
+        cogl_xlib_renderer_get_display (ctx->display->renderer);
+
+      XDamageSubtract (display, tex_pixmap->damage, None, None);
+      tex_pixmap->damage_subtract_pending = FALSE;
+    }
+
   if (tex_pixmap->winsys)
     {
       const CoglWinsysVtable *winsys =
@@ -1068,10 +1120,10 @@ _cogl_texture_pixmap_x11_new (CoglContext *ctx,
     }
 
   /* Assume the entire pixmap is damaged to begin with */
-  tex_pixmap->damage_rect.x = 0;
-  tex_pixmap->damage_rect.width = pixmap_width;
-  tex_pixmap->damage_rect.y = 0;
-  tex_pixmap->damage_rect.height = pixmap_height;
+  tex_pixmap->damage_region =
+    mtk_region_create_rectangle (&MTK_RECTANGLE_INIT (0, 0,
+                                                      pixmap_width,
+                                                      pixmap_height));
 
   winsys = _cogl_texture_pixmap_x11_get_winsys (tex_pixmap);
   if (winsys->texture_pixmap_x11_create)
@@ -1163,9 +1215,8 @@ cogl_texture_pixmap_x11_update_area (CoglTexturePixmapX11 *tex_pixmap,
       winsys = _cogl_texture_pixmap_x11_get_winsys (tex_pixmap);
       winsys->texture_pixmap_x11_damage_notify (tex_pixmap);
     }
-  mtk_rectangle_union (&tex_pixmap->damage_rect,
-                       area,
-                       &tex_pixmap->damage_rect);
+
+  add_damage_rect (tex_pixmap, area);
 }
 
 gboolean
@@ -23,6 +23,7 @@
 #include <glib/gstdio.h>
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "mtk/mtk-anonymous-file.h"
@@ -32,6 +33,8 @@ struct _MtkAnonymousFile
   char *name;
   int fd;
   size_t size;
+  gboolean writable;
+  void *data;
 };
 
 #define READONLY_SEALS (F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE)
@@ -226,6 +229,159 @@ mtk_anonymous_file_new (const char    *name,
   return g_steal_pointer (&file);
 }
 
+/**
+ * mtk_anonymous_file_new_writable: (skip)
+ * @name: Name of the file
+ *
+ * Create a new empty anonymous file, to be filled by writing to the file
+ * descriptor returned by mtk_anonymous_file_get_write_fd(). This avoids
+ * keeping a copy of data of unknown size in memory while it is being
+ * received. Once all data is written, call
+ * mtk_anonymous_file_finish_writing() to make the file read-only.
+ *
+ * When done, free the data using mtk_anonymous_file_free().
+ *
+ * If this function fails errno is set.
+ *
+ * Returns: The newly created #MtkAnonymousFile, or %NULL on failure.
+ */
+MtkAnonymousFile *
+mtk_anonymous_file_new_writable (const char *name)
+{
+  MtkAnonymousFile *file;
+  int fd;
+
+  fd = create_anonymous_file (name, 0);
+  if (fd == -1)
+    return NULL;
+
+  file = g_malloc0 (sizeof *file);
+  file->name = g_strdup (name);
+  file->fd = fd;
+  file->writable = TRUE;
+
+  return file;
+}
+
+/**
+ * mtk_anonymous_file_new_mapped: (skip)
+ * @name: Name of the file
+ * @size: The size of the file
+ *
+ * Create a new zero filled anonymous file of the given size, that stays
+ * mapped for writing for as long as it exists. Readers of file descriptors
+ * returned by mtk_anonymous_file_open_read_fd() see the changes made through
+ * mtk_anonymous_file_get_data() as they happen, which makes it suitable for
+ * publishing state that changes over time.
+ *
+ * When done, free the data using mtk_anonymous_file_free().
+ *
+ * If this function fails errno is set.
+ *
+ * Returns: The newly created #MtkAnonymousFile, or %NULL on failure.
+ */
+MtkAnonymousFile *
+mtk_anonymous_file_new_mapped (const char *name,
+                               size_t      size)
+{
+  g_autoptr (MtkAnonymousFile) file = NULL;
+  void *map;
+
+  g_return_val_if_fail (size > 0, NULL);
+
+  file = g_malloc0 (sizeof *file);
+  file->name = g_strdup (name);
+  file->size = size;
+  file->fd = create_anonymous_file (name, size);
+  if (file->fd == -1)
+    return NULL;
+
+  map = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, file->fd, 0);
+  if (map == MAP_FAILED)
+    return NULL;
+
+  file->data = map;
+
+#if defined(HAVE_MEMFD_CREATE)
+  /* Readers map it too, so it must not change size under them. Only the
+   * mapping above may write to it, no file descriptor handed out, even if
+   * opened anew for writing, can be used to write or map it for writing.
+   */
+#if defined(F_SEAL_FUTURE_WRITE)
+  fcntl (file->fd, F_ADD_SEALS,
+         F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_FUTURE_WRITE);
+#else
+  fcntl (file->fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW);
+#endif
+#endif
+
+  return g_steal_pointer (&file);
+}
+
+/**
+ * mtk_anonymous_file_get_data: (skip)
+ * @file: A #MtkAnonymousFile created with mtk_anonymous_file_new_mapped()
+ *
+ * Get the writable mapping of @file, of mtk_anonymous_file_size() bytes.
+ *
+ * Returns: The mapping of @file.
+ */
+void *
+mtk_anonymous_file_get_data (MtkAnonymousFile *file)
+{
+  g_return_val_if_fail (file->data, NULL);
+
+  return file->data;
+}
+
+/**
+ * mtk_anonymous_file_get_write_fd: (skip)
+ * @file: A #MtkAnonymousFile created with mtk_anonymous_file_new_writable()
+ *
+ * Get the file descriptor to write the contents of @file to. It remains
+ * owned by @file, and is only valid until mtk_anonymous_file_finish_writing()
+ * is called.
+ *
+ * Returns: The file descriptor to write to.
+ */
+int
+mtk_anonymous_file_get_write_fd (MtkAnonymousFile *file)
+{
+  g_return_val_if_fail (file->writable, -1);
+
+  return file->fd;
+}
+
+/**
+ * mtk_anonymous_file_finish_writing: (skip)
+ * @file: A #MtkAnonymousFile created with mtk_anonymous_file_new_writable()
+ *
+ * Finish writing to @file, and make it read-only. Its size is whatever was
+ * written to it up to now.
+ *
+ * If this function fails errno is set.
+ *
+ * Returns: %TRUE if @file is ready to be read.
+ */
+gboolean
+mtk_anonymous_file_finish_writing (MtkAnonymousFile *file)
+{
+  struct stat stat_buf;
+
+  g_return_val_if_fail (file->writable, FALSE);
+
+  if (fstat (file->fd, &stat_buf) != 0)
+    return FALSE;
+
+  file->size = stat_buf.st_size;
+  file->writable = FALSE;
+
+#if defined(HAVE_MEMFD_CREATE)
+  fcntl (file->fd, F_ADD_SEALS, READONLY_SEALS);
+#endif
+
+  return TRUE;
+}
 
 /**
  * mtk_anonymous_file_free: (skip)
@@ -236,6 +392,8 @@ mtk_anonymous_file_new (const char    *name,
 void
 mtk_anonymous_file_free (MtkAnonymousFile *file)
 {
+  if (file->data)
+    munmap (file->data, file->size);
   g_clear_fd (&file->fd, NULL);
   g_free (file);
 }
@@ -333,6 +491,61 @@ mtk_anonymous_file_open_fd (const MtkAnonymousFile  *file,
   return fd;
 }
 
+/**
+ * mtk_anonymous_file_open_read_fd: (skip)
+ * @file: the #MtkAnonymousFile to read
+ *
+ * Returns a new file descriptor to read the contents of @file from the
+ * start, with a file offset of its own. If @file is sealed read-only, the
+ * file descriptor refers to the same memory as @file, instead of to a copy
+ * of it as with mtk_anonymous_file_open_fd(). This makes it suitable for
+ * serving the contents with sendfile() or splice().
+ *
+ * If @file was created with mtk_anonymous_file_new_mapped(), the file
+ * descriptor always refers to the same memory, but can't be used to map it
+ * for writing.
+ *
+ * The returned file descriptor must be closed with close().
+ *
+ * If this function fails errno is set.
+ *
+ * Returns: A file descriptor, or -1 on failure.
+ */
+int
+mtk_anonymous_file_open_read_fd (const MtkAnonymousFile *file)
+{
+  g_return_val_if_fail (!file->writable, -1);
+
+  if (file->data)
+    {
+      g_autofree char *path = NULL;
+
+      path = g_strdup_printf ("/proc/self/fd/%d", file->fd);
+      return open (path, O_RDONLY | O_CLOEXEC);
+    }
+
+#if defined(HAVE_MEMFD_CREATE)
+  int seals;
+
+  seals = fcntl (file->fd, F_GET_SEALS);
+  if (seals != -1 && (seals & READONLY_SEALS) == READONLY_SEALS)
+    {
+      g_autofree char *path = NULL;
+      int fd;
+
+      /* Opening the file anew, rather than duplicating the file descriptor,
+       * gives it a file offset that isn't shared with other readers.
+       */
+      path = g_strdup_printf ("/proc/self/fd/%d", file->fd);
+      fd = open (path, O_RDONLY | O_CLOEXEC);
+      if (fd >= 0)
+        return fd;
+    }
+#endif
+
+  return mtk_anonymous_file_open_fd (file, MTK_ANONYMOUS_FILE_MAPMODE_SHARED);
+}
+
 /**
  * mtk_anonymous_file_close_fd: (skip)
  * @fd: A file descriptor obtained using mtk_anonymous_file_open_fd()
@@ -37,6 +37,22 @@ MtkAnonymousFile * mtk_anonymous_file_new (const char    *name,
                                            size_t         size,
                                            const uint8_t *data);
 
+MTK_EXPORT
+MtkAnonymousFile * mtk_anonymous_file_new_writable (const char *name);
+
+MTK_EXPORT
+MtkAnonymousFile * mtk_anonymous_file_new_mapped (const char *name,
+                                                  size_t      size);
+
+MTK_EXPORT
+void * mtk_anonymous_file_get_data (MtkAnonymousFile *file);
+
+MTK_EXPORT
+int mtk_anonymous_file_get_write_fd (MtkAnonymousFile *file);
+
+MTK_EXPORT
+gboolean mtk_anonymous_file_finish_writing (MtkAnonymousFile *file);
+
 MTK_EXPORT
 void mtk_anonymous_file_free (MtkAnonymousFile *file);
 
@@ -47,6 +63,9 @@ MTK_EXPORT
 int mtk_anonymous_file_open_fd (const MtkAnonymousFile  *file,
                                 MtkAnonymousFileMapmode  mapmode);
 
+MTK_EXPORT
+int mtk_anonymous_file_open_read_fd (const MtkAnonymousFile *file);
+
 MTK_EXPORT
 void mtk_anonymous_file_close_fd (int fd);
 
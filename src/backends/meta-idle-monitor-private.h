@@ -23,6 +23,7 @@
 #pragma once
 
 #include "core/display-private.h"
+#include "core/util-private.h"
 #include "meta/meta-idle-monitor.h"
 
 typedef struct
@@ -34,7 +35,8 @@ typedef struct
   GDestroyNotify            notify;
   guint64                   timeout_msec;
   int                       idle_source_id;
-  GSource                  *timeout_source;
+  GSequenceIter            *iter;
+  uint64_t                  fired_serial;
 } MetaIdleMonitorWatch;
 
 struct _MetaIdleMonitorClass
@@ -42,6 +44,7 @@ struct _MetaIdleMonitorClass
   GObjectClass parent_class;
 };
 
+META_EXPORT_TEST
 void meta_idle_monitor_reset_idletime (MetaIdleMonitor *monitor);
 
 MetaIdleManager * meta_idle_monitor_get_manager (MetaIdleMonitor *monitor);
@@ -49,10 +49,44 @@ struct _MetaIdleMonitor
   gboolean inhibited;
   GHashTable *watches;
   int64_t last_event_time;
+
+  /* Idle watches sorted by timeout, and thus by deadline, as all of them
+   * are relative to the same last_event_time. Watches before
+   * next_watch_iter have already been handled since the last event. */
+  GSequence *idle_watches;
+  GSequenceIter *next_watch_iter;
+  uint64_t idle_serial;
+  GSource *timeout_source;
+
+  GQueue user_active_watches;
 };
 
 G_DEFINE_TYPE (MetaIdleMonitor, meta_idle_monitor, G_TYPE_OBJECT)
 
+static int64_t
+get_watch_deadline (MetaIdleMonitor      *monitor,
+                    MetaIdleMonitorWatch *watch)
+{
+  return monitor->last_event_time + watch->timeout_msec * 1000;
+}
+
+static void
+update_timeout (MetaIdleMonitor *monitor)
+{
+  MetaIdleMonitorWatch *watch;
+
+  if (monitor->inhibited ||
+      g_sequence_iter_is_end (monitor->next_watch_iter))
+    {
+      g_source_set_ready_time (monitor->timeout_source, -1);
+      return;
+    }
+
+  watch = g_sequence_get (monitor->next_watch_iter);
+  g_source_set_ready_time (monitor->timeout_source,
+                           get_watch_deadline (monitor, watch));
+}
+
 static void
 meta_idle_monitor_watch_fire (MetaIdleMonitorWatch *watch)
 {
@@ -83,6 +117,13 @@ meta_idle_monitor_dispose (GObject *object)
   MetaIdleMonitor *monitor = META_IDLE_MONITOR (object);
 
   g_clear_pointer (&monitor->watches, g_hash_table_destroy);
+  g_clear_pointer (&monitor->idle_watches, g_sequence_free);
+  g_queue_clear (&monitor->user_active_watches);
+  if (monitor->timeout_source)
+    {
+      g_source_destroy (monitor->timeout_source);
+      g_clear_pointer (&monitor->timeout_source, g_source_unref);
+    }
   g_clear_object (&monitor->session_proxy);
 
   G_OBJECT_CLASS (meta_idle_monitor_parent_class)->dispose (object);
@@ -109,34 +150,19 @@ free_watch (gpointer data)
   if (watch->notify != NULL)
     watch->notify (watch->user_data);
 
-  if (watch->timeout_source != NULL)
-    g_source_destroy (watch->timeout_source);
-
-  g_object_unref (monitor);
-  g_free (watch);
-}
-
-static void
-update_inhibited_watch (gpointer key,
-                        gpointer value,
-                        gpointer user_data)
-{
-  MetaIdleMonitor *monitor = user_data;
-  MetaIdleMonitorWatch *watch = value;
-
-  if (!watch->timeout_source)
-    return;
-
-  if (monitor->inhibited)
+  if (watch->iter)
     {
-      g_source_set_ready_time (watch->timeout_source, -1);
+      if (monitor->next_watch_iter == watch->iter)
+        monitor->next_watch_iter = g_sequence_iter_next (watch->iter);
+      g_sequence_remove (watch->iter);
     }
   else
     {
-      g_source_set_ready_time (watch->timeout_source,
-                               monitor->last_event_time +
-                               watch->timeout_msec * 1000);
+      g_queue_remove (&monitor->user_active_watches, watch);
     }
+
+  g_object_unref (monitor);
+  g_free (watch);
 }
 
 static void
@@ -148,9 +174,7 @@ update_inhibited (MetaIdleMonitor *monitor,
 
   monitor->inhibited = inhibited;
 
-  g_hash_table_foreach (monitor->watches,
-                        update_inhibited_watch,
-                        monitor);
+  update_timeout (monitor);
 }
 
 static void
@@ -171,11 +195,63 @@ meta_idle_monitor_inhibited_actions_changed (GDBusProxy  *session,
       g_variant_unref (v);
 
       if (!inhibited)
-        monitor->last_event_time = g_get_monotonic_time ();
+        {
+          monitor->last_event_time = g_get_monotonic_time ();
+          monitor->idle_serial++;
+          monitor->next_watch_iter =
+            g_sequence_get_begin_iter (monitor->idle_watches);
+        }
       update_inhibited (monitor, inhibited);
     }
 }
 
+static gboolean
+idle_monitor_dispatch_timeout (GSource     *source,
+                               GSourceFunc  callback,
+                               gpointer     user_data)
+{
+  MetaIdleMonitor *monitor = META_IDLE_MONITOR (user_data);
+  int64_t now;
+
+  now = g_source_get_time (source);
+
+  g_object_ref (monitor);
+
+  /* Resetting the idle time only moves the deadlines forward, so the
+   * timeout may fire early; if so, it's simply re-armed here. */
+  while (!monitor->inhibited &&
+         !g_sequence_iter_is_end (monitor->next_watch_iter))
+    {
+      MetaIdleMonitorWatch *watch;
+
+      watch = g_sequence_get (monitor->next_watch_iter);
+      if (get_watch_deadline (monitor, watch) > now)
+        break;
+
+      monitor->next_watch_iter =
+        g_sequence_iter_next (monitor->next_watch_iter);
+
+      if (watch->fired_serial == monitor->idle_serial)
+        continue;
+
+      watch->fired_serial = monitor->idle_serial;
+      meta_idle_monitor_watch_fire (watch);
+    }
+
+  update_timeout (monitor);
+
+  g_object_unref (monitor);
+
+  return G_SOURCE_CONTINUE;
+}
+
+static GSourceFuncs idle_monitor_source_funcs = {
+  .prepare = NULL,
+  .check = NULL,
+  .dispatch = idle_monitor_dispatch_timeout,
+  .finalize = NULL,
+};
+
 static void
 meta_idle_monitor_init (MetaIdleMonitor *monitor)
 {
@@ -184,6 +260,17 @@ meta_idle_monitor_init (MetaIdleMonitor *monitor)
   monitor->watches = g_hash_table_new_full (NULL, NULL, NULL, free_watch);
   monitor->last_event_time = g_get_monotonic_time ();
 
+  monitor->idle_watches = g_sequence_new (NULL);
+  monitor->next_watch_iter = g_sequence_get_end_iter (monitor->idle_watches);
+  monitor->idle_serial = 1;
+  g_queue_init (&monitor->user_active_watches);
+
+  monitor->timeout_source = g_source_new (&idle_monitor_source_funcs,
+                                          sizeof (GSource));
+  g_source_set_name (monitor->timeout_source, "[mutter] Idle monitor");
+  g_source_set_callback (monitor->timeout_source, NULL, monitor, NULL);
+  g_source_attach (monitor->timeout_source, NULL);
+
   /* Monitor inhibitors */
   monitor->session_proxy =
     g_dbus_proxy_new_for_bus_sync (G_BUS_TYPE_SESSION,
@@ -222,34 +309,23 @@ get_next_watch_serial (void)
   return serial;
 }
 
-static gboolean
-idle_monitor_dispatch_timeout (GSource     *source,
-                               GSourceFunc  callback,
-                               gpointer     user_data)
+static int
+compare_idle_watches (gconstpointer a,
+                      gconstpointer b,
+                      gpointer      user_data)
 {
-  MetaIdleMonitorWatch *watch = (MetaIdleMonitorWatch *) user_data;
-  int64_t now;
-  int64_t ready_time;
+  const MetaIdleMonitorWatch *watch_a = a;
+  const MetaIdleMonitorWatch *watch_b = b;
 
-  now = g_source_get_time (source);
-  ready_time = g_source_get_ready_time (source);
-  if (ready_time > now)
-    return G_SOURCE_CONTINUE;
-
-  g_source_set_ready_time (watch->timeout_source, -1);
+  if (watch_a->timeout_msec != watch_b->timeout_msec)
+    return watch_a->timeout_msec < watch_b->timeout_msec ? -1 : 1;
 
-  meta_idle_monitor_watch_fire (watch);
+  if (watch_a->id != watch_b->id)
+    return watch_a->id < watch_b->id ? -1 : 1;
 
-  return G_SOURCE_CONTINUE;
+  return 0;
 }
 
-static GSourceFuncs idle_monitor_source_funcs = {
-  .prepare = NULL,
-  .check = NULL,
-  .dispatch = idle_monitor_dispatch_timeout,
-  .finalize = NULL,
-};
-
 static MetaIdleMonitorWatch *
 make_watch (MetaIdleMonitor           *monitor,
             guint64                    timeout_msec,
@@ -270,21 +346,22 @@ make_watch (MetaIdleMonitor           *monitor,
 
   if (timeout_msec != 0)
     {
-      GSource *source = g_source_new (&idle_monitor_source_funcs,
-                                      sizeof (GSource));
-      g_source_set_name (source, "[mutter] Idle monitor");
-
-      g_source_set_callback (source, NULL, watch, NULL);
-      if (!monitor->inhibited)
-        {
-          g_source_set_ready_time (source,
-                                   monitor->last_event_time +
-                                   timeout_msec * 1000);
-        }
-      g_source_attach (source, NULL);
-      g_source_unref (source);
-
-      watch->timeout_source = source;
+      watch->iter = g_sequence_insert_sorted (monitor->idle_watches,
+                                              watch,
+                                              compare_idle_watches,
+                                              NULL);
+
+      /* A watch for an idle time that has already passed is due right
+       * away, just like one that hasn't been reached yet */
+      if (g_sequence_iter_compare (watch->iter,
+                                   monitor->next_watch_iter) < 0)
+        monitor->next_watch_iter = watch->iter;
+
+      update_timeout (monitor);
+    }
+  else
+    {
+      g_queue_push_tail (&monitor->user_active_watches, watch);
     }
 
   g_hash_table_insert (monitor->watches,
@@ -407,42 +484,52 @@ meta_idle_monitor_get_idletime (MetaIdleMonitor *monitor)
 void
 meta_idle_monitor_reset_idletime (MetaIdleMonitor *monitor)
 {
-  GList *node, *watch_ids;
-
   monitor->last_event_time = g_get_monotonic_time ();
+  monitor->idle_serial++;
 
-  watch_ids = g_hash_table_get_keys (monitor->watches);
+  monitor->next_watch_iter = g_sequence_get_begin_iter (monitor->idle_watches);
 
-  for (node = watch_ids; node != NULL; node = node->next)
+  /* This happens for every input event, so the timeout is not moved
+   * forward here; firing early, it re-arms itself. It only needs updating
+   * when it would fire too late, i.e. when watches already fired. */
+  if (!g_sequence_iter_is_end (monitor->next_watch_iter))
     {
-      guint watch_id = GPOINTER_TO_UINT (node->data);
-      MetaIdleMonitorWatch *watch;
+      MetaIdleMonitorWatch *watch = g_sequence_get (monitor->next_watch_iter);
+      int64_t ready_time;
 
-      watch = g_hash_table_lookup (monitor->watches,
-                                   GUINT_TO_POINTER (watch_id));
-      if (!watch)
-        continue;
+      ready_time = g_source_get_ready_time (monitor->timeout_source);
+      if (ready_time == -1 || ready_time > get_watch_deadline (monitor, watch))
+        update_timeout (monitor);
+    }
+
+  if (!g_queue_is_empty (&monitor->user_active_watches))
+    {
+      GList *node, *watch_ids = NULL;
 
-      if (watch->timeout_msec == 0)
+      for (node = monitor->user_active_watches.head; node; node = node->next)
         {
-          meta_idle_monitor_watch_fire (watch);
+          MetaIdleMonitorWatch *watch = node->data;
+
+          watch_ids = g_list_prepend (watch_ids, GUINT_TO_POINTER (watch->id));
         }
-      else
+
+      watch_ids = g_list_reverse (watch_ids);
+
+      for (node = watch_ids; node != NULL; node = node->next)
         {
-          if (monitor->inhibited)
-            {
-              g_source_set_ready_time (watch->timeout_source, -1);
-            }
-          else
-            {
-              g_source_set_ready_time (watch->timeout_source,
-                                       monitor->last_event_time +
-                                       watch->timeout_msec * 1000);
-            }
+          guint watch_id = GPOINTER_TO_UINT (node->data);
+          MetaIdleMonitorWatch *watch;
+
+          watch = g_hash_table_lookup (monitor->watches,
+                                       GUINT_TO_POINTER (watch_id));
+          if (!watch)
+            continue;
+
+          meta_idle_monitor_watch_fire (watch);
         }
-    }
 
-  g_list_free (watch_ids);
+      g_list_free (watch_ids);
+    }
 }
 
 MetaIdleManager *
@@ -390,23 +390,18 @@ draw_cursor_sprite_via_offscreen (MetaScreenCastStreamSrc  *src,
   CoglPipeline *pipeline;
   CoglColor clear_color;
 
-  bitmap_texture = cogl_texture_2d_new_with_size (cogl_context,
-                                                  bitmap_width, bitmap_height);
-  cogl_texture_2d_set_auto_mipmap (COGL_TEXTURE_2D (bitmap_texture), FALSE);
-  if (!cogl_texture_allocate (bitmap_texture, error))
-    {
-      g_object_unref (bitmap_texture);
-      return FALSE;
-    }
+  /* The cursor is drawn into a bitmap of the same size on every frame,
+   * so let the offscreen be recycled instead of allocating a new one */
+  offscreen = cogl_offscreen_new_pooled (cogl_context,
+                                         COGL_PIXEL_FORMAT_ANY,
+                                         bitmap_width, bitmap_height,
+                                         error);
+  if (!offscreen)
+    return FALSE;
 
-  offscreen = cogl_offscreen_new_with_texture (bitmap_texture);
   fb = COGL_FRAMEBUFFER (offscreen);
-  g_object_unref (bitmap_texture);
-  if (!cogl_framebuffer_allocate (fb, error))
-    {
-      g_object_unref (fb);
-      return FALSE;
-    }
+  bitmap_texture = cogl_offscreen_get_texture (offscreen);
+  cogl_texture_2d_set_auto_mipmap (COGL_TEXTURE_2D (bitmap_texture), FALSE);
 
   pipeline = cogl_pipeline_new (cogl_context);
   cogl_pipeline_set_layer_texture (pipeline, 0, cursor_texture);
@@ -427,7 +422,7 @@ draw_cursor_sprite_via_offscreen (MetaScreenCastStreamSrc  *src,
                                 bitmap_width, bitmap_height,
                                 COGL_PIXEL_FORMAT_RGBA_8888_PRE,
                                 bitmap_data);
-  g_object_unref (fb);
+  cogl_offscreen_release (offscreen);
 
   return TRUE;
 }
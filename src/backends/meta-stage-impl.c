@@ -385,6 +385,7 @@ static void
 paint_stage (MetaStageImpl    *stage_impl,
              ClutterStageView *stage_view,
              MtkRegion        *redraw_clip,
+             MtkRegion        *repair_clip,
              ClutterFrame     *frame)
 {
   ClutterStage *stage = stage_impl->wrapper;
@@ -392,7 +393,7 @@ paint_stage (MetaStageImpl    *stage_impl,
   _clutter_stage_maybe_setup_viewport (stage, stage_view);
   clutter_stage_paint_view (stage, stage_view, redraw_clip, frame);
 
-  clutter_stage_view_after_paint (stage_view, redraw_clip);
+  clutter_stage_view_after_paint (stage_view, redraw_clip, repair_clip);
 }
 
 static MtkRegion *
@@ -480,10 +481,13 @@ meta_stage_impl_redraw_view_primary (MetaStageImpl    *stage_impl,
   gboolean use_clipped_redraw;
   gboolean buffer_has_valid_damage_history = FALSE;
   gboolean has_buffer_age;
+  gboolean has_intermediate_framebuffer;
   gboolean swap_with_damage;
   g_autoptr (MtkRegion) redraw_clip = NULL;
+  g_autoptr (MtkRegion) repair_clip = NULL;
   g_autoptr (MtkRegion) queued_redraw_clip = NULL;
   g_autoptr (MtkRegion) fb_clip_region = NULL;
+  g_autoptr (MtkRegion) fb_repair_region = NULL;
   g_autoptr (MtkRegion) swap_region = NULL;
   ClutterDrawDebugFlag paint_debug_flags;
   ClutterDamageHistory *damage_history;
@@ -506,6 +510,11 @@ meta_stage_impl_redraw_view_primary (MetaStageImpl    *stage_impl,
     COGL_IS_ONSCREEN (onscreen) &&
     cogl_context_has_winsys_feature (context, COGL_WINSYS_FEATURE_BUFFER_AGE);
 
+  /* Offscreen and shadow framebuffers keep their contents between frames,
+   * so the stage only needs to be painted where it changed; it's just the
+   * copy to the onscreen that has to make up for the buffer age. */
+  has_intermediate_framebuffer = fb != onscreen;
+
   redraw_clip = clutter_stage_view_take_accumulated_redraw_clip (stage_view);
 
   /* NB: a NULL redraw clip == full stage redraw */
@@ -580,8 +589,6 @@ meta_stage_impl_redraw_view_primary (MetaStageImpl    *stage_impl,
   /* swap_region does not need damage history, set it up before that */
   if (!use_clipped_redraw)
     swap_region = mtk_region_create ();
-  else if (clutter_stage_view_has_shadowfb (stage_view))
-    swap_region = mtk_region_ref (fb_clip_region);
   else
     swap_region = mtk_region_copy (fb_clip_region);
 
@@ -594,20 +601,32 @@ meta_stage_impl_redraw_view_primary (MetaStageImpl    *stage_impl,
         {
           int age;
 
+          if (has_intermediate_framebuffer)
+            fb_repair_region = mtk_region_copy (fb_clip_region);
+          else
+            fb_repair_region = mtk_region_ref (fb_clip_region);
+
           for (age = 1; age <= buffer_age; age++)
             {
               const MtkRegion *old_damage;
 
               old_damage =
                 clutter_damage_history_lookup (damage_history, age);
-              mtk_region_union (fb_clip_region, old_damage);
+              mtk_region_union (fb_repair_region, old_damage);
             }
 
           meta_topic (META_DEBUG_BACKEND,
-                      "Reusing back buffer(age=%d) - repairing region: num rects: %d",
+                      "Reusing back buffer(age=%d) - repairing region: num rects: %d, "
+                      "repainted: %d",
                       buffer_age,
+                      mtk_region_num_rectangles (fb_repair_region),
                       mtk_region_num_rectangles (fb_clip_region));
 
+          /* The shadow framebuffer is copied to the onscreen using the
+           * swap region, so that needs to cover the whole repair region */
+          if (clutter_stage_view_has_shadowfb (stage_view))
+            mtk_region_union (swap_region, fb_repair_region);
+
           swap_with_damage = TRUE;
         }
 
@@ -629,14 +648,27 @@ meta_stage_impl_redraw_view_primary (MetaStageImpl    *stage_impl,
                                                    1.0f / fb_scale,
                                                    view_rect.x,
                                                    view_rect.y);
+
+      if (fb_repair_region)
+        {
+          repair_clip = scale_offset_and_clamp_region (fb_repair_region,
+                                                       1.0f / fb_scale,
+                                                       view_rect.x,
+                                                       view_rect.y);
+        }
     }
 
+  if (!repair_clip)
+    repair_clip = mtk_region_ref (redraw_clip);
+
   if (paint_debug_flags & CLUTTER_DEBUG_PAINT_DAMAGE_REGION)
     {
       g_autoptr (MtkRegion) debug_redraw_clip = NULL;
 
       debug_redraw_clip = mtk_region_create_rectangle (&view_rect);
-      paint_stage (stage_impl, stage_view, debug_redraw_clip, frame);
+      paint_stage (stage_impl, stage_view,
+                   debug_redraw_clip, debug_redraw_clip,
+                   frame);
     }
   else if (use_clipped_redraw)
     {
@@ -644,7 +676,7 @@ meta_stage_impl_redraw_view_primary (MetaStageImpl    *stage_impl,
 
       cogl_framebuffer_push_region_clip (fb, fb_clip_region);
 
-      paint_stage (stage_impl, stage_view, redraw_clip, frame);
+      paint_stage (stage_impl, stage_view, redraw_clip, repair_clip, frame);
 
       cogl_framebuffer_pop_clip (fb);
     }
@@ -652,7 +684,7 @@ meta_stage_impl_redraw_view_primary (MetaStageImpl    *stage_impl,
     {
       meta_topic (META_DEBUG_BACKEND, "Unclipped stage paint");
 
-      paint_stage (stage_impl, stage_view, redraw_clip, frame);
+      paint_stage (stage_impl, stage_view, redraw_clip, repair_clip, frame);
     }
 
 #ifdef HAVE_PROFILER
@@ -685,7 +717,9 @@ meta_stage_impl_redraw_view_primary (MetaStageImpl    *stage_impl,
 #endif
 
   g_clear_pointer (&redraw_clip, mtk_region_unref);
+  g_clear_pointer (&repair_clip, mtk_region_unref);
   g_clear_pointer (&fb_clip_region, mtk_region_unref);
+  g_clear_pointer (&fb_repair_region, mtk_region_unref);
 
   if (queued_redraw_clip)
     {
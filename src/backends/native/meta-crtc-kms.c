@@ -53,6 +53,7 @@ struct _MetaCrtcKms
 
   MetaKmsPlane *assigned_primary_plane;
   MetaKmsPlane *assigned_cursor_plane;
+  MetaKmsPlane *assigned_overlay_plane;
 };
 
 static GQuark kms_crtc_crtc_kms_quark;
@@ -223,6 +224,7 @@ typedef struct _CrtcKmsAssignment
 {
   MetaKmsPlane *primary_plane;
   MetaKmsPlane *cursor_plane;
+  MetaKmsPlane *overlay_plane;
 } CrtcKmsAssignment;
 
 static gboolean
@@ -253,7 +255,9 @@ is_plane_assigned (MetaKmsPlane     *plane,
             return TRUE;
           break;
         case META_KMS_PLANE_TYPE_OVERLAY:
-          g_assert_not_reached ();
+          if (kms_assignment->overlay_plane == plane)
+            return TRUE;
+          break;
         }
     }
 
@@ -320,6 +324,7 @@ meta_crtc_kms_assign_extra (MetaCrtc            *crtc,
   MetaCrtcKms *crtc_kms = META_CRTC_KMS (crtc);
   MetaKmsPlane *primary_plane;
   MetaKmsPlane *cursor_plane;
+  MetaKmsPlane *overlay_plane;
   CrtcKmsAssignment *kms_assignment;
 
   primary_plane = find_unassigned_plane (crtc_kms, META_KMS_PLANE_TYPE_PRIMARY,
@@ -338,10 +343,13 @@ meta_crtc_kms_assign_extra (MetaCrtc            *crtc,
 
   cursor_plane = find_unassigned_plane (crtc_kms, META_KMS_PLANE_TYPE_CURSOR,
                                         crtc_assignments);
+  overlay_plane = find_unassigned_plane (crtc_kms, META_KMS_PLANE_TYPE_OVERLAY,
+                                         crtc_assignments);
 
   kms_assignment = g_new0 (CrtcKmsAssignment, 1);
   kms_assignment->primary_plane = primary_plane;
   kms_assignment->cursor_plane = cursor_plane;
+  kms_assignment->overlay_plane = overlay_plane;
 
   crtc_assignment->backend_private = kms_assignment;
   crtc_assignment->backend_private_destroy = g_free;
@@ -359,6 +367,7 @@ meta_crtc_kms_set_config (MetaCrtc             *crtc,
 
   crtc_kms->assigned_primary_plane = kms_assignment->primary_plane;
   crtc_kms->assigned_cursor_plane = kms_assignment->cursor_plane;
+  crtc_kms->assigned_overlay_plane = kms_assignment->overlay_plane;
 }
 
 void
@@ -368,6 +377,7 @@ meta_crtc_kms_assign_planes (MetaCrtcKms  *crtc_kms,
 {
   crtc_kms->assigned_primary_plane = primary_plane;
   crtc_kms->assigned_cursor_plane = cursor_plane;
+  crtc_kms->assigned_overlay_plane = NULL;
 }
 
 static void
@@ -380,6 +390,7 @@ meta_crtc_kms_unset_config (MetaCrtc *crtc)
 
   crtc_kms->assigned_primary_plane = NULL;
   crtc_kms->assigned_cursor_plane = NULL;
+  crtc_kms->assigned_overlay_plane = NULL;
 }
 
 static gboolean
@@ -419,6 +430,39 @@ meta_crtc_kms_get_assigned_cursor_plane (MetaCrtcKms *crtc_kms)
   return crtc_kms->assigned_cursor_plane;
 }
 
+MetaKmsPlane *
+meta_crtc_kms_get_assigned_overlay_plane (MetaCrtcKms *crtc_kms)
+{
+  return crtc_kms->assigned_overlay_plane;
+}
+
+gboolean
+meta_crtc_kms_is_overlay_plane_above_primary (MetaCrtcKms *crtc_kms)
+{
+  MetaKmsPlane *primary_plane = crtc_kms->assigned_primary_plane;
+  MetaKmsPlane *overlay_plane = crtc_kms->assigned_overlay_plane;
+  uint64_t primary_zpos;
+  uint64_t overlay_zpos;
+  gboolean has_primary_zpos;
+  gboolean has_overlay_zpos;
+
+  if (!primary_plane || !overlay_plane)
+    return FALSE;
+
+  has_primary_zpos = meta_kms_plane_get_zpos (primary_plane, &primary_zpos);
+  has_overlay_zpos = meta_kms_plane_get_zpos (overlay_plane, &overlay_zpos);
+
+  /* Without zpos, overlay planes are conventionally stacked above the
+   * primary plane. */
+  if (!has_primary_zpos && !has_overlay_zpos)
+    return TRUE;
+
+  if (!has_primary_zpos || !has_overlay_zpos)
+    return FALSE;
+
+  return overlay_zpos > primary_zpos;
+}
+
 MetaKmsPlane *
 meta_crtc_kms_get_assigned_primary_plane (MetaCrtcKms *crtc_kms)
 {
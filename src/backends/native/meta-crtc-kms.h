@@ -41,6 +41,11 @@ MetaKmsPlane * meta_crtc_kms_get_assigned_primary_plane (MetaCrtcKms *crtc_kms);
 
 MetaKmsPlane * meta_crtc_kms_get_assigned_cursor_plane (MetaCrtcKms *crtc_kms);
 
+META_EXPORT_TEST
+MetaKmsPlane * meta_crtc_kms_get_assigned_overlay_plane (MetaCrtcKms *crtc_kms);
+
+gboolean meta_crtc_kms_is_overlay_plane_above_primary (MetaCrtcKms *crtc_kms);
+
 void meta_crtc_kms_assign_planes (MetaCrtcKms  *crtc_kms,
                                   MetaKmsPlane *primary_plane,
                                   MetaKmsPlane *cursor_plane);
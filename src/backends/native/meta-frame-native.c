@@ -31,6 +31,7 @@ struct _MetaFrameNative
 
   MetaDrmBuffer *buffer;
   CoglScanout *scanout;
+  CoglScanout *overlay_scanout;
 
   MetaKmsUpdate *kms_update;
 
@@ -47,6 +48,7 @@ meta_frame_native_release (ClutterFrame *frame)
   g_clear_pointer (&frame_native->damage, mtk_region_unref);
   g_clear_object (&frame_native->buffer);
   g_clear_object (&frame_native->scanout);
+  g_clear_object (&frame_native->overlay_scanout);
 
   g_return_if_fail (!frame_native->kms_update);
 }
@@ -121,6 +123,19 @@ meta_frame_native_get_scanout (MetaFrameNative *frame_native)
   return frame_native->scanout;
 }
 
+void
+meta_frame_native_set_overlay_scanout (MetaFrameNative *frame_native,
+                                       CoglScanout     *scanout)
+{
+  g_set_object (&frame_native->overlay_scanout, scanout);
+}
+
+CoglScanout *
+meta_frame_native_get_overlay_scanout (MetaFrameNative *frame_native)
+{
+  return frame_native->overlay_scanout;
+}
+
 void
 meta_frame_native_set_damage (MetaFrameNative *frame_native,
                               const MtkRegion *damage)
@@ -103,6 +103,19 @@ meta_kms_plane_get_cursor_size_hints (MetaKmsPlane *plane)
   return &plane->size_hints;
 }
 
+gboolean
+meta_kms_plane_get_zpos (MetaKmsPlane *plane,
+                         uint64_t     *zpos)
+{
+  MetaKmsProp *prop = &plane->prop_table.props[META_KMS_PLANE_PROP_ZPOS];
+
+  if (!prop->prop_id)
+    return FALSE;
+
+  *zpos = prop->value;
+  return TRUE;
+}
+
 uint32_t
 meta_kms_plane_get_prop_id (MetaKmsPlane     *plane,
                             MetaKmsPlaneProp  prop)
@@ -684,6 +697,11 @@ init_properties (MetaKmsPlane            *plane,
           .num_enum_values = META_KMS_PLANE_YCBCR_COLOR_RANGE_N_PROPS,
           .default_value = META_KMS_PLANE_YCBCR_COLOR_RANGE_LIMITED,
         },
+      [META_KMS_PLANE_PROP_ZPOS] =
+        {
+          .name = "zpos",
+          .type = DRM_MODE_PROP_RANGE,
+        },
     },
     .rotation_bitmask = {
       [META_KMS_PLANE_ROTATION_BIT_ROTATE_0] =
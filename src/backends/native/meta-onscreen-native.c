@@ -86,6 +86,16 @@ typedef struct _MetaOnscreenNativeSecondaryGpuState
   MetaSharedFramebufferImportStatus import_status;
 } MetaOnscreenNativeSecondaryGpuState;
 
+typedef struct _OverlayTestKey
+{
+  uint32_t format;
+  uint64_t modifier;
+  int src_width;
+  int src_height;
+  int dst_width;
+  int dst_height;
+} OverlayTestKey;
+
 typedef struct _KmsProperty
 {
   gboolean invalidated;
@@ -126,6 +136,14 @@ struct _MetaOnscreenNative
   gboolean frame_sync_requested;
   gboolean frame_sync_enabled;
 
+  /* The overlay plane last assigned a buffer, if any */
+  MetaKmsPlane *active_overlay_plane;
+
+  /* Results of overlay plane test commits, by OverlayTestKey, for the
+   * overlay plane they were made with */
+  GHashTable *overlay_test_results;
+  MetaKmsPlane *overlay_test_plane;
+
   MetaRendererView *view;
 
   union {
@@ -528,17 +546,17 @@ apply_color_range (MetaKmsPlaneAssignment *kms_plane_assignment,
 }
 
 static MetaKmsPlaneAssignment *
-assign_primary_plane (MetaCrtcKms            *crtc_kms,
-                      MetaDrmBuffer          *buffer,
-                      MetaKmsUpdate          *kms_update,
-                      MetaKmsAssignPlaneFlag  flags,
-                      const graphene_rect_t  *src_rect,
-                      const MtkRectangle     *dst_rect)
+assign_plane (MetaCrtcKms            *crtc_kms,
+              MetaKmsPlane           *kms_plane,
+              MetaDrmBuffer          *buffer,
+              MetaKmsUpdate          *kms_update,
+              MetaKmsAssignPlaneFlag  flags,
+              const graphene_rect_t  *src_rect,
+              const MtkRectangle     *dst_rect)
 {
   MetaCrtc *crtc = META_CRTC (crtc_kms);
   MetaFixed16Rectangle src_rect_fixed16;
   MetaKmsCrtc *kms_crtc;
-  MetaKmsPlane *primary_kms_plane;
   MetaKmsPlaneAssignment *plane_assignment;
 
   src_rect_fixed16 = (MetaFixed16Rectangle) {
@@ -549,29 +567,157 @@ assign_primary_plane (MetaCrtcKms            *crtc_kms,
   };
 
   meta_topic (META_DEBUG_KMS,
-              "Assigning buffer to primary plane update on CRTC "
+              "Assigning buffer to %s plane update on CRTC "
               "(%" G_GUINT64_FORMAT ") with src rect %f,%f %fx%f "
               "and dst rect %d,%d %dx%d",
+              meta_kms_plane_type_to_string (meta_kms_plane_get_plane_type (kms_plane)),
               meta_crtc_get_id (crtc), src_rect->origin.x, src_rect->origin.y,
               src_rect->size.width, src_rect->size.height,
               dst_rect->x, dst_rect->y, dst_rect->width, dst_rect->height);
 
   kms_crtc = meta_crtc_kms_get_kms_crtc (crtc_kms);
-  primary_kms_plane = meta_crtc_kms_get_assigned_primary_plane (crtc_kms);
   plane_assignment = meta_kms_update_assign_plane (kms_update,
                                                    kms_crtc,
-                                                   primary_kms_plane,
+                                                   kms_plane,
                                                    buffer,
                                                    src_rect_fixed16,
                                                    *dst_rect,
                                                    flags);
-  apply_transform (crtc_kms, plane_assignment, primary_kms_plane);
-  apply_color_encoding (plane_assignment, primary_kms_plane);
-  apply_color_range (plane_assignment, primary_kms_plane);
+  apply_transform (crtc_kms, plane_assignment, kms_plane);
+  apply_color_encoding (plane_assignment, kms_plane);
+  apply_color_range (plane_assignment, kms_plane);
 
   return plane_assignment;
 }
 
+static MetaKmsPlaneAssignment *
+assign_primary_plane (MetaCrtcKms            *crtc_kms,
+                      MetaDrmBuffer          *buffer,
+                      MetaKmsUpdate          *kms_update,
+                      MetaKmsAssignPlaneFlag  flags,
+                      const graphene_rect_t  *src_rect,
+                      const MtkRectangle     *dst_rect)
+{
+  return assign_plane (crtc_kms,
+                       meta_crtc_kms_get_assigned_primary_plane (crtc_kms),
+                       buffer,
+                       kms_update,
+                       flags,
+                       src_rect,
+                       dst_rect);
+}
+
+typedef struct _OverlayScanoutResult
+{
+  MetaOnscreenNative *onscreen_native;
+  CoglScanout *scanout;
+} OverlayScanoutResult;
+
+static void
+overlay_scanout_result_free (gpointer user_data)
+{
+  OverlayScanoutResult *result = user_data;
+
+  g_object_unref (result->onscreen_native);
+  g_object_unref (result->scanout);
+  g_free (result);
+}
+
+static void
+overlay_scanout_result_feedback (const MetaKmsFeedback *kms_feedback,
+                                 gpointer               user_data)
+{
+  OverlayScanoutResult *result = user_data;
+  MetaOnscreenNative *onscreen_native = result->onscreen_native;
+  const GError *error;
+
+  error = meta_kms_feedback_get_error (kms_feedback);
+  if (!error ||
+      g_error_matches (error, META_KMS_ERROR, META_KMS_ERROR_DISCARDED) ||
+      g_error_matches (error, G_IO_ERROR, G_IO_ERROR_PERMISSION_DENIED))
+    return;
+
+  meta_topic (META_DEBUG_KMS,
+              "Page flip with overlay plane failed, falling back to "
+              "compositing: %s", error->message);
+
+  /* Don't try to put the same buffer on the overlay plane again, and make
+   * sure the next frame composites it instead. The test commit results
+   * evidently don't hold anymore either. */
+  cogl_scanout_notify_failed (result->scanout,
+                              COGL_ONSCREEN (onscreen_native));
+  onscreen_native->active_overlay_plane = NULL;
+  g_hash_table_remove_all (onscreen_native->overlay_test_results);
+
+  if (onscreen_native->view)
+    {
+      ClutterStageView *view = CLUTTER_STAGE_VIEW (onscreen_native->view);
+
+      clutter_stage_view_add_redraw_clip (view, NULL);
+      clutter_stage_view_schedule_update_now (view);
+    }
+}
+
+static const MetaKmsResultListenerVtable overlay_scanout_result_listener_vtable = {
+  .feedback = overlay_scanout_result_feedback,
+};
+
+static void
+update_overlay_plane (MetaOnscreenNative *onscreen_native,
+                      MetaFrameNative    *frame_native,
+                      MetaKmsUpdate      *kms_update)
+{
+  MetaCrtcKms *crtc_kms = META_CRTC_KMS (onscreen_native->crtc);
+  MetaKmsCrtc *kms_crtc = meta_crtc_kms_get_kms_crtc (crtc_kms);
+  MetaKmsPlane *overlay_plane;
+  CoglScanout *scanout;
+
+  overlay_plane = meta_crtc_kms_get_assigned_overlay_plane (crtc_kms);
+  scanout = meta_frame_native_get_overlay_scanout (frame_native);
+
+  if (onscreen_native->active_overlay_plane &&
+      (!scanout || onscreen_native->active_overlay_plane != overlay_plane))
+    {
+      meta_topic (META_DEBUG_KMS,
+                  "Disabling overlay plane %u on CRTC %u",
+                  meta_kms_plane_get_id (onscreen_native->active_overlay_plane),
+                  meta_kms_crtc_get_id (kms_crtc));
+
+      meta_kms_update_unassign_plane (kms_update,
+                                      kms_crtc,
+                                      onscreen_native->active_overlay_plane);
+      onscreen_native->active_overlay_plane = NULL;
+    }
+
+  if (scanout && overlay_plane)
+    {
+      OverlayScanoutResult *result;
+      graphene_rect_t src_rect;
+      MtkRectangle dst_rect;
+
+      cogl_scanout_get_src_rect (scanout, &src_rect);
+      cogl_scanout_get_dst_rect (scanout, &dst_rect);
+
+      assign_plane (crtc_kms,
+                    overlay_plane,
+                    META_DRM_BUFFER (cogl_scanout_get_buffer (scanout)),
+                    kms_update,
+                    META_KMS_ASSIGN_PLANE_FLAG_DISABLE_IMPLICIT_SYNC,
+                    &src_rect,
+                    &dst_rect);
+      onscreen_native->active_overlay_plane = overlay_plane;
+
+      result = g_new0 (OverlayScanoutResult, 1);
+      result->onscreen_native = g_object_ref (onscreen_native);
+      result->scanout = g_object_ref (scanout);
+      meta_kms_update_add_result_listener (kms_update,
+                                           &overlay_scanout_result_listener_vtable,
+                                           NULL,
+                                           result,
+                                           overlay_scanout_result_free);
+    }
+}
+
 static gboolean
 meta_onscreen_native_flip_crtc (CoglOnscreen           *onscreen,
                                 ClutterFrame           *frame,
@@ -644,6 +790,8 @@ meta_onscreen_native_flip_crtc (CoglOnscreen           *onscreen,
 
       if (region && !mtk_region_is_empty (region))
         meta_kms_plane_assignment_set_fb_damage (plane_assignment, region);
+
+      update_overlay_plane (onscreen_native, frame_native, kms_update);
       break;
     case META_RENDERER_NATIVE_MODE_SURFACELESS:
       g_assert_not_reached ();
@@ -1806,6 +1954,115 @@ meta_onscreen_native_is_buffer_scanout_compatible (CoglOnscreen *onscreen,
   return result == META_KMS_FEEDBACK_PASSED;
 }
 
+static guint
+overlay_test_key_hash (gconstpointer data)
+{
+  const OverlayTestKey *key = data;
+
+  return (g_int64_hash (&key->modifier) ^
+          key->format ^
+          (key->src_width << 16 | key->src_height) ^
+          (key->dst_width << 8 | key->dst_height << 24));
+}
+
+static gboolean
+overlay_test_key_equal (gconstpointer a,
+                        gconstpointer b)
+{
+  const OverlayTestKey *key_a = a;
+  const OverlayTestKey *key_b = b;
+
+  return (key_a->format == key_b->format &&
+          key_a->modifier == key_b->modifier &&
+          key_a->src_width == key_b->src_width &&
+          key_a->src_height == key_b->src_height &&
+          key_a->dst_width == key_b->dst_width &&
+          key_a->dst_height == key_b->dst_height);
+}
+
+gboolean
+meta_onscreen_native_is_buffer_overlay_compatible (CoglOnscreen *onscreen,
+                                                   CoglScanout  *scanout)
+{
+  MetaOnscreenNative *onscreen_native = META_ONSCREEN_NATIVE (onscreen);
+  MetaCrtc *crtc = onscreen_native->crtc;
+  MetaCrtcKms *crtc_kms = META_CRTC_KMS (crtc);
+  MetaGpuKms *gpu_kms;
+  MetaKmsDevice *kms_device;
+  MetaKmsCrtc *kms_crtc;
+  MetaKmsPlane *overlay_plane;
+  MetaKmsUpdate *test_update;
+  MetaDrmBuffer *buffer;
+  g_autoptr (MetaKmsFeedback) kms_feedback = NULL;
+  MetaKmsFeedbackResult result;
+  graphene_rect_t src_rect;
+  MtkRectangle dst_rect;
+  OverlayTestKey key;
+  gpointer cached_result;
+  gboolean passed;
+
+  overlay_plane = meta_crtc_kms_get_assigned_overlay_plane (crtc_kms);
+  if (!overlay_plane)
+    return FALSE;
+
+  cogl_scanout_get_src_rect (scanout, &src_rect);
+  cogl_scanout_get_dst_rect (scanout, &dst_rect);
+  buffer = META_DRM_BUFFER (cogl_scanout_get_buffer (scanout));
+
+  if (onscreen_native->overlay_test_plane != overlay_plane)
+    {
+      g_hash_table_remove_all (onscreen_native->overlay_test_results);
+      onscreen_native->overlay_test_plane = overlay_plane;
+    }
+
+  /* Test commits are synchronous, so avoid doing one for every frame of a
+   * windowed client; what matters to the display controller is the kind
+   * of buffer and how it is scaled, not the buffer itself. */
+  key = (OverlayTestKey) {
+    .format = meta_drm_buffer_get_format (buffer),
+    .modifier = meta_drm_buffer_get_modifier (buffer),
+    .src_width = (int) src_rect.size.width,
+    .src_height = (int) src_rect.size.height,
+    .dst_width = dst_rect.width,
+    .dst_height = dst_rect.height,
+  };
+  if (g_hash_table_lookup_extended (onscreen_native->overlay_test_results,
+                                    &key, NULL, &cached_result))
+    return GPOINTER_TO_INT (cached_result);
+
+  gpu_kms = META_GPU_KMS (meta_crtc_get_gpu (crtc));
+  kms_device = meta_gpu_kms_get_kms_device (gpu_kms);
+  kms_crtc = meta_crtc_kms_get_kms_crtc (crtc_kms);
+
+  test_update = meta_kms_update_new (kms_device);
+
+  assign_plane (crtc_kms,
+                overlay_plane,
+                buffer,
+                test_update,
+                META_KMS_ASSIGN_PLANE_FLAG_DISABLE_IMPLICIT_SYNC,
+                &src_rect,
+                &dst_rect);
+
+  meta_topic (META_DEBUG_KMS,
+              "Posting overlay plane test update for CRTC %u (%s) synchronously",
+              meta_kms_crtc_get_id (kms_crtc),
+              meta_kms_device_get_path (kms_device));
+
+  kms_feedback =
+    meta_kms_device_process_update_sync (kms_device, test_update,
+                                         META_KMS_UPDATE_FLAG_TEST_ONLY);
+
+  result = meta_kms_feedback_get_result (kms_feedback);
+  passed = result == META_KMS_FEEDBACK_PASSED;
+
+  g_hash_table_insert (onscreen_native->overlay_test_results,
+                       g_memdup2 (&key, sizeof (key)),
+                       GINT_TO_POINTER (passed));
+
+  return passed;
+}
+
 static void
 scanout_result_feedback (const MetaKmsFeedback *kms_feedback,
                          gpointer               user_data)
@@ -3042,6 +3299,8 @@ meta_onscreen_native_dispose (GObject *object)
   meta_onscreen_native_discard_pending_swaps (onscreen);
   g_clear_pointer (&onscreen_native->posted_frame, clutter_frame_unref);
   g_clear_pointer (&onscreen_native->presented_frame, clutter_frame_unref);
+  g_clear_pointer (&onscreen_native->overlay_test_results,
+                   g_hash_table_unref);
 
   renderer_gpu_data =
     meta_renderer_native_get_gpu_data (renderer_native,
@@ -3087,6 +3346,11 @@ meta_onscreen_native_dispose (GObject *object)
 static void
 meta_onscreen_native_init (MetaOnscreenNative *onscreen_native)
 {
+  onscreen_native->overlay_test_results =
+    g_hash_table_new_full (overlay_test_key_hash,
+                           overlay_test_key_equal,
+                           g_free,
+                           NULL);
 }
 
 static void
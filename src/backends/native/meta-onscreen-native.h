@@ -48,6 +48,9 @@ void meta_onscreen_native_dummy_power_save_page_flip (CoglOnscreen *onscreen);
 gboolean meta_onscreen_native_is_buffer_scanout_compatible (CoglOnscreen *onscreen,
                                                             CoglScanout  *scanout);
 
+gboolean meta_onscreen_native_is_buffer_overlay_compatible (CoglOnscreen *onscreen,
+                                                            CoglScanout  *scanout);
+
 void meta_onscreen_native_discard_pending_swaps (CoglOnscreen *onscreen);
 
 void meta_onscreen_native_set_view (CoglOnscreen     *onscreen,
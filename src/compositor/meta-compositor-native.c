@@ -41,7 +41,8 @@ meta_compositor_native_before_paint (MetaCompositor     *compositor,
 
 #ifdef HAVE_WAYLAND
   meta_compositor_view_native_maybe_assign_scanout (compositor_view_native,
-                                                    compositor);
+                                                    compositor,
+                                                    frame);
 #endif
 
   meta_compositor_view_native_maybe_update_frame_sync_surface (compositor_view_native,
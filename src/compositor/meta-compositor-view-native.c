@@ -34,7 +34,9 @@
 #include "core/window-private.h"
 
 #ifdef HAVE_WAYLAND
+#include "backends/native/meta-frame-native.h"
 #include "compositor/meta-surface-actor-wayland.h"
+#include "compositor/meta-window-actor-wayland.h"
 #include "wayland/meta-wayland-surface-private.h"
 #endif /* HAVE_WAYLAND */
 
@@ -47,6 +49,7 @@ struct _MetaCompositorViewNative
 
 #ifdef HAVE_WAYLAND
   MetaWaylandSurface *scanout_candidate;
+  MetaSurfaceActor *overlay_surface_actor;
 #endif /* HAVE_WAYLAND */
 
   MetaSurfaceActor *frame_sync_surface;
@@ -139,6 +142,42 @@ update_scanout_candidate (MetaCompositorViewNative *view_native,
     }
 }
 
+static gboolean
+is_software_cursor_within (MetaCompositor        *compositor,
+                           ClutterStageView      *stage_view,
+                           const graphene_rect_t *rect)
+{
+  MetaBackend *backend = meta_compositor_get_backend (compositor);
+  MetaCursorTracker *cursor_tracker =
+    meta_backend_get_cursor_tracker (backend);
+  CoglTexture *cursor_sprite;
+  graphene_rect_t cursor_rect;
+  graphene_point_t position;
+  float scale;
+  int hotspot_x;
+  int hotspot_y;
+
+  cursor_sprite = meta_cursor_tracker_get_sprite (cursor_tracker);
+  if (!cursor_sprite ||
+      !meta_cursor_tracker_get_pointer_visible (cursor_tracker) ||
+      meta_stage_view_is_cursor_overlay_inhibited (META_STAGE_VIEW (stage_view)))
+    return FALSE;
+
+  meta_cursor_tracker_get_pointer (cursor_tracker, &position, NULL);
+  meta_cursor_tracker_get_hot (cursor_tracker, &hotspot_x, &hotspot_y);
+
+  scale = (clutter_stage_view_get_scale (stage_view) *
+           meta_cursor_tracker_get_scale (cursor_tracker));
+
+  graphene_rect_init (&cursor_rect,
+                      position.x - (hotspot_x * scale),
+                      position.y - (hotspot_y * scale),
+                      cogl_texture_get_width (cursor_sprite) * scale,
+                      cogl_texture_get_height (cursor_sprite) * scale);
+
+  return graphene_rect_intersection (rect, &cursor_rect, NULL);
+}
+
 static gboolean
 find_scanout_candidate (MetaCompositorView  *compositor_view,
                         MetaCompositor      *compositor,
@@ -150,14 +189,11 @@ find_scanout_candidate (MetaCompositorView  *compositor_view,
     meta_compositor_view_get_stage_view (compositor_view);
   MetaStageView *view = META_STAGE_VIEW (stage_view);
   MetaRendererView *renderer_view = META_RENDERER_VIEW (stage_view);
-  MetaBackend *backend = meta_compositor_get_backend (compositor);
-  MetaCursorTracker *cursor_tracker =
-    meta_backend_get_cursor_tracker (backend);
-  CoglTexture *cursor_sprite;
   MetaCrtc *crtc;
   CoglFramebuffer *framebuffer;
   MetaWindowActor *window_actor;
   MtkRectangle view_rect;
+  graphene_rect_t graphene_view_rect;
   ClutterActorBox actor_box;
   MetaSurfaceActor *surface_actor;
   MetaSurfaceActorWayland *surface_actor_wayland;
@@ -175,39 +211,12 @@ find_scanout_candidate (MetaCompositorView  *compositor_view,
 
   clutter_stage_view_get_layout (stage_view, &view_rect);
 
-  cursor_sprite = meta_cursor_tracker_get_sprite (cursor_tracker);
-  if (cursor_sprite &&
-      meta_cursor_tracker_get_pointer_visible (cursor_tracker) &&
-      !meta_stage_view_is_cursor_overlay_inhibited (view))
-    {
-      graphene_rect_t graphene_view_rect;
-      graphene_rect_t cursor_rect;
-      graphene_point_t position;
-      float scale;
-      int hotspot_x;
-      int hotspot_y;
-
-      meta_cursor_tracker_get_pointer (cursor_tracker, &position, NULL);
-      meta_cursor_tracker_get_hot (cursor_tracker, &hotspot_x, &hotspot_y);
-
-      scale = (clutter_stage_view_get_scale (stage_view) *
-               meta_cursor_tracker_get_scale (cursor_tracker));
-
-      graphene_rect_init (&cursor_rect,
-                          position.x - (hotspot_x * scale),
-                          position.y - (hotspot_y * scale),
-                          cogl_texture_get_width (cursor_sprite) * scale,
-                          cogl_texture_get_height (cursor_sprite) * scale);
-
-      graphene_view_rect = mtk_rectangle_to_graphene_rect (&view_rect);
-      if (graphene_rect_intersection (&graphene_view_rect,
-                                      &cursor_rect,
-                                      NULL))
-        {
-          meta_topic (META_DEBUG_RENDER,
-                      "No direct scanout candidate: using software cursor");
-          return FALSE;
-        }
+  graphene_view_rect = mtk_rectangle_to_graphene_rect (&view_rect);
+  if (is_software_cursor_within (compositor, stage_view, &graphene_view_rect))
+    {
+      meta_topic (META_DEBUG_RENDER,
+                  "No direct scanout candidate: using software cursor");
+      return FALSE;
     }
 
   crtc = meta_renderer_view_get_crtc (renderer_view);
@@ -373,9 +382,366 @@ try_assign_next_scanout (MetaCompositorView *compositor_view,
   clutter_stage_view_assign_next_scanout (stage_view, scanout);
 }
 
+static gboolean
+actor_has_effects_up_to_stage (ClutterActor *actor)
+{
+  while (actor)
+    {
+      if (clutter_actor_has_effects (actor))
+        return TRUE;
+
+      actor = clutter_actor_get_parent (actor);
+    }
+
+  return FALSE;
+}
+
+static gboolean
+are_siblings_painted_over (ClutterActor          *first_sibling,
+                           const graphene_rect_t *rect)
+{
+  ClutterActor *sibling;
+
+  for (sibling = first_sibling;
+       sibling;
+       sibling = clutter_actor_get_next_sibling (sibling))
+    {
+      ClutterActorBox paint_box;
+      graphene_rect_t paint_rect;
+
+      if (!clutter_actor_is_mapped (sibling) ||
+          clutter_actor_get_paint_opacity (sibling) == 0)
+        continue;
+
+      /* Without a paint box, the actor might paint anywhere */
+      if (!clutter_actor_get_paint_box (sibling, &paint_box))
+        return TRUE;
+
+      graphene_rect_init (&paint_rect,
+                          paint_box.x1, paint_box.y1,
+                          paint_box.x2 - paint_box.x1,
+                          paint_box.y2 - paint_box.y1);
+      if (graphene_rect_intersection (rect, &paint_rect, NULL))
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+/* The overlay plane is scanned out above the composited frame, so anything
+ * painted after the actor within its area would end up hidden behind it.
+ * Unlike culling, this also considers translucent content, e.g. shadows,
+ * and actors outside of the window group, such as shell chrome. */
+static gboolean
+is_actor_painted_over (ClutterActor          *actor,
+                       const graphene_rect_t *rect)
+{
+  ClutterActor *parent;
+
+  if (are_siblings_painted_over (clutter_actor_get_first_child (actor), rect))
+    return TRUE;
+
+  for (parent = clutter_actor_get_parent (actor);
+       parent;
+       actor = parent, parent = clutter_actor_get_parent (parent))
+    {
+      if (are_siblings_painted_over (clutter_actor_get_next_sibling (actor),
+                                     rect))
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+MetaSurfaceActor *
+meta_compositor_view_native_find_overlay_surface_actor (MetaCompositor   *compositor,
+                                                        ClutterStageView *stage_view,
+                                                        MetaWindowActor  *window_actor)
+{
+  MtkRectangle view_rect;
+  ClutterActorBox actor_box;
+  graphene_rect_t actor_rect;
+  MetaSurfaceActor *surface_actor;
+  MetaWaylandSurface *surface;
+  ClutterColorState *output_color_state;
+  ClutterColorState *surface_color_state;
+  MetaMultiTextureCoefficients coeffs;
+
+  if (!window_actor || !META_IS_WINDOW_ACTOR_WAYLAND (window_actor))
+    {
+      meta_topic (META_DEBUG_RENDER,
+                  "No overlay plane candidate: no Wayland top window actor");
+      return NULL;
+    }
+
+  if (meta_window_actor_effect_in_progress (window_actor) ||
+      clutter_actor_has_transitions (CLUTTER_ACTOR (window_actor)))
+    {
+      meta_topic (META_DEBUG_RENDER,
+                  "No overlay plane candidate: window-actor is animating");
+      return NULL;
+    }
+
+  surface_actor =
+    meta_window_actor_wayland_get_topmost_surface_actor (META_WINDOW_ACTOR_WAYLAND (window_actor));
+  if (!surface_actor)
+    {
+      meta_topic (META_DEBUG_RENDER,
+                  "No overlay plane candidate: no visible surface-actor");
+      return NULL;
+    }
+
+  /* The surface is punched out of the composited frame, so whatever it
+   * would have been blended with is not there anymore. */
+  if (!meta_surface_actor_is_opaque (surface_actor) ||
+      clutter_actor_get_paint_opacity (CLUTTER_ACTOR (surface_actor)) != 255)
+    {
+      meta_topic (META_DEBUG_RENDER,
+                  "No overlay plane candidate: surface-actor is not opaque");
+      return NULL;
+    }
+
+  if (actor_has_effects_up_to_stage (CLUTTER_ACTOR (surface_actor)))
+    {
+      meta_topic (META_DEBUG_RENDER,
+                  "No overlay plane candidate: surface-actor has effects");
+      return NULL;
+    }
+
+  if (!clutter_actor_get_paint_box (CLUTTER_ACTOR (surface_actor),
+                                    &actor_box))
+    {
+      meta_topic (META_DEBUG_RENDER,
+                  "No overlay plane candidate: no surface-actor paint-box");
+      return NULL;
+    }
+
+  clutter_stage_view_get_layout (stage_view, &view_rect);
+  if (actor_box.x1 < view_rect.x ||
+      actor_box.y1 < view_rect.y ||
+      actor_box.x2 > view_rect.x + view_rect.width ||
+      actor_box.y2 > view_rect.y + view_rect.height)
+    {
+      meta_topic (META_DEBUG_RENDER,
+                  "No overlay plane candidate: paint-box (%f,%f,%f,%f) not "
+                  "contained in stage-view layout (%d,%d,%d,%d)",
+                  actor_box.x1, actor_box.y1,
+                  actor_box.x2 - actor_box.x1, actor_box.y2 - actor_box.y1,
+                  view_rect.x, view_rect.y, view_rect.width, view_rect.height);
+      return NULL;
+    }
+
+  graphene_rect_init (&actor_rect,
+                      actor_box.x1, actor_box.y1,
+                      actor_box.x2 - actor_box.x1,
+                      actor_box.y2 - actor_box.y1);
+  if (is_actor_painted_over (CLUTTER_ACTOR (surface_actor), &actor_rect))
+    {
+      meta_topic (META_DEBUG_RENDER,
+                  "No overlay plane candidate: surface-actor is painted over");
+      return NULL;
+    }
+
+  if (is_software_cursor_within (compositor, stage_view, &actor_rect))
+    {
+      meta_topic (META_DEBUG_RENDER,
+                  "No overlay plane candidate: using software cursor");
+      return NULL;
+    }
+
+  output_color_state = clutter_stage_view_get_output_color_state (stage_view);
+  surface_color_state =
+    clutter_actor_get_color_state (CLUTTER_ACTOR (surface_actor));
+  if (!clutter_color_state_equals (output_color_state, surface_color_state))
+    {
+      meta_topic (META_DEBUG_RENDER,
+                  "No overlay plane candidate: "
+                  "surface color state (%s) doesn't match the output's (%s)",
+                  clutter_color_state_to_string (surface_color_state),
+                  clutter_color_state_to_string (output_color_state));
+      return NULL;
+    }
+
+  surface =
+    meta_surface_actor_wayland_get_surface (META_SURFACE_ACTOR_WAYLAND (surface_actor));
+  if (!surface)
+    {
+      meta_topic (META_DEBUG_RENDER,
+                  "No overlay plane candidate: no surface");
+      return NULL;
+    }
+
+  coeffs = surface->applied_state.coeffs;
+  if (coeffs != META_MULTI_TEXTURE_COEFFICIENTS_NONE &&
+      coeffs != META_MULTI_TEXTURE_COEFFICIENTS_IDENTITY_FULL &&
+      coeffs != META_MULTI_TEXTURE_COEFFICIENTS_BT709_LIMITED)
+    {
+      meta_topic (META_DEBUG_RENDER,
+                  "No overlay plane candidate: unsupported color coefficients");
+      return NULL;
+    }
+
+  return surface_actor;
+}
+
+static MetaSurfaceActor *
+find_overlay_candidate (MetaCompositorView  *compositor_view,
+                        MetaCompositor      *compositor,
+                        CoglOnscreen       **onscreen_out,
+                        MetaWaylandSurface **surface_out)
+{
+  ClutterStageView *stage_view =
+    meta_compositor_view_get_stage_view (compositor_view);
+  MetaRendererView *renderer_view = META_RENDERER_VIEW (stage_view);
+  MetaCrtc *crtc;
+  MetaCrtcKms *crtc_kms;
+  CoglFramebuffer *framebuffer;
+  MetaWindowActor *window_actor;
+  MetaSurfaceActor *surface_actor;
+
+  if (meta_get_debug_paint_flags () & META_DEBUG_PAINT_DISABLE_DIRECT_SCANOUT)
+    return NULL;
+
+  /* A fullscreen surface is already scanned out from the primary plane. */
+  if (clutter_stage_view_peek_scanout (stage_view))
+    return NULL;
+
+  if (meta_compositor_is_unredirect_inhibited (compositor))
+    {
+      meta_topic (META_DEBUG_RENDER,
+                  "No overlay plane candidate: unredirect inhibited");
+      return NULL;
+    }
+
+  crtc = meta_renderer_view_get_crtc (renderer_view);
+  if (!META_IS_CRTC_KMS (crtc) ||
+      !meta_crtc_kms_get_assigned_overlay_plane (META_CRTC_KMS (crtc)))
+    {
+      meta_topic (META_DEBUG_RENDER,
+                  "No overlay plane candidate: no KMS overlay plane");
+      return NULL;
+    }
+
+  crtc_kms = META_CRTC_KMS (crtc);
+  if (!meta_crtc_kms_is_overlay_plane_above_primary (crtc_kms))
+    {
+      meta_topic (META_DEBUG_RENDER,
+                  "No overlay plane candidate: overlay plane is not stacked "
+                  "above the primary plane");
+      return NULL;
+    }
+
+  framebuffer = clutter_stage_view_get_onscreen (stage_view);
+  if (!COGL_IS_ONSCREEN (framebuffer) ||
+      clutter_stage_view_has_shadowfb (stage_view))
+    {
+      meta_topic (META_DEBUG_RENDER,
+                  "No overlay plane candidate: not painting to the onscreen");
+      return NULL;
+    }
+
+  if (clutter_stage_view_get_transform (stage_view) !=
+      MTK_MONITOR_TRANSFORM_NORMAL)
+    {
+      meta_topic (META_DEBUG_RENDER,
+                  "No overlay plane candidate: stage-view is transformed");
+      return NULL;
+    }
+
+  window_actor = meta_compositor_view_get_top_window_actor (compositor_view);
+  surface_actor =
+    meta_compositor_view_native_find_overlay_surface_actor (compositor,
+                                                            stage_view,
+                                                            window_actor);
+  if (!surface_actor)
+    return NULL;
+
+  *onscreen_out = COGL_ONSCREEN (framebuffer);
+  *surface_out =
+    meta_surface_actor_wayland_get_surface (META_SURFACE_ACTOR_WAYLAND (surface_actor));
+
+  return surface_actor;
+}
+
+static void
+update_overlay_surface_actor (MetaCompositorViewNative *view_native,
+                              MetaSurfaceActor         *surface_actor)
+{
+  MetaSurfaceActor *old_surface_actor = view_native->overlay_surface_actor;
+
+  if (old_surface_actor == surface_actor)
+    return;
+
+  if (old_surface_actor)
+    {
+      MetaCompositorView *compositor_view = META_COMPOSITOR_VIEW (view_native);
+      ClutterStageView *stage_view =
+        meta_compositor_view_get_stage_view (compositor_view);
+      graphene_rect_t extents;
+      MtkRectangle clip;
+
+      meta_surface_actor_set_offloaded (old_surface_actor, FALSE);
+
+      /* The area below the overlay plane was punched out of the composited
+       * frame, so it must be repainted in the frame disabling the plane. */
+      clutter_actor_get_transformed_extents (CLUTTER_ACTOR (old_surface_actor),
+                                             &extents);
+      mtk_rectangle_from_graphene_rect (&extents,
+                                        MTK_ROUNDING_STRATEGY_GROW,
+                                        &clip);
+      clutter_stage_view_add_redraw_clip (stage_view, &clip);
+    }
+
+  if (surface_actor)
+    meta_surface_actor_set_offloaded (surface_actor, TRUE);
+
+  g_set_weak_pointer (&view_native->overlay_surface_actor, surface_actor);
+}
+
+static void
+maybe_assign_overlay (MetaCompositorViewNative *view_native,
+                      MetaCompositor           *compositor,
+                      ClutterFrame             *frame)
+{
+  MetaCompositorView *compositor_view = META_COMPOSITOR_VIEW (view_native);
+  ClutterStageView *stage_view =
+    meta_compositor_view_get_stage_view (compositor_view);
+  g_autoptr (CoglScanout) scanout = NULL;
+  MetaSurfaceActor *surface_actor;
+  CoglOnscreen *onscreen = NULL;
+  MetaWaylandSurface *surface = NULL;
+
+  surface_actor = find_overlay_candidate (compositor_view,
+                                          compositor,
+                                          &onscreen,
+                                          &surface);
+  if (surface_actor)
+    {
+      scanout = meta_wayland_surface_try_acquire_overlay_scanout (surface,
+                                                                  onscreen,
+                                                                  stage_view);
+      if (!scanout)
+        {
+          meta_topic (META_DEBUG_RENDER,
+                      "Could not acquire overlay plane scanout");
+          surface_actor = NULL;
+        }
+    }
+
+  if (scanout)
+    {
+      MetaFrameNative *frame_native = meta_frame_native_from_frame (frame);
+
+      meta_frame_native_set_overlay_scanout (frame_native, scanout);
+    }
+
+  update_overlay_surface_actor (view_native, surface_actor);
+}
+
 void
 meta_compositor_view_native_maybe_assign_scanout (MetaCompositorViewNative *view_native,
-                                                  MetaCompositor           *compositor)
+                                                  MetaCompositor           *compositor,
+                                                  ClutterFrame             *frame)
 {
   MetaCompositorView *compositor_view = META_COMPOSITOR_VIEW (view_native);
   MetaCrtc *crtc = NULL;
@@ -396,6 +762,8 @@ meta_compositor_view_native_maybe_assign_scanout (MetaCompositorViewNative *view
     }
 
   update_scanout_candidate (view_native, surface, crtc);
+
+  maybe_assign_overlay (view_native, compositor, frame);
 }
 #endif /* HAVE_WAYLAND */
 
@@ -603,6 +971,7 @@ meta_compositor_view_native_finalize (GObject *object)
   MetaCompositorViewNative *view_native = META_COMPOSITOR_VIEW_NATIVE (object);
 
   g_clear_weak_pointer (&view_native->scanout_candidate);
+  g_clear_weak_pointer (&view_native->overlay_surface_actor);
 #endif /* HAVE_WAYLAND */
 
   G_OBJECT_CLASS (meta_compositor_view_native_parent_class)->finalize (object);
@@ -24,6 +24,8 @@
 
 #include "clutter/clutter-mutter.h"
 #include "compositor/meta-compositor-view.h"
+#include "compositor/meta-surface-actor.h"
+#include "core/util-private.h"
 #include "meta/compositor.h"
 
 #define META_TYPE_COMPOSITOR_VIEW_NATIVE (meta_compositor_view_native_get_type ())
@@ -34,7 +36,13 @@ MetaCompositorViewNative *meta_compositor_view_native_new (ClutterStageView *sta
 
 #ifdef HAVE_WAYLAND
 void meta_compositor_view_native_maybe_assign_scanout (MetaCompositorViewNative *view_native,
-                                                       MetaCompositor           *compositor);
+                                                       MetaCompositor           *compositor,
+                                                       ClutterFrame             *frame);
+
+META_EXPORT_TEST
+MetaSurfaceActor * meta_compositor_view_native_find_overlay_surface_actor (MetaCompositor   *compositor,
+                                                                           ClutterStageView *stage_view,
+                                                                           MetaWindowActor  *window_actor);
 #endif /* HAVE_WAYLAND */
 
 void meta_compositor_view_native_maybe_update_frame_sync_surface (MetaCompositorViewNative *view_native,
@@ -27,6 +27,7 @@
 #include "backends/x11/meta-clutter-backend-x11.h"
 #include "backends/x11/meta-event-x11.h"
 #include "compositor/meta-compositor-view.h"
+#include "compositor/meta-surface-actor-x11.h"
 #include "compositor/meta-sync-ring.h"
 #include "compositor/meta-window-actor-x11.h"
 #include "core/display-private.h"
@@ -374,9 +375,10 @@ maybe_do_sync (MetaCompositor *compositor)
        * Xorg and open source driver specifics:
        *
        * The X server makes sure to flush drawing to the kernel before sending
-       * out damage events, but since we use DamageReportBoundingBox there may
-       * be drawing between the last damage event and the XDamageSubtract()
-       * that needs to be flushed as well.
+       * out damage events, but since we use DamageReportDeltaRectangles,
+       * drawing to areas that are already damaged is not reported, so there
+       * may be drawing between the last damage event and the
+       * XDamageSubtract() that needs to be flushed as well.
        *
        * Xorg always makes sure that drawing is flushed to the kernel before
        * writing events or responses to the client, so any round trip request
@@ -389,12 +391,32 @@ maybe_do_sync (MetaCompositor *compositor)
     }
 }
 
+static void
+flush_damage (MetaCompositor *compositor)
+{
+  MetaCompositorX11 *compositor_x11 = META_COMPOSITOR_X11 (compositor);
+  GList *l;
+
+  if (!compositor_x11->frame_has_updated_xsurfaces)
+    return;
+
+  for (l = meta_compositor_get_window_actors (compositor); l; l = l->next)
+    {
+      MetaSurfaceActor *surface;
+
+      surface = meta_window_actor_get_surface (l->data);
+      if (META_IS_SURFACE_ACTOR_X11 (surface))
+        meta_surface_actor_x11_flush_damage (META_SURFACE_ACTOR_X11 (surface));
+    }
+}
+
 static void
 on_before_update (ClutterStage     *stage,
                   ClutterStageView *stage_view,
                   ClutterFrame     *frame,
                   MetaCompositor   *compositor)
 {
+  flush_damage (compositor);
   maybe_do_sync (compositor);
 }
 
@@ -783,9 +805,9 @@ meta_compositor_x11_before_paint (MetaCompositor     *compositor,
    * time XDamageSubtract may happen before painting (when it calls
    * meta_window_actor_x11_before_paint -> handle_updates ->
    * meta_surface_actor_x11_handle_updates). If a client was to redraw between
-   * the last damage event and XDamageSubtract, and the bounding box of the
-   * region didn't grow, then we will not receive a new damage report for it
-   * (because XDamageReportBoundingBox). Then if we haven't synchronized again
+   * the last damage event and XDamageSubtract, within the already damaged
+   * region, then we will not receive a new damage report for it (because
+   * XDamageReportDeltaRectangles). Then if we haven't synchronized again
    * and the same region doesn't change on subsequent frames, we have lost some
    * part of the update from the client. So to ensure the correct pixels get
    * composited we must sync at least once between XDamageSubtract and
@@ -33,6 +33,7 @@ typedef struct _MetaLater
   unsigned int id;
   unsigned int ref_count;
   MetaLaterType when;
+  MetaLaterPriority priority;
 
   GSourceFunc func;
   gpointer user_data;
@@ -40,10 +41,13 @@ typedef struct _MetaLater
 
   guint source_id;
   gboolean run_once;
+  gboolean deferred;
 } MetaLater;
 
 #define META_LATER_N_TYPES (META_LATER_IDLE + 1)
 
+#define DEFAULT_REFRESH_RATE 60.0f
+
 struct _MetaLaters
 {
   GObject parent;
@@ -54,6 +58,8 @@ struct _MetaLaters
 
   GSList *laters[META_LATER_N_TYPES];
 
+  int64_t low_priority_deadline_us;
+
   gulong before_update_handler_id;
 };
 
@@ -143,11 +149,31 @@ remove_later_from_list (unsigned int   later_id,
   return FALSE;
 }
 
-static void
-run_repaint_laters (GSList **laters_list)
+static gboolean
+should_defer_later (MetaLaters *laters,
+                    MetaLater  *later)
 {
+  if (later->priority != META_LATER_PRIORITY_LOW)
+    return FALSE;
+
+  /* Only ever push it to the next frame, not indefinitely */
+  if (later->deferred)
+    return FALSE;
+
+  return g_get_monotonic_time () >= laters->low_priority_deadline_us;
+}
+
+static int
+run_repaint_laters (MetaLaters    *laters,
+                    MetaLaterType  when)
+{
+  GSList **laters_list = &laters->laters[when];
   g_autoptr (GSList) laters_copy = NULL;
   GSList *l;
+  int n_invoked = 0;
+  int n_deferred = 0;
+
+  COGL_TRACE_BEGIN_SCOPED (RunLaters, "Meta::Laters::run()");
 
   for (l = *laters_list; l; l = l->next)
     {
@@ -164,12 +190,60 @@ run_repaint_laters (GSList **laters_list)
       MetaLater *later = l->data;
 
       if (!later->func)
-        remove_later_from_list (later->id, laters_list);
-      else if (!meta_later_invoke (later))
-        remove_later_from_list (later->id, laters_list);
+        {
+          remove_later_from_list (later->id, laters_list);
+        }
+      else if (should_defer_later (laters, later))
+        {
+          later->deferred = TRUE;
+          n_deferred++;
+        }
+      else
+        {
+          later->deferred = FALSE;
+          n_invoked++;
+
+          if (!meta_later_invoke (later))
+            remove_later_from_list (later->id, laters_list);
+        }
 
       meta_later_unref (later);
     }
+
+#ifdef HAVE_PROFILER
+  if (G_UNLIKELY (cogl_is_tracing_enabled ()))
+    {
+      g_autofree char *description = NULL;
+
+      description = g_strdup_printf ("%s, invoked: %d, deferred: %d",
+                                     later_type_to_string (when),
+                                     n_invoked, n_deferred);
+      COGL_TRACE_DESCRIBE (RunLaters, description);
+    }
+#endif
+
+  return n_deferred;
+}
+
+static int64_t
+calculate_low_priority_deadline (ClutterStageView *stage_view,
+                                 ClutterFrame     *frame)
+{
+  int64_t now_us = g_get_monotonic_time ();
+  int64_t frame_deadline_us;
+  float refresh_rate;
+
+  /* Low priority laters get the first half of the time left until the
+   * frame deadline, leaving the rest for layout and painting.
+   */
+  if (clutter_frame_get_frame_deadline (frame, &frame_deadline_us))
+    return now_us + MAX (frame_deadline_us - now_us, 0) / 2;
+
+  refresh_rate = clutter_stage_view_get_refresh_rate (stage_view);
+  if (refresh_rate <= 0.0f)
+    refresh_rate = DEFAULT_REFRESH_RATE;
+
+  return now_us + (int64_t) (G_USEC_PER_SEC / refresh_rate) / 2;
 }
 
 static void
@@ -181,9 +255,20 @@ on_before_update (ClutterStage     *stage,
   unsigned int i;
   GSList *l;
   gboolean needs_schedule_update = FALSE;
+  int n_deferred = 0;
+
+  COGL_TRACE_DEFINE_COUNTER_INT (LatersDeferred,
+                                 "LatersDeferred",
+                                 "low priority laters deferred to the "
+                                 "next frame");
+
+  laters->low_priority_deadline_us =
+    calculate_low_priority_deadline (stage_view, frame);
 
   for (i = 0; i < G_N_ELEMENTS (laters->laters); i++)
-    run_repaint_laters (&laters->laters[i]);
+    n_deferred += run_repaint_laters (laters, i);
+
+  COGL_TRACE_SET_COUNTER_INT (LatersDeferred, n_deferred);
 
   for (i = 0; i < G_N_ELEMENTS (laters->laters); i++)
     {
@@ -205,7 +290,7 @@ invoke_later_idle (gpointer data)
 {
   MetaLater *later = data;
 
-  if (!later->func (later->user_data))
+  if (!meta_later_invoke (later))
     {
       meta_laters_remove (later->laters, later->id);
       return FALSE;
@@ -246,6 +331,24 @@ meta_laters_init (MetaLaters *laters)
 {
 }
 
+static GSList *
+insert_later (GSList    *laters_list,
+              MetaLater *later)
+{
+  GSList *l;
+
+  /* Sorted by priority, and newest first within the same priority */
+  for (l = laters_list; l; l = l->next)
+    {
+      MetaLater *other = l->data;
+
+      if (other->priority >= later->priority)
+        break;
+    }
+
+  return g_slist_insert_before (laters_list, l, later);
+}
+
 /**
  * meta_laters_add:
  * @laters: a #MetaLaters
@@ -270,6 +373,35 @@ meta_laters_add (MetaLaters     *laters,
                  GSourceFunc     func,
                  gpointer        user_data,
                  GDestroyNotify  notify)
+{
+  return meta_laters_add_full (laters, when, META_LATER_PRIORITY_DEFAULT,
+                               func, user_data, notify);
+}
+
+/**
+ * meta_laters_add_full:
+ * @laters: a #MetaLaters
+ * @when: enumeration value determining the phase at which to run the callback
+ * @priority: the priority of the callback within its phase
+ * @func: callback to run later
+ * @user_data: data to pass to the callback
+ * @notify: function to call to destroy @data when it is no longer in use, or %NULL
+ *
+ * Like meta_laters_add(), but with a priority that orders the callback among
+ * the others of the same @when. Callbacks with %META_LATER_PRIORITY_LOW are
+ * run last, and when the frame they are run for is close to its deadline,
+ * are deferred to the next frame, so that they don't make it miss it.
+ *
+ * Return value: an integer ID (guaranteed to be non-zero) that can be used
+ *  to cancel the callback and prevent it from being run.
+ */
+unsigned int
+meta_laters_add_full (MetaLaters        *laters,
+                      MetaLaterType      when,
+                      MetaLaterPriority  priority,
+                      GSourceFunc        func,
+                      gpointer           user_data,
+                      GDestroyNotify     notify)
 {
   ClutterStage *stage = meta_compositor_get_stage (laters->compositor);
   MetaLater *later = g_new0 (MetaLater, 1);
@@ -278,11 +410,12 @@ meta_laters_add (MetaLaters     *laters,
   later->laters = laters;
   later->ref_count = 1;
   later->when = when;
+  later->priority = priority;
   later->func = func;
   later->user_data = user_data;
   later->destroy_notify = notify;
 
-  laters->laters[when] = g_slist_prepend (laters->laters[when], later);
+  laters->laters[when] = insert_later (laters->laters[when], later);
 
   switch (when)
     {
@@ -127,6 +127,7 @@ struct _MetaShapedTexture
   int buffer_scale;
 
   guint create_mipmaps : 1;
+  guint mipmap_update_id;
 
   MetaMultiTextureAlphaMode premult;
   MetaMultiTextureCoefficients coeffs;
@@ -336,6 +337,7 @@ meta_shaped_texture_dispose (GObject *object)
 {
   MetaShapedTexture *stex = (MetaShapedTexture *) object;
 
+  g_clear_handle_id (&stex->mipmap_update_id, g_source_remove);
   g_clear_pointer (&stex->texture_mipmap, meta_texture_mipmap_free);
 
   g_clear_object (&stex->texture);
@@ -818,6 +820,40 @@ flip_ints (int *x,
   *y = tmp;
 }
 
+static gboolean
+update_mipmap_cb (gpointer user_data)
+{
+  MetaShapedTexture *stex = META_SHAPED_TEXTURE (user_data);
+
+  stex->mipmap_update_id = 0;
+  clutter_content_invalidate (CLUTTER_CONTENT (stex));
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+maybe_schedule_mipmap_update (MetaShapedTexture *stex)
+{
+  int64_t update_time_us;
+  int64_t delay_us;
+
+  if (stex->mipmap_update_id)
+    return;
+
+  /* Changes held back to limit how often the mipmap is updated need
+   * another paint to show up eventually, even if nothing else changes */
+  update_time_us =
+    meta_texture_mipmap_get_next_update_time (stex->texture_mipmap);
+  if (!update_time_us)
+    return;
+
+  delay_us = MAX (update_time_us - g_get_monotonic_time (), 0);
+  stex->mipmap_update_id = g_timeout_add ((guint) ((delay_us + 999) / 1000),
+                                          update_mipmap_cb, stex);
+  g_source_set_name_by_id (stex->mipmap_update_id,
+                           "[mutter] update_mipmap_cb");
+}
+
 static void
 do_paint_content (MetaShapedTexture   *stex,
                   ClutterPaintNode    *root_node,
@@ -908,6 +944,8 @@ do_paint_content (MetaShapedTexture   *stex,
         {
           paint_tex = meta_texture_mipmap_get_paint_texture (stex->texture_mipmap);
           min_filter = COGL_PIPELINE_FILTER_LINEAR_MIPMAP_NEAREST;
+
+          maybe_schedule_mipmap_update (stex);
         }
     }
 
@@ -1311,7 +1349,7 @@ meta_shaped_texture_update_area (MetaShapedTexture  *stex,
                                     clip);
     }
 
-  meta_texture_mipmap_invalidate (stex->texture_mipmap);
+  meta_texture_mipmap_invalidate_area (stex->texture_mipmap, area);
 
   return TRUE;
 }
@@ -48,6 +48,9 @@ struct _MetaSurfaceActorX11
   Pixmap pixmap;
   Damage damage;
 
+  /* Damage received since the last frame, processed all at once */
+  MtkRegion *queued_damage;
+
   int last_width;
   int last_height;
 
@@ -198,19 +201,45 @@ meta_surface_actor_x11_process_damage (MetaSurfaceActor   *actor,
                                        const MtkRectangle *area)
 {
   MetaSurfaceActorX11 *self = META_SURFACE_ACTOR_X11 (actor);
-  CoglTexturePixmapX11 *pixmap;
 
   self->received_damage = TRUE;
 
+  /* Damage events tend to come in bursts; only collect them here, and
+   * update the texture and queue redraws once per frame, see
+   * meta_surface_actor_x11_flush_damage().
+   */
+  if (!self->queued_damage)
+    {
+      self->queued_damage = mtk_region_create_rectangle (area);
+      meta_surface_actor_schedule_update (actor);
+    }
+  else
+    {
+      mtk_region_union_rectangle (self->queued_damage, area);
+    }
+}
+
+void
+meta_surface_actor_x11_flush_damage (MetaSurfaceActorX11 *self)
+{
+  MetaSurfaceActor *actor = META_SURFACE_ACTOR (self);
+  g_autoptr (MtkRegion) damage = NULL;
+  CoglTexturePixmapX11 *pixmap;
+  int i, n_rects;
+
+  damage = g_steal_pointer (&self->queued_damage);
+  if (!damage)
+    return;
+
   if (meta_window_is_fullscreen (self->window) && !self->unredirected && !self->does_full_damage)
     {
       MtkRectangle window_rect;
+
       meta_window_get_frame_rect (self->window, &window_rect);
+      window_rect.x = window_rect.y = 0;
 
-      if (area->x == 0 &&
-          area->y == 0 &&
-          window_rect.width == area->width &&
-          window_rect.height == area->height)
+      if (mtk_region_contains_rectangle (damage, &window_rect) ==
+          MTK_REGION_OVERLAP_IN)
         self->full_damage_frames_count++;
       else
         self->full_damage_frames_count = 0;
@@ -227,8 +256,16 @@ meta_surface_actor_x11_process_damage (MetaSurfaceActor   *actor,
     return;
 
   pixmap = COGL_TEXTURE_PIXMAP_X11 (meta_multi_texture_get_plane (self->texture, 0));
-  cogl_texture_pixmap_x11_update_area (pixmap, area);
-  meta_surface_actor_update_area (actor, area);
+
+  n_rects = mtk_region_num_rectangles (damage);
+  for (i = 0; i < n_rects; i++)
+    {
+      MtkRectangle rect;
+
+      rect = mtk_region_get_rectangle (damage, i);
+      cogl_texture_pixmap_x11_update_area (pixmap, &rect);
+      meta_surface_actor_update_area (actor, &rect);
+    }
 }
 
 void
@@ -325,6 +362,8 @@ release_x11_resources (MetaSurfaceActorX11 *self)
   detach_pixmap (self);
   free_damage (self);
   mtk_x11_error_trap_pop (x11_display->xdisplay);
+
+  g_clear_pointer (&self->queued_damage, mtk_region_unref);
 }
 
 static void
@@ -364,7 +403,8 @@ create_damage (MetaSurfaceActorX11 *self)
   Window xwindow = meta_window_x11_get_toplevel_xwindow (self->window);
 
   mtk_x11_error_trap_push (xdisplay);
-  self->damage = XDamageCreate (xdisplay, xwindow, XDamageReportBoundingBox);
+  self->damage = XDamageCreate (xdisplay, xwindow,
+                                XDamageReportDeltaRectangles);
   mtk_x11_error_trap_pop (xdisplay);
 }
 
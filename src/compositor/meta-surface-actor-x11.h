@@ -54,4 +54,6 @@ gboolean meta_surface_actor_x11_is_visible (MetaSurfaceActorX11 *self);
 
 void meta_surface_actor_x11_handle_updates (MetaSurfaceActorX11 *self);
 
+void meta_surface_actor_x11_flush_damage (MetaSurfaceActorX11 *self);
+
 G_END_DECLS
@@ -51,6 +51,9 @@ typedef struct _MetaSurfaceActorPrivate
   /* Freeze/thaw accounting */
   MtkRegion *pending_damage;
   gboolean is_frozen;
+
+  /* Shown on a hardware plane instead of being composited */
+  gboolean is_offloaded;
 } MetaSurfaceActorPrivate;
 
 static void cullable_iface_init (MetaCullableInterface *iface);
@@ -377,8 +380,23 @@ meta_surface_actor_cull_redraw_clip (MetaCullable *cullable,
                                      MtkRegion    *clip_region)
 {
   MetaSurfaceActor *surface_actor = META_SURFACE_ACTOR (cullable);
+  MetaSurfaceActorPrivate *priv =
+    meta_surface_actor_get_instance_private (surface_actor);
 
-  set_clip_region (surface_actor, clip_region);
+  /* An offloaded surface is placed above the composited content by the
+   * display controller, so there is no point in painting it. */
+  if (clip_region && priv->is_offloaded &&
+      !clutter_actor_has_mapped_clones (CLUTTER_ACTOR (surface_actor)))
+    {
+      g_autoptr (MtkRegion) empty_region = NULL;
+
+      empty_region = mtk_region_create ();
+      set_clip_region (surface_actor, empty_region);
+    }
+  else
+    {
+      set_clip_region (surface_actor, clip_region);
+    }
 
   subtract_opaque_region (surface_actor, clip_region);
 }
@@ -692,3 +710,22 @@ meta_surface_actor_is_frozen (MetaSurfaceActor *self)
 
   return priv->is_frozen;
 }
+
+gboolean
+meta_surface_actor_is_offloaded (MetaSurfaceActor *self)
+{
+  MetaSurfaceActorPrivate *priv =
+    meta_surface_actor_get_instance_private (self);
+
+  return priv->is_offloaded;
+}
+
+void
+meta_surface_actor_set_offloaded (MetaSurfaceActor *self,
+                                  gboolean          offloaded)
+{
+  MetaSurfaceActorPrivate *priv =
+    meta_surface_actor_get_instance_private (self);
+
+  priv->is_offloaded = offloaded;
+}
@@ -56,4 +56,8 @@ gboolean meta_surface_actor_is_opaque (MetaSurfaceActor *actor);
 gboolean meta_surface_actor_is_frozen (MetaSurfaceActor *actor);
 void meta_surface_actor_set_frozen (MetaSurfaceActor *actor,
                                     gboolean          frozen);
+
+gboolean meta_surface_actor_is_offloaded (MetaSurfaceActor *actor);
+void meta_surface_actor_set_offloaded (MetaSurfaceActor *actor,
+                                       gboolean          offloaded);
 G_END_DECLS
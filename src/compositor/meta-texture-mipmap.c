@@ -30,6 +30,14 @@
 #include <math.h>
 #include <string.h>
 
+/* Damage made of more rectangles than this is updated as a whole */
+#define MAX_DAMAGE_RECTS 16
+
+/* Partial updates are mostly caused by small and frequent changes, e.g.
+ * a blinking cursor or a progress bar, which don't need to show up in
+ * scaled down copies of windows at full frame rate */
+#define MIN_PARTIAL_UPDATE_INTERVAL_US (G_USEC_PER_SEC / 20)
+
 struct _MetaTextureMipmap
 {
   MetaMultiTexture *base_texture;
@@ -39,8 +47,19 @@ struct _MetaTextureMipmap
   CoglContext *cogl_context;
   gboolean invalid;
   MetaMultiTextureCoefficients coeffs;
+
+  /* Areas of the base texture that changed since the mipmap texture was
+   * last updated, unless all of it needs updating anyway */
+  MtkRegion *damage;
+  int64_t last_update_us;
 };
 
+static void
+release_framebuffer (CoglFramebuffer *framebuffer)
+{
+  cogl_offscreen_release (COGL_OFFSCREEN (framebuffer));
+}
+
 /**
  * meta_texture_mipmap_new:
  *
@@ -75,7 +94,8 @@ meta_texture_mipmap_free (MetaTextureMipmap *mipmap)
   g_clear_object (&mipmap->pipeline);
   g_clear_object (&mipmap->base_texture);
   g_clear_object (&mipmap->mipmap_texture);
-  g_clear_object (&mipmap->fb);
+  g_clear_pointer (&mipmap->fb, release_framebuffer);
+  g_clear_pointer (&mipmap->damage, mtk_region_unref);
 
   g_free (mipmap);
 }
@@ -106,7 +126,7 @@ meta_texture_mipmap_set_base_texture (MetaTextureMipmap *mipmap,
   if (mipmap->base_texture != NULL)
     {
       g_object_ref (mipmap->base_texture);
-      mipmap->invalid = TRUE;
+      meta_texture_mipmap_invalidate (mipmap);
     }
 }
 
@@ -120,7 +140,7 @@ meta_texture_mipmap_set_coeffs (MetaTextureMipmap            *mipmap,
     return;
 
   mipmap->coeffs = coeffs;
-  mipmap->invalid = TRUE;
+  meta_texture_mipmap_invalidate (mipmap);
 }
 
 void
@@ -129,13 +149,60 @@ meta_texture_mipmap_invalidate (MetaTextureMipmap *mipmap)
   g_return_if_fail (mipmap != NULL);
 
   mipmap->invalid = TRUE;
+  g_clear_pointer (&mipmap->damage, mtk_region_unref);
+}
+
+/**
+ * meta_texture_mipmap_invalidate_area:
+ * @mipmap: a #MetaTextureMipmap
+ * @area: the area of the base texture that changed
+ *
+ * Marks @area of the base texture as changed, so only the corresponding
+ * part of the mipmap texture is rendered again. Such partial updates are
+ * rate limited, see meta_texture_mipmap_get_next_update_time().
+ */
+void
+meta_texture_mipmap_invalidate_area (MetaTextureMipmap  *mipmap,
+                                     const MtkRectangle *area)
+{
+  g_return_if_fail (mipmap != NULL);
+
+  /* Without a mipmap texture, all of it gets rendered once it is
+   * created anyway */
+  if (mipmap->invalid || !mipmap->mipmap_texture)
+    return;
+
+  if (!mipmap->damage)
+    mipmap->damage = mtk_region_create ();
+
+  mtk_region_union_rectangle (mipmap->damage, area);
+}
+
+/**
+ * meta_texture_mipmap_get_next_update_time:
+ * @mipmap: a #MetaTextureMipmap
+ *
+ * Returns: the monotonic time at which the mipmap texture returned by
+ *   meta_texture_mipmap_get_paint_texture() will catch up with changes
+ *   that were held back to limit the update rate, or 0 if it is up to date
+ */
+int64_t
+meta_texture_mipmap_get_next_update_time (MetaTextureMipmap *mipmap)
+{
+  g_return_val_if_fail (mipmap != NULL, 0);
+
+  if (mipmap->invalid || !mipmap->damage)
+    return 0;
+
+  return mipmap->last_update_us + MIN_PARTIAL_UPDATE_INTERVAL_US;
 }
 
 static void
 free_mipmaps (MetaTextureMipmap *mipmap)
 {
-  g_clear_object (&mipmap->fb);
+  g_clear_pointer (&mipmap->fb, release_framebuffer);
   g_clear_object (&mipmap->mipmap_texture);
+  g_clear_pointer (&mipmap->damage, mtk_region_unref);
 }
 
 void
@@ -147,7 +214,105 @@ meta_texture_mipmap_clear (MetaTextureMipmap *mipmap)
 }
 
 static void
-ensure_mipmap_texture (MetaTextureMipmap *mipmap)
+ensure_pipeline (MetaTextureMipmap *mipmap)
+{
+  int n_planes, i;
+
+  n_planes = meta_multi_texture_get_n_planes (mipmap->base_texture);
+
+  if (!mipmap->pipeline)
+    {
+      mipmap->pipeline = cogl_pipeline_new (mipmap->cogl_context);
+      cogl_pipeline_set_blend (mipmap->pipeline,
+                               "RGBA = ADD (SRC_COLOR, 0)",
+                               NULL);
+
+      for (i = 0; i < n_planes; i++)
+        {
+          cogl_pipeline_set_layer_filters (mipmap->pipeline, i,
+                                           COGL_PIPELINE_FILTER_LINEAR,
+                                           COGL_PIPELINE_FILTER_LINEAR);
+          cogl_pipeline_set_layer_combine (mipmap->pipeline, i,
+                                           "RGBA = REPLACE(TEXTURE)",
+                                           NULL);
+        }
+
+      meta_multi_texture_add_pipeline_sampling (mipmap->base_texture,
+                                                mipmap->coeffs,
+                                                META_MULTI_TEXTURE_ALPHA_MODE_PREMULT_ELECTRICAL,
+                                                mipmap->pipeline);
+    }
+
+  for (i = 0; i < n_planes; i++)
+    {
+      CoglTexture *plane = meta_multi_texture_get_plane (mipmap->base_texture, i);
+
+      cogl_pipeline_set_layer_texture (mipmap->pipeline, i, plane);
+    }
+}
+
+static void
+update_damaged_area (MetaTextureMipmap  *mipmap,
+                     const MtkRectangle *area,
+                     int                 width,
+                     int                 height)
+{
+  float scale_x, scale_y;
+  int x1, y1, x2, y2;
+
+  scale_x = (float) width / meta_multi_texture_get_width (mipmap->base_texture);
+  scale_y = (float) height / meta_multi_texture_get_height (mipmap->base_texture);
+
+  /* Every pixel of the mipmap texture is linearly filtered from the base
+   * texels around its center, so one more pixel on each side picks up
+   * everything the damaged texels contribute to */
+  x1 = CLAMP ((int) floorf (area->x * scale_x) - 1, 0, width);
+  y1 = CLAMP ((int) floorf (area->y * scale_y) - 1, 0, height);
+  x2 = CLAMP ((int) ceilf ((area->x + area->width) * scale_x) + 1, 0, width);
+  y2 = CLAMP ((int) ceilf ((area->y + area->height) * scale_y) + 1, 0, height);
+
+  if (x1 >= x2 || y1 >= y2)
+    return;
+
+  /* Same mapping from mipmap pixels to texture coordinates as when
+   * drawing all of it, so the result is the same */
+  cogl_framebuffer_draw_textured_rectangle (mipmap->fb,
+                                            mipmap->pipeline,
+                                            x1, y1, x2, y2,
+                                            (float) x1 / width,
+                                            (float) y1 / height,
+                                            (float) x2 / width,
+                                            (float) y2 / height);
+}
+
+static void
+update_damaged_areas (MetaTextureMipmap *mipmap,
+                      int                width,
+                      int                height)
+{
+  int n_rects, i;
+
+  n_rects = mtk_region_num_rectangles (mipmap->damage);
+
+  if (n_rects > MAX_DAMAGE_RECTS)
+    {
+      MtkRectangle extents = mtk_region_get_extents (mipmap->damage);
+
+      update_damaged_area (mipmap, &extents, width, height);
+      return;
+    }
+
+  for (i = 0; i < n_rects; i++)
+    {
+      MtkRectangle rect = mtk_region_get_rectangle (mipmap->damage, i);
+
+      update_damaged_area (mipmap, &rect, width, height);
+    }
+}
+
+static void
+ensure_mipmap_texture (MetaTextureMipmap *mipmap,
+                       int64_t            now_us)
 {
   int width, height;
 
@@ -187,68 +352,27 @@ ensure_mipmap_texture (MetaTextureMipmap *mipmap)
 
       free_mipmaps (mipmap);
 
-      tex = cogl_texture_2d_new_with_size (mipmap->cogl_context, width, height);
-      if (!tex)
-        return;
-
-      mipmap->mipmap_texture = meta_multi_texture_new_simple (tex);
-
-      offscreen = cogl_offscreen_new_with_texture (tex);
+      offscreen = cogl_offscreen_new_pooled (mipmap->cogl_context,
+                                             COGL_PIXEL_FORMAT_ANY,
+                                             width, height,
+                                             NULL);
       if (!offscreen)
-        {
-          free_mipmaps (mipmap);
-          return;
-        }
+        return;
 
       mipmap->fb = COGL_FRAMEBUFFER (offscreen);
 
-      if (!cogl_framebuffer_allocate (mipmap->fb, NULL))
-        {
-          free_mipmaps (mipmap);
-          return;
-        }
+      tex = cogl_offscreen_get_texture (offscreen);
+      mipmap->mipmap_texture = meta_multi_texture_new_simple (g_object_ref (tex));
 
       cogl_framebuffer_orthographic (mipmap->fb,
                                      0, 0, width, height, -1.0, 1.0);
 
-      mipmap->invalid = TRUE;
+      meta_texture_mipmap_invalidate (mipmap);
     }
 
   if (mipmap->invalid)
     {
-      int n_planes, i;
-
-      n_planes = meta_multi_texture_get_n_planes (mipmap->base_texture);
-
-      if (!mipmap->pipeline)
-        {
-          mipmap->pipeline = cogl_pipeline_new (mipmap->cogl_context);
-          cogl_pipeline_set_blend (mipmap->pipeline,
-                                   "RGBA = ADD (SRC_COLOR, 0)",
-                                   NULL);
-
-          for (i = 0; i < n_planes; i++)
-            {
-              cogl_pipeline_set_layer_filters (mipmap->pipeline, i,
-                                               COGL_PIPELINE_FILTER_LINEAR,
-                                               COGL_PIPELINE_FILTER_LINEAR);
-              cogl_pipeline_set_layer_combine (mipmap->pipeline, i,
-                                               "RGBA = REPLACE(TEXTURE)",
-                                               NULL);
-            }
-
-          meta_multi_texture_add_pipeline_sampling (mipmap->base_texture,
-                                                    mipmap->coeffs,
-                                                    META_MULTI_TEXTURE_ALPHA_MODE_PREMULT_ELECTRICAL,
-                                                    mipmap->pipeline);
-        }
-
-      for (i = 0; i < n_planes; i++)
-        {
-          CoglTexture *plane = meta_multi_texture_get_plane (mipmap->base_texture, i);
-
-          cogl_pipeline_set_layer_texture (mipmap->pipeline, i, plane);
-        }
+      ensure_pipeline (mipmap);
 
       cogl_framebuffer_draw_textured_rectangle (mipmap->fb,
                                                 mipmap->pipeline,
@@ -256,6 +380,18 @@ ensure_mipmap_texture (MetaTextureMipmap *mipmap)
                                                 0.0, 0.0, 1.0, 1.0);
 
       mipmap->invalid = FALSE;
+      mipmap->last_update_us = now_us;
+    }
+  else if (mipmap->damage)
+    {
+      if (now_us - mipmap->last_update_us < MIN_PARTIAL_UPDATE_INTERVAL_US)
+        return;
+
+      ensure_pipeline (mipmap);
+      update_damaged_areas (mipmap, width, height);
+
+      g_clear_pointer (&mipmap->damage, mtk_region_unref);
+      mipmap->last_update_us = now_us;
     }
 }
 
@@ -274,10 +410,29 @@ ensure_mipmap_texture (MetaTextureMipmap *mipmap)
  */
 MetaMultiTexture *
 meta_texture_mipmap_get_paint_texture (MetaTextureMipmap *mipmap)
+{
+  return meta_texture_mipmap_get_paint_texture_at (mipmap,
+                                                   g_get_monotonic_time ());
+}
+
+/**
+ * meta_texture_mipmap_get_paint_texture_at:
+ * @mipmap: a #MetaTextureMipmap
+ * @now_us: the current monotonic time
+ *
+ * Like meta_texture_mipmap_get_paint_texture(), but rate limits partial
+ * updates according to @now_us rather than the monotonic clock.
+ *
+ * Return value: the COGL texture handle to use for painting, or
+ *  %NULL if no base texture has yet been set.
+ */
+MetaMultiTexture *
+meta_texture_mipmap_get_paint_texture_at (MetaTextureMipmap *mipmap,
+                                          int64_t            now_us)
 {
   g_return_val_if_fail (mipmap != NULL, NULL);
 
-  ensure_mipmap_texture (mipmap);
+  ensure_mipmap_texture (mipmap, now_us);
 
   return mipmap->mipmap_texture;
 }
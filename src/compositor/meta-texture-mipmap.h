@@ -23,6 +23,7 @@
 #pragma once
 
 #include "clutter/clutter.h"
+#include "core/util-private.h"
 #include "meta/meta-multi-texture.h"
 
 G_BEGIN_DECLS
@@ -37,20 +38,37 @@ G_BEGIN_DECLS
 
 typedef struct _MetaTextureMipmap MetaTextureMipmap;
 
+META_EXPORT_TEST
 MetaTextureMipmap *meta_texture_mipmap_new (CoglContext *cogl_context);
 
+META_EXPORT_TEST
 void meta_texture_mipmap_free (MetaTextureMipmap *mipmap);
 
+META_EXPORT_TEST
 void meta_texture_mipmap_set_base_texture (MetaTextureMipmap *mipmap,
                                            MetaMultiTexture  *texture);
 
 void meta_texture_mipmap_set_coeffs (MetaTextureMipmap            *mipmap,
                                      MetaMultiTextureCoefficients  coeffs);
 
+META_EXPORT_TEST
 MetaMultiTexture *meta_texture_mipmap_get_paint_texture (MetaTextureMipmap *mipmap);
 
+META_EXPORT_TEST
+MetaMultiTexture *meta_texture_mipmap_get_paint_texture_at (MetaTextureMipmap *mipmap,
+                                                            int64_t            now_us);
+
+META_EXPORT_TEST
 void meta_texture_mipmap_invalidate (MetaTextureMipmap *mipmap);
 
+META_EXPORT_TEST
+void meta_texture_mipmap_invalidate_area (MetaTextureMipmap  *mipmap,
+                                          const MtkRectangle *area);
+
+META_EXPORT_TEST
+int64_t meta_texture_mipmap_get_next_update_time (MetaTextureMipmap *mipmap);
+
+META_EXPORT_TEST
 void meta_texture_mipmap_clear (MetaTextureMipmap *mipmap);
 
 G_END_DECLS
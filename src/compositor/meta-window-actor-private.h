@@ -104,6 +104,10 @@ gboolean meta_window_actor_is_streaming (MetaWindowActor *window_actor);
 
 void meta_window_actor_notify_damaged (MetaWindowActor *window_actor);
 
+void meta_window_actor_get_frame_timing (MetaWindowActor *self,
+                                         int64_t         *last_presentation_time_us,
+                                         uint64_t        *n_frames);
+
 gboolean meta_window_actor_is_frozen (MetaWindowActor *self);
 
 gboolean meta_window_actor_is_opaque (MetaWindowActor *self);
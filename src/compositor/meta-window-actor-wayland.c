@@ -345,17 +345,15 @@ cullable_iface_init (MetaCullableInterface *iface)
 }
 
 static MetaSurfaceActor *
-meta_window_actor_wayland_get_scanout_candidate (MetaWindowActor *actor)
+find_topmost_surface_actor (MetaWindowActorWayland *self,
+                            int                    *n_visible_surface_actors)
 {
-  MetaWindowActorWayland *self = META_WINDOW_ACTOR_WAYLAND (actor);
   ClutterActor *surface_container = CLUTTER_ACTOR (self->surface_container);
   ClutterActor *child_actor;
   ClutterActorIter iter;
   MetaSurfaceActor *topmost_surface_actor = NULL;
-  int n_visible_surface_actors = 0;
-  MetaWindow *window;
-  ClutterActorBox window_box;
-  ClutterActorBox surface_box;
+
+  *n_visible_surface_actors = 0;
 
   if (clutter_actor_get_last_child (CLUTTER_ACTOR (self)) != surface_container)
     {
@@ -377,7 +375,7 @@ meta_window_actor_wayland_get_scanout_candidate (MetaWindowActor *actor)
         continue;
 
       topmost_surface_actor = surface_actor;
-      n_visible_surface_actors++;
+      (*n_visible_surface_actors)++;
     }
 
   if (!topmost_surface_actor)
@@ -387,6 +385,35 @@ meta_window_actor_wayland_get_scanout_candidate (MetaWindowActor *actor)
       return NULL;
     }
 
+  return topmost_surface_actor;
+}
+
+MetaSurfaceActor *
+meta_window_actor_wayland_get_topmost_surface_actor (MetaWindowActorWayland *self)
+{
+  int n_visible_surface_actors;
+
+  return find_topmost_surface_actor (self, &n_visible_surface_actors);
+}
+
+static MetaSurfaceActor *
+meta_window_actor_wayland_get_scanout_candidate (MetaWindowActor *actor)
+{
+  MetaWindowActorWayland *self = META_WINDOW_ACTOR_WAYLAND (actor);
+  ClutterActor *surface_container = CLUTTER_ACTOR (self->surface_container);
+  ClutterActor *child_actor;
+  ClutterActorIter iter;
+  MetaSurfaceActor *topmost_surface_actor;
+  int n_visible_surface_actors;
+  MetaWindow *window;
+  ClutterActorBox window_box;
+  ClutterActorBox surface_box;
+
+  topmost_surface_actor = find_topmost_surface_actor (self,
+                                                      &n_visible_surface_actors);
+  if (!topmost_surface_actor)
+    return NULL;
+
   window = meta_window_actor_get_meta_window (actor);
   if (meta_window_is_fullscreen (window) && n_visible_surface_actors == 1)
     return topmost_surface_actor;
@@ -35,3 +35,5 @@ G_DECLARE_FINAL_TYPE (MetaSurfaceContainerActorWayland,
                       ClutterActor)
 
 void meta_window_actor_wayland_rebuild_surface_tree (MetaWindowActor *actor);
+
+MetaSurfaceActor * meta_window_actor_wayland_get_topmost_surface_actor (MetaWindowActorWayland *self);
@@ -29,6 +29,7 @@
 #include "compositor/meta-surface-actor.h"
 #include "compositor/meta-window-actor-private.h"
 #include "core/boxes-private.h"
+#include "core/display-private.h"
 #include "core/window-private.h"
 #include "meta/window.h"
 
@@ -80,6 +81,10 @@ typedef struct _MetaWindowActorPrivate
   guint             freeze_count;
   guint             screen_cast_usage_count;
 
+  /* Presentation of frames with new contents */
+  int64_t last_frame_presentation_time_us;
+  uint64_t n_frames_presented;
+
   guint		    visible                : 1;
   guint		    disposed               : 1;
 
@@ -87,6 +92,7 @@ typedef struct _MetaWindowActorPrivate
 
   guint             updates_frozen         : 1;
   guint             first_frame_state      : 2; /* FirstFrameState */
+  guint             damaged_since_frame    : 1;
 
   /* whether the associated window was created during a window drag */
   unsigned int tied_to_drag : 1;
@@ -1248,6 +1254,23 @@ meta_window_actor_frame_complete (MetaWindowActor  *self,
                                   ClutterFrameInfo *frame_info,
                                   gint64            presentation_time)
 {
+  MetaWindowActorPrivate *priv =
+    meta_window_actor_get_instance_private (self);
+
+  if (priv->damaged_since_frame)
+    {
+      MetaWindowSnapshot *window_snapshot =
+        priv->window->display->window_snapshot;
+
+      priv->last_frame_presentation_time_us = presentation_time;
+      priv->n_frames_presented++;
+      priv->damaged_since_frame = FALSE;
+
+      /* The frame timing is part of the window snapshot */
+      if (window_snapshot)
+        meta_window_snapshot_queue_update (window_snapshot);
+    }
+
   META_WINDOW_ACTOR_GET_CLASS (self)->frame_complete (self,
                                                       frame_info,
                                                       presentation_time);
@@ -1650,9 +1673,26 @@ meta_window_actor_from_actor (ClutterActor *actor)
 void
 meta_window_actor_notify_damaged (MetaWindowActor *window_actor)
 {
+  MetaWindowActorPrivate *priv =
+    meta_window_actor_get_instance_private (window_actor);
+
+  priv->damaged_since_frame = TRUE;
+
   g_signal_emit (window_actor, signals[DAMAGED], 0);
 }
 
+void
+meta_window_actor_get_frame_timing (MetaWindowActor *self,
+                                    int64_t         *last_presentation_time_us,
+                                    uint64_t        *n_frames)
+{
+  MetaWindowActorPrivate *priv =
+    meta_window_actor_get_instance_private (self);
+
+  *last_presentation_time_us = priv->last_frame_presentation_time_us;
+  *n_frames = priv->n_frames_presented;
+}
+
 static CoglFramebuffer *
 create_framebuffer_from_window_actor (MetaWindowActor  *self,
                                       MtkRectangle     *clip,
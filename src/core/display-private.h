@@ -33,6 +33,7 @@
 #include "core/meta-gesture-tracker-private.h"
 #include "core/meta-pad-action-mapper.h"
 #include "core/meta-tool-action-mapper.h"
+#include "core/meta-window-snapshot.h"
 #include "core/stack-tracker.h"
 #include "core/startup-notification-private.h"
 #include "meta/barrier.h"
@@ -61,6 +62,15 @@ typedef enum
 typedef void (* MetaDisplayWindowFunc) (MetaWindow *window,
                                         gpointer    user_data);
 
+typedef struct _MetaDisplayWindowIter
+{
+  /*< private >*/
+  MetaDisplay *display;
+  MetaListWindowsFlags flags;
+  unsigned int index;
+  unsigned int age;
+} MetaDisplayWindowIter;
+
 
 /* To avoid ifdefing MetaX11Display usage when built without X11 support */
 #ifndef HAVE_X11_CLIENT
@@ -97,6 +107,12 @@ struct _MetaDisplay
   GHashTable *stamps;
   GHashTable *wayland_windows;
 
+  /* All managed windows, X11 and Wayland, sorted most recently used first.
+   * The age changes whenever the registry does, to catch modifications
+   * while iterating. */
+  GPtrArray *window_registry;
+  unsigned int window_registry_age;
+
   guint32 current_time;
 
   /* We maintain a sequence counter, incremented for each #MetaWindow
@@ -155,10 +171,13 @@ struct _MetaDisplay
   MetaSoundPlayer *sound_player;
 
   MetaSelectionSource *selection_source;
-  GBytes *saved_clipboard;
+  MtkAnonymousFile *saved_clipboard;
   gchar *saved_clipboard_mimetype;
   MetaSelection *selection;
   GCancellable *saved_clipboard_cancellable;
+
+  /* Created when first asked for through the debug control interface */
+  MetaWindowSnapshot *window_snapshot;
 };
 
 struct _MetaDisplayClass
@@ -225,6 +244,21 @@ META_EXPORT_TEST
 GSList*     meta_display_list_windows        (MetaDisplay          *display,
                                               MetaListWindowsFlags  flags);
 
+void        meta_display_register_window     (MetaDisplay *display,
+                                              MetaWindow  *window);
+void        meta_display_unregister_window   (MetaDisplay *display,
+                                              MetaWindow  *window);
+void        meta_display_window_user_time_changed (MetaDisplay *display,
+                                                   MetaWindow  *window);
+
+META_EXPORT_TEST
+void        meta_display_window_iter_init    (MetaDisplayWindowIter *iter,
+                                              MetaDisplay           *display,
+                                              MetaListWindowsFlags   flags);
+META_EXPORT_TEST
+gboolean    meta_display_window_iter_next    (MetaDisplayWindowIter  *iter,
+                                              MetaWindow            **window);
+
 void meta_display_ping_window      (MetaWindow  *window,
                                     guint32      serial);
 void meta_display_pong_for_serial  (MetaDisplay *display,
@@ -338,3 +372,5 @@ void meta_display_handle_window_enter (MetaDisplay *display,
 
 void meta_display_handle_window_leave (MetaDisplay *display,
                                        MetaWindow  *window);
+
+MetaWindowSnapshot * meta_display_get_window_snapshot (MetaDisplay *display);
@@ -206,9 +206,6 @@ static void on_monitors_changed_internal (MetaMonitorManager *monitor_manager,
 static void    prefs_changed_callback    (MetaPreference pref,
                                           void          *data);
 
-static int mru_cmp (gconstpointer a,
-                    gconstpointer b);
-
 static void meta_display_reload_cursor (MetaDisplay *display);
 
 static void meta_display_unmanage_windows (MetaDisplay *display,
@@ -985,6 +982,7 @@ meta_display_new (MetaContext  *context,
   display->stamps = g_hash_table_new (g_int64_hash,
                                       g_int64_equal);
   display->wayland_windows = g_hash_table_new (NULL, NULL);
+  display->window_registry = g_ptr_array_new ();
 
   monitor_manager = meta_backend_get_monitor_manager (backend);
   g_signal_connect (monitor_manager, "monitors-changed-internal",
@@ -1097,17 +1095,6 @@ meta_display_new (MetaContext  *context,
   return display;
 }
 
-static gint
-ptrcmp (gconstpointer a, gconstpointer b)
-{
-  if (a < b)
-    return -1;
-  else if (a > b)
-    return 1;
-  else
-    return 0;
-}
-
 /**
  * meta_display_list_windows:
  * @display: a #MetaDisplay
@@ -1123,85 +1110,163 @@ GSList*
 meta_display_list_windows (MetaDisplay          *display,
                            MetaListWindowsFlags  flags)
 {
-  GSList *winlist;
-  GSList *prev;
-  GSList *tmp;
-  GHashTableIter iter;
-  gpointer key, value;
+  MetaDisplayWindowIter iter;
+  MetaWindow *window;
+  GSList *winlist = NULL;
 
-  winlist = NULL;
+  meta_display_window_iter_init (&iter, display, flags);
+  while (meta_display_window_iter_next (&iter, &window))
+    winlist = g_slist_prepend (winlist, window);
 
-#ifdef HAVE_X11_CLIENT
-  if (display->x11_display)
-    {
-      g_hash_table_iter_init (&iter, display->x11_display->xids);
-      while (g_hash_table_iter_next (&iter, &key, &value))
-        {
-          MetaWindow *window = value;
+  return g_slist_reverse (winlist);
+}
+
+/**
+ * meta_display_window_iter_init:
+ * @iter: an uninitialized #MetaDisplayWindowIter
+ * @display: a #MetaDisplay
+ * @flags: options for listing
+ *
+ * Initializes an iterator over the same windows meta_display_list_windows()
+ * lists, without allocating anything. With %META_LIST_SORTED, the most
+ * recently used window comes first.
+ *
+ * Windows must not be managed or unmanaged, nor have their user time
+ * changed, while iterating; use meta_display_list_windows() for that.
+ */
+void
+meta_display_window_iter_init (MetaDisplayWindowIter *iter,
+                               MetaDisplay           *display,
+                               MetaListWindowsFlags   flags)
+{
+  iter->display = display;
+  iter->flags = flags;
+  iter->index = 0;
+  iter->age = display->window_registry_age;
+}
 
-          if (!META_IS_WINDOW (window) || window->unmanaging)
-            continue;
+/**
+ * meta_display_window_iter_next:
+ * @iter: an initialized #MetaDisplayWindowIter
+ * @window: (out) (optional): a location to store the window
+ *
+ * Advances @iter, and retrieves the next window.
+ *
+ * Returns: %FALSE when there are no more windows
+ */
+gboolean
+meta_display_window_iter_next (MetaDisplayWindowIter  *iter,
+                               MetaWindow            **window)
+{
+  GPtrArray *windows = iter->display->window_registry;
 
-          if (!window->override_redirect ||
-              (flags & META_LIST_INCLUDE_OVERRIDE_REDIRECT) != 0)
-            winlist = g_slist_prepend (winlist, window);
+  g_return_val_if_fail (iter->age == iter->display->window_registry_age,
+                        FALSE);
+
+  while (iter->index < windows->len)
+    {
+      MetaWindow *next_window = g_ptr_array_index (windows, iter->index++);
+
+      if (!next_window->override_redirect ||
+          (iter->flags & META_LIST_INCLUDE_OVERRIDE_REDIRECT) != 0)
+        {
+          if (window)
+            *window = next_window;
+          return TRUE;
         }
     }
-#endif
 
-  g_hash_table_iter_init (&iter, display->wayland_windows);
-  while (g_hash_table_iter_next (&iter, &key, &value))
-    {
-      MetaWindow *window = value;
+  return FALSE;
+}
 
-      if (!META_IS_WINDOW (window) || window->unmanaging)
-        continue;
+static gboolean
+is_more_recently_used (MetaWindow *window,
+                       MetaWindow *other_window)
+{
+  return (meta_window_get_user_time (window) >
+          meta_window_get_user_time (other_window));
+}
 
-      if (!window->override_redirect ||
-          (flags & META_LIST_INCLUDE_OVERRIDE_REDIRECT) != 0)
-        winlist = g_slist_prepend (winlist, window);
-    }
+static void
+set_registered_window (MetaDisplay  *display,
+                       unsigned int  index,
+                       MetaWindow   *window)
+{
+  display->window_registry->pdata[index] = window;
+  window->registry_index = index;
+}
 
-  /* Uniquify the list, since both frame windows and plain
-   * windows are in the hash
-   */
-  winlist = g_slist_sort (winlist, ptrcmp);
+static void
+sort_registered_window (MetaDisplay *display,
+                        MetaWindow  *window)
+{
+  GPtrArray *windows = display->window_registry;
+  unsigned int index = window->registry_index;
 
-  prev = NULL;
-  tmp = winlist;
-  while (tmp != NULL)
+  /* User times mostly only move forward, so windows tend to move a few
+   * places towards the front, if at all */
+  while (index > 0 &&
+         is_more_recently_used (window,
+                                g_ptr_array_index (windows, index - 1)))
     {
-      GSList *next;
+      set_registered_window (display, index,
+                             g_ptr_array_index (windows, index - 1));
+      index--;
+    }
 
-      next = tmp->next;
+  while (index + 1 < windows->len &&
+         is_more_recently_used (g_ptr_array_index (windows, index + 1),
+                                window))
+    {
+      set_registered_window (display, index,
+                             g_ptr_array_index (windows, index + 1));
+      index++;
+    }
 
-      if (next &&
-          next->data == tmp->data)
-        {
-          /* Delete tmp from list */
+  set_registered_window (display, index, window);
+}
 
-          if (prev)
-            prev->next = next;
+void
+meta_display_register_window (MetaDisplay *display,
+                              MetaWindow  *window)
+{
+  g_return_if_fail (window->registry_index == -1);
 
-          if (tmp == winlist)
-            winlist = next;
+  window->registry_index = display->window_registry->len;
+  g_ptr_array_add (display->window_registry, window);
+  sort_registered_window (display, window);
 
-          g_slist_free_1 (tmp);
+  display->window_registry_age++;
+}
 
-          /* leave prev unchanged */
-        }
-      else
-        {
-          prev = tmp;
-        }
+void
+meta_display_unregister_window (MetaDisplay *display,
+                                MetaWindow  *window)
+{
+  GPtrArray *windows = display->window_registry;
+  unsigned int index;
 
-      tmp = next;
-    }
+  if (window->registry_index == -1)
+    return;
+
+  g_ptr_array_remove_index (windows, window->registry_index);
+  for (index = window->registry_index; index < windows->len; index++)
+    set_registered_window (display, index, g_ptr_array_index (windows, index));
+  window->registry_index = -1;
+
+  display->window_registry_age++;
+}
+
+void
+meta_display_window_user_time_changed (MetaDisplay *display,
+                                       MetaWindow  *window)
+{
+  if (window->registry_index == -1)
+    return;
 
-  if (flags & META_LIST_SORTED)
-    winlist = g_slist_sort (winlist, mru_cmp);
+  sort_registered_window (display, window);
 
-  return winlist;
+  display->window_registry_age++;
 }
 
 void
@@ -1223,6 +1288,8 @@ meta_display_close (MetaDisplay *display,
 
   g_signal_emit (display, display_signals[CLOSING], 0);
 
+  g_clear_object (&display->window_snapshot);
+
   meta_display_unmanage_windows (display, timestamp);
   meta_compositor_unmanage (display->compositor);
 
@@ -1257,6 +1324,7 @@ meta_display_close (MetaDisplay *display,
    * unregister windows
    */
   g_hash_table_destroy (display->wayland_windows);
+  g_clear_pointer (&display->window_registry, g_ptr_array_unref);
   g_hash_table_destroy (display->stamps);
 
   meta_display_shutdown_keys (display);
@@ -1964,7 +2032,7 @@ find_tab_forward (MetaDisplay   *display,
       tmp = tmp->next;
     }
 
-  tmp = workspace->mru_list;
+  tmp = workspace->mru_list.head;
   while (tmp != start)
     {
       MetaWindow *window = tmp->data;
@@ -2003,7 +2071,7 @@ find_tab_backward (MetaDisplay   *display,
       tmp = tmp->prev;
     }
 
-  tmp = g_list_last (workspace->mru_list);
+  tmp = workspace->mru_list.tail;
   while (tmp != start)
     {
       MetaWindow *window = tmp->data;
@@ -2017,23 +2085,6 @@ find_tab_backward (MetaDisplay   *display,
   return NULL;
 }
 
-static int
-mru_cmp (gconstpointer a,
-         gconstpointer b)
-{
-  guint32 time_a, time_b;
-
-  time_a = meta_window_get_user_time ((MetaWindow *)a);
-  time_b = meta_window_get_user_time ((MetaWindow *)b);
-
-  if (time_a > time_b)
-    return -1;
-  else if (time_a < time_b)
-    return 1;
-  else
-    return 0;
-}
-
 /**
  * meta_display_list_all_windows:
  * @display: a #MetaDisplay
@@ -2088,13 +2139,16 @@ meta_display_get_tab_list (MetaDisplay   *display,
 
   if (workspace == NULL)
     {
-      /* Yay for mixing GList and GSList in the API */
-      for (w = windows; w; w = w->next)
-        global_mru_list = g_list_prepend (global_mru_list, w->data);
-      global_mru_list = g_list_sort (global_mru_list, mru_cmp);
+      MetaDisplayWindowIter iter;
+      MetaWindow *window;
+
+      meta_display_window_iter_init (&iter, display, META_LIST_SORTED);
+      while (meta_display_window_iter_next (&iter, &window))
+        global_mru_list = g_list_prepend (global_mru_list, window);
+      global_mru_list = g_list_reverse (global_mru_list);
     }
 
-  mru_list = workspace ? workspace->mru_list : global_mru_list;
+  mru_list = workspace ? workspace->mru_list.head : global_mru_list;
 
   /* Windows MRU ordering strategy:
    * - NORMAL_ALL_MRU: Pure MRU order
@@ -2309,7 +2363,7 @@ meta_display_unmanage_windows (MetaDisplay *display,
 
   winlist = meta_display_list_windows (display,
                                        META_LIST_INCLUDE_OVERRIDE_REDIRECT);
-  winlist = g_slist_sort (winlist, meta_window_stack_position_compare);
+  meta_stack_sort_windows_slist (display->stack, winlist);
   g_slist_foreach (winlist, (GFunc)g_object_ref, NULL);
 
   /* Unmanage all windows */
@@ -2354,7 +2408,7 @@ meta_display_sort_windows_by_stacking (MetaDisplay *display,
 {
   GSList *copy = g_slist_copy (windows);
 
-  copy = g_slist_sort (copy, meta_window_stack_position_compare);
+  meta_stack_sort_windows_slist (display->stack, copy);
 
   return copy;
 }
@@ -3429,14 +3483,12 @@ MetaWindow *
 meta_display_get_window_from_id (MetaDisplay *display,
                                  uint64_t     window_id)
 {
-  g_autoptr (GSList) windows = NULL;
-  GSList *l;
+  MetaDisplayWindowIter iter;
+  MetaWindow *window;
 
-  windows = meta_display_list_windows (display, META_LIST_DEFAULT);
-  for (l = windows; l; l = l->next)
+  meta_display_window_iter_init (&iter, display, META_LIST_DEFAULT);
+  while (meta_display_window_iter_next (&iter, &window))
     {
-      MetaWindow *window = l->data;
-
       if (window->id == window_id)
         return window;
     }
@@ -3481,6 +3533,15 @@ meta_display_get_selection (MetaDisplay *display)
   return display->selection;
 }
 
+MetaWindowSnapshot *
+meta_display_get_window_snapshot (MetaDisplay *display)
+{
+  if (!display->window_snapshot)
+    display->window_snapshot = meta_window_snapshot_new (display);
+
+  return display->window_snapshot;
+}
+
 #ifdef WITH_VERBOSE_MODE
 static const char* meta_window_queue_names[META_N_QUEUE_TYPES] =
   {
@@ -3507,6 +3568,11 @@ update_window_visibilities (MetaDisplay *display,
   COGL_TRACE_BEGIN_SCOPED (MetaDisplayUpdateVisibility,
                            "Meta::Display::update_window_visibilities()");
 
+  /* Sorting all of them once keeps each of the lists below in stacking
+   * order; unplaced and hidden windows bottom to top, shown windows top
+   * to bottom */
+  meta_stack_sort_windows (display->stack, windows);
+
   for (l = windows; l; l = l->next)
     {
       MetaWindow *window = l->data;
@@ -3519,13 +3585,8 @@ update_window_visibilities (MetaDisplay *display,
         should_hide = g_list_prepend (should_hide, window);
     }
 
-  /* Sort bottom to top */
-  unplaced = g_list_sort (unplaced, meta_window_stack_position_compare);
-  should_hide = g_list_sort (should_hide, meta_window_stack_position_compare);
-
-  /* Sort top to bottom */
-  should_show = g_list_sort (should_show, meta_window_stack_position_compare);
-  should_show = g_list_reverse (should_show);
+  unplaced = g_list_reverse (unplaced);
+  should_hide = g_list_reverse (should_hide);
 
   COGL_TRACE_BEGIN_SCOPED (MetaDisplayShowUnplacedWindows,
                            "Meta::Display::update_window_visibilities#show_unplaced()");
@@ -20,8 +20,12 @@
 #include "config.h"
 
 #include "core/meta-clipboard-manager.h"
+
+#include <errno.h>
+#include <gio/gunixoutputstream.h>
+
 #include "core/meta-selection-private.h"
-#include "meta/meta-selection-source-memory.h"
+#include "core/meta-selection-source-memory-private.h"
 
 #define MAX_TEXT_SIZE (4 * 1024 * 1024) /* 4MB */
 #define MAX_IMAGE_SIZE (200 * 1024 * 1024) /* 200MB */
@@ -63,12 +67,12 @@ mimetype_match (const char *mimetype,
 }
 
 static void
-transfer_cb (MetaSelection *selection,
-             GAsyncResult  *result,
-             GOutputStream *output_stream)
+transfer_cb (MetaSelection    *selection,
+             GAsyncResult     *result,
+             MtkAnonymousFile *content)
 {
   MetaDisplay *display = meta_selection_get_display (selection);
-  g_autoptr (GOutputStream) output = output_stream;
+  g_autoptr (MtkAnonymousFile) saved_clipboard = content;
   g_autoptr (GError) error = NULL;
 
   if (!meta_selection_transfer_finish (selection, result, &error))
@@ -79,9 +83,13 @@ transfer_cb (MetaSelection *selection,
       return;
     }
 
-  g_output_stream_close (output, NULL, NULL);
-  display->saved_clipboard =
-    g_memory_output_stream_steal_as_bytes (G_MEMORY_OUTPUT_STREAM (output));
+  if (!mtk_anonymous_file_finish_writing (saved_clipboard))
+    {
+      g_warning ("Failed to store clipboard: %s", g_strerror (errno));
+      return;
+    }
+
+  display->saved_clipboard = g_steal_pointer (&saved_clipboard);
 }
 
 static void
@@ -95,7 +103,8 @@ owner_changed_cb (MetaSelection       *selection,
 
   if (new_owner && new_owner != display->selection_source)
     {
-      GOutputStream *output;
+      g_autoptr (GOutputStream) output = NULL;
+      MtkAnonymousFile *content;
       GList *mimetypes, *l;
       int best_idx = -1;
       const char *best = NULL;
@@ -108,7 +117,7 @@ owner_changed_cb (MetaSelection       *selection,
       g_clear_object (&display->saved_clipboard_cancellable);
       g_clear_object (&display->selection_source);
       g_clear_pointer (&display->saved_clipboard_mimetype, g_free);
-      g_clear_pointer (&display->saved_clipboard, g_bytes_unref);
+      g_clear_pointer (&display->saved_clipboard, mtk_anonymous_file_free);
 
       mimetypes = meta_selection_get_mimetypes (selection, selection_type);
 
@@ -136,7 +145,20 @@ owner_changed_cb (MetaSelection       *selection,
 
       display->saved_clipboard_mimetype = g_strdup (best);
       g_list_free_full (mimetypes, g_free);
-      output = g_memory_output_stream_new_resizable ();
+
+      /* The contents are stored straight into an anonymous file, so they
+       * don't take up memory of our own, and can be handed out later
+       * without copying.
+       */
+      content = mtk_anonymous_file_new_writable ("clipboard");
+      if (!content)
+        {
+          g_warning ("Failed to store clipboard: %s", g_strerror (errno));
+          return;
+        }
+
+      output = g_unix_output_stream_new (mtk_anonymous_file_get_write_fd (content),
+                                         FALSE);
       display->saved_clipboard_cancellable = g_cancellable_new ();
       meta_selection_transfer_async (selection,
                                      META_SELECTION_CLIPBOARD,
@@ -145,28 +167,26 @@ owner_changed_cb (MetaSelection       *selection,
                                      output,
                                      display->saved_clipboard_cancellable,
                                      (GAsyncReadyCallback) transfer_cb,
-                                     output);
+                                     content);
     }
-  else if (!new_owner && display->saved_clipboard)
+  else if (!new_owner &&
+           (display->saved_clipboard || display->selection_source))
     {
-      g_autoptr (GError) error = NULL;
-      g_autoptr (MetaSelectionSource) new_source = NULL;
-
       g_assert (display->saved_clipboard_mimetype != NULL);
 
-      /* Old owner is gone, time to take over */
-      new_source = meta_selection_source_memory_new (display->saved_clipboard_mimetype,
-                                                     display->saved_clipboard,
-                                                     &error);
-      if (!new_source)
+      /* Old owner is gone, time to take over. The stored contents are
+       * handed over to the selection source, which is kept around for as
+       * long as they are valid.
+       */
+      if (!display->selection_source)
         {
-          g_warning ("MetaClipboardManager failed to create new MetaSelectionSourceMemory: %s",
-                     error->message);
-          return;
+          display->selection_source =
+            meta_selection_source_memory_new_for_file (display->saved_clipboard_mimetype,
+                                                       g_steal_pointer (&display->saved_clipboard));
         }
 
-      g_set_object (&display->selection_source, new_source);
-      meta_selection_set_owner (selection, selection_type, new_source);
+      meta_selection_set_owner (selection, selection_type,
+                                display->selection_source);
     }
 }
 
@@ -188,7 +208,7 @@ meta_clipboard_manager_shutdown (MetaDisplay *display)
   g_cancellable_cancel (display->saved_clipboard_cancellable);
   g_clear_object (&display->saved_clipboard_cancellable);
   g_clear_object (&display->selection_source);
-  g_clear_pointer (&display->saved_clipboard, g_bytes_unref);
+  g_clear_pointer (&display->saved_clipboard, mtk_anonymous_file_free);
   g_clear_pointer (&display->saved_clipboard_mimetype, g_free);
   selection = meta_display_get_selection (display);
   g_signal_handlers_disconnect_by_func (selection, owner_changed_cb, display);
@@ -29,3 +29,5 @@ gboolean meta_debug_control_is_session_management_protocol_enabled (MetaDebugCon
 gboolean meta_debug_control_is_hw_cursor_inhibited (MetaDebugControl *debug_control);
 
 gboolean meta_debug_control_is_a11y_manager_without_access_control (MetaDebugControl *debug_control);
+
+gboolean meta_debug_control_is_wayland_client_statistics_enabled (MetaDebugControl *debug_control);
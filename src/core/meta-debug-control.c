@@ -20,10 +20,19 @@
 
 #include "core/meta-debug-control-private.h"
 
+#include <gio/gunixfdlist.h>
+#include <unistd.h>
+
+#include "core/display-private.h"
 #include "core/util-private.h"
 #include "meta/meta-backend.h"
 #include "meta/meta-context.h"
 
+#ifdef HAVE_WAYLAND
+#include "wayland/meta-wayland-client-private.h"
+#include "wayland/meta-wayland-private.h"
+#endif
+
 enum
 {
   PROP_0,
@@ -57,9 +66,103 @@ G_DEFINE_TYPE_WITH_CODE (MetaDebugControl,
                          G_IMPLEMENT_INTERFACE (META_DBUS_TYPE_DEBUG_CONTROL,
                                                 meta_dbus_debug_control_iface_init))
 
+static gboolean
+handle_get_wayland_client_statistics (MetaDBusDebugControl  *object,
+                                      GDBusMethodInvocation *invocation)
+{
+  MetaDebugControl *debug_control = META_DEBUG_CONTROL (object);
+  GVariantBuilder statistics_builder;
+#ifdef HAVE_WAYLAND
+  MetaWaylandCompositor *compositor =
+    meta_context_get_wayland_compositor (debug_control->context);
+#endif
+
+  g_variant_builder_init (&statistics_builder, G_VARIANT_TYPE ("a(uttt)"));
+
+#ifdef HAVE_WAYLAND
+  if (compositor)
+    {
+      struct wl_list *client_list;
+      struct wl_client *wl_client;
+
+      client_list = wl_display_get_client_list (compositor->wayland_display);
+      wl_client_for_each (wl_client, client_list)
+        {
+          MetaWaylandClient *client = meta_get_wayland_client (wl_client);
+          uint64_t n_requests, n_bytes, n_floods;
+
+          if (!client)
+            continue;
+
+          meta_wayland_client_get_request_stats (client,
+                                                 &n_requests,
+                                                 &n_bytes,
+                                                 &n_floods);
+          g_variant_builder_add (&statistics_builder, "(uttt)",
+                                 (uint32_t) meta_wayland_client_get_pid (client),
+                                 n_requests,
+                                 n_bytes,
+                                 n_floods);
+        }
+    }
+#endif
+
+  meta_dbus_debug_control_complete_get_wayland_client_statistics (
+    object,
+    invocation,
+    g_variant_builder_end (&statistics_builder));
+
+  return G_DBUS_METHOD_INVOCATION_HANDLED;
+}
+
+static gboolean
+handle_get_window_snapshot (MetaDBusDebugControl  *object,
+                            GDBusMethodInvocation *invocation,
+                            GUnixFDList           *in_fd_list)
+{
+  MetaDebugControl *debug_control = META_DEBUG_CONTROL (object);
+  MetaDisplay *display = meta_context_get_display (debug_control->context);
+  g_autoptr (GUnixFDList) fd_list = NULL;
+  g_autoptr (GError) error = NULL;
+  int fd_idx;
+  int fd;
+
+  if (!display)
+    {
+      g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
+                                             G_DBUS_ERROR_FAILED,
+                                             "No display");
+      return G_DBUS_METHOD_INVOCATION_HANDLED;
+    }
+
+  fd = meta_window_snapshot_open_fd (meta_display_get_window_snapshot (display),
+                                     &error);
+  if (fd < 0)
+    {
+      g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
+                                             G_DBUS_ERROR_FAILED,
+                                             "%s", error->message);
+      return G_DBUS_METHOD_INVOCATION_HANDLED;
+    }
+
+  fd_list = g_unix_fd_list_new ();
+  fd_idx = g_unix_fd_list_append (fd_list, fd, NULL);
+  close (fd);
+
+  meta_dbus_debug_control_complete_get_window_snapshot (object,
+                                                        invocation,
+                                                        fd_list,
+                                                        g_variant_new_handle (fd_idx));
+
+  return G_DBUS_METHOD_INVOCATION_HANDLED;
+}
+
 static void
 meta_dbus_debug_control_iface_init (MetaDBusDebugControlIface *iface)
 {
+  iface->handle_get_wayland_client_statistics =
+    handle_get_wayland_client_statistics;
+  iface->handle_get_window_snapshot = handle_get_window_snapshot;
 }
 
 static void
@@ -172,6 +275,7 @@ meta_debug_control_init (MetaDebugControl *debug_control)
   gboolean session_management_protocol;
   gboolean inhibit_hw_cursor;
   gboolean a11y_manager_without_access_control;
+  gboolean wayland_client_statistics;
 
   force_hdr = g_strcmp0 (getenv ("MUTTER_DEBUG_FORCE_HDR"), "1") == 0;
   meta_dbus_debug_control_set_force_hdr (dbus_debug_control, force_hdr);
@@ -195,6 +299,11 @@ meta_debug_control_init (MetaDebugControl *debug_control)
     g_strcmp0 (getenv ("MUTTER_DEBUG_A11Y_MANAGER_WITHOUT_ACCESS_CONTROL"), "1") == 0;
   meta_dbus_debug_control_set_a11y_manager_without_access_control (dbus_debug_control,
                                                                    a11y_manager_without_access_control);
+
+  wayland_client_statistics =
+    g_strcmp0 (getenv ("MUTTER_DEBUG_WAYLAND_CLIENT_STATISTICS"), "1") == 0;
+  meta_dbus_debug_control_set_wayland_client_statistics (dbus_debug_control,
+                                                         wayland_client_statistics);
 }
 
 gboolean
@@ -269,3 +378,12 @@ meta_debug_control_is_a11y_manager_without_access_control (MetaDebugControl *deb
 
   return meta_dbus_debug_control_get_a11y_manager_without_access_control (dbus_debug_control);
 }
+
+gboolean
+meta_debug_control_is_wayland_client_statistics_enabled (MetaDebugControl *debug_control)
+{
+  MetaDBusDebugControl *dbus_debug_control =
+    META_DBUS_DEBUG_CONTROL (debug_control);
+
+  return meta_dbus_debug_control_get_wayland_client_statistics (dbus_debug_control);
+}
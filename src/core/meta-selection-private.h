@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include "core/util-private.h"
 #include "meta/meta-selection.h"
 
 MetaSelectionSource *
@@ -27,3 +28,7 @@ MetaSelectionSource *
                                     MetaSelectionType  selection_type);
 
 MetaDisplay * meta_selection_get_display (MetaSelection *selection);
+
+META_EXPORT_TEST
+void meta_selection_set_transfer_chunk_size (MetaSelection *selection,
+                                             size_t         chunk_size);
@@ -19,7 +19,7 @@
 
 #include "config.h"
 
-#include "meta/meta-selection-source-memory.h"
+#include "core/meta-selection-source-memory-private.h"
 
 #include <gio/gunixinputstream.h>
 
@@ -36,60 +36,6 @@ G_DEFINE_TYPE (MetaSelectionSourceMemory,
                meta_selection_source_memory,
                META_TYPE_SELECTION_SOURCE)
 
-struct _MetaUnixInputStream
-{
-  GUnixInputStream parent_instance;
-};
-
-#define META_TYPE_UNIX_INPUT_STREAM (meta_unix_input_stream_get_type ())
-G_DECLARE_FINAL_TYPE (MetaUnixInputStream,
-                      meta_unix_input_stream,
-                      META, UNIX_INPUT_STREAM,
-                      GUnixInputStream)
-
-G_DEFINE_FINAL_TYPE (MetaUnixInputStream,
-                     meta_unix_input_stream,
-                     G_TYPE_UNIX_INPUT_STREAM)
-
-static gboolean
-meta_unix_input_stream_close_fn (GInputStream  *input_stream,
-                                 GCancellable  *cancellable,
-                                 GError       **error)
-{
-  GUnixInputStream *stream = G_UNIX_INPUT_STREAM (input_stream);
-  int fd;
-
-  if (!g_unix_input_stream_get_close_fd (stream))
-    return TRUE;
-
-  fd = g_unix_input_stream_get_fd (stream);
-  mtk_anonymous_file_close_fd (fd);
-
-  return TRUE;
-}
-
-static void
-meta_unix_input_stream_class_init (MetaUnixInputStreamClass *klass)
-{
-  GInputStreamClass *input_stream_class = G_INPUT_STREAM_CLASS (klass);
-
-  input_stream_class->close_fn = meta_unix_input_stream_close_fn;
-}
-
-static void
-meta_unix_input_stream_init (MetaUnixInputStream *stream)
-{
-}
-
-static GInputStream *
-meta_unix_input_stream_new (int fd)
-{
-  return G_INPUT_STREAM (g_object_new (META_TYPE_UNIX_INPUT_STREAM,
-                                       "fd", fd,
-                                       "close-fd", TRUE,
-                                       NULL));
-}
-
 static void
 meta_selection_source_memory_read_async (MetaSelectionSource *source,
                                          const char          *mimetype,
@@ -114,8 +60,7 @@ meta_selection_source_memory_read_async (MetaSelectionSource *source,
   task = g_task_new (source, cancellable, callback, user_data);
   g_task_set_source_tag (task, meta_selection_source_memory_read_async);
 
-  fd = mtk_anonymous_file_open_fd (source_mem->content,
-                                   MTK_ANONYMOUS_FILE_MAPMODE_SHARED);
+  fd = mtk_anonymous_file_open_read_fd (source_mem->content);
 
   if (fd == -1)
     {
@@ -126,7 +71,7 @@ meta_selection_source_memory_read_async (MetaSelectionSource *source,
       return;
     }
 
-  stream = meta_unix_input_stream_new (fd);
+  stream = g_unix_input_stream_new (fd, TRUE);
 
   g_task_return_pointer (task, stream, g_object_unref);
 }
@@ -186,7 +131,6 @@ meta_selection_source_memory_new (const char  *mimetype,
                                   GBytes      *content,
                                   GError     **error)
 {
-  MetaSelectionSourceMemory *source;
   MtkAnonymousFile *anon_file;
   const uint8_t *data;
   size_t size;
@@ -204,9 +148,28 @@ meta_selection_source_memory_new (const char  *mimetype,
       return NULL;
     }
 
+  return meta_selection_source_memory_new_for_file (mimetype, anon_file);
+}
+
+/*
+ * meta_selection_source_memory_new_for_file:
+ * @mimetype: Mimetype of @content
+ * @content: (transfer full): Read-only anonymous file with the contents
+ *
+ * Creates a selection source serving @content, without copying it.
+ */
+MetaSelectionSource *
+meta_selection_source_memory_new_for_file (const char       *mimetype,
+                                           MtkAnonymousFile *content)
+{
+  MetaSelectionSourceMemory *source;
+
+  g_return_val_if_fail (mimetype != NULL, NULL);
+  g_return_val_if_fail (content != NULL, NULL);
+
   source = g_object_new (META_TYPE_SELECTION_SOURCE_MEMORY, NULL);
   source->mimetype = g_strdup (mimetype);
-  source->content = anon_file;
+  source->content = content;
 
   return META_SELECTION_SOURCE (source);
 }
@@ -19,9 +19,20 @@
 
 #include "config.h"
 
+#include <errno.h>
+#include <gio/gfiledescriptorbased.h>
+#include <glib-unix.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+
 #include "core/meta-selection-private.h"
 #include "meta/meta-selection.h"
 
+#define SEND_FILE_CHUNK_SIZE (1024 * 1024)
+#define DEFAULT_TRANSFER_CHUNK_SIZE (64 * 1024)
+#define N_TRANSFER_BUFFERS 2
+#define TRANSFER_TIMEOUT_MS (15 * 1000)
+
 typedef struct TransferRequest TransferRequest;
 
 struct _MetaSelection
@@ -29,18 +40,43 @@ struct _MetaSelection
   GObject parent_instance;
   MetaDisplay *display;
   MetaSelectionSource *owners[META_N_SELECTION_TYPES];
+  size_t transfer_chunk_size;
 };
 
+typedef struct
+{
+  uint8_t *data;
+  size_t size;
+} TransferBuffer;
+
 struct TransferRequest
 {
   MetaSelectionType selection_type;
   GInputStream  *istream;
   GOutputStream *ostream;
   gssize len;
+  gboolean close_streams;
   GSource *timeout_source;
+  GSource *send_file_source;
   GCancellable *cancellable;
   GCancellable *external_cancellable;
   gulong cancellable_signal_handler;
+  int64_t last_progress_us;
+
+  /* Contents are read into one buffer while the other one is being
+   * written out, so a transfer never holds more than these in memory,
+   * and a slow receiver holds back reading from the sender.
+   */
+  TransferBuffer buffers[N_TRANSFER_BUFFERS];
+  size_t chunk_size;
+  int n_filled;
+  int read_index;
+  int write_index;
+  gboolean reading;
+  gboolean writing;
+  gboolean eof;
+  gboolean finished;
+  GError *error;
 };
 
 enum
@@ -53,8 +89,7 @@ static guint signals[N_SIGNALS] = { 0 };
 
 G_DEFINE_TYPE (MetaSelection, meta_selection, G_TYPE_OBJECT)
 
-static void read_selection_source_async (GTask           *task,
-                                         TransferRequest *request);
+static void transfer_pump (GTask *task);
 
 static void
 meta_selection_dispose (GObject *object)
@@ -91,6 +126,7 @@ meta_selection_class_init (MetaSelectionClass *klass)
 static void
 meta_selection_init (MetaSelection *selection)
 {
+  selection->transfer_chunk_size = DEFAULT_TRANSFER_CHUNK_SIZE;
 }
 
 MetaSelection *
@@ -181,10 +217,24 @@ meta_selection_get_mimetypes (MetaSelection     *selection,
   return meta_selection_source_get_mimetypes (selection->owners[selection_type]);
 }
 
+static void arm_transfer_timeout (TransferRequest *request,
+                                  int64_t          timeout_ms);
+
 static gboolean
 cancel_transfer_request (gpointer user_data)
 {
   TransferRequest *request = user_data;
+  int64_t idle_ms;
+
+  /* Large transfers may take a while, only give up on those that stopped
+   * making progress.
+   */
+  idle_ms = (g_get_monotonic_time () - request->last_progress_us) / 1000;
+  if (idle_ms < TRANSFER_TIMEOUT_MS)
+    {
+      arm_transfer_timeout (request, TRANSFER_TIMEOUT_MS - idle_ms);
+      return G_SOURCE_REMOVE;
+    }
 
   g_cancellable_cancel (request->cancellable);
   if (request->cancellable_signal_handler)
@@ -209,10 +259,27 @@ on_external_cancellable_cancelled (GCancellable    *external_cancellable,
   g_clear_pointer (&request->timeout_source, g_source_unref);
 }
 
+static void
+arm_transfer_timeout (TransferRequest *request,
+                      int64_t          timeout_ms)
+{
+  if (request->timeout_source)
+    {
+      g_source_destroy (request->timeout_source);
+      g_source_unref (request->timeout_source);
+    }
+
+  request->timeout_source = g_timeout_source_new (timeout_ms);
+  g_source_set_callback (request->timeout_source, cancel_transfer_request,
+                         request, NULL);
+  g_source_attach (request->timeout_source, NULL);
+}
+
 static TransferRequest *
 transfer_request_new (GOutputStream     *ostream,
                       MetaSelectionType  selection_type,
                       ssize_t            len,
+                      size_t             chunk_size,
                       GCancellable      *external_cancellable)
 {
   TransferRequest *request;
@@ -221,12 +288,12 @@ transfer_request_new (GOutputStream     *ostream,
   request->ostream = g_object_ref (ostream);
   request->selection_type = selection_type;
   request->len = len;
+  request->eof = len == 0;
+  request->chunk_size = chunk_size;
   request->cancellable = g_cancellable_new ();
-  request->timeout_source = g_timeout_source_new_seconds (15);
+  request->last_progress_us = g_get_monotonic_time ();
 
-  g_source_set_callback (request->timeout_source, cancel_transfer_request,
-                         request, NULL);
-  g_source_attach (request->timeout_source, NULL);
+  arm_transfer_timeout (request, TRANSFER_TIMEOUT_MS);
 
   if (external_cancellable)
     {
@@ -243,6 +310,8 @@ transfer_request_new (GOutputStream     *ostream,
 static void
 transfer_request_free (TransferRequest *request)
 {
+  int i;
+
   if (request->cancellable_signal_handler)
     {
       g_assert (request->external_cancellable);
@@ -258,6 +327,16 @@ transfer_request_free (TransferRequest *request)
       g_clear_pointer (&request->timeout_source, g_source_unref);
     }
 
+  if (request->send_file_source)
+    {
+      g_source_destroy (request->send_file_source);
+      g_clear_pointer (&request->send_file_source, g_source_unref);
+    }
+
+  for (i = 0; i < N_TRANSFER_BUFFERS; i++)
+    g_free (request->buffers[i].data);
+
+  g_clear_error (&request->error);
   g_clear_object (&request->cancellable);
   g_clear_object (&request->istream);
   g_clear_object (&request->ostream);
@@ -265,108 +344,324 @@ transfer_request_free (TransferRequest *request)
 }
 
 static void
-splice_cb (GOutputStream *stream,
-           GAsyncResult  *result,
-           GTask         *task)
+transfer_set_error (TransferRequest *request,
+                    GError          *error)
 {
-  GError *error = NULL;
+  if (!request->error)
+    request->error = error;
+  else
+    g_error_free (error);
+}
 
-  g_output_stream_splice_finish (stream, result, &error);
-  if (error)
-    {
-      g_task_return_error (task, error);
-      g_object_unref (task);
-      return;
-    }
+static void
+transfer_return (GTask *task)
+{
+  TransferRequest *request = g_task_get_task_data (task);
+
+  if (request->error)
+    g_task_return_error (task, g_steal_pointer (&request->error));
+  else
+    g_task_return_boolean (task, TRUE);
 
-  g_task_return_boolean (task, TRUE);
   g_object_unref (task);
 }
 
 static void
-write_cb (GOutputStream *stream,
+close_cb (GOutputStream *stream,
           GAsyncResult  *result,
           GTask         *task)
 {
-  TransferRequest *request;
+  TransferRequest *request = g_task_get_task_data (task);
   GError *error = NULL;
 
-  g_output_stream_write_bytes_finish (stream, result, &error);
-  if (error)
+  if (!g_output_stream_close_finish (stream, result, &error))
+    transfer_set_error (request, error);
+
+  transfer_return (task);
+}
+
+static void
+transfer_close (GTask *task)
+{
+  TransferRequest *request = g_task_get_task_data (task);
+
+  if (request->close_streams)
     {
-      g_task_return_error (task, error);
-      g_object_unref (task);
+      g_input_stream_close (request->istream, NULL, NULL);
+      g_output_stream_close_async (request->ostream,
+                                   G_PRIORITY_DEFAULT,
+                                   NULL,
+                                   (GAsyncReadyCallback) close_cb,
+                                   task);
+    }
+  else
+    {
+      transfer_return (task);
+    }
+}
+
+static void
+transfer_finish (GTask *task)
+{
+  TransferRequest *request = g_task_get_task_data (task);
+
+  request->finished = TRUE;
+
+  /* Streams can't be closed while an operation on them is outstanding,
+   * so cancel it and close them once it came back.
+   */
+  if (request->reading || request->writing)
+    {
+      g_cancellable_cancel (request->cancellable);
       return;
     }
 
-  request = g_task_get_task_data (task);
+  transfer_close (task);
+}
 
-  if (request->len > 0)
+static void
+transfer_continue (GTask *task)
+{
+  TransferRequest *request = g_task_get_task_data (task);
+
+  if (!request->finished)
+    transfer_pump (task);
+  else if (!request->reading && !request->writing)
+    transfer_close (task);
+}
+
+static void
+transfer_write_cb (GOutputStream *stream,
+                   GAsyncResult  *result,
+                   GTask         *task)
+{
+  TransferRequest *request = g_task_get_task_data (task);
+  GError *error = NULL;
+
+  request->writing = FALSE;
+
+  if (g_output_stream_write_all_finish (stream, result, NULL, &error))
     {
-      read_selection_source_async (task, request);
+      request->buffers[request->write_index].size = 0;
+      request->write_index = (request->write_index + 1) % N_TRANSFER_BUFFERS;
+      request->n_filled--;
+      request->last_progress_us = g_get_monotonic_time ();
     }
   else
     {
-      g_task_return_boolean (task, TRUE);
-      g_object_unref (task);
+      transfer_set_error (request, error);
     }
+
+  transfer_continue (task);
+
+  g_object_unref (task);
 }
 
 static void
-read_cb (GInputStream *stream,
-         GAsyncResult *result,
-         GTask        *task)
+transfer_read_cb (GInputStream *stream,
+                  GAsyncResult *result,
+                  GTask        *task)
 {
-  TransferRequest *request;
+  TransferRequest *request = g_task_get_task_data (task);
   GError *error = NULL;
-  GBytes *bytes;
+  gssize n_read;
+
+  request->reading = FALSE;
 
-  bytes = g_input_stream_read_bytes_finish (stream, result, &error);
-  if (error)
+  n_read = g_input_stream_read_finish (stream, result, &error);
+  if (n_read < 0)
     {
-      g_task_return_error (task, error);
-      g_object_unref (task);
-      return;
+      transfer_set_error (request, error);
     }
-  else if (g_bytes_get_size (bytes) == 0)
+  else if (n_read == 0)
     {
-      g_task_return_boolean (task, TRUE);
-      g_object_unref (task);
+      request->eof = TRUE;
+    }
+  else
+    {
+      request->buffers[request->read_index].size = n_read;
+      request->read_index = (request->read_index + 1) % N_TRANSFER_BUFFERS;
+      request->n_filled++;
+
+      if (request->len > 0)
+        {
+          request->len -= n_read;
+          request->eof = request->len == 0;
+        }
+    }
+
+  transfer_continue (task);
+
+  g_object_unref (task);
+}
+
+static void
+transfer_pump (GTask *task)
+{
+  TransferRequest *request = g_task_get_task_data (task);
+
+  if (request->error)
+    {
+      transfer_finish (task);
       return;
     }
 
-  request = g_task_get_task_data (task);
+  if (!request->writing && request->n_filled > 0)
+    {
+      TransferBuffer *buffer = &request->buffers[request->write_index];
+
+      request->writing = TRUE;
+      g_output_stream_write_all_async (request->ostream,
+                                       buffer->data,
+                                       buffer->size,
+                                       G_PRIORITY_DEFAULT,
+                                       request->cancellable,
+                                       (GAsyncReadyCallback) transfer_write_cb,
+                                       g_object_ref (task));
+    }
 
-  if (request->len < g_bytes_get_size (bytes))
+  if (!request->reading && !request->eof &&
+      request->n_filled < N_TRANSFER_BUFFERS)
     {
-      GBytes *copy;
+      TransferBuffer *buffer = &request->buffers[request->read_index];
+      size_t count;
+
+      if (!buffer->data)
+        buffer->data = g_malloc (request->chunk_size);
+
+      count = request->chunk_size;
+      if (request->len > 0)
+        count = MIN (count, (size_t) request->len);
+
+      request->reading = TRUE;
+      g_input_stream_read_async (request->istream,
+                                 buffer->data,
+                                 count,
+                                 G_PRIORITY_DEFAULT,
+                                 request->cancellable,
+                                 (GAsyncReadyCallback) transfer_read_cb,
+                                 g_object_ref (task));
+    }
 
-      /* Trim content */
-      copy = g_bytes_new_from_bytes (bytes, 0, request->len);
-      g_bytes_unref (bytes);
-      bytes = copy;
+  if (request->eof && request->n_filled == 0 &&
+      !request->reading && !request->writing)
+    transfer_finish (task);
+}
+
+static int
+get_stream_fd (gpointer stream)
+{
+  if (!G_IS_FILE_DESCRIPTOR_BASED (stream))
+    return -1;
+
+  return g_file_descriptor_based_get_fd (G_FILE_DESCRIPTOR_BASED (stream));
+}
+
+static gboolean
+can_send_file (TransferRequest *request)
+{
+  struct stat stat_buf;
+  int fd;
+
+  if (get_stream_fd (request->ostream) < 0)
+    return FALSE;
+
+  /* sendfile() reads from files it can map, such as the anonymous files
+   * of memory selection sources, but not from pipes.
+   */
+  fd = get_stream_fd (request->istream);
+  if (fd < 0 || fstat (fd, &stat_buf) != 0)
+    return FALSE;
+
+  return S_ISREG (stat_buf.st_mode);
+}
+
+static gboolean
+send_file_cb (int           fd,
+              GIOCondition  condition,
+              GTask        *task)
+{
+  TransferRequest *request = g_task_get_task_data (task);
+  GError *error = NULL;
+  size_t count;
+  ssize_t sent;
+
+  if (g_cancellable_set_error_if_cancelled (request->cancellable, &error))
+    {
+      transfer_set_error (request, error);
+      transfer_finish (task);
+      return G_SOURCE_REMOVE;
     }
 
-  request->len -= g_bytes_get_size (bytes);
-  g_output_stream_write_bytes_async (request->ostream,
-                                     bytes,
-                                     G_PRIORITY_DEFAULT,
-                                     g_task_get_cancellable (task),
-                                     (GAsyncReadyCallback) write_cb,
-                                     task);
-  g_bytes_unref (bytes);
+  if (request->len < 0)
+    count = SEND_FILE_CHUNK_SIZE;
+  else
+    count = MIN (request->len, SEND_FILE_CHUNK_SIZE);
+
+  sent = sendfile (fd, get_stream_fd (request->istream), NULL, count);
+  if (sent < 0)
+    {
+      int errsv = errno;
+
+      if (errsv == EAGAIN || errsv == EINTR)
+        return G_SOURCE_CONTINUE;
+
+      transfer_set_error (request,
+                          g_error_new (G_IO_ERROR,
+                                       g_io_error_from_errno (errsv),
+                                       "Failed to send selection contents: %s",
+                                       g_strerror (errsv)));
+      transfer_finish (task);
+      return G_SOURCE_REMOVE;
+    }
+
+  if (sent == 0)
+    {
+      transfer_finish (task);
+      return G_SOURCE_REMOVE;
+    }
+
+  request->last_progress_us = g_get_monotonic_time ();
+
+  if (request->len > 0)
+    {
+      request->len -= sent;
+
+      if (request->len == 0)
+        {
+          transfer_finish (task);
+          return G_SOURCE_REMOVE;
+        }
+    }
+
+  return G_SOURCE_CONTINUE;
 }
 
 static void
-read_selection_source_async (GTask           *task,
-                             TransferRequest *request)
+send_file_async (GTask           *task,
+                 TransferRequest *request)
 {
-  g_input_stream_read_bytes_async (request->istream,
-                                   (gsize) request->len,
-                                   G_PRIORITY_DEFAULT,
-                                   g_task_get_cancellable (task),
-                                   (GAsyncReadyCallback) read_cb,
-                                   task);
+  g_autoptr (GSource) cancellable_source = NULL;
+  int fd;
+
+  /* Contents are handed from one file descriptor to the other within the
+   * kernel, a chunk at a time whenever the receiving end is ready for
+   * more.
+   */
+  fd = get_stream_fd (request->ostream);
+
+  request->send_file_source = g_unix_fd_source_new (fd, G_IO_OUT);
+  g_source_set_callback (request->send_file_source,
+                         (GSourceFunc) send_file_cb,
+                         task, NULL);
+  g_source_set_static_name (request->send_file_source,
+                            "[mutter] Selection transfer");
+
+  cancellable_source = g_cancellable_source_new (request->cancellable);
+  g_source_set_dummy_callback (cancellable_source);
+  g_source_add_child_source (request->send_file_source, cancellable_source);
+
+  g_source_attach (request->send_file_source, NULL);
 }
 
 static void
@@ -377,6 +672,7 @@ source_read_cb (MetaSelectionSource *source,
   TransferRequest *request;
   GInputStream *stream;
   GError *error = NULL;
+  int fd;
 
   stream = meta_selection_source_read_finish (source, result, &error);
   if (!stream)
@@ -389,21 +685,20 @@ source_read_cb (MetaSelectionSource *source,
   request = g_task_get_task_data (task);
   request->istream = stream;
 
-  if (request->len < 0)
-    {
-      g_output_stream_splice_async (request->ostream,
-                                    request->istream,
-                                    G_OUTPUT_STREAM_SPLICE_CLOSE_SOURCE |
-                                    G_OUTPUT_STREAM_SPLICE_CLOSE_TARGET,
-                                    G_PRIORITY_DEFAULT,
-                                    g_task_get_cancellable (task),
-                                    (GAsyncReadyCallback) splice_cb,
-                                    task);
-    }
+  /* Transfers of unknown size end with the contents, and the receiving
+   * end only finds out once the stream is closed.
+   */
+  request->close_streams = request->len < 0;
+
+  /* Never block on a receiver that is slow to take the contents */
+  fd = get_stream_fd (request->ostream);
+  if (fd >= 0)
+    g_unix_set_fd_nonblocking (fd, TRUE, NULL);
+
+  if (can_send_file (request))
+    send_file_async (task, request);
   else
-    {
-      read_selection_source_async (task, request);
-    }
+    transfer_pump (task);
 }
 
 /**
@@ -449,6 +744,7 @@ meta_selection_transfer_async (MetaSelection        *selection,
     }
 
   transfer_request = transfer_request_new (output, selection_type, size,
+                                           selection->transfer_chunk_size,
                                            cancellable);
 
   g_task_set_task_data (task, transfer_request,
@@ -497,3 +793,13 @@ meta_selection_get_display (MetaSelection *selection)
 {
   return selection->display;
 }
+
+void
+meta_selection_set_transfer_chunk_size (MetaSelection *selection,
+                                        size_t         chunk_size)
+{
+  g_return_if_fail (META_IS_SELECTION (selection));
+  g_return_if_fail (chunk_size > 0);
+
+  selection->transfer_chunk_size = chunk_size;
+}
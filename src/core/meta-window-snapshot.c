@@ -0,0 +1,400 @@
+/*
+ * Copyright (C) 2026 Red Hat Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * A compact description of the state of all managed windows, kept in
+ * memory shared with other processes, so that monitoring tools can read it
+ * whenever they like, without a round-trip to the compositor. It is only
+ * rewritten, from an idle later, when something it describes has changed,
+ * so it causes no wakeups of its own.
+ */
+
+#include "config.h"
+
+#include "core/meta-window-snapshot.h"
+
+#include <errno.h>
+#include <gio/gio.h>
+#include <string.h>
+
+#include "cogl/cogl.h"
+#include "compositor/meta-window-actor-private.h"
+#include "core/display-private.h"
+#include "core/stack.h"
+#include "core/util-private.h"
+#include "core/window-private.h"
+#include "meta/compositor.h"
+#include "meta/meta-later.h"
+#include "meta/workspace.h"
+#include "mtk/mtk.h"
+
+#define MIN_ENTRIES 64
+
+struct _MetaWindowSnapshot
+{
+  GObject parent;
+
+  MetaDisplay *display;
+
+  MtkAnonymousFile *file;
+  uint32_t max_entries;
+
+  GArray *entries;
+
+  unsigned int update_later_id;
+};
+
+G_DEFINE_FINAL_TYPE (MetaWindowSnapshot, meta_window_snapshot, G_TYPE_OBJECT)
+
+static MetaWindowSnapshotHeader *
+get_header (MtkAnonymousFile *file)
+{
+  return mtk_anonymous_file_get_data (file);
+}
+
+static MetaWindowSnapshotEntry *
+get_entries (MtkAnonymousFile *file)
+{
+  return (MetaWindowSnapshotEntry *) (get_header (file) + 1);
+}
+
+static void
+begin_write (MetaWindowSnapshotHeader *header)
+{
+  g_atomic_int_set ((int *) &header->sequence, header->sequence + 1);
+
+  /* Readers must not see any of the following writes without also seeing
+   * the odd sequence number */
+  __atomic_thread_fence (__ATOMIC_RELEASE);
+}
+
+static void
+end_write (MetaWindowSnapshotHeader *header)
+{
+  g_atomic_int_set ((int *) &header->sequence, header->sequence + 1);
+}
+
+static void
+mark_stale (MtkAnonymousFile *file)
+{
+  MetaWindowSnapshotHeader *header = get_header (file);
+
+  begin_write (header);
+  header->flags |= META_WINDOW_SNAPSHOT_HEADER_FLAG_STALE;
+  end_write (header);
+}
+
+static gboolean
+ensure_file (MetaWindowSnapshot  *snapshot,
+             uint32_t             n_entries,
+             GError             **error)
+{
+  g_autoptr (MtkAnonymousFile) file = NULL;
+  MetaWindowSnapshotHeader *header;
+  uint32_t max_entries;
+
+  if (snapshot->file && n_entries <= snapshot->max_entries)
+    return TRUE;
+
+  max_entries = MAX (snapshot->max_entries, MIN_ENTRIES);
+  while (max_entries < n_entries)
+    max_entries *= 2;
+
+  file = mtk_anonymous_file_new_mapped ("window-snapshot",
+                                        sizeof (MetaWindowSnapshotHeader) +
+                                        max_entries *
+                                        sizeof (MetaWindowSnapshotEntry));
+  if (!file)
+    {
+      int errsv = errno;
+
+      g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+                   "Failed to create window snapshot: %s",
+                   g_strerror (errsv));
+      return FALSE;
+    }
+
+  header = get_header (file);
+  header->magic = META_WINDOW_SNAPSHOT_MAGIC;
+  header->version = META_WINDOW_SNAPSHOT_VERSION;
+  header->header_size = sizeof (MetaWindowSnapshotHeader);
+  header->entry_size = sizeof (MetaWindowSnapshotEntry);
+  header->max_entries = max_entries;
+
+  /* Readers of the old file need to ask for the new one */
+  if (snapshot->file)
+    mark_stale (snapshot->file);
+
+  g_clear_pointer (&snapshot->file, mtk_anonymous_file_free);
+  snapshot->file = g_steal_pointer (&file);
+  snapshot->max_entries = max_entries;
+
+  return TRUE;
+}
+
+static void
+fill_entry (MetaWindowSnapshotEntry *entry,
+            MetaWindow              *window,
+            uint32_t                 stacking_index)
+{
+  MetaWindowActor *window_actor;
+  MetaWorkspace *workspace;
+  MtkRectangle frame_rect;
+  MetaMaximizeFlags maximize_flags;
+
+  meta_window_get_frame_rect (window, &frame_rect);
+  workspace = meta_window_get_workspace (window);
+  maximize_flags = meta_window_get_maximize_flags (window);
+
+  entry->id = meta_window_get_id (window);
+  entry->pid = MAX (meta_window_get_pid (window), 0);
+  entry->workspace = workspace && !meta_window_is_on_all_workspaces (window) ?
+                     meta_workspace_index (workspace) : -1;
+  entry->x = frame_rect.x;
+  entry->y = frame_rect.y;
+  entry->width = frame_rect.width;
+  entry->height = frame_rect.height;
+  entry->stacking_index = stacking_index;
+
+  if (meta_window_appears_focused (window))
+    entry->flags |= META_WINDOW_SNAPSHOT_FLAG_FOCUSED;
+  if (meta_window_is_hidden (window))
+    entry->flags |= META_WINDOW_SNAPSHOT_FLAG_HIDDEN;
+  if (window->minimized)
+    entry->flags |= META_WINDOW_SNAPSHOT_FLAG_MINIMIZED;
+  if (maximize_flags & META_MAXIMIZE_HORIZONTAL)
+    entry->flags |= META_WINDOW_SNAPSHOT_FLAG_MAXIMIZED_HORIZONTALLY;
+  if (maximize_flags & META_MAXIMIZE_VERTICAL)
+    entry->flags |= META_WINDOW_SNAPSHOT_FLAG_MAXIMIZED_VERTICALLY;
+  if (meta_window_is_fullscreen (window))
+    entry->flags |= META_WINDOW_SNAPSHOT_FLAG_FULLSCREEN;
+  if (meta_window_is_on_all_workspaces (window))
+    entry->flags |= META_WINDOW_SNAPSHOT_FLAG_ON_ALL_WORKSPACES;
+  if (meta_window_get_client_type (window) == META_WINDOW_CLIENT_TYPE_X11)
+    entry->flags |= META_WINDOW_SNAPSHOT_FLAG_X11;
+
+  window_actor = meta_window_actor_from_window (window);
+  if (window_actor)
+    {
+      meta_window_actor_get_frame_timing (window_actor,
+                                          &entry->last_frame_time_us,
+                                          &entry->n_frames);
+    }
+}
+
+static gboolean
+update_snapshot (MetaWindowSnapshot  *snapshot,
+                 GError             **error)
+{
+  MetaDisplay *display = snapshot->display;
+  g_autoptr (GList) windows = NULL;
+  MetaWindowSnapshotHeader *header;
+  MetaWindowSnapshotEntry *entries;
+  size_t entries_size;
+  GList *l;
+  uint32_t i;
+
+  COGL_TRACE_BEGIN_SCOPED (UpdateWindowSnapshot,
+                           "Meta::WindowSnapshot::update()");
+
+  g_array_set_size (snapshot->entries, 0);
+
+  windows = meta_stack_list_windows (display->stack, NULL);
+  for (l = windows, i = 0; l; l = l->next, i++)
+    {
+      MetaWindowSnapshotEntry entry = { 0 };
+
+      fill_entry (&entry, l->data, i);
+      g_array_append_val (snapshot->entries, entry);
+    }
+
+  if (!ensure_file (snapshot, snapshot->entries->len, error))
+    return FALSE;
+
+  header = get_header (snapshot->file);
+  entries = get_entries (snapshot->file);
+  entries_size = snapshot->entries->len * sizeof (MetaWindowSnapshotEntry);
+
+  /* Readers only see the sequence change when something actually did */
+  if (header->n_entries == snapshot->entries->len &&
+      memcmp (entries, snapshot->entries->data, entries_size) == 0)
+    return TRUE;
+
+  begin_write (header);
+  memcpy (entries, snapshot->entries->data, entries_size);
+  header->n_entries = snapshot->entries->len;
+  header->update_time_us = g_get_monotonic_time ();
+  end_write (header);
+
+  meta_topic (META_DEBUG_WINDOW_STATE,
+              "Updated window snapshot with %u windows, sequence %u",
+              header->n_entries, header->sequence);
+
+  return TRUE;
+}
+
+static gboolean
+update_later_cb (gpointer user_data)
+{
+  MetaWindowSnapshot *snapshot = user_data;
+  g_autoptr (GError) error = NULL;
+
+  snapshot->update_later_id = 0;
+
+  if (!update_snapshot (snapshot, &error))
+    g_warning ("Failed to update window snapshot: %s", error->message);
+
+  return G_SOURCE_REMOVE;
+}
+
+void
+meta_window_snapshot_queue_update (MetaWindowSnapshot *snapshot)
+{
+  MetaLaters *laters;
+
+  if (snapshot->update_later_id)
+    return;
+
+  laters = meta_compositor_get_laters (snapshot->display->compositor);
+  snapshot->update_later_id = meta_laters_add (laters, META_LATER_IDLE,
+                                               update_later_cb,
+                                               snapshot, NULL);
+}
+
+static void
+connect_window (MetaWindowSnapshot *snapshot,
+                MetaWindow         *window)
+{
+  const char * const signals[] = {
+    "position-changed",
+    "size-changed",
+    "workspace-changed",
+    "shown",
+    "notify::minimized",
+    "notify::maximized-horizontally",
+    "notify::maximized-vertically",
+    "notify::fullscreen",
+    "notify::appears-focused",
+    "notify::on-all-workspaces",
+  };
+  int i;
+
+  for (i = 0; i < G_N_ELEMENTS (signals); i++)
+    {
+      g_signal_connect_object (window, signals[i],
+                               G_CALLBACK (meta_window_snapshot_queue_update),
+                               snapshot,
+                               G_CONNECT_SWAPPED);
+    }
+}
+
+static void
+on_window_created (MetaDisplay        *display,
+                   MetaWindow         *window,
+                   MetaWindowSnapshot *snapshot)
+{
+  connect_window (snapshot, window);
+  meta_window_snapshot_queue_update (snapshot);
+}
+
+static void
+meta_window_snapshot_dispose (GObject *object)
+{
+  MetaWindowSnapshot *snapshot = META_WINDOW_SNAPSHOT (object);
+
+  if (snapshot->update_later_id)
+    {
+      MetaLaters *laters =
+        meta_compositor_get_laters (snapshot->display->compositor);
+
+      meta_laters_remove (laters, snapshot->update_later_id);
+      snapshot->update_later_id = 0;
+    }
+
+  if (snapshot->file)
+    mark_stale (snapshot->file);
+  g_clear_pointer (&snapshot->file, mtk_anonymous_file_free);
+  g_clear_pointer (&snapshot->entries, g_array_unref);
+
+  G_OBJECT_CLASS (meta_window_snapshot_parent_class)->dispose (object);
+}
+
+static void
+meta_window_snapshot_class_init (MetaWindowSnapshotClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->dispose = meta_window_snapshot_dispose;
+}
+
+static void
+meta_window_snapshot_init (MetaWindowSnapshot *snapshot)
+{
+  snapshot->entries = g_array_new (FALSE, TRUE,
+                                   sizeof (MetaWindowSnapshotEntry));
+}
+
+MetaWindowSnapshot *
+meta_window_snapshot_new (MetaDisplay *display)
+{
+  MetaWindowSnapshot *snapshot;
+  g_autoptr (GSList) windows = NULL;
+  GSList *l;
+
+  snapshot = g_object_new (META_TYPE_WINDOW_SNAPSHOT, NULL);
+  snapshot->display = display;
+
+  g_signal_connect_object (display->stack, "changed",
+                           G_CALLBACK (meta_window_snapshot_queue_update),
+                           snapshot,
+                           G_CONNECT_SWAPPED);
+  g_signal_connect_object (display, "window-created",
+                           G_CALLBACK (on_window_created),
+                           snapshot,
+                           G_CONNECT_DEFAULT);
+
+  windows = meta_display_list_windows (display, META_LIST_DEFAULT);
+  for (l = windows; l; l = l->next)
+    connect_window (snapshot, l->data);
+
+  return snapshot;
+}
+
+/* Returns a read-only file descriptor of the memory the snapshot is kept
+ * in, to be closed with close() */
+int
+meta_window_snapshot_open_fd (MetaWindowSnapshot  *snapshot,
+                              GError             **error)
+{
+  int fd;
+
+  if (!snapshot->file && !update_snapshot (snapshot, error))
+    return -1;
+
+  fd = mtk_anonymous_file_open_read_fd (snapshot->file);
+  if (fd < 0)
+    {
+      int errsv = errno;
+
+      g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+                   "Failed to open window snapshot: %s",
+                   g_strerror (errsv));
+      return -1;
+    }
+
+  return fd;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2026 Red Hat Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <glib-object.h>
+#include <stdint.h>
+
+#include "meta/display.h"
+
+/*
+ * The layout of the window snapshot, as read by other processes. It starts
+ * with a header, followed by max_entries entries of entry_size bytes, of
+ * which the first n_entries are valid, bottom-most window first. All
+ * fields are in native byte order.
+ *
+ * The sequence is odd while the snapshot is being updated. Readers copy
+ * what they need, and retry if the sequence was odd, or changed while
+ * copying. Once the stale flag is set, the file is not updated anymore,
+ * and a new one is to be requested.
+ */
+#define META_WINDOW_SNAPSHOT_MAGIC 0x5353574d /* "MWSS" */
+#define META_WINDOW_SNAPSHOT_VERSION 1
+
+typedef enum _MetaWindowSnapshotHeaderFlags
+{
+  META_WINDOW_SNAPSHOT_HEADER_FLAG_STALE = 1 << 0,
+} MetaWindowSnapshotHeaderFlags;
+
+typedef struct _MetaWindowSnapshotHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t header_size;
+  uint32_t entry_size;
+  uint32_t max_entries;
+  uint32_t n_entries;
+  uint32_t sequence;
+  uint32_t flags;
+  int64_t update_time_us;
+} MetaWindowSnapshotHeader;
+
+typedef enum _MetaWindowSnapshotFlags
+{
+  META_WINDOW_SNAPSHOT_FLAG_FOCUSED = 1 << 0,
+  META_WINDOW_SNAPSHOT_FLAG_HIDDEN = 1 << 1,
+  META_WINDOW_SNAPSHOT_FLAG_MINIMIZED = 1 << 2,
+  META_WINDOW_SNAPSHOT_FLAG_MAXIMIZED_HORIZONTALLY = 1 << 3,
+  META_WINDOW_SNAPSHOT_FLAG_MAXIMIZED_VERTICALLY = 1 << 4,
+  META_WINDOW_SNAPSHOT_FLAG_FULLSCREEN = 1 << 5,
+  META_WINDOW_SNAPSHOT_FLAG_ON_ALL_WORKSPACES = 1 << 6,
+  META_WINDOW_SNAPSHOT_FLAG_X11 = 1 << 7,
+} MetaWindowSnapshotFlags;
+
+typedef struct _MetaWindowSnapshotEntry
+{
+  uint64_t id;
+  uint32_t pid;
+  int32_t workspace;
+  int32_t x;
+  int32_t y;
+  int32_t width;
+  int32_t height;
+  uint32_t stacking_index;
+  uint32_t flags;
+  int64_t last_frame_time_us;
+  uint64_t n_frames;
+} MetaWindowSnapshotEntry;
+
+#define META_TYPE_WINDOW_SNAPSHOT (meta_window_snapshot_get_type ())
+G_DECLARE_FINAL_TYPE (MetaWindowSnapshot, meta_window_snapshot,
+                      META, WINDOW_SNAPSHOT, GObject)
+
+MetaWindowSnapshot * meta_window_snapshot_new (MetaDisplay *display);
+
+void meta_window_snapshot_queue_update (MetaWindowSnapshot *snapshot);
+
+int meta_window_snapshot_open_fd (MetaWindowSnapshot  *snapshot,
+                                  GError             **error);
@@ -29,6 +29,16 @@
 #include "meta/types.h"
 #include "meta/meta-workspace-manager.h"
 
+/* How work areas were brought up to date, over all workspaces */
+typedef struct _MetaWorkAreaStats
+{
+  unsigned int n_screen_computed;
+  unsigned int n_screen_shared;
+  unsigned int n_monitors_computed;
+  unsigned int n_monitors_kept;
+  unsigned int n_monitors_shared;
+} MetaWorkAreaStats;
+
 struct _MetaWorkspaceManager
 {
   GObject parent;
@@ -43,6 +53,8 @@ struct _MetaWorkspaceManager
   MetaDisplayCorner starting_corner;
   guint vertical_workspaces : 1;
   guint workspace_layout_overridden : 1;
+
+  MetaWorkAreaStats work_area_stats;
 };
 
 MetaWorkspaceManager *meta_workspace_manager_new (MetaDisplay *display);
@@ -953,7 +953,7 @@ meta_workspace_manager_show_desktop (MetaWorkspaceManager *workspace_manager,
   /* Focus the most recently used META_WINDOW_DESKTOP window, if there is one;
    * see bug 159257.
    */
-  for (l = workspace_manager->active_workspace->mru_list; l; l = l->next)
+  for (l = workspace_manager->active_workspace->mru_list.head; l; l = l->next)
     {
       MetaWindow *w = l->data;
 
@@ -932,6 +932,169 @@ meta_stack_list_windows (MetaStack     *stack,
   return workspace_windows;
 }
 
+/* Comparing few windows is cheaper than walking the whole stack */
+#define MIN_STACK_WALK_FRACTION 8
+
+static int
+compare_sorted_window_position (gconstpointer a,
+                                gconstpointer b,
+                                gpointer      user_data)
+{
+  const MetaWindow *window_a = *(MetaWindow **) a;
+  const MetaWindow *window_b = *(MetaWindow **) b;
+
+  if (window_a->layer != window_b->layer)
+    return window_a->layer < window_b->layer ? -1 : 1;
+  else if (window_a->stack_position != window_b->stack_position)
+    return window_a->stack_position < window_b->stack_position ? -1 : 1;
+  else
+    return 0;
+}
+
+static unsigned int
+next_sort_serial (MetaStack *stack)
+{
+  stack->sort_serial++;
+
+  /* Windows start out with 0 */
+  if (stack->sort_serial == 0)
+    stack->sort_serial++;
+
+  return stack->sort_serial;
+}
+
+static gboolean
+mark_window_for_sorting (MetaWindow   *window,
+                         unsigned int  serial)
+{
+  /* Windows that aren't in the stack, or are there twice, can't be picked
+   * off the stack */
+  if (window->stack_position < 0 ||
+      window->stack_sort_serial == serial)
+    return FALSE;
+
+  window->stack_sort_serial = serial;
+
+  return TRUE;
+}
+
+static gboolean
+should_walk_stack (MetaStack *stack,
+                   int        n_windows)
+{
+  return n_windows * MIN_STACK_WALK_FRACTION >= stack->n_positions;
+}
+
+void
+meta_stack_sort_windows (MetaStack *stack,
+                         GList     *windows)
+{
+  gboolean can_walk_stack = TRUE;
+  unsigned int serial;
+  int n_windows = 0;
+  GList *last = NULL;
+  GList *l;
+
+  meta_stack_ensure_sorted (stack);
+
+  serial = next_sort_serial (stack);
+  for (l = windows; l; l = l->next)
+    {
+      if (!mark_window_for_sorting (l->data, serial))
+        can_walk_stack = FALSE;
+
+      n_windows++;
+      last = l;
+    }
+
+  if (n_windows < 2)
+    return;
+
+  if (!can_walk_stack || !should_walk_stack (stack, n_windows))
+    {
+      g_autofree MetaWindow **sorted = NULL;
+      int i;
+
+      sorted = g_new (MetaWindow *, n_windows);
+      for (l = windows, i = 0; l; l = l->next, i++)
+        sorted[i] = l->data;
+
+      g_sort_array (sorted, n_windows, sizeof (MetaWindow *),
+                    compare_sorted_window_position, NULL);
+
+      for (l = windows, i = 0; l; l = l->next, i++)
+        l->data = sorted[i];
+
+      return;
+    }
+
+  /* The stack is sorted top to bottom */
+  for (l = stack->sorted; l; l = l->next)
+    {
+      MetaWindow *window = l->data;
+
+      if (window->stack_sort_serial != serial)
+        continue;
+
+      last->data = window;
+      last = last->prev;
+    }
+}
+
+void
+meta_stack_sort_windows_slist (MetaStack *stack,
+                               GSList    *windows)
+{
+  gboolean can_walk_stack = TRUE;
+  unsigned int serial;
+  int n_windows = 0;
+  g_autofree MetaWindow **sorted = NULL;
+  GSList *l;
+  int i;
+
+  meta_stack_ensure_sorted (stack);
+
+  serial = next_sort_serial (stack);
+  for (l = windows; l; l = l->next)
+    {
+      if (!mark_window_for_sorting (l->data, serial))
+        can_walk_stack = FALSE;
+
+      n_windows++;
+    }
+
+  if (n_windows < 2)
+    return;
+
+  sorted = g_new (MetaWindow *, n_windows);
+
+  if (can_walk_stack && should_walk_stack (stack, n_windows))
+    {
+      GList *stacked;
+
+      /* The stack is sorted top to bottom */
+      i = n_windows;
+      for (stacked = stack->sorted; stacked; stacked = stacked->next)
+        {
+          MetaWindow *window = stacked->data;
+
+          if (window->stack_sort_serial == serial)
+            sorted[--i] = window;
+        }
+    }
+  else
+    {
+      for (l = windows, i = 0; l; l = l->next, i++)
+        sorted[i] = l->data;
+
+      g_sort_array (sorted, n_windows, sizeof (MetaWindow *),
+                    compare_sorted_window_position, NULL);
+    }
+
+  for (l = windows, i = 0; l; l = l->next, i++)
+    l->data = sorted[i];
+}
+
 void
 meta_window_set_stack_position_no_sync (MetaWindow *window,
                                         int         position)
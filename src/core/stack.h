@@ -95,6 +95,9 @@ struct _MetaStack
    * recalculated with respect to transiency (parent and child windows)?
    */
   unsigned int need_constrain : 1;
+
+  /** Used to mark the windows being sorted by meta_stack_sort_windows() */
+  unsigned int sort_serial;
 };
 
 #define META_TYPE_STACK (meta_stack_get_type ())
@@ -258,6 +261,23 @@ MetaWindow * meta_stack_get_below (MetaStack  *stack,
 GList * meta_stack_list_windows (MetaStack     *stack,
                                  MetaWorkspace *workspace);
 
+/**
+ * meta_stack_sort_windows:
+ * @stack: A #MetaStack
+ * @windows: A list of windows
+ *
+ * Sorts windows in stacking order, from bottom to top, honouring layers.
+ * Only the data of the list is rearranged, not its links. When many of
+ * the windows in the stack are passed, they are picked off the already
+ * sorted stack instead of being compared.
+ */
+void meta_stack_sort_windows (MetaStack *stack,
+                              GList     *windows);
+
+META_EXPORT_TEST
+void meta_stack_sort_windows_slist (MetaStack *stack,
+                                    GSList    *windows);
+
 /**
  * meta_window_set_stack_position:
  * @window: The window which is moving.
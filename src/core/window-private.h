@@ -361,6 +361,10 @@ struct _MetaWindow
   /* Managed by stack.c */
   MetaStackLayer layer;
   int stack_position; /* see comment in stack.h */
+  unsigned int stack_sort_serial;
+
+  /* Managed by display.c */
+  int registry_index;
 
   /* Managed by delete.c */
   MetaCloseDialog *close_dialog;
@@ -730,6 +734,7 @@ void meta_window_stack_just_below (MetaWindow *window,
 void meta_window_stack_just_above (MetaWindow *window,
                                    MetaWindow *above_this_one);
 
+META_EXPORT_TEST
 int meta_window_stack_position_compare (gconstpointer window_a,
                                         gconstpointer window_b);
 
@@ -744,6 +749,7 @@ gboolean meta_window_can_tile_side_by_side   (MetaWindow *window,
 
 void meta_window_compute_tile_match (MetaWindow *window);
 
+META_EXPORT_TEST
 gboolean meta_window_updates_are_frozen (MetaWindow *window);
 
 META_EXPORT_TEST
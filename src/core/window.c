@@ -1217,6 +1217,7 @@ meta_window_constructed (GObject *object)
 
   window->layer = META_LAYER_LAST; /* invalid value */
   window->stack_position = -1;
+  window->registry_index = -1;
   window->initial_workspace = 0; /* not used */
   window->initial_timestamp = 0; /* not used */
 
@@ -1261,6 +1262,8 @@ meta_window_constructed (GObject *object)
 
   window->id = meta_display_generate_window_id (display);
 
+  meta_display_register_window (display, window);
+
   meta_window_manage (window);
 
   if (window->initially_iconic)
@@ -1307,6 +1310,8 @@ meta_window_constructed (GObject *object)
           window->net_wm_user_time =
             meta_display_get_current_time_roundtrip (display);
         }
+
+      meta_display_window_user_time_changed (display, window);
     }
 
   window->attached = meta_window_should_attach_to_parent (window);
@@ -1512,6 +1517,8 @@ meta_window_unmanage (MetaWindow  *window,
   meta_topic (META_DEBUG_WINDOW_STATE, "Unmanaging %s", window->desc);
   window->unmanaging = TRUE;
 
+  meta_display_unregister_window (window->display, window);
+
   reset_pending_auto_maximize (window);
   g_clear_handle_id (&priv->suspend_timoeut_id, g_source_remove);
   g_clear_handle_id (&window->close_dialog_timeout_id, g_source_remove);
@@ -1636,7 +1643,7 @@ meta_window_unmanage (MetaWindow  *window,
       MetaWorkspace *workspace = tmp->data;
 
       g_assert (g_list_find (workspace->windows, window) == NULL);
-      g_assert (g_list_find (workspace->mru_list, window) == NULL);
+      g_assert (meta_workspace_get_mru_link (workspace, window) == NULL);
 
       tmp = tmp->next;
     }
@@ -4991,7 +4998,7 @@ meta_window_make_most_recent (MetaWindow    *window,
       MetaWorkspace *workspace = l->data;
       GList *self, *link;
 
-      self = g_list_find (workspace->mru_list, window);
+      self = meta_workspace_get_mru_link (workspace, window);
       if (!self)
         continue;
 
@@ -5001,8 +5008,7 @@ meta_window_make_most_recent (MetaWindow    *window,
        */
       if (workspace == target_workspace || window->on_all_workspaces_requested)
         {
-          workspace->mru_list = g_list_delete_link (workspace->mru_list, self);
-          workspace->mru_list = g_list_prepend (workspace->mru_list, window);
+          meta_workspace_mru_move_to_front (workspace, window);
           continue;
         }
 
@@ -5011,7 +5017,7 @@ meta_window_make_most_recent (MetaWindow    *window,
         continue;
 
       /* Otherwise move it before other sticky windows */
-      for (link = workspace->mru_list; link; link = link->next)
+      for (link = workspace->mru_list.head; link; link = link->next)
         {
           MetaWindow *mru_window = link->data;
 
@@ -5019,11 +5025,7 @@ meta_window_make_most_recent (MetaWindow    *window,
             break;
         }
 
-      if (link == self)
-        continue;
-
-      workspace->mru_list = g_list_delete_link (workspace->mru_list, self);
-      workspace->mru_list = g_list_insert_before (workspace->mru_list, link, window);
+      meta_workspace_mru_move_before (workspace, window, link);
     }
 }
 
@@ -5526,19 +5528,8 @@ lower_window_and_transients (MetaWindow *window,
           meta_window_located_on_workspace (window,
                                             workspace_manager->active_workspace))
         {
-          GList *link;
-          link = g_list_find (workspace_manager->active_workspace->mru_list,
-                              window);
-          g_assert (link);
-
-          workspace_manager->active_workspace->mru_list =
-            g_list_remove_link (workspace_manager->active_workspace->mru_list,
-                                link);
-          g_list_free (link);
-
-          workspace_manager->active_workspace->mru_list =
-            g_list_append (workspace_manager->active_workspace->mru_list,
-                           window);
+          meta_workspace_mru_move_to_back (workspace_manager->active_workspace,
+                                           window);
         }
     }
 
@@ -6484,40 +6475,37 @@ static void
 ensure_mru_position_after (MetaWindow *window,
                            MetaWindow *after_this_one)
 {
-  /* This is sort of slow since it runs through the entire list more
-   * than once (especially considering the fact that we expect the
-   * windows of interest to be the first two elements in the list),
-   * but it doesn't matter while we're only using it on new window
-   * map.
-   */
-
   MetaWorkspaceManager *workspace_manager = window->display->workspace_manager;
-  GList *active_mru_list;
+  MetaWorkspace *workspace = workspace_manager->active_workspace;
   GList *window_position;
   GList *after_this_one_position;
+  GList *l;
 
-  active_mru_list         = workspace_manager->active_workspace->mru_list;
-  window_position         = g_list_find (active_mru_list, window);
-  after_this_one_position = g_list_find (active_mru_list, after_this_one);
+  window_position = meta_workspace_get_mru_link (workspace, window);
+  after_this_one_position = meta_workspace_get_mru_link (workspace,
+                                                         after_this_one);
 
   /* after_this_one_position is NULL when we switch workspaces, but in
    * that case we don't need to do any MRU shuffling so we can simply
    * return.
    */
-  if (after_this_one_position == NULL)
+  if (window_position == NULL || after_this_one_position == NULL)
     return;
 
-  if (g_list_length (window_position) > g_list_length (after_this_one_position))
+  /* We expect the windows of interest to be close to the front of the
+   * list, so look for whichever of them comes first from there.
+   */
+  for (l = workspace->mru_list.head; l; l = l->next)
     {
-      workspace_manager->active_workspace->mru_list =
-        g_list_delete_link (workspace_manager->active_workspace->mru_list,
-                            window_position);
+      if (l == after_this_one_position)
+        return;
 
-      workspace_manager->active_workspace->mru_list =
-        g_list_insert_before (workspace_manager->active_workspace->mru_list,
-                              after_this_one_position->next,
-                              window);
+      if (l == window_position)
+        break;
     }
+
+  meta_workspace_mru_move_before (workspace, window,
+                                  after_this_one_position->next);
 }
 
 gboolean
@@ -6626,6 +6614,8 @@ meta_window_set_user_time (MetaWindow *window,
       if (XSERVER_TIME_IS_BEFORE (window->display->last_user_time, timestamp))
         window->display->last_user_time = timestamp;
 
+      meta_display_window_user_time_changed (window->display, window);
+
       g_object_notify_by_pspec (G_OBJECT (window), obj_props[PROP_USER_TIME]);
     }
 }
@@ -49,8 +49,12 @@ struct _MetaWorkspace
    * It used to be used to calculate the default focused window,
    * but isn't anymore, as the window next in the stacking order
    * can sometimes be not the window the user interacted with last,
+   *
+   * The links are looked up through mru_links, so that reordering the
+   * list on focus changes doesn't need to search it.
    */
-  GList *mru_list;
+  GQueue mru_list;
+  GHashTable *mru_links;
 
   GList  *list_containing_self;
 
@@ -81,6 +85,16 @@ void           meta_workspace_remove_window (MetaWorkspace *workspace,
 void           meta_workspace_relocate_windows (MetaWorkspace *workspace,
                                                 MetaWorkspace *new_home);
 
+GList * meta_workspace_get_mru_link (MetaWorkspace *workspace,
+                                     MetaWindow    *window);
+void meta_workspace_mru_move_before (MetaWorkspace *workspace,
+                                     MetaWindow    *window,
+                                     GList         *sibling);
+void meta_workspace_mru_move_to_front (MetaWorkspace *workspace,
+                                       MetaWindow    *window);
+void meta_workspace_mru_move_to_back (MetaWorkspace *workspace,
+                                      MetaWindow    *window);
+
 void meta_workspace_get_work_area_for_logical_monitor (MetaWorkspace      *workspace,
                                                        MetaLogicalMonitor *logical_monitor,
                                                        MtkRectangle       *area);
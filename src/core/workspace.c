@@ -81,6 +81,12 @@ static guint signals[LAST_SIGNAL] = { 0 };
 
 typedef struct _MetaWorkspaceLogicalMonitorData
 {
+  /* What the region and work area were computed from, so they can be kept
+   * when other monitors' struts change, and shared with other workspaces.
+   */
+  MtkRectangle logical_monitor_rect;
+  GSList *struts;
+
   GList *logical_monitor_region;
   MtkRectangle logical_monitor_work_area;
 } MetaWorkspaceLogicalMonitorData;
@@ -103,6 +109,7 @@ meta_workspace_get_logical_monitor_data (MetaWorkspace      *workspace,
 static void
 workspace_logical_monitor_data_free (MetaWorkspaceLogicalMonitorData *data)
 {
+  g_clear_slist (&data->struts, g_free);
   g_clear_pointer (&data->logical_monitor_region,
                    meta_rectangle_free_list_and_elements);
   g_free (data);
@@ -222,7 +229,8 @@ meta_workspace_new (MetaWorkspaceManager *workspace_manager)
   workspace_manager->workspaces =
     g_list_append (workspace_manager->workspaces, workspace);
   workspace->windows = NULL;
-  workspace->mru_list = NULL;
+  g_queue_init (&workspace->mru_list);
+  workspace->mru_links = g_hash_table_new (NULL, NULL);
 
   workspace->work_areas_invalid = TRUE;
   workspace->work_area_screen.x = 0;
@@ -307,7 +315,8 @@ meta_workspace_remove (MetaWorkspace *workspace)
 
   meta_workspace_clear_logical_monitor_data (workspace);
 
-  g_list_free (workspace->mru_list);
+  g_queue_clear (&workspace->mru_list);
+  g_clear_pointer (&workspace->mru_links, g_hash_table_destroy);
   g_list_free (workspace->list_containing_self);
 
   workspace_free_builtin_struts (workspace);
@@ -358,14 +367,16 @@ meta_workspace_add_window (MetaWorkspace *workspace,
 {
   MetaWorkspaceManager *workspace_manager;
 
-  g_return_if_fail (g_list_find (workspace->mru_list, window) == NULL);
+  g_return_if_fail (!g_hash_table_contains (workspace->mru_links, window));
 
   COGL_TRACE_BEGIN_SCOPED (MetaWorkspaceAddWindow,
                            "Meta::Workspace::add_window()");
 
   workspace_manager = workspace->display->workspace_manager;
 
-  workspace->mru_list = g_list_prepend (workspace->mru_list, window);
+  g_queue_push_head (&workspace->mru_list, window);
+  g_hash_table_insert (workspace->mru_links, window,
+                       workspace->mru_list.head);
 
   workspace->windows = g_list_prepend (workspace->windows, window);
 
@@ -389,14 +400,17 @@ meta_workspace_remove_window (MetaWorkspace *workspace,
                               MetaWindow    *window)
 {
   MetaWorkspaceManager *workspace_manager = workspace->display->workspace_manager;
+  GList *link;
 
   COGL_TRACE_BEGIN_SCOPED (MetaWorkspaceRemoveWindow,
                            "Meta::Workspace::remove_window()");
 
   workspace->windows = g_list_remove (workspace->windows, window);
 
-  workspace->mru_list = g_list_remove (workspace->mru_list, window);
-  g_assert (g_list_find (workspace->mru_list, window) == NULL);
+  link = g_hash_table_lookup (workspace->mru_links, window);
+  g_assert (link);
+  g_queue_delete_link (&workspace->mru_list, link);
+  g_hash_table_remove (workspace->mru_links, window);
 
   if (window->struts)
     {
@@ -437,6 +451,50 @@ meta_workspace_relocate_windows (MetaWorkspace *workspace,
   assert_workspace_empty (workspace);
 }
 
+GList *
+meta_workspace_get_mru_link (MetaWorkspace *workspace,
+                             MetaWindow    *window)
+{
+  return g_hash_table_lookup (workspace->mru_links, window);
+}
+
+/* Moves @window right before @sibling in the MRU list, or to the back of
+ * it if @sibling is %NULL. */
+void
+meta_workspace_mru_move_before (MetaWorkspace *workspace,
+                                MetaWindow    *window,
+                                GList         *sibling)
+{
+  GList *link;
+
+  link = meta_workspace_get_mru_link (workspace, window);
+  g_return_if_fail (link);
+
+  if (link == sibling)
+    return;
+
+  g_queue_unlink (&workspace->mru_list, link);
+
+  if (sibling)
+    g_queue_insert_before_link (&workspace->mru_list, sibling, link);
+  else
+    g_queue_push_tail_link (&workspace->mru_list, link);
+}
+
+void
+meta_workspace_mru_move_to_front (MetaWorkspace *workspace,
+                                  MetaWindow    *window)
+{
+  meta_workspace_mru_move_before (workspace, window, workspace->mru_list.head);
+}
+
+void
+meta_workspace_mru_move_to_back (MetaWorkspace *workspace,
+                                 MetaWindow    *window)
+{
+  meta_workspace_mru_move_before (workspace, window, NULL);
+}
+
 void
 meta_workspace_queue_calc_showing  (MetaWorkspace *workspace)
 {
@@ -806,8 +864,8 @@ meta_workspace_invalidate_work_area (MetaWorkspace *workspace)
       workspace == workspace->manager->active_workspace)
     meta_window_drag_update_edges (window_drag);
 
-  meta_workspace_clear_logical_monitor_data (workspace);
-
+  /* The per monitor data is kept around, for the monitors whose struts
+   * didn't change to keep using it */
   workspace_free_all_struts (workspace);
 
   meta_rectangle_free_list_and_elements (workspace->screen_region);
@@ -850,80 +908,228 @@ copy_strut_list(GSList *original)
   return g_slist_reverse (result);
 }
 
-static void
-ensure_work_areas_validated (MetaWorkspace *workspace)
+static GSList *
+copy_struts_overlapping (GSList             *struts,
+                         const MtkRectangle *rect)
 {
-  MetaContext *context = meta_display_get_context (workspace->display);
-  MetaBackend *backend = meta_context_get_backend (context);
-  MetaMonitorManager *monitor_manager =
-    meta_backend_get_monitor_manager (backend);
-  GList *windows;
-  GList *tmp;
-  GList *logical_monitors, *l;
-  MtkRectangle display_rect = { 0 };
-  MtkRectangle work_area;
+  GSList *result = NULL;
 
-  if (!workspace->work_areas_invalid)
-    return;
+  for (; struts != NULL; struts = struts->next)
+    {
+      MetaStrut *strut = struts->data;
 
-  g_assert (workspace->all_struts == NULL);
-  g_assert (workspace->screen_region == NULL);
-  g_assert (workspace->screen_edges == NULL);
-  g_assert (workspace->monitor_edges == NULL);
+      if (mtk_rectangle_overlap (&strut->rect, rect))
+        result = g_slist_prepend (result, copy_strut (strut));
+    }
 
-  meta_display_get_size (workspace->display,
-                         &display_rect.width,
-                         &display_rect.height);
+  return g_slist_reverse (result);
+}
 
-  /* STEP 1: Get the list of struts */
+static int
+compare_struts (gconstpointer a,
+                gconstpointer b)
+{
+  const MetaStrut *strut_a = a;
+  const MetaStrut *strut_b = b;
+
+  if (strut_a->side != strut_b->side)
+    return strut_a->side - strut_b->side;
+  if (strut_a->rect.x != strut_b->rect.x)
+    return strut_a->rect.x - strut_b->rect.x;
+  if (strut_a->rect.y != strut_b->rect.y)
+    return strut_a->rect.y - strut_b->rect.y;
+  if (strut_a->rect.width != strut_b->rect.width)
+    return strut_a->rect.width - strut_b->rect.width;
+
+  return strut_a->rect.height - strut_b->rect.height;
+}
 
-  workspace->all_struts = copy_strut_list (workspace->builtin_struts);
+static gboolean
+strut_lists_equal (GSList *l,
+                   GSList *m)
+{
+  for (; l && m; l = l->next, m = m->next)
+    {
+      MetaStrut *a = l->data;
+      MetaStrut *b = m->data;
 
-  windows = meta_workspace_list_windows (workspace);
-  for (tmp = windows; tmp != NULL; tmp = tmp->next)
+      if (a->side != b->side ||
+          !mtk_rectangle_equal (&a->rect, &b->rect))
+        return FALSE;
+    }
+
+  return l == NULL && m == NULL;
+}
+
+static MetaEdge *
+copy_edge (const MetaEdge *edge,
+           gpointer        user_data)
+{
+  return g_memdup2 (edge, sizeof (MetaEdge));
+}
+
+static GList *
+copy_rectangle_list (GList *list)
+{
+  return g_list_copy_deep (list, (GCopyFunc) mtk_rectangle_copy, NULL);
+}
+
+/* Finds another workspace that has its work areas computed from the same
+ * struts, which is the common case with docks and panels that are on all
+ * workspaces.
+ */
+static MetaWorkspace *
+find_workspace_with_same_struts (MetaWorkspace *workspace)
+{
+  GList *l;
+
+  for (l = workspace->manager->workspaces; l; l = l->next)
     {
-      MetaWindow *win = tmp->data;
-      GSList *s_iter;
+      MetaWorkspace *other = l->data;
 
-      for (s_iter = win->struts; s_iter != NULL; s_iter = s_iter->next) {
-        workspace->all_struts = g_slist_prepend (workspace->all_struts,
-                                                 copy_strut(s_iter->data));
-      }
+      if (other == workspace || other->work_areas_invalid)
+        continue;
+
+      if (strut_lists_equal (workspace->all_struts, other->all_struts))
+        return other;
     }
-  g_list_free (windows);
 
-  /* STEP 2: Get the maximal/spanning rects for the onscreen and
-   *         on-single-monitor regions
-   */
-  g_assert (workspace->screen_region   == NULL);
+  return NULL;
+}
 
-  logical_monitors =
-    meta_monitor_manager_get_logical_monitors (monitor_manager);
-  for (l = logical_monitors; l; l = l->next)
+static MetaWorkspaceLogicalMonitorData *
+find_shared_logical_monitor_data (MetaWorkspace                   *workspace,
+                                  MetaLogicalMonitor              *logical_monitor,
+                                  MetaWorkspaceLogicalMonitorData *data)
+{
+  GList *l;
+
+  for (l = workspace->manager->workspaces; l; l = l->next)
     {
-      MetaLogicalMonitor *logical_monitor = l->data;
-      MetaWorkspaceLogicalMonitorData *data;
+      MetaWorkspace *other = l->data;
+      MetaWorkspaceLogicalMonitorData *other_data;
+
+      if (other == workspace || other->work_areas_invalid)
+        continue;
 
-      g_assert (!meta_workspace_get_logical_monitor_data (workspace,
-                                                          logical_monitor));
+      other_data = meta_workspace_get_logical_monitor_data (other,
+                                                            logical_monitor);
+      if (other_data &&
+          mtk_rectangle_equal (&other_data->logical_monitor_rect,
+                               &data->logical_monitor_rect) &&
+          strut_lists_equal (other_data->struts, data->struts))
+        return other_data;
+    }
 
-      data = meta_workspace_ensure_logical_monitor_data (workspace,
-                                                         logical_monitor);
+  return NULL;
+}
+
+static gboolean
+take_logical_monitor_data (GHashTable                      *old_data,
+                           MetaWorkspaceLogicalMonitorData *data)
+{
+  GHashTableIter iter;
+  MetaWorkspaceLogicalMonitorData *old;
+
+  if (!old_data)
+    return FALSE;
+
+  /* Logical monitors are recreated when the monitor configuration changes,
+   * so match them by what the data was computed from */
+  g_hash_table_iter_init (&iter, old_data);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &old))
+    {
+      if (!mtk_rectangle_equal (&old->logical_monitor_rect,
+                                &data->logical_monitor_rect) ||
+          !strut_lists_equal (old->struts, data->struts))
+        continue;
+
+      data->logical_monitor_region =
+        g_steal_pointer (&old->logical_monitor_region);
+      data->logical_monitor_work_area = old->logical_monitor_work_area;
+      g_hash_table_iter_remove (&iter);
+
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
+static void
+update_logical_monitor_data (MetaWorkspace                   *workspace,
+                             GHashTable                      *old_data,
+                             MetaLogicalMonitor              *logical_monitor,
+                             MetaWorkspaceLogicalMonitorData *data)
+{
+  MetaWorkAreaStats *stats = &workspace->manager->work_area_stats;
+  MetaWorkspaceLogicalMonitorData *shared_data;
+  MtkRectangle work_area;
+
+  data->logical_monitor_rect = logical_monitor->rect;
+  data->struts = copy_struts_overlapping (workspace->all_struts,
+                                          &logical_monitor->rect);
+
+  if (take_logical_monitor_data (old_data, data))
+    {
+      stats->n_monitors_kept++;
+      return;
+    }
+
+  shared_data = find_shared_logical_monitor_data (workspace, logical_monitor,
+                                                  data);
+  if (shared_data)
+    {
       data->logical_monitor_region =
-        meta_rectangle_get_minimal_spanning_set_for_region (
-          &logical_monitor->rect,
-          workspace->all_struts);
+        copy_rectangle_list (shared_data->logical_monitor_region);
+      data->logical_monitor_work_area = shared_data->logical_monitor_work_area;
+      stats->n_monitors_shared++;
+      return;
     }
 
+  data->logical_monitor_region =
+    meta_rectangle_get_minimal_spanning_set_for_region (&logical_monitor->rect,
+                                                        data->struts);
+
+  work_area = logical_monitor->rect;
+  if (!data->logical_monitor_region)
+    /* FIXME: constraints.c untested with this, but it might be nice for
+     * a screen reader or magnifier.
+     */
+    work_area = MTK_RECTANGLE_INIT (work_area.x, work_area.y, -1, -1);
+  else
+    meta_rectangle_clip_to_region (data->logical_monitor_region,
+                                   FIXED_DIRECTION_NONE,
+                                   &work_area);
+
+  data->logical_monitor_work_area = work_area;
+  stats->n_monitors_computed++;
+
+  meta_topic (META_DEBUG_WORKAREA,
+              "Computed work area for workspace %d "
+              "monitor %d: %d,%d %d x %d",
+              meta_workspace_index (workspace),
+              logical_monitor->number,
+              data->logical_monitor_work_area.x,
+              data->logical_monitor_work_area.y,
+              data->logical_monitor_work_area.width,
+              data->logical_monitor_work_area.height);
+}
+
+static void
+compute_screen_work_area (MetaWorkspace *workspace,
+                          MtkRectangle  *display_rect,
+                          GList         *logical_monitors)
+{
+  MtkRectangle work_area;
+  GList *monitor_rects = NULL;
+  GList *l;
+
   workspace->screen_region =
     meta_rectangle_get_minimal_spanning_set_for_region (
-      &display_rect,
+      display_rect,
       workspace->all_struts);
 
-  /* STEP 3: Get the work areas (region-to-maximize-to) for the screen and
-   *         monitors.
-   */
-  work_area = display_rect;  /* start with the screen */
+  work_area = *display_rect;  /* start with the screen */
   if (workspace->screen_region == NULL)
     work_area = MTK_RECTANGLE_INIT (0, 0, -1, -1);
   else
@@ -934,14 +1140,14 @@ ensure_work_areas_validated (MetaWorkspace *workspace)
   /* Lots of paranoia checks, forcing work_area_screen to be sane */
 #define MIN_SANE_AREA 100
   if (work_area.width < MIN_SANE_AREA &&
-      work_area.width != display_rect.width)
+      work_area.width != display_rect->width)
     {
       g_warning ("struts occupy an unusually large percentage of the screen; "
                  "available remaining width = %d < %d",
                  work_area.width, MIN_SANE_AREA);
       if (work_area.width < 1)
         {
-          work_area.x = (display_rect.width - MIN_SANE_AREA)/2;
+          work_area.x = (display_rect->width - MIN_SANE_AREA)/2;
           work_area.width = MIN_SANE_AREA;
         }
       else
@@ -952,14 +1158,14 @@ ensure_work_areas_validated (MetaWorkspace *workspace)
         }
     }
   if (work_area.height < MIN_SANE_AREA &&
-      work_area.height != display_rect.height)
+      work_area.height != display_rect->height)
     {
       g_warning ("struts occupy an unusually large percentage of the screen; "
                  "available remaining height = %d < %d",
                  work_area.height, MIN_SANE_AREA);
       if (work_area.height < 1)
         {
-          work_area.y = (display_rect.height - MIN_SANE_AREA)/2;
+          work_area.y = (display_rect->height - MIN_SANE_AREA)/2;
           work_area.height = MIN_SANE_AREA;
         }
       else
@@ -978,42 +1184,7 @@ ensure_work_areas_validated (MetaWorkspace *workspace)
               workspace->work_area_screen.width,
               workspace->work_area_screen.height);
 
-  /* Now find the work areas for each monitor */
-  for (l = logical_monitors; l; l = l->next)
-    {
-      MetaLogicalMonitor *logical_monitor = l->data;
-      MetaWorkspaceLogicalMonitorData *data;
-
-      data = meta_workspace_get_logical_monitor_data (workspace,
-                                                      logical_monitor);
-      work_area = logical_monitor->rect;
-
-      if (!data->logical_monitor_region)
-        /* FIXME: constraints.c untested with this, but it might be nice for
-         * a screen reader or magnifier.
-         */
-        work_area = MTK_RECTANGLE_INIT (work_area.x, work_area.y, -1, -1);
-      else
-        meta_rectangle_clip_to_region (data->logical_monitor_region,
-                                       FIXED_DIRECTION_NONE,
-                                       &work_area);
-
-      data->logical_monitor_work_area = work_area;
-
-      meta_topic (META_DEBUG_WORKAREA,
-                  "Computed work area for workspace %d "
-                  "monitor %d: %d,%d %d x %d",
-                  meta_workspace_index (workspace),
-                  logical_monitor->number,
-                  data->logical_monitor_work_area.x,
-                  data->logical_monitor_work_area.y,
-                  data->logical_monitor_work_area.width,
-                  data->logical_monitor_work_area.height);
-    }
-
-  /* STEP 4: Make sure the screen_region is nonempty (separate from step 2
-   *         since it relies on step 3).
-   */
+  /* Make sure the screen_region is nonempty */
   if (workspace->screen_region == NULL)
     {
       MtkRectangle *nonempty_region;
@@ -1022,43 +1193,121 @@ ensure_work_areas_validated (MetaWorkspace *workspace)
       workspace->screen_region = g_list_prepend (NULL, nonempty_region);
     }
 
-  /* STEP 5: Cache screen and monitor edges for edge resistance and snapping */
-  g_assert (workspace->screen_edges    == NULL);
-  g_assert (workspace->monitor_edges  == NULL);
+  /* Cache screen and monitor edges for edge resistance and snapping */
   workspace->screen_edges =
-    meta_rectangle_find_onscreen_edges (&display_rect,
+    meta_rectangle_find_onscreen_edges (display_rect,
                                         workspace->all_struts);
-  tmp = NULL;
   for (l = logical_monitors; l; l = l->next)
     {
       MetaLogicalMonitor *logical_monitor = l->data;
 
-      tmp = g_list_prepend (tmp, &logical_monitor->rect);
+      monitor_rects = g_list_prepend (monitor_rects, &logical_monitor->rect);
     }
   workspace->monitor_edges =
-    meta_rectangle_find_nonintersected_monitor_edges (tmp,
+    meta_rectangle_find_nonintersected_monitor_edges (monitor_rects,
                                                        workspace->all_struts);
-  g_list_free (tmp);
-
-  /* We're all done, YAAY!  Record that everything has been validated. */
-  workspace->work_areas_invalid = FALSE;
+  g_list_free (monitor_rects);
 }
 
-static gboolean
-strut_lists_equal (GSList *l,
-                   GSList *m)
+static void
+ensure_work_areas_validated (MetaWorkspace *workspace)
 {
-  for (; l && m; l = l->next, m = m->next)
+  MetaContext *context = meta_display_get_context (workspace->display);
+  MetaBackend *backend = meta_context_get_backend (context);
+  MetaMonitorManager *monitor_manager =
+    meta_backend_get_monitor_manager (backend);
+  MetaWorkAreaStats *stats = &workspace->manager->work_area_stats;
+  MetaWorkspace *shared_workspace;
+  g_autoptr (GHashTable) old_data = NULL;
+  GList *windows;
+  GList *tmp;
+  GList *logical_monitors, *l;
+  MtkRectangle display_rect = { 0 };
+
+  if (!workspace->work_areas_invalid)
+    return;
+
+  g_assert (workspace->all_struts == NULL);
+  g_assert (workspace->screen_region == NULL);
+  g_assert (workspace->screen_edges == NULL);
+  g_assert (workspace->monitor_edges == NULL);
+
+  meta_display_get_size (workspace->display,
+                         &display_rect.width,
+                         &display_rect.height);
+
+  /* STEP 1: Get the list of struts, in an order that doesn't depend on the
+   *         order of windows, so that lists can be compared.
+   */
+
+  workspace->all_struts = copy_strut_list (workspace->builtin_struts);
+
+  windows = meta_workspace_list_windows (workspace);
+  for (tmp = windows; tmp != NULL; tmp = tmp->next)
     {
-      MetaStrut *a = l->data;
-      MetaStrut *b = m->data;
+      MetaWindow *win = tmp->data;
+      GSList *s_iter;
 
-      if (a->side != b->side ||
-          !mtk_rectangle_equal (&a->rect, &b->rect))
-        return FALSE;
+      for (s_iter = win->struts; s_iter != NULL; s_iter = s_iter->next) {
+        workspace->all_struts = g_slist_prepend (workspace->all_struts,
+                                                 copy_strut(s_iter->data));
+      }
     }
+  g_list_free (windows);
 
-  return l == NULL && m == NULL;
+  workspace->all_struts = g_slist_sort (workspace->all_struts, compare_struts);
+
+  /* STEP 2: Get the maximal/spanning rects and work areas for each monitor,
+   *         keeping those whose overlapping struts didn't change, or taking
+   *         them from another workspace with the same overlapping struts.
+   */
+  old_data = g_steal_pointer (&workspace->logical_monitor_data);
+
+  logical_monitors =
+    meta_monitor_manager_get_logical_monitors (monitor_manager);
+  for (l = logical_monitors; l; l = l->next)
+    {
+      MetaLogicalMonitor *logical_monitor = l->data;
+      MetaWorkspaceLogicalMonitorData *data;
+
+      data = meta_workspace_ensure_logical_monitor_data (workspace,
+                                                         logical_monitor);
+      update_logical_monitor_data (workspace, old_data,
+                                   logical_monitor, data);
+    }
+
+  /* STEP 3: Get the region, work area and edges of the whole screen. These
+   *         only depend on the struts and the monitor layout, and all
+   *         workspaces are invalidated when the layout changes, so those
+   *         of any valid workspace with the same struts can be used as is.
+   */
+  shared_workspace = find_workspace_with_same_struts (workspace);
+  if (shared_workspace)
+    {
+      workspace->screen_region =
+        copy_rectangle_list (shared_workspace->screen_region);
+      workspace->work_area_screen = shared_workspace->work_area_screen;
+      workspace->screen_edges =
+        g_list_copy_deep (shared_workspace->screen_edges,
+                          (GCopyFunc) copy_edge, NULL);
+      workspace->monitor_edges =
+        g_list_copy_deep (shared_workspace->monitor_edges,
+                          (GCopyFunc) copy_edge, NULL);
+      stats->n_screen_shared++;
+
+      meta_topic (META_DEBUG_WORKAREA,
+                  "Using work areas of workspace %d for workspace %d",
+                  meta_workspace_index (shared_workspace),
+                  meta_workspace_index (workspace));
+    }
+  else
+    {
+      compute_screen_work_area (workspace, &display_rect, logical_monitors);
+      stats->n_screen_computed++;
+    }
+
+  /* We're all done, YAAY!  Record that everything has been validated. */
+  workspace->work_areas_invalid = FALSE;
 }
 
 /**
@@ -1460,7 +1709,7 @@ meta_workspace_get_default_focus_candidates (MetaWorkspace *workspace)
   GList *l;
   GList *candidates = NULL;
 
-  for (l = workspace->mru_list; l; l = l->next)
+  for (l = workspace->mru_list.head; l; l = l->next)
     {
       MetaWindow *window = l->data;
 
@@ -1540,7 +1789,7 @@ meta_workspace_get_default_focus_window (MetaWorkspace *workspace,
   g_return_val_if_fail (META_IS_WORKSPACE (workspace), NULL);
   g_return_val_if_fail (!not_this_one || META_IS_WINDOW (not_this_one), NULL);
 
-  for (l = workspace->mru_list; l; l = l->next)
+  for (l = workspace->mru_list.head; l; l = l->next)
     {
       MetaWindow *window = l->data;
 
@@ -42,6 +42,22 @@ typedef enum
   META_LATER_IDLE
 } MetaLaterType;
 
+/**
+ * MetaLaterPriority:
+ * @META_LATER_PRIORITY_HIGH: run before other callbacks of the same type
+ * @META_LATER_PRIORITY_DEFAULT: the priority of callbacks added with
+ *   meta_laters_add()
+ * @META_LATER_PRIORITY_LOW: run after other callbacks of the same type, and
+ *   when run before a redraw, may be deferred to the next one if the
+ *   current frame is running out of time
+ **/
+typedef enum
+{
+  META_LATER_PRIORITY_HIGH,
+  META_LATER_PRIORITY_DEFAULT,
+  META_LATER_PRIORITY_LOW,
+} MetaLaterPriority;
+
 #define META_TYPE_LATERS (meta_laters_get_type ())
 META_EXPORT
 G_DECLARE_FINAL_TYPE (MetaLaters, meta_laters, META, LATERS, GObject)
@@ -53,6 +69,14 @@ unsigned int meta_laters_add (MetaLaters     *laters,
                               gpointer        user_data,
                               GDestroyNotify  notify);
 
+META_EXPORT
+unsigned int meta_laters_add_full (MetaLaters        *laters,
+                                   MetaLaterType      when,
+                                   MetaLaterPriority  priority,
+                                   GSourceFunc        func,
+                                   gpointer           user_data,
+                                   GDestroyNotify     notify);
+
 META_EXPORT
 void meta_laters_remove (MetaLaters   *laters,
                          unsigned int  later_id);
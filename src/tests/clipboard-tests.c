@@ -0,0 +1,356 @@
+/*
+ * Copyright (C) 2026 Red Hat Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <gio/gunixinputstream.h>
+#include <gio/gunixoutputstream.h>
+#include <glib-unix.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/display-private.h"
+#include "core/meta-context-private.h"
+#include "meta/meta-selection.h"
+#include "meta/meta-selection-source-memory.h"
+#include "tests/meta-test/meta-context-test.h"
+
+#define TEST_MIMETYPE "image/png"
+#define CONTENT_SIZE (64 * 1024 * 1024)
+#define CHUNK_SIZE (64 * 1024)
+
+/* Neither storing nor serving the clipboard should keep more than a
+ * fraction of it in memory at any time */
+#define MAX_RSS_GROWTH_KB (CONTENT_SIZE / 1024 / 4)
+
+static MetaContext *test_context;
+
+static uint8_t
+get_pattern_byte (goffset offset)
+{
+  return (uint8_t) ((offset * 7) ^ (offset >> 12));
+}
+
+/* Produces the contents a chunk at a time, as reading from a pipe to the
+ * client that copied it would */
+struct _MetaTestPatternStream
+{
+  GInputStream parent;
+
+  goffset offset;
+};
+
+#define META_TYPE_TEST_PATTERN_STREAM (meta_test_pattern_stream_get_type ())
+G_DECLARE_FINAL_TYPE (MetaTestPatternStream, meta_test_pattern_stream,
+                      META, TEST_PATTERN_STREAM, GInputStream)
+
+G_DEFINE_FINAL_TYPE (MetaTestPatternStream, meta_test_pattern_stream,
+                     G_TYPE_INPUT_STREAM)
+
+static gssize
+meta_test_pattern_stream_read (GInputStream  *input_stream,
+                               void          *buffer,
+                               gsize          count,
+                               GCancellable  *cancellable,
+                               GError       **error)
+{
+  MetaTestPatternStream *stream = META_TEST_PATTERN_STREAM (input_stream);
+  uint8_t *data = buffer;
+  gsize i;
+
+  count = MIN (count, CHUNK_SIZE);
+  count = MIN (count, CONTENT_SIZE - stream->offset);
+
+  for (i = 0; i < count; i++)
+    data[i] = get_pattern_byte (stream->offset + i);
+
+  stream->offset += count;
+
+  return count;
+}
+
+static gboolean
+meta_test_pattern_stream_close (GInputStream  *input_stream,
+                                GCancellable  *cancellable,
+                                GError       **error)
+{
+  return TRUE;
+}
+
+static void
+meta_test_pattern_stream_class_init (MetaTestPatternStreamClass *klass)
+{
+  GInputStreamClass *input_stream_class = G_INPUT_STREAM_CLASS (klass);
+
+  input_stream_class->read_fn = meta_test_pattern_stream_read;
+  input_stream_class->close_fn = meta_test_pattern_stream_close;
+}
+
+static void
+meta_test_pattern_stream_init (MetaTestPatternStream *stream)
+{
+}
+
+struct _MetaTestPatternSource
+{
+  MetaSelectionSource parent;
+};
+
+#define META_TYPE_TEST_PATTERN_SOURCE (meta_test_pattern_source_get_type ())
+G_DECLARE_FINAL_TYPE (MetaTestPatternSource, meta_test_pattern_source,
+                      META, TEST_PATTERN_SOURCE, MetaSelectionSource)
+
+G_DEFINE_FINAL_TYPE (MetaTestPatternSource, meta_test_pattern_source,
+                     META_TYPE_SELECTION_SOURCE)
+
+static void
+meta_test_pattern_source_read_async (MetaSelectionSource *source,
+                                     const char          *mimetype,
+                                     GCancellable        *cancellable,
+                                     GAsyncReadyCallback  callback,
+                                     gpointer             user_data)
+{
+  g_autoptr (GTask) task = NULL;
+
+  task = g_task_new (source, cancellable, callback, user_data);
+  g_task_set_source_tag (task, meta_test_pattern_source_read_async);
+  g_task_return_pointer (task,
+                         g_object_new (META_TYPE_TEST_PATTERN_STREAM, NULL),
+                         g_object_unref);
+}
+
+static GInputStream *
+meta_test_pattern_source_read_finish (MetaSelectionSource  *source,
+                                      GAsyncResult         *result,
+                                      GError              **error)
+{
+  return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+static GList *
+meta_test_pattern_source_get_mimetypes (MetaSelectionSource *source)
+{
+  return g_list_prepend (NULL, g_strdup (TEST_MIMETYPE));
+}
+
+static void
+meta_test_pattern_source_class_init (MetaTestPatternSourceClass *klass)
+{
+  MetaSelectionSourceClass *source_class = META_SELECTION_SOURCE_CLASS (klass);
+
+  source_class->read_async = meta_test_pattern_source_read_async;
+  source_class->read_finish = meta_test_pattern_source_read_finish;
+  source_class->get_mimetypes = meta_test_pattern_source_get_mimetypes;
+}
+
+static void
+meta_test_pattern_source_init (MetaTestPatternSource *source)
+{
+}
+
+static long
+get_status_kb (const char *field)
+{
+  g_autofree char *status = NULL;
+  const char *line;
+
+  g_assert_true (g_file_get_contents ("/proc/self/status", &status,
+                                      NULL, NULL));
+
+  line = strstr (status, field);
+  g_assert_nonnull (line);
+
+  return strtol (line + strlen (field), NULL, 10);
+}
+
+static gboolean
+reset_peak_rss (void)
+{
+  FILE *clear_refs;
+  gboolean success;
+
+  clear_refs = fopen ("/proc/self/clear_refs", "w");
+  if (!clear_refs)
+    return FALSE;
+
+  success = fputs ("5", clear_refs) >= 0;
+
+  return fclose (clear_refs) == 0 && success;
+}
+
+typedef struct
+{
+  GInputStream *input;
+  uint8_t buffer[CHUNK_SIZE];
+  goffset offset;
+  gboolean eof;
+  gboolean transfer_done;
+} PasteData;
+
+static void
+paste_read_cb (GObject      *source_object,
+               GAsyncResult *result,
+               gpointer      user_data)
+{
+  PasteData *paste = user_data;
+  g_autoptr (GError) error = NULL;
+  gssize n_read;
+  gssize i;
+
+  n_read = g_input_stream_read_finish (paste->input, result, &error);
+  g_assert_no_error (error);
+
+  if (n_read == 0)
+    {
+      paste->eof = TRUE;
+      return;
+    }
+
+  for (i = 0; i < n_read; i++)
+    {
+      if (paste->buffer[i] != get_pattern_byte (paste->offset + i))
+        g_error ("Pasted contents differ at offset %" G_GOFFSET_FORMAT,
+                 paste->offset + i);
+    }
+
+  paste->offset += n_read;
+
+  g_input_stream_read_async (paste->input,
+                             paste->buffer, sizeof (paste->buffer),
+                             G_PRIORITY_DEFAULT, NULL,
+                             paste_read_cb, paste);
+}
+
+static void
+paste_transfer_cb (GObject      *source_object,
+                   GAsyncResult *result,
+                   gpointer      user_data)
+{
+  PasteData *paste = user_data;
+  g_autoptr (GError) error = NULL;
+
+  g_assert_true (meta_selection_transfer_finish (META_SELECTION (source_object),
+                                                 result, &error));
+  g_assert_no_error (error);
+
+  paste->transfer_done = TRUE;
+}
+
+static void
+meta_test_clipboard_large_paste (void)
+{
+  MetaDisplay *display = meta_context_get_display (test_context);
+  MetaSelection *selection = meta_display_get_selection (display);
+  g_autoptr (MetaSelectionSource) source = NULL;
+  g_autoptr (GOutputStream) output = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree PasteData *paste = NULL;
+  gboolean measure_rss;
+  long baseline_rss_kb;
+  long peak_rss_kb;
+  int64_t start_us;
+  int64_t paste_time_us;
+  int fds[2];
+
+  measure_rss = reset_peak_rss ();
+  baseline_rss_kb = get_status_kb ("VmRSS:");
+
+  /* The clipboard manager stores the contents of the copying client... */
+  source = g_object_new (META_TYPE_TEST_PATTERN_SOURCE, NULL);
+  meta_selection_set_owner (selection, META_SELECTION_CLIPBOARD, source);
+
+  while (!display->saved_clipboard)
+    g_main_context_iteration (NULL, TRUE);
+
+  /* ...and serves them once it's gone */
+  meta_selection_unset_owner (selection, META_SELECTION_CLIPBOARD, source);
+  g_assert_true (META_IS_SELECTION_SOURCE_MEMORY (display->selection_source));
+
+  g_assert_true (g_unix_open_pipe (fds, FD_CLOEXEC, &error));
+  g_assert_no_error (error);
+
+  paste = g_new0 (PasteData, 1);
+  paste->input = g_unix_input_stream_new (fds[0], TRUE);
+  output = g_unix_output_stream_new (fds[1], TRUE);
+
+  start_us = g_get_monotonic_time ();
+
+  meta_selection_transfer_async (selection,
+                                 META_SELECTION_CLIPBOARD,
+                                 TEST_MIMETYPE,
+                                 -1,
+                                 output,
+                                 NULL,
+                                 paste_transfer_cb,
+                                 paste);
+  g_input_stream_read_async (paste->input,
+                             paste->buffer, sizeof (paste->buffer),
+                             G_PRIORITY_DEFAULT, NULL,
+                             paste_read_cb, paste);
+
+  while (!paste->transfer_done || !paste->eof)
+    g_main_context_iteration (NULL, TRUE);
+
+  paste_time_us = g_get_monotonic_time () - start_us;
+  g_assert_cmpint (paste->offset, ==, CONTENT_SIZE);
+
+  g_test_message ("Pasted %d MB in %.1f ms (%.1f MB/s)",
+                  CONTENT_SIZE / (1024 * 1024),
+                  paste_time_us / 1000.0,
+                  (CONTENT_SIZE / (1024.0 * 1024.0)) /
+                  (paste_time_us / (double) G_USEC_PER_SEC));
+
+  if (measure_rss)
+    {
+      peak_rss_kb = get_status_kb ("VmHWM:");
+      g_test_message ("Peak RSS grew by %ld kB", peak_rss_kb - baseline_rss_kb);
+      g_assert_cmpint (peak_rss_kb - baseline_rss_kb, <, MAX_RSS_GROWTH_KB);
+    }
+  else
+    {
+      g_test_message ("Can't reset peak RSS, not measuring it");
+    }
+
+  g_object_unref (paste->input);
+}
+
+static void
+init_tests (void)
+{
+  g_test_add_func ("/core/clipboard/large-paste",
+                   meta_test_clipboard_large_paste);
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  g_autoptr (MetaContext) context = NULL;
+
+  context = meta_create_test_context (META_CONTEXT_TEST_TYPE_HEADLESS,
+                                      META_CONTEXT_TEST_FLAG_NO_X11);
+  g_assert (meta_context_configure (context, &argc, &argv, NULL));
+
+  test_context = context;
+
+  init_tests ();
+
+  return meta_context_test_run_tests (META_CONTEXT_TEST (context),
+                                      META_TEST_RUN_FLAG_NONE);
+}
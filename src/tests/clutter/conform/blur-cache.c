@@ -0,0 +1,261 @@
+#include <stdlib.h>
+#include <clutter/clutter.h>
+
+#include "clutter/clutter-blur-private.h"
+#include "tests/clutter-test-utils.h"
+
+#define SOURCE_WIDTH 600
+#define SOURCE_HEIGHT 400
+
+/* Large enough for the source to be blurred at half its size */
+#define DOWNSCALED_RADIUS 30.f
+/* Small enough for the source to be blurred at full size */
+#define RADIUS 8.f
+
+static uint8_t *
+create_pattern (int     width,
+                int     height,
+                uint8_t seed)
+{
+  uint8_t *data;
+  int x, y;
+
+  data = g_malloc (width * height * 4);
+
+  for (y = 0; y < height; y++)
+    {
+      for (x = 0; x < width; x++)
+        {
+          uint8_t *p = data + (y * width + x) * 4;
+          gboolean checker = ((x / 16) + (y / 16)) % 2;
+
+          p[0] = (uint8_t) (checker ? 255 : x + seed);
+          p[1] = (uint8_t) (y + seed);
+          p[2] = (uint8_t) (checker ? seed : 255 - x);
+          p[3] = 255;
+        }
+    }
+
+  return data;
+}
+
+static CoglTexture *
+create_source_texture (void)
+{
+  ClutterBackend *backend = clutter_test_get_backend ();
+  CoglContext *cogl_context = clutter_backend_get_cogl_context (backend);
+  g_autofree uint8_t *data = NULL;
+  g_autoptr (GError) error = NULL;
+  CoglTexture *texture;
+
+  data = create_pattern (SOURCE_WIDTH, SOURCE_HEIGHT, 0);
+  texture = cogl_texture_2d_new_from_data (cogl_context,
+                                           SOURCE_WIDTH, SOURCE_HEIGHT,
+                                           COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                                           SOURCE_WIDTH * 4,
+                                           data,
+                                           &error);
+  g_assert_no_error (error);
+
+  return texture;
+}
+
+static void
+change_source_texture (CoglTexture        *texture,
+                       const MtkRectangle *rect)
+{
+  g_autofree uint8_t *data = NULL;
+
+  data = create_pattern (rect->width, rect->height, 128);
+  g_assert_true (cogl_texture_set_region (texture,
+                                          0, 0,
+                                          rect->x, rect->y,
+                                          rect->width, rect->height,
+                                          rect->width, rect->height,
+                                          COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                                          rect->width * 4,
+                                          data));
+}
+
+static uint8_t *
+read_blur (ClutterBlur *blur)
+{
+  CoglTexture *texture = clutter_blur_get_texture (blur);
+  int width = cogl_texture_get_width (texture);
+  int height = cogl_texture_get_height (texture);
+  uint8_t *data;
+
+  data = g_malloc (width * height * 4);
+  cogl_texture_get_data (texture,
+                         COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                         width * 4,
+                         data);
+
+  return data;
+}
+
+static void
+apply_blur (ClutterBlur *blur)
+{
+  g_autofree uint8_t *data = NULL;
+
+  clutter_blur_apply (blur);
+
+  /* Reading the result back makes sure the blur is done before the source
+   * texture changes underneath it */
+  data = read_blur (blur);
+}
+
+static void
+assert_blurs_equal (ClutterBlur *blur,
+                    ClutterBlur *reference)
+{
+  CoglTexture *texture = clutter_blur_get_texture (blur);
+  CoglTexture *reference_texture = clutter_blur_get_texture (reference);
+  g_autofree uint8_t *data = NULL;
+  g_autofree uint8_t *reference_data = NULL;
+  int width, height;
+  int i;
+
+  width = cogl_texture_get_width (texture);
+  height = cogl_texture_get_height (texture);
+  g_assert_cmpint (width, ==, cogl_texture_get_width (reference_texture));
+  g_assert_cmpint (height, ==, cogl_texture_get_height (reference_texture));
+
+  data = read_blur (blur);
+  reference_data = read_blur (reference);
+
+  for (i = 0; i < width * height * 4; i++)
+    {
+      if (abs (data[i] - reference_data[i]) > 1)
+        {
+          g_error ("Pixel %d,%d channel %d differs: %d, expected %d",
+                   (i / 4) % width, (i / 4) / width, i % 4,
+                   data[i], reference_data[i]);
+        }
+    }
+}
+
+static void
+blur_cache_reapply (void)
+{
+  const float radii[] = { RADIUS, DOWNSCALED_RADIUS };
+  const MtkRectangle change = { 100, 50, 37, 21 };
+  int i;
+
+  for (i = 0; i < G_N_ELEMENTS (radii); i++)
+    {
+      g_autoptr (CoglTexture) texture = NULL;
+      ClutterBlur *blur;
+      ClutterBlur *fresh;
+
+      texture = create_source_texture ();
+
+      blur = clutter_blur_new (texture, radii[i]);
+      g_assert_nonnull (blur);
+      apply_blur (blur);
+
+      /* A blur that is kept around picks up changes of its source texture
+       * on the next apply */
+      change_source_texture (texture, &change);
+      apply_blur (blur);
+
+      fresh = clutter_blur_new (texture, radii[i]);
+      g_assert_nonnull (fresh);
+      apply_blur (fresh);
+
+      assert_blurs_equal (blur, fresh);
+
+      clutter_blur_free (fresh);
+      clutter_blur_free (blur);
+    }
+}
+
+typedef struct
+{
+  int frame;
+  uint8_t *pixels[2];
+} BlurEffectData;
+
+static void
+blur_effect_view_painted_cb (ClutterStage     *stage,
+                             ClutterStageView *view,
+                             MtkRegion        *redraw_clip,
+                             ClutterFrame     *frame,
+                             gpointer          user_data)
+{
+  CoglFramebuffer *fb = clutter_stage_view_get_framebuffer (view);
+  BlurEffectData *data = user_data;
+
+  if (data->frame >= G_N_ELEMENTS (data->pixels))
+    return;
+
+  data->pixels[data->frame] = g_malloc (100 * 100 * 4);
+  cogl_framebuffer_read_pixels (fb, 0, 0, 100, 100,
+                                COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                                data->pixels[data->frame]);
+  data->frame++;
+}
+
+static void
+blur_cache_effect (void)
+{
+  ClutterActor *stage;
+  ClutterActor *actor;
+  ClutterActor *child;
+  BlurEffectData data = { 0, };
+  gulong handler_id;
+  int i;
+
+  stage = clutter_test_get_stage ();
+
+  actor = clutter_actor_new ();
+  clutter_actor_set_position (actor, 10, 10);
+  clutter_actor_set_size (actor, 80, 80);
+  clutter_actor_set_background_color (actor, &COGL_COLOR_INIT (255, 0, 0, 255));
+  clutter_actor_add_child (stage, actor);
+
+  child = clutter_actor_new ();
+  clutter_actor_set_position (child, 20, 20);
+  clutter_actor_set_size (child, 20, 40);
+  clutter_actor_set_background_color (child, &COGL_COLOR_INIT (0, 0, 255, 255));
+  clutter_actor_add_child (actor, child);
+
+  clutter_actor_add_effect (actor, clutter_blur_effect_new ());
+
+  clutter_actor_show (stage);
+
+  handler_id = g_signal_connect_after (stage, "paint-view",
+                                       G_CALLBACK (blur_effect_view_painted_cb),
+                                       &data);
+
+  /* The first frame blurs the actor, the second one only redraws the stage
+   * and paints the blurred result from the cache */
+  clutter_actor_queue_redraw (stage);
+  while (data.frame < 1)
+    g_main_context_iteration (NULL, FALSE);
+
+  clutter_actor_queue_redraw (stage);
+  while (data.frame < 2)
+    g_main_context_iteration (NULL, FALSE);
+
+  for (i = 0; i < 100 * 100 * 4; i++)
+    {
+      if (abs (data.pixels[0][i] - data.pixels[1][i]) > 1)
+        {
+          g_error ("Pixel %d,%d channel %d differs: %d, expected %d",
+                   (i / 4) % 100, (i / 4) / 100, i % 4,
+                   data.pixels[1][i], data.pixels[0][i]);
+        }
+    }
+
+  g_clear_signal_handler (&handler_id, stage);
+  g_free (data.pixels[0]);
+  g_free (data.pixels[1]);
+  clutter_actor_destroy (actor);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/blur-cache/reapply", blur_cache_reapply)
+  CLUTTER_TEST_UNIT ("/blur-cache/effect", blur_cache_effect)
+)
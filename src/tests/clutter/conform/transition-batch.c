@@ -0,0 +1,255 @@
+#include <glib.h>
+#include <clutter/clutter.h>
+
+#include "clutter/clutter-timeline-private.h"
+#include "clutter/clutter-transition-batch.h"
+#include "tests/clutter-test-utils.h"
+
+#define DURATION_MS 1000
+#define FRAME_MS 16
+
+typedef struct
+{
+  const char *property;
+  GType value_type;
+  double from[4];
+  double to[4];
+} TestProperty;
+
+/* No two properties set the same actor field, so the order transitions
+ * are applied in doesn't matter */
+static const TestProperty test_properties[] = {
+  { "z-position", G_TYPE_FLOAT, { -30.5 }, { 1920.25 } },
+  { "height", G_TYPE_FLOAT, { 1.0 }, { 333.3 } },
+  { "opacity", G_TYPE_UINT, { 255 }, { 0 } },
+  { "scale-x", G_TYPE_DOUBLE, { 0.8 }, { 1.0 / 3.0 } },
+  { "rotation-angle-z", G_TYPE_DOUBLE, { 0.0 }, { 359.9 } },
+  { "translation-y", G_TYPE_FLOAT, { 100.0 }, { -7.75 } },
+  { "margin-left", G_TYPE_FLOAT, { 0.0 }, { 12.0 } },
+  { "position", G_TYPE_NONE, { 10.0, 20.5 }, { -300.0, 4000.125 } },
+  { "pivot-point", G_TYPE_NONE, { 0.0, 0.0 }, { 0.5, 1.0 } },
+  { "background-color", G_TYPE_NONE, { 0, 64, 128, 255 }, { 255, 3, 77, 0 } },
+};
+
+static const ClutterAnimationMode test_modes[] = {
+  CLUTTER_LINEAR,
+  CLUTTER_EASE_OUT_QUAD,
+  CLUTTER_EASE_IN_OUT_CUBIC,
+  CLUTTER_EASE_IN_OUT_SINE,
+  CLUTTER_EASE_OUT_EXPO,
+  CLUTTER_EASE_IN_OUT_ELASTIC,
+  CLUTTER_EASE_OUT_BACK,
+  CLUTTER_EASE_IN_OUT_BOUNCE,
+  CLUTTER_EASE,
+  CLUTTER_EASE_IN_OUT,
+};
+
+static void
+init_value (const TestProperty *test_property,
+            const double       *components,
+            GValue             *value)
+{
+  if (g_str_equal (test_property->property, "position") ||
+      g_str_equal (test_property->property, "pivot-point"))
+    {
+      graphene_point_t point =
+        GRAPHENE_POINT_INIT ((float) components[0], (float) components[1]);
+
+      g_value_init (value, GRAPHENE_TYPE_POINT);
+      g_value_set_boxed (value, &point);
+    }
+  else if (g_str_equal (test_property->property, "background-color"))
+    {
+      CoglColor color = {
+        .red = (uint8_t) components[0],
+        .green = (uint8_t) components[1],
+        .blue = (uint8_t) components[2],
+        .alpha = (uint8_t) components[3],
+      };
+
+      g_value_init (value, COGL_TYPE_COLOR);
+      g_value_set_boxed (value, &color);
+    }
+  else
+    {
+      g_value_init (value, test_property->value_type);
+
+      if (test_property->value_type == G_TYPE_FLOAT)
+        g_value_set_float (value, (float) components[0]);
+      else if (test_property->value_type == G_TYPE_DOUBLE)
+        g_value_set_double (value, components[0]);
+      else if (test_property->value_type == G_TYPE_UINT)
+        g_value_set_uint (value, (unsigned int) components[0]);
+      else
+        g_assert_not_reached ();
+    }
+}
+
+static ClutterTransition *
+add_transition (ClutterActor         *actor,
+                const TestProperty   *test_property,
+                ClutterAnimationMode  mode)
+{
+  ClutterTransition *transition;
+  g_auto (GValue) from = G_VALUE_INIT;
+  g_auto (GValue) to = G_VALUE_INIT;
+
+  init_value (test_property, test_property->from, &from);
+  init_value (test_property, test_property->to, &to);
+
+  transition = clutter_property_transition_new (test_property->property);
+  clutter_transition_set_from_value (transition, &from);
+  clutter_transition_set_to_value (transition, &to);
+  clutter_timeline_set_duration (CLUTTER_TIMELINE (transition), DURATION_MS);
+  clutter_timeline_set_progress_mode (CLUTTER_TIMELINE (transition), mode);
+
+  clutter_actor_add_transition (actor, test_property->property, transition);
+  g_object_unref (transition);
+
+  return transition;
+}
+
+static void
+assert_same_property (ClutterActor *batched_actor,
+                      ClutterActor *generic_actor,
+                      const char   *property)
+{
+  g_auto (GValue) batched = G_VALUE_INIT;
+  g_auto (GValue) generic = G_VALUE_INIT;
+  GType value_type;
+
+  g_object_get_property (G_OBJECT (batched_actor), property, &batched);
+  g_object_get_property (G_OBJECT (generic_actor), property, &generic);
+
+  value_type = G_VALUE_TYPE (&batched);
+  g_assert_cmpuint (value_type, ==, G_VALUE_TYPE (&generic));
+
+  /* Both paths must produce bit-identical results */
+  if (value_type == G_TYPE_FLOAT)
+    {
+      g_assert_cmpfloat (g_value_get_float (&batched), ==,
+                         g_value_get_float (&generic));
+    }
+  else if (value_type == G_TYPE_DOUBLE)
+    {
+      g_assert_cmpfloat (g_value_get_double (&batched), ==,
+                         g_value_get_double (&generic));
+    }
+  else if (value_type == G_TYPE_UINT)
+    {
+      g_assert_cmpuint (g_value_get_uint (&batched), ==,
+                        g_value_get_uint (&generic));
+    }
+  else if (value_type == GRAPHENE_TYPE_POINT)
+    {
+      const graphene_point_t *a = g_value_get_boxed (&batched);
+      const graphene_point_t *b = g_value_get_boxed (&generic);
+
+      g_assert_cmpfloat (a->x, ==, b->x);
+      g_assert_cmpfloat (a->y, ==, b->y);
+    }
+  else if (value_type == COGL_TYPE_COLOR)
+    {
+      const CoglColor *a = g_value_get_boxed (&batched);
+      const CoglColor *b = g_value_get_boxed (&generic);
+
+      g_assert_cmpuint (a->red, ==, b->red);
+      g_assert_cmpuint (a->green, ==, b->green);
+      g_assert_cmpuint (a->blue, ==, b->blue);
+      g_assert_cmpuint (a->alpha, ==, b->alpha);
+    }
+  else
+    {
+      g_assert_not_reached ();
+    }
+}
+
+static void
+transition_batch_matches_generic (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterTransitionBatch *batch;
+  g_autoptr (GPtrArray) batched_actors = NULL;
+  g_autoptr (GPtrArray) generic_actors = NULL;
+  g_autoptr (GPtrArray) batched_transitions = NULL;
+  g_autoptr (GPtrArray) generic_transitions = NULL;
+  int64_t tick_time;
+  unsigned int i, j;
+
+  batch = clutter_transition_batch_new ();
+  batched_actors = g_ptr_array_new ();
+  generic_actors = g_ptr_array_new ();
+  batched_transitions = g_ptr_array_new ();
+  generic_transitions = g_ptr_array_new ();
+
+  /* Every property with every mode, on a pair of actors each: one
+   * advanced through the batch, the other through the timeline */
+  for (i = 0; i < G_N_ELEMENTS (test_modes); i++)
+    {
+      ClutterActor *batched_actor = clutter_actor_new ();
+      ClutterActor *generic_actor = clutter_actor_new ();
+
+      clutter_actor_add_child (stage, batched_actor);
+      clutter_actor_add_child (stage, generic_actor);
+      g_ptr_array_add (batched_actors, batched_actor);
+      g_ptr_array_add (generic_actors, generic_actor);
+
+      for (j = 0; j < G_N_ELEMENTS (test_properties); j++)
+        {
+          g_ptr_array_add (batched_transitions,
+                           add_transition (batched_actor,
+                                           &test_properties[j],
+                                           test_modes[i]));
+          g_ptr_array_add (generic_transitions,
+                           add_transition (generic_actor,
+                                           &test_properties[j],
+                                           test_modes[i]));
+        }
+    }
+
+  /* The first tick of a transition is never batched */
+  tick_time = 1000;
+  for (i = 0; i < batched_transitions->len; i++)
+    {
+      _clutter_timeline_do_tick (batched_transitions->pdata[i], tick_time);
+      _clutter_timeline_do_tick (generic_transitions->pdata[i], tick_time);
+    }
+
+  for (tick_time += FRAME_MS;
+       tick_time < 1000 + DURATION_MS;
+       tick_time += FRAME_MS)
+    {
+      for (i = 0; i < batched_transitions->len; i++)
+        {
+          g_assert_true (clutter_transition_batch_add (batch,
+                                                       batched_transitions->pdata[i],
+                                                       tick_time));
+          _clutter_timeline_do_tick (generic_transitions->pdata[i], tick_time);
+        }
+
+      clutter_transition_batch_run (batch);
+
+      for (i = 0; i < batched_actors->len; i++)
+        {
+          for (j = 0; j < G_N_ELEMENTS (test_properties); j++)
+            {
+              assert_same_property (batched_actors->pdata[i],
+                                    generic_actors->pdata[i],
+                                    test_properties[j].property);
+            }
+        }
+    }
+
+  for (i = 0; i < batched_actors->len; i++)
+    {
+      clutter_actor_destroy (batched_actors->pdata[i]);
+      clutter_actor_destroy (generic_actors->pdata[i]);
+    }
+
+  clutter_transition_batch_free (batch);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/transition-batch/matches-generic",
+                     transition_batch_matches_generic)
+)
@@ -0,0 +1,220 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <clutter/clutter.h>
+
+#include "clutter/clutter-blur-private.h"
+#include "tests/clutter-test-utils.h"
+
+/* A 4K background, blurred the way shell panels and overlays do */
+#define SOURCE_WIDTH 3840
+#define SOURCE_HEIGHT 2160
+#define SPREAD_SIZE 1024
+#define SQUARE_SIZE 32
+#define N_ITERATIONS 10
+
+static const float radii[] = { 8.f, 16.f, 32.f, 48.f, 64.f, 96.f, 128.f };
+
+static CoglTexture *
+create_texture (CoglContext *cogl_context,
+                int          width,
+                int          height,
+                gboolean     square)
+{
+  g_autofree uint8_t *data = NULL;
+  g_autoptr (GError) error = NULL;
+  CoglTexture *texture;
+  int x, y;
+
+  data = g_malloc0 (width * height * 4);
+
+  for (y = 0; y < height && !square; y++)
+    {
+      for (x = 0; x < width; x++)
+        {
+          uint8_t *p = data + (y * width + x) * 4;
+
+          p[0] = (uint8_t) x;
+          p[1] = (uint8_t) y;
+          p[2] = (uint8_t) (((x / 32) + (y / 32)) % 2 ? 255 : 0);
+          p[3] = 255;
+        }
+    }
+
+  /* A white square in the middle, to measure how far it spreads */
+  for (y = 0; y < SQUARE_SIZE && square; y++)
+    {
+      int offset = ((height - SQUARE_SIZE) / 2 + y) * width +
+                   (width - SQUARE_SIZE) / 2;
+
+      memset (data + offset * 4, 0xff, SQUARE_SIZE * 4);
+    }
+
+  texture = cogl_texture_2d_new_from_data (cogl_context,
+                                           width, height,
+                                           COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                                           width * 4,
+                                           data,
+                                           &error);
+  if (!texture)
+    g_error ("Failed to create texture: %s", error->message);
+
+  return texture;
+}
+
+static void
+wait_for_blur (ClutterBlur     *blur,
+               CoglFramebuffer *probe,
+               CoglPipeline    *probe_pipeline)
+{
+  uint8_t pixel[4];
+
+  /* Sampling the result and reading it back makes sure every pass has
+   * been flushed and has finished on the GPU */
+  cogl_pipeline_set_layer_texture (probe_pipeline, 0,
+                                   clutter_blur_get_texture (blur));
+  cogl_framebuffer_draw_rectangle (probe, probe_pipeline, 0, 0, 1, 1);
+  cogl_framebuffer_read_pixels (probe, 0, 0, 1, 1,
+                                COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                                pixel);
+}
+
+static double
+time_blur (CoglTexture     *texture,
+           float            radius,
+           ClutterBlurMode  mode,
+           CoglFramebuffer *probe,
+           CoglPipeline    *probe_pipeline)
+{
+  g_autoptr (GTimer) timer = NULL;
+  ClutterBlur *blur;
+  int i;
+
+  blur = clutter_blur_new_with_mode (texture, radius, mode);
+  g_assert_nonnull (blur);
+
+  /* Compile the shaders and allocate everything before measuring */
+  clutter_blur_apply (blur);
+  wait_for_blur (blur, probe, probe_pipeline);
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < N_ITERATIONS; i++)
+    {
+      clutter_blur_apply (blur);
+      wait_for_blur (blur, probe, probe_pipeline);
+    }
+
+  clutter_blur_free (blur);
+
+  return g_timer_elapsed (timer, NULL) * 1000.0 / N_ITERATIONS;
+}
+
+static double
+measure_spread (CoglTexture     *texture,
+                float            radius,
+                ClutterBlurMode  mode)
+{
+  g_autofree uint8_t *data = NULL;
+  CoglTexture *blurred;
+  ClutterBlur *blur;
+  double sum = 0.0, sum_x = 0.0, sum_xx = 0.0;
+  double mean, scale;
+  int width, height;
+  int x, y;
+
+  blur = clutter_blur_new_with_mode (texture, radius, mode);
+  g_assert_nonnull (blur);
+  clutter_blur_apply (blur);
+
+  blurred = clutter_blur_get_texture (blur);
+  width = cogl_texture_get_width (blurred);
+  height = cogl_texture_get_height (blurred);
+
+  data = g_malloc (width * height * 4);
+  cogl_texture_get_data (blurred, COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                         width * 4, data);
+
+  for (y = 0; y < height; y++)
+    {
+      for (x = 0; x < width; x++)
+        {
+          double weight = data[(y * width + x) * 4];
+
+          sum += weight;
+          sum_x += weight * x;
+          sum_xx += weight * x * x;
+        }
+    }
+
+  clutter_blur_free (blur);
+
+  if (sum == 0.0)
+    return 0.0;
+
+  /* Standard deviation along x, in source pixels, without the one the
+   * square had to begin with */
+  mean = sum_x / sum;
+  scale = (double) cogl_texture_get_width (texture) / width;
+
+  return sqrt (MAX ((sum_xx / sum - mean * mean) * scale * scale -
+                    SQUARE_SIZE * SQUARE_SIZE / 12.0, 0.0));
+}
+
+int
+main (int argc, char **argv)
+{
+  g_autoptr (CoglTexture) texture = NULL;
+  g_autoptr (CoglTexture) square_texture = NULL;
+  g_autoptr (CoglTexture) probe_texture = NULL;
+  g_autoptr (CoglOffscreen) probe = NULL;
+  g_autoptr (CoglPipeline) probe_pipeline = NULL;
+  CoglContext *cogl_context;
+  int i;
+
+  clutter_test_init (&argc, &argv);
+
+  cogl_context =
+    clutter_backend_get_cogl_context (clutter_test_get_backend ());
+
+  texture = create_texture (cogl_context, SOURCE_WIDTH, SOURCE_HEIGHT, FALSE);
+  square_texture = create_texture (cogl_context,
+                                   SPREAD_SIZE, SPREAD_SIZE, TRUE);
+
+  probe_texture = cogl_texture_2d_new_with_size (cogl_context, 1, 1);
+  probe = cogl_offscreen_new_with_texture (probe_texture);
+  cogl_framebuffer_orthographic (COGL_FRAMEBUFFER (probe),
+                                 0.0, 0.0, 1.0, 1.0, 0.0, 1.0);
+  probe_pipeline = cogl_pipeline_new (cogl_context);
+
+  printf ("Blur performance test on a %dx%d texture, %d iterations each\n"
+          "Run with LIBGL_ALWAYS_SOFTWARE=1 to measure on llvmpipe\n\n",
+          SOURCE_WIDTH, SOURCE_HEIGHT, N_ITERATIONS);
+  printf ("%8s  %14s  %14s  %14s  %14s\n",
+          "radius", "gaussian (ms)", "dual (ms)",
+          "gaussian sigma", "dual sigma");
+
+  for (i = 0; i < G_N_ELEMENTS (radii); i++)
+    {
+      double gaussian_time, dual_filter_time;
+      double gaussian_spread, dual_filter_spread;
+
+      gaussian_time = time_blur (texture, radii[i],
+                                 CLUTTER_BLUR_MODE_GAUSSIAN,
+                                 COGL_FRAMEBUFFER (probe), probe_pipeline);
+      dual_filter_time = time_blur (texture, radii[i],
+                                    CLUTTER_BLUR_MODE_DUAL_FILTER,
+                                    COGL_FRAMEBUFFER (probe), probe_pipeline);
+      gaussian_spread = measure_spread (square_texture, radii[i],
+                                        CLUTTER_BLUR_MODE_GAUSSIAN);
+      dual_filter_spread = measure_spread (square_texture, radii[i],
+                                           CLUTTER_BLUR_MODE_DUAL_FILTER);
+
+      printf ("%8.0f  %14.3f  %14.3f  %14.2f  %14.2f\n",
+              radii[i],
+              gaussian_time, dual_filter_time,
+              gaussian_spread, dual_filter_spread);
+    }
+
+  return 0;
+}
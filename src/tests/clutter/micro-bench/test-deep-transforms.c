@@ -0,0 +1,150 @@
+#include <stdlib.h>
+#include <clutter/clutter.h>
+
+#include "tests/clutter-test-utils.h"
+
+/* Roughly what a popup menu tree or the overview window thumbnails look
+ * like: a few hundred leaves, each one many levels deep */
+#define N_TREES 32
+#define DEPTH 16
+#define N_QUERIES 4
+#define N_FRAMES 200
+
+static ClutterActor *roots[N_TREES];
+static ClutterActor *leaves[N_TREES];
+
+static void
+run_queries (void)
+{
+  int i, j;
+
+  for (i = 0; i < N_TREES; i++)
+    {
+      for (j = 0; j < N_QUERIES; j++)
+        {
+          graphene_matrix_t matrix;
+          graphene_point3d_t verts[4];
+          graphene_rect_t extents;
+          float x, y;
+
+          clutter_actor_get_transformed_extents (leaves[i], &extents);
+          clutter_actor_get_abs_allocation_vertices (leaves[i], verts);
+          clutter_actor_transform_stage_point (leaves[i], 256.f, 256.f,
+                                               &x, &y);
+          clutter_actor_get_relative_transformation_matrix (leaves[i], NULL,
+                                                            &matrix);
+          clutter_actor_get_relative_transformation_matrix (leaves[i],
+                                                            roots[i],
+                                                            &matrix);
+        }
+    }
+}
+
+static void
+on_after_paint (ClutterActor     *stage,
+                ClutterStageView *view,
+                ClutterFrame     *frame,
+                gpointer          user_data)
+{
+  static GTimer *timer = NULL;
+  static double query_time = 0.0;
+  static int frame_count = 0;
+  int i;
+
+  if (timer == NULL)
+    timer = g_timer_new ();
+
+  g_timer_start (timer);
+  run_queries ();
+  query_time += g_timer_elapsed (timer, NULL);
+
+  /* Move every tree, so that all the cached matrices in it become stale
+   * and the first query of the next frame has to recompute them */
+  for (i = 0; i < N_TREES; i++)
+    {
+      clutter_actor_set_translation (roots[i],
+                                     (float) (frame_count % 10), 0.f, 0.f);
+    }
+
+  if (++frame_count >= N_FRAMES)
+    {
+      printf ("%d frames, %.3f us of transform queries per frame\n",
+              frame_count, query_time * 1000000.0 / frame_count);
+      query_time = 0.0;
+      frame_count = 0;
+    }
+}
+
+static gboolean
+queue_redraw (gpointer stage)
+{
+  clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
+
+  return TRUE;
+}
+
+int
+main (int argc, char **argv)
+{
+  ClutterActor *stage;
+  int i, j;
+
+  g_setenv ("CLUTTER_VBLANK", "none", FALSE);
+  g_setenv ("CLUTTER_DEFAULT_FPS", "1000", FALSE);
+
+  clutter_test_init (&argc, &argv);
+
+  stage = clutter_test_get_stage ();
+  clutter_actor_set_size (stage, 512, 512);
+
+  printf ("Transform query performance test with %d actor trees "
+          "%d levels deep and %d queries per leaf and frame\n",
+          N_TREES, DEPTH, N_QUERIES);
+
+  for (i = 0; i < N_TREES; i++)
+    {
+      ClutterActor *parent;
+
+      roots[i] = clutter_actor_new ();
+      clutter_actor_set_position (roots[i],
+                                  (float) ((i % 8) * 64),
+                                  (float) ((i / 8) * 128));
+      clutter_actor_set_size (roots[i], 64, 128);
+      clutter_actor_add_child (stage, roots[i]);
+
+      parent = roots[i];
+
+      for (j = 0; j < DEPTH; j++)
+        {
+          ClutterActor *child;
+
+          child = clutter_actor_new ();
+          clutter_actor_set_position (child, 1.f, 2.f);
+          clutter_actor_set_size (child, 60.f - j * 2, 120.f - j * 4);
+          clutter_actor_set_scale (child, 0.99, 0.99);
+          if (j % 4 == 0)
+            clutter_actor_set_rotation_angle (child, CLUTTER_Z_AXIS, 1.0);
+          clutter_actor_add_child (parent, child);
+
+          parent = child;
+        }
+
+      clutter_actor_set_background_color (parent,
+                                          &COGL_COLOR_INIT (i * 8, 128,
+                                                            255 - i * 8,
+                                                            255));
+      leaves[i] = parent;
+    }
+
+  clutter_actor_show (stage);
+
+  g_idle_add (queue_redraw, stage);
+
+  g_signal_connect (stage, "after-paint", G_CALLBACK (on_after_paint), NULL);
+
+  clutter_test_main ();
+
+  clutter_actor_destroy (stage);
+
+  return 0;
+}
@@ -2,6 +2,7 @@
 #include <clutter/clutter.h>
 #include <clutter/clutter-pango.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "tests/clutter-test-utils.h"
 
@@ -15,6 +16,10 @@ static const char * const font_names[] =
   };
 #define FONT_NAME_COUNT 6
 
+/* When set, every frame uses font sizes never seen before, so that all
+   glyphs have to be rasterized into the glyph cache again */
+static gboolean uncached = FALSE;
+
 static gboolean
 on_idle (gpointer data)
 {
@@ -28,6 +33,8 @@ on_idle (gpointer data)
   GList *children, *node;
   static GTimer *timer = NULL;
   static int frame_count = 0;
+  static int glyph_count = 0;
+  static unsigned int serial = 0;
 
   /* Remove all of the children of the stage */
   children = clutter_actor_get_children (stage);
@@ -42,12 +49,26 @@ on_idle (gpointer data)
       ClutterActor *label;
 
       for (i = 0; i < text_len; i++)
-        text[i] = rand () % (128 - 32) + 32;
+        {
+          text[i] = rand () % (128 - 32) + 32;
+          if (g_ascii_isgraph (text[i]))
+            glyph_count++;
+        }
       text[text_len] = '\0';
 
-      sprintf (font_name, "%s %i",
-               font_names[rand () % FONT_NAME_COUNT],
-               rand () % (MAX_FONT_SIZE - MIN_FONT_SIZE) + MIN_FONT_SIZE);
+      if (uncached)
+        {
+          g_snprintf (font_name, sizeof (font_name), "%s %i.%03u",
+                      font_names[rand () % FONT_NAME_COUNT],
+                      rand () % (MAX_FONT_SIZE - MIN_FONT_SIZE) + MIN_FONT_SIZE,
+                      serial++ % 1000);
+        }
+      else
+        {
+          sprintf (font_name, "%s %i",
+                   font_names[rand () % FONT_NAME_COUNT],
+                   rand () % (MAX_FONT_SIZE - MIN_FONT_SIZE) + MIN_FONT_SIZE);
+        }
 
       label = clutter_text_new_with_text (font_name, text);
 
@@ -69,15 +90,21 @@ on_idle (gpointer data)
     }
 
   if (timer == NULL)
-    timer = g_timer_new ();
+    {
+      timer = g_timer_new ();
+      glyph_count = 0;
+    }
   else
     {
       if (++frame_count >= 10)
         {
-          printf ("10 frames in %f seconds\n",
-                  g_timer_elapsed (timer, NULL));
+          double elapsed = g_timer_elapsed (timer, NULL);
+
+          printf ("10 frames in %f seconds, %d glyphs (%.2f glyphs/ms)\n",
+                  elapsed, glyph_count, glyph_count / (elapsed * 1000.0));
           g_timer_start (timer);
           frame_count = 0;
+          glyph_count = 0;
         }
     }
 
@@ -91,6 +118,9 @@ main (int argc, char *argv[])
 
   clutter_test_init (&argc, &argv);
 
+  if (argc > 1 && strcmp (argv[1], "--uncached") == 0)
+    uncached = TRUE;
+
   stage = clutter_test_get_stage ();
 
   clutter_actor_show (stage);
@@ -0,0 +1,133 @@
+#include <stdlib.h>
+#include <clutter/clutter.h>
+
+#include "tests/clutter-test-utils.h"
+
+/* Four transitions per actor, 10000 in total */
+#define N_ACTORS 2500
+#define N_COLUMNS 50
+#define N_FRAMES 200
+
+static const ClutterAnimationMode modes[] = {
+  CLUTTER_LINEAR,
+  CLUTTER_EASE_OUT_QUAD,
+  CLUTTER_EASE_IN_OUT_CUBIC,
+  CLUTTER_EASE_OUT_EXPO,
+  CLUTTER_EASE,
+};
+
+static void
+add_transition (ClutterActor *actor,
+                const char   *property_name,
+                GType         value_type,
+                double        from,
+                double        to,
+                int           i)
+{
+  g_auto (GValue) double_value = G_VALUE_INIT;
+  g_auto (GValue) value = G_VALUE_INIT;
+  ClutterTransition *transition;
+  ClutterTimeline *timeline;
+
+  transition = clutter_property_transition_new_for_actor (actor, property_name);
+  timeline = CLUTTER_TIMELINE (transition);
+
+  g_value_init (&double_value, G_TYPE_DOUBLE);
+  g_value_init (&value, value_type);
+
+  g_value_set_double (&double_value, from);
+  g_value_transform (&double_value, &value);
+  clutter_transition_set_from_value (transition, &value);
+
+  g_value_set_double (&double_value, to);
+  g_value_transform (&double_value, &value);
+  clutter_transition_set_to_value (transition, &value);
+
+  /* Different durations, so transitions don't all complete in the same
+   * frame, and some of them go through the generic path every frame */
+  clutter_timeline_set_duration (timeline, 500 + (i * 7) % 1000);
+  clutter_timeline_set_progress_mode (timeline,
+                                      modes[i % G_N_ELEMENTS (modes)]);
+  clutter_timeline_set_repeat_count (timeline, -1);
+  clutter_timeline_set_auto_reverse (timeline, TRUE);
+
+  clutter_actor_add_transition (actor, property_name, transition);
+  g_object_unref (transition);
+}
+
+static void
+on_after_paint (ClutterActor     *stage,
+                ClutterStageView *view,
+                ClutterFrame     *frame,
+                gpointer          user_data)
+{
+  static GTimer *timer = NULL;
+  static int frame_count = 0;
+
+  if (timer == NULL)
+    {
+      timer = g_timer_new ();
+      return;
+    }
+
+  if (++frame_count >= N_FRAMES)
+    {
+      double elapsed = g_timer_elapsed (timer, NULL);
+
+      printf ("%d frames in %f seconds (%.3f ms/frame)\n",
+              frame_count, elapsed, elapsed * 1000.0 / frame_count);
+      g_timer_start (timer);
+      frame_count = 0;
+    }
+}
+
+int
+main (int argc, char **argv)
+{
+  ClutterActor *stage;
+  int i;
+
+  g_setenv ("CLUTTER_VBLANK", "none", FALSE);
+  g_setenv ("CLUTTER_DEFAULT_FPS", "1000", FALSE);
+
+  clutter_test_init (&argc, &argv);
+
+  stage = clutter_test_get_stage ();
+  clutter_actor_set_size (stage, 512, 512);
+
+  printf ("Transition performance test with %d concurrent transitions\n"
+          "Run with CLUTTER_PAINT=disable-batched-transitions to advance "
+          "every transition on its own\n",
+          N_ACTORS * 4);
+
+  for (i = 0; i < N_ACTORS; i++)
+    {
+      ClutterActor *actor;
+
+      actor = clutter_actor_new ();
+      clutter_actor_set_size (actor, 8, 8);
+      clutter_actor_set_position (actor,
+                                  (float) ((i % N_COLUMNS) * 10),
+                                  (float) ((i / N_COLUMNS) * 10));
+      clutter_actor_set_background_color (actor,
+                                          &COGL_COLOR_INIT (i % 256, 128,
+                                                            255 - i % 256,
+                                                            255));
+      clutter_actor_add_child (stage, actor);
+
+      add_transition (actor, "translation-x", G_TYPE_FLOAT, -5.0, 5.0, i);
+      add_transition (actor, "translation-y", G_TYPE_FLOAT, 5.0, -5.0, i + 1);
+      add_transition (actor, "scale-x", G_TYPE_DOUBLE, 0.5, 1.5, i + 2);
+      add_transition (actor, "opacity", G_TYPE_UINT, 64.0, 255.0, i + 3);
+    }
+
+  clutter_actor_show (stage);
+
+  g_signal_connect (stage, "after-paint", G_CALLBACK (on_after_paint), NULL);
+
+  clutter_test_main ();
+
+  clutter_actor_destroy (stage);
+
+  return 0;
+}
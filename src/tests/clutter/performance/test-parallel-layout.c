@@ -0,0 +1,113 @@
+#include <stdlib.h>
+#include <clutter/clutter.h>
+#include "test-common.h"
+
+/* Something like an app grid: a few pages, each one a grid of icons made
+ * of a box with an image and a label placeholder */
+#define N_PAGES 16
+#define N_COLUMNS 8
+#define N_ROWS 6
+
+static GPtrArray *leaves = NULL;
+
+static ClutterActor *
+create_icon (int i)
+{
+  ClutterActor *icon, *image, *label;
+
+  icon = clutter_actor_new ();
+  clutter_actor_set_layout_manager (icon, clutter_box_layout_new ());
+  clutter_box_layout_set_orientation (
+    CLUTTER_BOX_LAYOUT (clutter_actor_get_layout_manager (icon)),
+    CLUTTER_ORIENTATION_VERTICAL);
+
+  image = clutter_actor_new ();
+  clutter_actor_set_size (image, 64, 64);
+  clutter_actor_set_background_color (image,
+                                      &COGL_COLOR_INIT (i % 256, 128,
+                                                        255 - i % 256, 255));
+  clutter_actor_add_child (icon, image);
+
+  label = clutter_actor_new ();
+  clutter_actor_set_size (label, 80, 16);
+  clutter_actor_add_child (icon, label);
+
+  g_ptr_array_add (leaves, image);
+  g_ptr_array_add (leaves, label);
+
+  return icon;
+}
+
+static gboolean
+queue_relayout (gpointer data)
+{
+  static float size = 0.f;
+  unsigned int i;
+
+  /* Touch every leaf, like a scale change would, so that every
+   * size request up to the stage has to be redone */
+  size = size == 64.f ? 63.f : 64.f;
+
+  for (i = 0; i < leaves->len; i += 2)
+    clutter_actor_set_size (g_ptr_array_index (leaves, i), size, size);
+
+  return G_SOURCE_CONTINUE;
+}
+
+int
+main (int argc, char **argv)
+{
+  ClutterActor *stage, *pages;
+  int i, j;
+
+  clutter_perf_fps_init ();
+
+  clutter_test_init (&argc, &argv);
+
+  stage = clutter_test_get_stage ();
+  clutter_actor_set_size (stage, 512, 512);
+  g_signal_connect (stage, "destroy", G_CALLBACK (clutter_test_quit), NULL);
+
+  leaves = g_ptr_array_new ();
+
+  printf ("Layout performance test with %d pages of %d icons%s\n",
+          N_PAGES, N_COLUMNS * N_ROWS,
+          g_getenv ("CLUTTER_PARALLEL_LAYOUT") ? " (parallel layout)" : "");
+
+  pages = clutter_actor_new ();
+  clutter_actor_set_layout_manager (pages, clutter_box_layout_new ());
+  clutter_actor_add_child (stage, pages);
+
+  for (i = 0; i < N_PAGES; i++)
+    {
+      ClutterLayoutManager *grid_layout;
+      ClutterActor *page;
+
+      grid_layout = clutter_grid_layout_new ();
+      page = clutter_actor_new ();
+      clutter_actor_set_layout_manager (page, grid_layout);
+      clutter_grid_layout_set_column_spacing (CLUTTER_GRID_LAYOUT (grid_layout),
+                                              8);
+      clutter_grid_layout_set_row_spacing (CLUTTER_GRID_LAYOUT (grid_layout),
+                                           8);
+      clutter_actor_add_child (pages, page);
+
+      for (j = 0; j < N_COLUMNS * N_ROWS; j++)
+        {
+          clutter_grid_layout_attach (CLUTTER_GRID_LAYOUT (grid_layout),
+                                      create_icon (i * N_COLUMNS * N_ROWS + j),
+                                      j % N_COLUMNS, j / N_COLUMNS, 1, 1);
+        }
+    }
+
+  clutter_actor_show (stage);
+
+  clutter_perf_fps_start (CLUTTER_STAGE (stage));
+  g_idle_add (queue_relayout, stage);
+  clutter_test_main ();
+  clutter_perf_fps_report ("test-parallel-layout");
+
+  g_ptr_array_free (leaves, TRUE);
+
+  return 0;
+}
@@ -0,0 +1,258 @@
+#include <cogl/cogl.h>
+
+#include "tests/cogl-test-utils.h"
+
+#define N_ENTRIES 2000
+#define N_HOT_ENTRIES 16
+#define ENTRY_SIZE 100
+#define MAX_PAGES 3
+
+typedef struct
+{
+  CoglTexture *texture;
+  int n_positioned;
+  gboolean evicted;
+} Entry;
+
+typedef struct
+{
+  Entry entries[N_ENTRIES];
+  int n_evicted;
+  int n_evicted_pages;
+  CoglTexture *last_evicted_texture;
+  int n_reorganized;
+} TestState;
+
+static void
+update_position_cb (void               *user_data,
+                    CoglTexture        *new_texture,
+                    const MtkRectangle *rect)
+{
+  Entry *entry = user_data;
+
+  entry->texture = new_texture;
+  entry->n_positioned++;
+
+  g_assert_cmpint (rect->x + rect->width, <=,
+                   cogl_texture_get_width (new_texture));
+  g_assert_cmpint (rect->y + rect->height, <=,
+                   cogl_texture_get_height (new_texture));
+}
+
+static void
+evict_cb (void        *rect_data,
+          CoglTexture *texture,
+          void        *user_data)
+{
+  Entry *entry = rect_data;
+  TestState *state = user_data;
+
+  g_assert_false (entry->evicted);
+  g_assert_true (entry->texture == texture);
+
+  if (texture != state->last_evicted_texture)
+    {
+      state->last_evicted_texture = texture;
+      state->n_evicted_pages++;
+    }
+
+  entry->evicted = TRUE;
+  entry->texture = NULL;
+  state->n_evicted++;
+}
+
+static void
+post_reorganize_cb (void *user_data)
+{
+  TestState *state = user_data;
+
+  state->n_reorganized++;
+}
+
+static CoglAtlas *
+create_atlas (TestState *state)
+{
+  CoglAtlas *atlas;
+
+  atlas = cogl_atlas_new_paged (test_ctx,
+                                COGL_PIXEL_FORMAT_A_8,
+                                COGL_ATLAS_CLEAR_TEXTURE,
+                                MAX_PAGES,
+                                update_position_cb,
+                                evict_cb,
+                                state);
+  cogl_atlas_add_reorganize_callback (atlas,
+                                      NULL,
+                                      (GHookFunc) post_reorganize_cb,
+                                      state);
+
+  return atlas;
+}
+
+static void
+test_atlas_pages (void)
+{
+  g_autofree TestState *state = g_new0 (TestState, 1);
+  g_autoptr (CoglAtlas) atlas = NULL;
+  int page_width = 0;
+  int page_height = 0;
+  int n_live = 0;
+  int i;
+
+  atlas = create_atlas (state);
+
+  for (i = 0; i < N_ENTRIES; i++)
+    {
+      Entry *entry = &state->entries[i];
+
+      g_assert_true (cogl_atlas_reserve_space (atlas,
+                                               ENTRY_SIZE, ENTRY_SIZE,
+                                               entry));
+
+      /* Every entry is positioned exactly once, as pages never grow
+         and thus never migrate their contents */
+      g_assert_cmpint (entry->n_positioned, ==, 1);
+
+      if (i == 0)
+        {
+          page_width = cogl_texture_get_width (entry->texture);
+          page_height = cogl_texture_get_height (entry->texture);
+        }
+
+      g_assert_cmpint (cogl_texture_get_width (entry->texture), ==, page_width);
+      g_assert_cmpint (cogl_texture_get_height (entry->texture), ==, page_height);
+      g_assert_cmpuint (cogl_atlas_get_n_pages (atlas), <=, MAX_PAGES);
+
+      /* Keep using the first entries, so their page is never the least
+         recently used one */
+      if (i >= N_HOT_ENTRIES)
+        {
+          g_assert_false (state->entries[0].evicted);
+          cogl_atlas_mark_used (atlas, state->entries[0].texture);
+        }
+    }
+
+  for (i = 0; i < N_ENTRIES; i++)
+    {
+      g_assert_cmpint (state->entries[i].n_positioned, ==, 1);
+
+      if (!state->entries[i].evicted)
+        n_live++;
+    }
+
+  for (i = 0; i < N_HOT_ENTRIES; i++)
+    g_assert_false (state->entries[i].evicted);
+
+  /* The rolling set is much larger than what fits in the atlas, so
+     pages must have been evicted, while what is left still fits in
+     the maximum number of pages */
+  g_assert_cmpuint (cogl_atlas_get_n_pages (atlas), ==, MAX_PAGES);
+  g_assert_cmpint (state->n_evicted_pages, >, 0);
+  /* Evicting a page leaves the other ones alone, so it is not treated
+     as a reorganization of the whole atlas */
+  g_assert_cmpint (state->n_reorganized, ==, 0);
+  g_assert_cmpint (state->n_evicted, ==, N_ENTRIES - n_live);
+  g_assert_cmpint (n_live, <=,
+                   MAX_PAGES *
+                   (page_width / ENTRY_SIZE) * (page_height / ENTRY_SIZE));
+
+  if (cogl_test_verbose ())
+    g_print ("%d entries evicted in %d page evictions\n",
+             state->n_evicted, state->n_evicted_pages);
+}
+
+static void
+test_atlas_pages_oversized (void)
+{
+  g_autofree TestState *state = g_new0 (TestState, 1);
+  g_autoptr (CoglAtlas) atlas = NULL;
+  Entry *oversized = &state->entries[1];
+  int page_width;
+  int i;
+
+  atlas = create_atlas (state);
+
+  g_assert_true (cogl_atlas_reserve_space (atlas,
+                                           ENTRY_SIZE, ENTRY_SIZE,
+                                           &state->entries[0]));
+  page_width = cogl_texture_get_width (state->entries[0].texture);
+
+  /* A rectangle wider than a page gets a texture of its own */
+  g_assert_true (cogl_atlas_reserve_space (atlas,
+                                           page_width + 10, ENTRY_SIZE,
+                                           oversized));
+  g_assert_cmpint (cogl_texture_get_width (oversized->texture), ==,
+                   page_width + 10);
+  g_assert_cmpint (cogl_texture_get_height (oversized->texture), ==,
+                   ENTRY_SIZE);
+  g_assert_cmpuint (cogl_atlas_get_n_pages (atlas), ==, 2);
+
+  /* It is evicted like any other page once it is not used anymore */
+  for (i = 2; i < N_ENTRIES && !oversized->evicted; i++)
+    {
+      g_assert_true (cogl_atlas_reserve_space (atlas,
+                                               ENTRY_SIZE, ENTRY_SIZE,
+                                               &state->entries[i]));
+      g_assert_cmpuint (cogl_atlas_get_n_pages (atlas), <=, MAX_PAGES);
+    }
+
+  g_assert_true (oversized->evicted);
+}
+
+static void
+test_atlas_pages_pinned (void)
+{
+  g_autofree TestState *state = g_new0 (TestState, 1);
+  g_autoptr (CoglAtlas) atlas = NULL;
+  int max_entries_per_page;
+  int n_pinned_entries;
+  int i;
+
+  atlas = create_atlas (state);
+
+  g_assert_true (cogl_atlas_reserve_space (atlas,
+                                           ENTRY_SIZE, ENTRY_SIZE,
+                                           &state->entries[0]));
+  max_entries_per_page =
+    cogl_texture_get_width (state->entries[0].texture) *
+    cogl_texture_get_height (state->entries[0].texture) /
+    (ENTRY_SIZE * ENTRY_SIZE);
+
+  /* More than what fits in the maximum number of pages */
+  n_pinned_entries = MAX_PAGES * max_entries_per_page + 1;
+  g_assert_cmpint (n_pinned_entries, <, N_ENTRIES);
+
+  cogl_atlas_pin_used_pages (atlas);
+
+  cogl_atlas_mark_used (atlas, state->entries[0].texture);
+
+  for (i = 1; i < n_pinned_entries; i++)
+    {
+      g_assert_true (cogl_atlas_reserve_space (atlas,
+                                               ENTRY_SIZE, ENTRY_SIZE,
+                                               &state->entries[i]));
+    }
+
+  /* Nothing used while pinned is evicted, the atlas grows instead */
+  g_assert_cmpint (state->n_evicted, ==, 0);
+  g_assert_cmpuint (cogl_atlas_get_n_pages (atlas), >, MAX_PAGES);
+
+  cogl_atlas_unpin_pages (atlas);
+
+  /* Once unpinned, the atlas shrinks back on the next eviction */
+  for (i = n_pinned_entries; i < N_ENTRIES && state->n_evicted == 0; i++)
+    {
+      g_assert_true (cogl_atlas_reserve_space (atlas,
+                                               ENTRY_SIZE, ENTRY_SIZE,
+                                               &state->entries[i]));
+    }
+
+  g_assert_cmpint (state->n_evicted, >, 0);
+  g_assert_cmpuint (cogl_atlas_get_n_pages (atlas), ==, MAX_PAGES);
+}
+
+COGL_TEST_SUITE (
+  g_test_add_func ("/atlas/pages", test_atlas_pages);
+  g_test_add_func ("/atlas/pages/oversized", test_atlas_pages_oversized);
+  g_test_add_func ("/atlas/pages/pinned", test_atlas_pages_pinned);
+)
@@ -0,0 +1,188 @@
+#include <cogl/cogl.h>
+
+#include <string.h>
+
+#include "tests/cogl-test-utils.h"
+
+#define TEXTURE_SIZE 256
+#define SOURCE_SIZE 128
+#define SOURCE_X 16
+#define SOURCE_Y 8
+
+static const MtkRectangle test_rects[] = {
+  /* Two vertically adjacent rectangles that can be merged into one upload */
+  { 0, 0, 16, 16 },
+  { 0, 16, 16, 16 },
+  /* Far away from everything else */
+  { 100, 4, 20, 10 },
+  { 40, 60, 30, 40 },
+  /* Touching the bottom right edge of the source */
+  { 110, 110, 18, 18 },
+  /* Overlapping a previous rectangle */
+  { 50, 70, 40, 8 },
+};
+
+static void
+fill_pixel (uint8_t *p,
+            int      x,
+            int      y)
+{
+  p[0] = x;
+  p[1] = y;
+  p[2] = 128;
+  p[3] = x ^ y;
+}
+
+static gboolean
+is_in_test_rects (int x,
+                  int y)
+{
+  int i;
+
+  for (i = 0; i < G_N_ELEMENTS (test_rects); i++)
+    {
+      const MtkRectangle *rect = &test_rects[i];
+
+      if (x >= rect->x && x < rect->x + rect->width &&
+          y >= rect->y && y < rect->y + rect->height)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+static void
+check_texture (TestUtilsTextureFlags      flags,
+               CoglTextureSetRegionsFlags set_regions_flags)
+{
+  g_autoptr (GError) error = NULL;
+  CoglTexture *tex;
+  CoglBitmap *bmp;
+  uint8_t *data, *p;
+  int x, y;
+
+  p = data = g_malloc (TEXTURE_SIZE * TEXTURE_SIZE * 4);
+  for (y = 0; y < TEXTURE_SIZE; y++)
+    for (x = 0; x < TEXTURE_SIZE; x++, p += 4)
+      fill_pixel (p, x, y);
+
+  bmp = cogl_bitmap_new_for_data (test_ctx,
+                                  TEXTURE_SIZE, TEXTURE_SIZE,
+                                  COGL_PIXEL_FORMAT_RGBA_8888,
+                                  TEXTURE_SIZE * 4,
+                                  data);
+  tex = test_utils_texture_new_from_bitmap (bmp, flags, FALSE);
+  g_object_unref (bmp);
+
+  /* The source mirrors the texture contents at its offset, with the
+   * pixels covered by the rectangles negated. Pixels between
+   * rectangles that are merged into one upload thus stay unchanged. */
+  p = data;
+  for (y = 0; y < SOURCE_SIZE; y++)
+    for (x = 0; x < SOURCE_SIZE; x++, p += 4)
+      {
+        fill_pixel (p, SOURCE_X + x, SOURCE_Y + y);
+
+        if (is_in_test_rects (x, y))
+          {
+            p[0] = ~p[0];
+            p[1] = ~p[1];
+            p[2] = ~p[2];
+            p[3] = ~p[3];
+          }
+      }
+
+  g_assert_true (cogl_texture_set_regions (tex,
+                                           SOURCE_SIZE, SOURCE_SIZE,
+                                           COGL_PIXEL_FORMAT_RGBA_8888,
+                                           SOURCE_SIZE * 4,
+                                           data,
+                                           SOURCE_X, SOURCE_Y,
+                                           test_rects,
+                                           G_N_ELEMENTS (test_rects),
+                                           set_regions_flags,
+                                           &error));
+  g_assert_no_error (error);
+
+  memset (data, 0, TEXTURE_SIZE * TEXTURE_SIZE * 4);
+  cogl_texture_get_data (tex, COGL_PIXEL_FORMAT_RGBA_8888,
+                         TEXTURE_SIZE * 4, data);
+
+  p = data;
+  for (y = 0; y < TEXTURE_SIZE; y++)
+    for (x = 0; x < TEXTURE_SIZE; x++, p += 4)
+      {
+        uint8_t expected[4];
+
+        fill_pixel (expected, x, y);
+
+        if (is_in_test_rects (x - SOURCE_X, y - SOURCE_Y))
+          {
+            g_assert_cmpint (p[0], ==, ~expected[0] & 0xff);
+            g_assert_cmpint (p[1], ==, ~expected[1] & 0xff);
+            g_assert_cmpint (p[2], ==, ~expected[2] & 0xff);
+            g_assert_cmpint (p[3], ==, ~expected[3] & 0xff);
+          }
+        else
+          {
+            g_assert_cmpint (p[0], ==, expected[0]);
+            g_assert_cmpint (p[1], ==, expected[1]);
+            g_assert_cmpint (p[2], ==, expected[2]);
+            g_assert_cmpint (p[3], ==, expected[3]);
+          }
+      }
+
+  g_object_unref (tex);
+  g_free (data);
+}
+
+static void
+test_texture_set_regions (void)
+{
+  /* A plain 2D texture takes the batched driver path */
+  check_texture (TEST_UTILS_TEXTURE_NO_ATLAS,
+                 COGL_TEXTURE_SET_REGIONS_FLAG_NONE);
+  check_texture (TEST_UTILS_TEXTURE_NO_ATLAS,
+                 COGL_TEXTURE_SET_REGIONS_FLAG_ALLOW_MERGE);
+  /* Atlased textures fall back to one set_region per rectangle */
+  check_texture (TEST_UTILS_TEXTURE_NONE,
+                 COGL_TEXTURE_SET_REGIONS_FLAG_ALLOW_MERGE);
+}
+
+static void
+test_texture_set_regions_out_of_bounds (void)
+{
+  static const MtkRectangle rects[] = {
+    { 0, 0, 16, 16 },
+    { SOURCE_SIZE - 8, 0, 16, 16 },
+  };
+  g_autoptr (GError) error = NULL;
+  g_autofree uint8_t *data = NULL;
+  CoglTexture *tex;
+
+  data = g_malloc0 (SOURCE_SIZE * SOURCE_SIZE * 4);
+  tex = test_utils_texture_new_with_size (test_ctx,
+                                          TEXTURE_SIZE, TEXTURE_SIZE,
+                                          TEST_UTILS_TEXTURE_NO_ATLAS,
+                                          COGL_TEXTURE_COMPONENTS_RGBA);
+
+  g_assert_false (cogl_texture_set_regions (tex,
+                                            SOURCE_SIZE, SOURCE_SIZE,
+                                            COGL_PIXEL_FORMAT_RGBA_8888,
+                                            SOURCE_SIZE * 4,
+                                            data,
+                                            0, 0,
+                                            rects,
+                                            G_N_ELEMENTS (rects),
+                                            COGL_TEXTURE_SET_REGIONS_FLAG_NONE,
+                                            &error));
+  g_assert_error (error, COGL_TEXTURE_ERROR, COGL_TEXTURE_ERROR_BAD_PARAMETER);
+
+  g_object_unref (tex);
+}
+
+COGL_TEST_SUITE (
+  g_test_add_func ("/texture/set-regions", test_texture_set_regions);
+  g_test_add_func ("/texture/set-regions/out-of-bounds",
+                   test_texture_set_regions_out_of_bounds);
+)
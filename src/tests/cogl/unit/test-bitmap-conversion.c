@@ -0,0 +1,219 @@
+#include "config.h"
+
+#include "cogl/cogl.h"
+#include "cogl/cogl-bitmap-private.h"
+#include "cogl/cogl-debug.h"
+#include "tests/cogl-test-utils.h"
+
+/* Not a multiple of any SIMD block size, so the generic code has to
+ * pick up where the SIMD kernels leave off */
+#define WIDTH 67
+#define HEIGHT 5
+#define PADDING 12
+
+static const CoglPixelFormat formats[] = {
+  COGL_PIXEL_FORMAT_RGBA_8888,
+  COGL_PIXEL_FORMAT_BGRA_8888,
+  COGL_PIXEL_FORMAT_ARGB_8888,
+  COGL_PIXEL_FORMAT_ABGR_8888,
+  COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+  COGL_PIXEL_FORMAT_BGRA_8888_PRE,
+  COGL_PIXEL_FORMAT_ARGB_8888_PRE,
+  COGL_PIXEL_FORMAT_ABGR_8888_PRE,
+  COGL_PIXEL_FORMAT_RGBX_8888,
+  COGL_PIXEL_FORMAT_BGRX_8888,
+  COGL_PIXEL_FORMAT_XRGB_8888,
+  COGL_PIXEL_FORMAT_XBGR_8888,
+  COGL_PIXEL_FORMAT_RGBA_FP_16161616,
+  COGL_PIXEL_FORMAT_BGRA_FP_16161616,
+  COGL_PIXEL_FORMAT_ARGB_FP_16161616,
+  COGL_PIXEL_FORMAT_ABGR_FP_16161616,
+  COGL_PIXEL_FORMAT_RGBA_FP_16161616_PRE,
+  COGL_PIXEL_FORMAT_XRGB_FP_16161616,
+  COGL_PIXEL_FORMAT_RGB_888,
+};
+
+static uint8_t *
+create_source_data (CoglPixelFormat  format,
+                    GRand           *rand,
+                    int             *rowstride_out)
+{
+  int bpp = cogl_pixel_format_get_bytes_per_pixel (format, 0);
+  int rowstride = WIDTH * bpp + PADDING;
+  uint8_t *data;
+  int x, y, i;
+
+  data = g_malloc (rowstride * HEIGHT);
+
+  for (y = 0; y < HEIGHT; y++)
+    {
+      uint8_t *p = data + y * rowstride;
+
+      for (x = 0; x < WIDTH; x++, p += bpp)
+        {
+          if (bpp == 8)
+            {
+              uint16_t *p16 = (uint16_t *) p;
+
+              /* Mostly values in [0, 1], but also out of range ones,
+               * infinities and NaNs */
+              for (i = 0; i < 4; i++)
+                {
+                  if (g_rand_int_range (rand, 0, 4) == 0)
+                    p16[i] = g_rand_int_range (rand, 0, 0x10000);
+                  else
+                    p16[i] = g_rand_int_range (rand, 0, 0x3c01);
+                }
+            }
+          else
+            {
+              for (i = 0; i < bpp; i++)
+                p[i] = g_rand_int_range (rand, 0, 256);
+
+              /* Make sure fully transparent and opaque pixels show up
+               * wherever the alpha component ends up being */
+              if (x % 7 == 0)
+                memset (p, 0, bpp);
+              else if (x % 7 == 1)
+                memset (p, 0xff, bpp);
+            }
+        }
+    }
+
+  *rowstride_out = rowstride;
+  return data;
+}
+
+static uint8_t *
+convert (CoglPixelFormat  src_format,
+         uint8_t         *src_data,
+         int              src_rowstride,
+         CoglPixelFormat  dst_format,
+         gboolean         disable_simd)
+{
+  g_autoptr (GError) error = NULL;
+  g_autoptr (CoglBitmap) src_bmp = NULL;
+  g_autoptr (CoglBitmap) dst_bmp = NULL;
+  int dst_rowstride;
+  uint8_t *dst_data;
+
+  dst_rowstride =
+    WIDTH * cogl_pixel_format_get_bytes_per_pixel (dst_format, 0) + PADDING;
+  dst_data = g_malloc0 (dst_rowstride * HEIGHT);
+
+  src_bmp = cogl_bitmap_new_for_data (test_ctx, WIDTH, HEIGHT,
+                                      src_format, src_rowstride, src_data);
+  dst_bmp = cogl_bitmap_new_for_data (test_ctx, WIDTH, HEIGHT,
+                                      dst_format, dst_rowstride, dst_data);
+
+  if (disable_simd)
+    COGL_DEBUG_SET_FLAG (COGL_DEBUG_DISABLE_SIMD_CONVERSION);
+  else
+    COGL_DEBUG_CLEAR_FLAG (COGL_DEBUG_DISABLE_SIMD_CONVERSION);
+
+  g_assert_true (_cogl_bitmap_convert_into_bitmap (src_bmp, dst_bmp, &error));
+  g_assert_no_error (error);
+
+  COGL_DEBUG_CLEAR_FLAG (COGL_DEBUG_DISABLE_SIMD_CONVERSION);
+
+  return dst_data;
+}
+
+static void
+test_bitmap_conversion (void)
+{
+  g_autoptr (GRand) rand = g_rand_new_with_seed (0x1234);
+  int i, j;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++)
+    {
+      g_autofree uint8_t *src_data = NULL;
+      int src_rowstride;
+
+      src_data = create_source_data (formats[i], rand, &src_rowstride);
+
+      for (j = 0; j < G_N_ELEMENTS (formats); j++)
+        {
+          g_autofree uint8_t *generic = NULL;
+          g_autofree uint8_t *simd = NULL;
+          int dst_rowstride;
+          int y;
+
+          if (i == j)
+            continue;
+
+          generic = convert (formats[i], src_data, src_rowstride,
+                             formats[j], TRUE);
+          simd = convert (formats[i], src_data, src_rowstride,
+                          formats[j], FALSE);
+
+          dst_rowstride =
+            WIDTH * cogl_pixel_format_get_bytes_per_pixel (formats[j], 0);
+
+          if (cogl_test_verbose ())
+            g_print ("%s -> %s\n",
+                     cogl_pixel_format_to_string (formats[i]),
+                     cogl_pixel_format_to_string (formats[j]));
+
+          for (y = 0; y < HEIGHT; y++)
+            {
+              g_assert_cmpmem (simd + y * (dst_rowstride + PADDING),
+                               dst_rowstride,
+                               generic + y * (dst_rowstride + PADDING),
+                               dst_rowstride);
+            }
+        }
+    }
+}
+
+static void
+check_premult (CoglPixelFormat format,
+               gboolean        premult)
+{
+  g_autoptr (GRand) rand = g_rand_new_with_seed (0x5678);
+  g_autofree uint8_t *generic = NULL;
+  g_autofree uint8_t *simd = NULL;
+  int rowstride;
+  int i;
+
+  generic = create_source_data (format, rand, &rowstride);
+  simd = g_memdup2 (generic, rowstride * HEIGHT);
+
+  for (i = 0; i < 2; i++)
+    {
+      g_autoptr (GError) error = NULL;
+      g_autoptr (CoglBitmap) bmp = NULL;
+      gboolean disable_simd = i == 0;
+
+      bmp = cogl_bitmap_new_for_data (test_ctx, WIDTH, HEIGHT, format,
+                                      rowstride,
+                                      disable_simd ? generic : simd);
+
+      if (disable_simd)
+        COGL_DEBUG_SET_FLAG (COGL_DEBUG_DISABLE_SIMD_CONVERSION);
+
+      if (premult)
+        g_assert_true (_cogl_bitmap_premult (bmp, &error));
+      else
+        g_assert_true (_cogl_bitmap_unpremult (bmp, &error));
+      g_assert_no_error (error);
+
+      COGL_DEBUG_CLEAR_FLAG (COGL_DEBUG_DISABLE_SIMD_CONVERSION);
+    }
+
+  g_assert_cmpmem (simd, rowstride * HEIGHT, generic, rowstride * HEIGHT);
+}
+
+static void
+test_bitmap_premult (void)
+{
+  check_premult (COGL_PIXEL_FORMAT_RGBA_8888, TRUE);
+  check_premult (COGL_PIXEL_FORMAT_ARGB_8888, TRUE);
+  check_premult (COGL_PIXEL_FORMAT_RGBA_8888_PRE, FALSE);
+  check_premult (COGL_PIXEL_FORMAT_ARGB_8888_PRE, FALSE);
+}
+
+COGL_TEST_SUITE (
+  g_test_add_func ("/bitmap/conversion/simd", test_bitmap_conversion);
+  g_test_add_func ("/bitmap/premult/simd", test_bitmap_premult);
+)
@@ -0,0 +1,290 @@
+#include "config.h"
+
+#include "cogl/cogl.h"
+#include "cogl/cogl-context-private.h"
+#include "cogl/cogl-offscreen-pool-private.h"
+#include "cogl/cogl-texture-2d-private.h"
+#include "cogl/cogl-texture-private.h"
+#include "tests/cogl-test-utils.h"
+
+#define WIDTH 64
+#define HEIGHT 32
+
+static void
+get_stats (CoglOffscreenPoolStats *stats)
+{
+  cogl_offscreen_pool_get_stats (test_ctx->offscreen_pool, stats);
+}
+
+static void
+empty_pool (void)
+{
+  cogl_offscreen_pool_trim (test_ctx->offscreen_pool, G_MAXINT64);
+}
+
+static CoglOffscreen *
+acquire (int width,
+         int height)
+{
+  g_autoptr (GError) error = NULL;
+  CoglOffscreen *offscreen;
+  CoglTexture *texture;
+
+  offscreen = cogl_offscreen_new_pooled (test_ctx,
+                                         COGL_PIXEL_FORMAT_ANY,
+                                         width, height,
+                                         &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (offscreen);
+
+  texture = cogl_offscreen_get_texture (offscreen);
+  g_assert_cmpint (cogl_texture_get_width (texture), ==, width);
+  g_assert_cmpint (cogl_texture_get_height (texture), ==, height);
+
+  return offscreen;
+}
+
+static void
+check_reuse (void)
+{
+  CoglOffscreenPoolStats before, after;
+  CoglOffscreen *offscreen;
+  CoglOffscreen *other;
+
+  empty_pool ();
+  get_stats (&before);
+
+  offscreen = acquire (WIDTH, HEIGHT);
+  cogl_offscreen_release (offscreen);
+
+  /* Same size, same offscreen */
+  g_assert_true (acquire (WIDTH, HEIGHT) == offscreen);
+
+  /* Other sizes never get it */
+  other = acquire (WIDTH, HEIGHT * 2);
+  g_assert_true (other != offscreen);
+
+  cogl_offscreen_release (other);
+  cogl_offscreen_release (offscreen);
+
+  get_stats (&after);
+  g_assert_cmpuint (after.n_allocated - before.n_allocated, ==, 2);
+  g_assert_cmpuint (after.n_reused - before.n_reused, ==, 1);
+  g_assert_cmpuint (after.n_pooled, ==, 2);
+
+  empty_pool ();
+}
+
+static void
+check_pending_drawing (void)
+{
+  g_autoptr (CoglPipeline) pipeline = NULL;
+  CoglOffscreen *offscreen;
+  CoglColor color;
+
+  empty_pool ();
+
+  /* Fill an offscreen with red and draw it onto the test framebuffer */
+  offscreen = acquire (WIDTH, HEIGHT);
+  cogl_color_init_from_4f (&color, 1.0f, 0.0f, 0.0f, 1.0f);
+  cogl_framebuffer_clear (COGL_FRAMEBUFFER (offscreen),
+                          COGL_BUFFER_BIT_COLOR, &color);
+
+  pipeline = cogl_pipeline_new (test_ctx);
+  cogl_pipeline_set_layer_texture (pipeline, 0,
+                                   cogl_offscreen_get_texture (offscreen));
+  cogl_framebuffer_orthographic (test_fb, 0, 0,
+                                 cogl_framebuffer_get_width (test_fb),
+                                 cogl_framebuffer_get_height (test_fb),
+                                 -1, 1);
+  cogl_framebuffer_draw_rectangle (test_fb, pipeline, 0, 0, WIDTH, HEIGHT);
+  g_clear_object (&pipeline);
+
+  /* The drawing is still pending when the offscreen is handed out again,
+   * so it must still see the red contents rather than the new ones */
+  cogl_offscreen_release (offscreen);
+  g_assert_true (acquire (WIDTH, HEIGHT) == offscreen);
+
+  cogl_color_init_from_4f (&color, 0.0f, 1.0f, 0.0f, 1.0f);
+  cogl_framebuffer_clear (COGL_FRAMEBUFFER (offscreen),
+                          COGL_BUFFER_BIT_COLOR, &color);
+
+  test_utils_check_pixel (test_fb, WIDTH / 2, HEIGHT / 2, 0xff0000ff);
+
+  cogl_offscreen_release (offscreen);
+  empty_pool ();
+}
+
+static void
+check_double_release (void)
+{
+  CoglOffscreenPoolStats stats;
+  CoglOffscreen *offscreen;
+
+  empty_pool ();
+
+  offscreen = acquire (WIDTH, HEIGHT);
+  cogl_offscreen_release (offscreen);
+
+  /* Releasing an offscreen that is already back in the pool must not
+   * put it in there twice */
+  g_test_expect_message (G_LOG_DOMAIN, G_LOG_LEVEL_CRITICAL,
+                         "cogl_offscreen_pool_release: "
+                         "assertion 'item->checked_out' failed");
+  cogl_offscreen_release (offscreen);
+  g_test_assert_expected_messages ();
+
+  get_stats (&stats);
+  g_assert_cmpuint (stats.n_pooled, ==, 1);
+
+  empty_pool ();
+}
+
+static void
+check_invalid_size (void)
+{
+  g_autoptr (GError) error = NULL;
+  CoglOffscreen *offscreen;
+
+  offscreen = cogl_offscreen_new_pooled (test_ctx,
+                                         COGL_PIXEL_FORMAT_ANY,
+                                         0, HEIGHT,
+                                         &error);
+  g_assert_null (offscreen);
+  g_assert_error (error, COGL_TEXTURE_ERROR, COGL_TEXTURE_ERROR_SIZE);
+}
+
+static void
+check_budget (void)
+{
+  CoglOffscreenPoolStats before, after;
+  CoglOffscreen *first;
+  CoglOffscreen *second;
+
+  empty_pool ();
+  get_stats (&before);
+
+  cogl_offscreen_pool_set_budget (test_ctx->offscreen_pool,
+                                  WIDTH * HEIGHT * 4);
+
+  first = acquire (WIDTH, HEIGHT);
+  second = acquire (WIDTH, HEIGHT);
+  cogl_offscreen_release (first);
+  cogl_offscreen_release (second);
+
+  /* Only the most recently released one fits */
+  get_stats (&after);
+  g_assert_cmpuint (after.n_evicted - before.n_evicted, ==, 1);
+  g_assert_cmpuint (after.n_pooled, ==, 1);
+  g_assert_cmpuint (after.pooled_bytes, ==, WIDTH * HEIGHT * 4);
+
+  /* Offscreens larger than the whole budget aren't kept at all */
+  cogl_offscreen_release (acquire (WIDTH * 2, HEIGHT));
+
+  get_stats (&after);
+  g_assert_cmpuint (after.n_pooled, ==, 1);
+
+  cogl_offscreen_pool_set_budget (test_ctx->offscreen_pool, 0);
+  get_stats (&after);
+  g_assert_cmpuint (after.n_pooled, ==, 0);
+  g_assert_cmpuint (after.pooled_bytes, ==, 0);
+
+  cogl_offscreen_pool_set_budget (test_ctx->offscreen_pool,
+                                  64 * 1024 * 1024);
+}
+
+static void
+check_trim (void)
+{
+  CoglOffscreenPoolStats stats;
+
+  empty_pool ();
+
+  cogl_offscreen_release (acquire (WIDTH, HEIGHT));
+  cogl_offscreen_release (acquire (HEIGHT, WIDTH));
+
+  /* Recently released offscreens are kept */
+  cogl_offscreen_pool_trim (test_ctx->offscreen_pool, g_get_monotonic_time ());
+  get_stats (&stats);
+  g_assert_cmpuint (stats.n_pooled, ==, 2);
+
+  /* Old ones aren't */
+  cogl_offscreen_pool_trim (test_ctx->offscreen_pool,
+                            g_get_monotonic_time () + 60 * G_USEC_PER_SEC);
+  get_stats (&stats);
+  g_assert_cmpuint (stats.n_pooled, ==, 0);
+  g_assert_cmpuint (stats.pooled_bytes, ==, 0);
+}
+
+static void
+check_state_reset (void)
+{
+  CoglFramebuffer *framebuffer;
+  CoglOffscreen *offscreen;
+  graphene_matrix_t matrix;
+
+  empty_pool ();
+
+  offscreen = acquire (WIDTH, HEIGHT);
+  framebuffer = COGL_FRAMEBUFFER (offscreen);
+  cogl_framebuffer_set_viewport (framebuffer, 1, 2, 3, 4);
+  cogl_framebuffer_orthographic (framebuffer, 0, 0, WIDTH, HEIGHT, -1, 1);
+  cogl_framebuffer_translate (framebuffer, 10, 20, 0);
+  cogl_offscreen_release (offscreen);
+
+  g_assert_true (acquire (WIDTH, HEIGHT) == offscreen);
+
+  g_assert_cmpfloat (cogl_framebuffer_get_viewport_x (framebuffer), ==, 0);
+  g_assert_cmpfloat (cogl_framebuffer_get_viewport_y (framebuffer), ==, 0);
+  g_assert_cmpfloat (cogl_framebuffer_get_viewport_width (framebuffer),
+                     ==, WIDTH);
+  g_assert_cmpfloat (cogl_framebuffer_get_viewport_height (framebuffer),
+                     ==, HEIGHT);
+
+  cogl_framebuffer_get_modelview_matrix (framebuffer, &matrix);
+  g_assert_true (graphene_matrix_is_identity (&matrix));
+  cogl_framebuffer_get_projection_matrix (framebuffer, &matrix);
+  g_assert_true (graphene_matrix_is_identity (&matrix));
+
+  cogl_offscreen_release (offscreen);
+  empty_pool ();
+}
+
+static void
+check_texture_state_reset (void)
+{
+  CoglOffscreen *offscreen;
+  CoglTexture *texture;
+  CoglTexture2D *tex_2d;
+
+  empty_pool ();
+
+  offscreen = acquire (WIDTH, HEIGHT);
+  texture = cogl_offscreen_get_texture (offscreen);
+  tex_2d = COGL_TEXTURE_2D (texture);
+  cogl_texture_2d_set_auto_mipmap (tex_2d, FALSE);
+  cogl_texture_set_max_level (texture, 0);
+  cogl_offscreen_release (offscreen);
+
+  g_assert_true (acquire (WIDTH, HEIGHT) == offscreen);
+
+  g_assert_true (tex_2d->auto_mipmap);
+  g_assert_true (tex_2d->mipmaps_dirty);
+  g_assert_cmpint (_cogl_texture_get_n_levels (texture), >, 1);
+  g_assert_true (cogl_texture_get_premultiplied (texture));
+
+  cogl_offscreen_release (offscreen);
+  empty_pool ();
+}
+
+COGL_TEST_SUITE (
+  g_test_add_func ("/offscreen-pool/reuse", check_reuse);
+  g_test_add_func ("/offscreen-pool/pending-drawing", check_pending_drawing);
+  g_test_add_func ("/offscreen-pool/double-release", check_double_release);
+  g_test_add_func ("/offscreen-pool/invalid-size", check_invalid_size);
+  g_test_add_func ("/offscreen-pool/budget", check_budget);
+  g_test_add_func ("/offscreen-pool/trim", check_trim);
+  g_test_add_func ("/offscreen-pool/state-reset", check_state_reset);
+  g_test_add_func ("/offscreen-pool/texture-state-reset",
+                   check_texture_state_reset);
+)
@@ -18,8 +18,16 @@
 
 #include "config.h"
 
+#include <gio/gunixfdlist.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "backends/meta-backend-private.h"
+#include "core/meta-window-snapshot.h"
+#include "core/window-private.h"
 #include "meta-test/meta-context-test.h"
+#include "tests/meta-test-utils.h"
 
 static MetaContext *test_context;
 
@@ -88,6 +96,217 @@ meta_test_debug_control_inhibit_hw_cursor (void)
   g_assert_false (meta_backend_is_hw_cursors_inhibited (backend));
 }
 
+static void
+get_window_snapshot_cb (GObject      *source_object,
+                        GAsyncResult *res,
+                        gpointer      user_data)
+{
+  g_autoptr (GError) error = NULL;
+  g_autoptr (GVariant) ret = NULL;
+  g_autoptr (GUnixFDList) fd_list = NULL;
+  int *fd = user_data;
+  int fd_idx;
+
+  ret = g_dbus_proxy_call_with_unix_fd_list_finish (G_DBUS_PROXY (source_object),
+                                                    &fd_list,
+                                                    res,
+                                                    &error);
+  g_assert_no_error (error);
+
+  g_variant_get (ret, "(h)", &fd_idx);
+  *fd = g_unix_fd_list_get (fd_list, fd_idx, &error);
+  g_assert_no_error (error);
+}
+
+static int
+get_window_snapshot_via_dbus (GDBusProxy *proxy)
+{
+  int fd = -1;
+
+  g_dbus_proxy_call_with_unix_fd_list (proxy,
+                                       "GetWindowSnapshot",
+                                       NULL,
+                                       G_DBUS_CALL_FLAGS_NO_AUTO_START,
+                                       -1,
+                                       NULL,
+                                       NULL,
+                                       &get_window_snapshot_cb,
+                                       &fd);
+  while (fd == -1)
+    g_main_context_iteration (NULL, TRUE);
+
+  return fd;
+}
+
+static uint32_t
+read_window_snapshot (const MetaWindowSnapshotHeader *header,
+                      GArray                         *entries)
+{
+  while (TRUE)
+    {
+      uint32_t sequence;
+
+      sequence = g_atomic_int_get ((int *) &header->sequence);
+      if (sequence % 2)
+        continue;
+
+      g_array_set_size (entries, header->n_entries);
+      memcpy (entries->data,
+              (const uint8_t *) header + header->header_size,
+              entries->len * header->entry_size);
+
+      if (g_atomic_int_get ((int *) &header->sequence) == sequence)
+        return sequence;
+    }
+}
+
+static const MetaWindowSnapshotEntry *
+find_snapshot_entry (GArray     *entries,
+                     MetaWindow *window)
+{
+  int i;
+
+  for (i = 0; i < entries->len; i++)
+    {
+      const MetaWindowSnapshotEntry *entry =
+        &g_array_index (entries, MetaWindowSnapshotEntry, i);
+
+      if (entry->id == meta_window_get_id (window))
+        return entry;
+    }
+
+  return NULL;
+}
+
+static gboolean
+snapshot_entry_matches (const MetaWindowSnapshotEntry *entry,
+                        MetaWindow                    *window)
+{
+  MtkRectangle frame_rect;
+
+  meta_window_get_frame_rect (window, &frame_rect);
+
+  return (entry &&
+          entry->pid == meta_window_get_pid (window) &&
+          entry->x == frame_rect.x &&
+          entry->y == frame_rect.y &&
+          entry->width == frame_rect.width &&
+          entry->height == frame_rect.height &&
+          !!(entry->flags & META_WINDOW_SNAPSHOT_FLAG_FOCUSED) ==
+          meta_window_appears_focused (window));
+}
+
+static void
+wait_for_snapshot_of (const MetaWindowSnapshotHeader *header,
+                      GArray                         *entries,
+                      MetaWindow                     *window)
+{
+  while (TRUE)
+    {
+      read_window_snapshot (header, entries);
+      if (snapshot_entry_matches (find_snapshot_entry (entries, window),
+                                  window))
+        break;
+
+      g_main_context_iteration (NULL, TRUE);
+    }
+}
+
+static void
+meta_test_debug_control_window_snapshot (void)
+{
+  g_autoptr (GError) error = NULL;
+  g_autoptr (GDBusProxy) proxy = NULL;
+  g_autoptr (GArray) entries = NULL;
+  const MetaWindowSnapshotHeader *header;
+  const MetaWindowSnapshotEntry *entry1;
+  const MetaWindowSnapshotEntry *entry2;
+  MetaTestClient *test_client;
+  MetaWindow *window1;
+  MetaWindow *window2;
+  struct stat stat_buf;
+  void *map;
+  uint32_t sequence;
+  int fd;
+
+  test_client = meta_test_client_new (test_context,
+                                      "window-snapshot",
+                                      META_WINDOW_CLIENT_TYPE_WAYLAND,
+                                      &error);
+  g_assert_no_error (error);
+
+  if (!meta_test_client_do (test_client, &error, "create", "1", NULL) ||
+      !meta_test_client_do (test_client, &error, "show", "1", NULL) ||
+      !meta_test_client_do (test_client, &error, "create", "2", NULL) ||
+      !meta_test_client_do (test_client, &error, "show", "2", NULL) ||
+      !meta_test_client_wait (test_client, &error))
+    g_error ("Failed to create windows: %s", error->message);
+
+  window1 = meta_test_client_find_window (test_client, "1", &error);
+  g_assert_no_error (error);
+  window2 = meta_test_client_find_window (test_client, "2", &error);
+  g_assert_no_error (error);
+
+  proxy = g_dbus_proxy_new_for_bus_sync (G_BUS_TYPE_SESSION,
+                                         G_DBUS_PROXY_FLAGS_DO_NOT_AUTO_START,
+                                         NULL,
+                                         "org.gnome.Mutter.DebugControl",
+                                         "/org/gnome/Mutter/DebugControl",
+                                         "org.gnome.Mutter.DebugControl",
+                                         NULL,
+                                         &error);
+  g_assert_no_error (error);
+
+  fd = get_window_snapshot_via_dbus (proxy);
+  g_assert_cmpint (fstat (fd, &stat_buf), ==, 0);
+
+  /* It can only be read */
+  map = mmap (NULL, stat_buf.st_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+              fd, 0);
+  g_assert_true (map == MAP_FAILED);
+
+  map = mmap (NULL, stat_buf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  g_assert_true (map != MAP_FAILED);
+  close (fd);
+
+  header = map;
+  g_assert_cmphex (header->magic, ==, META_WINDOW_SNAPSHOT_MAGIC);
+  g_assert_cmpuint (header->version, ==, META_WINDOW_SNAPSHOT_VERSION);
+  g_assert_cmpuint (header->entry_size, ==, sizeof (MetaWindowSnapshotEntry));
+
+  entries = g_array_new (FALSE, TRUE, sizeof (MetaWindowSnapshotEntry));
+  wait_for_snapshot_of (header, entries, window1);
+  wait_for_snapshot_of (header, entries, window2);
+
+  entry1 = find_snapshot_entry (entries, window1);
+  entry2 = find_snapshot_entry (entries, window2);
+  g_assert_cmpint (meta_window_stack_position_compare (window1, window2) < 0,
+                   ==,
+                   entry1->stacking_index < entry2->stacking_index);
+
+  /* Changes show up without asking again... */
+  meta_window_move_frame (window1, FALSE, 123, 45);
+  wait_for_snapshot_of (header, entries, window1);
+
+  /* ...and nothing changes when nothing happens */
+  meta_wait_for_update (test_context);
+  while (g_main_context_iteration (NULL, FALSE));
+  sequence = read_window_snapshot (header, entries);
+  g_usleep (50 * 1000);
+  while (g_main_context_iteration (NULL, FALSE));
+  g_assert_cmpuint (read_window_snapshot (header, entries), ==, sequence);
+
+  meta_test_client_destroy (test_client);
+  while (find_snapshot_entry (entries, window1) ||
+         find_snapshot_entry (entries, window2))
+    {
+      g_main_context_iteration (NULL, TRUE);
+      read_window_snapshot (header, entries);
+    }
+
+  munmap (map, stat_buf.st_size);
+}
+
 int
 main (int    argc,
       char **argv)
@@ -106,6 +325,8 @@ main (int    argc,
 
   g_test_add_func ("/debug-control/inhibit-hw-cursor",
                    meta_test_debug_control_inhibit_hw_cursor);
+  g_test_add_func ("/debug-control/window-snapshot",
+                   meta_test_debug_control_window_snapshot);
 
   return meta_context_test_run_tests (META_CONTEXT_TEST (context),
                                       META_TEST_RUN_FLAG_NONE);
@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2026 Red Hat Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include "backends/meta-backend-private.h"
+#include "backends/meta-idle-monitor-private.h"
+#include "core/meta-context-private.h"
+#include "tests/meta-test/meta-context-test.h"
+
+#define N_WATCHES 5000
+#define MIN_TIMEOUT_MS 20
+#define N_TIMEOUTS 200
+#define N_RESETS 100000
+
+typedef struct
+{
+  guint64 timeout_msec;
+  int n_fired;
+} WatchData;
+
+typedef struct
+{
+  WatchData watches[N_WATCHES];
+  guint ids[N_WATCHES];
+  int n_fired;
+  guint64 last_timeout_msec;
+  int n_user_active_fired;
+} IdleTest;
+
+static MetaContext *test_context;
+static IdleTest *current_test;
+
+static MetaIdleMonitor *
+get_idle_monitor (void)
+{
+  MetaBackend *backend = meta_context_get_backend (test_context);
+
+  return meta_backend_get_core_idle_monitor (backend);
+}
+
+static void
+idle_watch_cb (MetaIdleMonitor *monitor,
+               guint            watch_id,
+               gpointer         user_data)
+{
+  WatchData *watch = user_data;
+
+  g_assert_cmpint (meta_idle_monitor_get_idletime (monitor),
+                   >=, watch->timeout_msec);
+
+  /* Watches are due in the order of their timeouts */
+  g_assert_cmpuint (watch->timeout_msec, >=, current_test->last_timeout_msec);
+  current_test->last_timeout_msec = watch->timeout_msec;
+
+  watch->n_fired++;
+  current_test->n_fired++;
+}
+
+static void
+user_active_cb (MetaIdleMonitor *monitor,
+                guint            watch_id,
+                gpointer         user_data)
+{
+  IdleTest *test = user_data;
+
+  test->n_user_active_fired++;
+}
+
+static void
+add_watches (IdleTest        *test,
+             MetaIdleMonitor *monitor)
+{
+  int i;
+
+  for (i = 0; i < N_WATCHES; i++)
+    {
+      /* Many watches share a timeout, and they are added out of order */
+      test->watches[i].timeout_msec =
+        MIN_TIMEOUT_MS + (i * 7919) % N_TIMEOUTS;
+      test->ids[i] =
+        meta_idle_monitor_add_idle_watch (monitor,
+                                          test->watches[i].timeout_msec,
+                                          idle_watch_cb,
+                                          &test->watches[i],
+                                          NULL);
+      g_assert_cmpuint (test->ids[i], !=, 0);
+    }
+}
+
+static void
+wait_for_watches (IdleTest *test,
+                  int       n_watches)
+{
+  test->n_fired = 0;
+  test->last_timeout_msec = 0;
+
+  while (test->n_fired < n_watches)
+    g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+dispatch_pending (IdleTest *test)
+{
+  test->last_timeout_msec = 0;
+
+  while (g_main_context_iteration (NULL, FALSE));
+}
+
+static void
+assert_all_fired (IdleTest *test,
+                  int       n_times)
+{
+  int i;
+
+  for (i = 0; i < N_WATCHES; i++)
+    g_assert_cmpint (test->watches[i].n_fired, ==, n_times);
+}
+
+static void
+remove_watches (IdleTest        *test,
+                MetaIdleMonitor *monitor)
+{
+  int i;
+
+  for (i = 0; i < N_WATCHES; i++)
+    {
+      if (test->ids[i])
+        meta_idle_monitor_remove_watch (monitor, test->ids[i]);
+    }
+}
+
+static void
+meta_test_idle_monitor_many_watches (void)
+{
+  MetaIdleMonitor *monitor = get_idle_monitor ();
+  g_autofree IdleTest *test = g_new0 (IdleTest, 1);
+  int i;
+
+  current_test = test;
+
+  meta_idle_monitor_reset_idletime (monitor);
+  add_watches (test, monitor);
+
+  wait_for_watches (test, N_WATCHES);
+  assert_all_fired (test, 1);
+
+  /* Staying idle doesn't fire them again */
+  g_usleep ((MIN_TIMEOUT_MS + N_TIMEOUTS) * 1000);
+  dispatch_pending (test);
+  assert_all_fired (test, 1);
+
+  /* Activity does re-arm them, and each of them fires once more */
+  meta_idle_monitor_reset_idletime (monitor);
+  wait_for_watches (test, N_WATCHES);
+  assert_all_fired (test, 2);
+
+  /* A burst of activity, as from a high rate mouse, while some watches
+   * already fired */
+  meta_idle_monitor_reset_idletime (monitor);
+  g_usleep ((MIN_TIMEOUT_MS + N_TIMEOUTS / 2) * 1000);
+  dispatch_pending (test);
+
+  for (i = 0; i < N_RESETS; i++)
+    meta_idle_monitor_reset_idletime (monitor);
+
+  g_assert_cmpint (meta_idle_monitor_get_idletime (monitor), <, MIN_TIMEOUT_MS);
+
+  wait_for_watches (test, N_WATCHES);
+  for (i = 0; i < N_WATCHES; i++)
+    g_assert_cmpint (test->watches[i].n_fired, >=, 3);
+
+  remove_watches (test, monitor);
+  current_test = NULL;
+}
+
+static void
+meta_test_idle_monitor_add_remove (void)
+{
+  MetaIdleMonitor *monitor = get_idle_monitor ();
+  g_autofree IdleTest *test = g_new0 (IdleTest, 1);
+  WatchData late_watch = { 0, };
+  guint late_watch_id;
+  int n_removed = 0;
+  int i;
+
+  current_test = test;
+
+  meta_idle_monitor_reset_idletime (monitor);
+  add_watches (test, monitor);
+
+  /* Removed watches never fire */
+  for (i = 0; i < N_WATCHES; i += 3)
+    {
+      meta_idle_monitor_remove_watch (monitor, test->ids[i]);
+      test->ids[i] = 0;
+      n_removed++;
+    }
+
+  wait_for_watches (test, N_WATCHES - n_removed);
+
+  for (i = 0; i < N_WATCHES; i++)
+    g_assert_cmpint (test->watches[i].n_fired, ==, test->ids[i] ? 1 : 0);
+
+  /* A watch for an idle time that already passed fires right away */
+  late_watch.timeout_msec = MIN_TIMEOUT_MS;
+  late_watch_id = meta_idle_monitor_add_idle_watch (monitor,
+                                                    late_watch.timeout_msec,
+                                                    idle_watch_cb,
+                                                    &late_watch,
+                                                    NULL);
+  wait_for_watches (test, 1);
+  g_assert_cmpint (late_watch.n_fired, ==, 1);
+
+  meta_idle_monitor_remove_watch (monitor, late_watch_id);
+  remove_watches (test, monitor);
+  current_test = NULL;
+}
+
+static void
+meta_test_idle_monitor_user_active (void)
+{
+  MetaIdleMonitor *monitor = get_idle_monitor ();
+  g_autofree IdleTest *test = g_new0 (IdleTest, 1);
+  int i;
+
+  for (i = 0; i < 10; i++)
+    {
+      meta_idle_monitor_add_user_active_watch (monitor,
+                                               user_active_cb,
+                                               test,
+                                               NULL);
+    }
+
+  meta_idle_monitor_reset_idletime (monitor);
+  g_assert_cmpint (test->n_user_active_fired, ==, 10);
+
+  /* They are one-shot */
+  meta_idle_monitor_reset_idletime (monitor);
+  g_assert_cmpint (test->n_user_active_fired, ==, 10);
+}
+
+static void
+init_tests (void)
+{
+  g_test_add_func ("/backends/idle-monitor/many-watches",
+                   meta_test_idle_monitor_many_watches);
+  g_test_add_func ("/backends/idle-monitor/add-remove",
+                   meta_test_idle_monitor_add_remove);
+  g_test_add_func ("/backends/idle-monitor/user-active",
+                   meta_test_idle_monitor_user_active);
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  g_autoptr (MetaContext) context = NULL;
+
+  context = meta_create_test_context (META_CONTEXT_TEST_TYPE_HEADLESS,
+                                      META_CONTEXT_TEST_FLAG_NO_X11);
+  g_assert (meta_context_configure (context, &argc, &argv, NULL));
+
+  test_context = context;
+
+  init_tests ();
+
+  return meta_context_test_run_tests (META_CONTEXT_TEST (context),
+                                      META_TEST_RUN_FLAG_NONE);
+}
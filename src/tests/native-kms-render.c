@@ -31,6 +31,7 @@
 #include "backends/native/meta-kms-device.h"
 #include "backends/native/meta-kms-device-private.h"
 #include "backends/native/meta-kms-impl-device-atomic.h"
+#include "backends/native/meta-kms-plane.h"
 #include "core/display-private.h"
 #include "meta/meta-backend.h"
 #include "meta-test/meta-context-test.h"
@@ -51,6 +52,11 @@ typedef struct
 
   gboolean wait_for_scanout;
 
+  struct {
+    uint32_t fb_id;
+    gboolean presented;
+  } overlay;
+
   struct {
     gboolean scanout_sabotaged;
     gboolean fallback_painted;
@@ -322,6 +328,164 @@ meta_test_kms_render_client_scanout (void)
   g_main_loop_unref (test.loop);
 }
 
+static void
+on_overlay_before_paint (ClutterStage     *stage,
+                         ClutterStageView *stage_view,
+                         ClutterFrame     *frame,
+                         KmsRenderingTest *test)
+{
+  MetaFrameNative *frame_native = meta_frame_native_from_frame (frame);
+  CoglScanout *scanout;
+  CoglScanoutBuffer *scanout_buffer;
+
+  g_assert_null (clutter_stage_view_peek_scanout (stage_view));
+
+  test->overlay.fb_id = 0;
+
+  scanout = meta_frame_native_get_overlay_scanout (frame_native);
+  if (!scanout)
+    return;
+
+  scanout_buffer = cogl_scanout_get_buffer (scanout);
+  g_assert_true (META_IS_DRM_BUFFER (scanout_buffer));
+  test->overlay.fb_id =
+    meta_drm_buffer_get_fb_id (META_DRM_BUFFER (scanout_buffer));
+  g_assert_cmpuint (test->overlay.fb_id, >, 0);
+}
+
+static void
+on_overlay_presented (ClutterStage     *stage,
+                      ClutterStageView *stage_view,
+                      ClutterFrameInfo *frame_info,
+                      KmsRenderingTest *test)
+{
+  MetaBackend *backend = meta_context_get_backend (test_context);
+  MetaBackendNative *backend_native = META_BACKEND_NATIVE (backend);
+  MetaDevicePool *device_pool;
+  CoglFramebuffer *fb;
+  MetaCrtc *crtc;
+  MetaKmsCrtc *kms_crtc;
+  MetaKmsPlane *kms_plane;
+  MetaKmsDevice *kms_device;
+  MetaDeviceFile *device_file;
+  GError *error = NULL;
+  drmModePlane *drm_plane;
+
+  if (test->overlay.fb_id == 0)
+    {
+      /* Keep painting until the client committed a buffer that fits. */
+      clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
+      return;
+    }
+
+  device_pool = meta_backend_native_get_device_pool (backend_native);
+
+  fb = clutter_stage_view_get_onscreen (stage_view);
+  crtc = meta_onscreen_native_get_crtc (META_ONSCREEN_NATIVE (fb));
+  kms_crtc = meta_crtc_kms_get_kms_crtc (META_CRTC_KMS (crtc));
+  kms_plane = meta_crtc_kms_get_assigned_overlay_plane (META_CRTC_KMS (crtc));
+  kms_device = meta_kms_crtc_get_device (kms_crtc);
+
+  device_file = meta_device_pool_open (device_pool,
+                                       meta_kms_device_get_path (kms_device),
+                                       META_DEVICE_FILE_FLAG_TAKE_CONTROL,
+                                       &error);
+  if (!device_file)
+    g_error ("Failed to open KMS device: %s", error->message);
+
+  drm_plane = drmModeGetPlane (meta_device_file_get_fd (device_file),
+                               meta_kms_plane_get_id (kms_plane));
+  g_assert_nonnull (drm_plane);
+  g_assert_cmpuint (drm_plane->fb_id, ==, test->overlay.fb_id);
+  g_assert_cmpuint (drm_plane->crtc_id, ==, meta_kms_crtc_get_id (kms_crtc));
+  drmModeFreePlane (drm_plane);
+
+  meta_device_file_release (device_file);
+
+  test->overlay.presented = TRUE;
+  g_main_loop_quit (test->loop);
+}
+
+static void
+meta_test_kms_render_client_overlay_scanout (void)
+{
+  MetaBackend *backend = meta_context_get_backend (test_context);
+  MetaWaylandCompositor *wayland_compositor =
+    meta_context_get_wayland_compositor (test_context);
+  ClutterStage *stage = CLUTTER_STAGE (meta_backend_get_stage (backend));
+  MetaKms *kms = meta_backend_native_get_kms (META_BACKEND_NATIVE (backend));
+  MetaKmsDevice *kms_device = meta_kms_get_devices (kms)->data;
+  ClutterStageView *stage_view;
+  MetaCrtc *crtc;
+  KmsRenderingTest test;
+  MetaWaylandTestClient *wayland_test_client;
+  g_autoptr (MetaWaylandTestDriver) test_driver = NULL;
+  gulong before_paint_handler_id;
+  gulong presented_handler_id;
+  MetaWindow *window;
+  MtkRectangle view_rect;
+
+  stage_view = clutter_stage_peek_stage_views (stage)->data;
+  crtc = meta_renderer_view_get_crtc (META_RENDERER_VIEW (stage_view));
+  if (!is_atomic_mode_setting (kms_device) ||
+      !meta_crtc_kms_get_assigned_overlay_plane (META_CRTC_KMS (crtc)))
+    {
+      g_test_skip ("No atomic overlay plane available");
+      return;
+    }
+
+  clutter_stage_view_get_layout (stage_view, &view_rect);
+
+  test_driver = meta_wayland_test_driver_new (wayland_compositor);
+  meta_wayland_test_driver_set_property (test_driver,
+                                         "gpu-path",
+                                         meta_kms_device_get_path (kms_device));
+
+  wayland_test_client =
+    meta_wayland_test_client_new (test_context, "dma-buf-scanout");
+  g_assert_nonnull (wayland_test_client);
+
+  test = (KmsRenderingTest) {
+    .loop = g_main_loop_new (NULL, FALSE),
+  };
+
+  window = meta_wait_for_client_window (test_context, "dma-buf-scanout-test");
+  meta_wait_for_window_shown (window);
+
+  g_debug ("Unmake fullscreen");
+  g_assert_true (meta_window_is_fullscreen (window));
+  meta_window_unmake_fullscreen (window);
+  meta_wayland_test_driver_wait_for_sync_point (test_driver,
+                                                SCANOUT_WINDOW_STATE_NONE);
+
+  g_debug ("Resizing to fit within the view");
+  meta_window_move_resize_frame (window, TRUE,
+                                 view_rect.x + view_rect.width / 4,
+                                 view_rect.y + view_rect.height / 4,
+                                 view_rect.width / 2,
+                                 view_rect.height / 2);
+  meta_wayland_test_driver_wait_for_sync_point (test_driver,
+                                                SCANOUT_WINDOW_STATE_NONE);
+
+  before_paint_handler_id =
+    g_signal_connect (stage, "before-paint",
+                      G_CALLBACK (on_overlay_before_paint), &test);
+  presented_handler_id =
+    g_signal_connect (stage, "presented",
+                      G_CALLBACK (on_overlay_presented), &test);
+
+  clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
+  g_main_loop_run (test.loop);
+  g_assert_true (test.overlay.presented);
+
+  g_signal_handler_disconnect (stage, before_paint_handler_id);
+  g_signal_handler_disconnect (stage, presented_handler_id);
+
+  meta_wayland_test_driver_emit_sync_event (test_driver, 0);
+  meta_wayland_test_client_finish (wayland_test_client);
+  g_main_loop_unref (test.loop);
+}
+
 static gboolean
 needs_repainted_guard (gpointer user_data)
 {
@@ -611,6 +775,8 @@ init_tests (void)
                    meta_test_kms_render_basic);
   g_test_add_func ("/backends/native/kms/render/client-scanout",
                    meta_test_kms_render_client_scanout);
+  g_test_add_func ("/backends/native/kms/render/client-overlay-scanout",
+                   meta_test_kms_render_client_overlay_scanout);
   g_test_add_func ("/backends/native/kms/render/client-scanout-fallback",
                    meta_test_kms_render_client_scanout_fallback);
   g_test_add_func ("/backends/native/kms/render/client-scanout-hotplug",
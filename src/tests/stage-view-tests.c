@@ -23,6 +23,7 @@
 #include "meta-test/meta-context-test.h"
 #include "meta/meta-window-actor.h"
 #include "tests/meta-backend-test.h"
+#include "tests/meta-crtc-test.h"
 #include "tests/meta-monitor-test-utils.h"
 #include "tests/meta-test-utils.h"
 #include "x11/meta-x11-display-private.h"
@@ -1317,6 +1318,109 @@ meta_test_timeline_actor_tree_clear (void)
   clutter_actor_destroy (container2);
 }
 
+static uint8_t *
+read_onscreen_pixels (ClutterStageView *view)
+{
+  CoglFramebuffer *onscreen = clutter_stage_view_get_onscreen (view);
+  int width = cogl_framebuffer_get_width (onscreen);
+  int height = cogl_framebuffer_get_height (onscreen);
+  uint8_t *pixels;
+
+  pixels = g_malloc0 (width * height * 4);
+  cogl_framebuffer_read_pixels (onscreen, 0, 0, width, height,
+                                COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                                pixels);
+
+  return pixels;
+}
+
+static void
+meta_test_stage_views_transformed_partial_repaint (void)
+{
+  MetaBackend *backend = test_backend;
+  MetaMonitorManager *monitor_manager =
+    meta_backend_get_monitor_manager (backend);
+  MetaMonitorManagerTest *monitor_manager_test =
+    META_MONITOR_MANAGER_TEST (monitor_manager);
+  ClutterActor *stage = meta_backend_get_stage (backend);
+  MtkMonitorTransform transform;
+
+  for (transform = MTK_MONITOR_TRANSFORM_NORMAL;
+       transform < MTK_MONITOR_N_TRANSFORMS;
+       transform++)
+    {
+      MonitorTestCaseSetup test_case_setup;
+      MetaMonitorTestSetup *test_setup;
+      ClutterStageView *view;
+      CoglFramebuffer *onscreen;
+      ClutterActor *actor;
+      g_autofree uint8_t *partial_pixels = NULL;
+      g_autofree uint8_t *full_pixels = NULL;
+      GList *stage_views;
+      GList *l;
+      int i;
+
+      test_case_setup = initial_test_case_setup;
+      test_case_setup.n_outputs = 1;
+      test_case_setup.n_crtcs = 1;
+      test_case_setup.outputs[0].panel_orientation_transform = transform;
+      test_setup = meta_create_monitor_test_setup (test_backend,
+                                                   &test_case_setup,
+                                                   MONITOR_TEST_FLAG_NO_STORED);
+
+      /* Make the view render the transform via an offscreen */
+      for (l = test_setup->crtcs; l; l = l->next)
+        meta_crtc_test_set_is_transform_handled (l->data, FALSE);
+
+      meta_monitor_manager_test_emulate_hotplug (monitor_manager_test,
+                                                 test_setup);
+
+      stage_views = clutter_stage_peek_stage_views (CLUTTER_STAGE (stage));
+      g_assert_cmpuint (g_list_length (stage_views), ==, 1);
+      view = stage_views->data;
+      onscreen = clutter_stage_view_get_onscreen (view);
+
+      if (transform == MTK_MONITOR_TRANSFORM_NORMAL)
+        g_assert_true (clutter_stage_view_get_framebuffer (view) == onscreen);
+      else
+        g_assert_true (clutter_stage_view_get_framebuffer (view) != onscreen);
+
+      actor = clutter_actor_new ();
+      clutter_actor_set_background_color (actor,
+                                          &COGL_COLOR_INIT (255, 0, 0, 255));
+      clutter_actor_set_size (actor, 50, 30);
+      clutter_actor_add_child (stage, actor);
+
+      clutter_stage_view_add_redraw_clip (view, NULL);
+      clutter_stage_view_schedule_update (view);
+      wait_for_paint (stage);
+
+      /* Move the actor around, so that only parts of the view are redrawn */
+      for (i = 0; i < 5; i++)
+        {
+          clutter_actor_set_position (actor, 20 + i * 37, 10 + i * 23);
+          wait_for_paint (stage);
+        }
+
+      partial_pixels = read_onscreen_pixels (view);
+
+      clutter_stage_view_add_redraw_clip (view, NULL);
+      clutter_stage_view_schedule_update (view);
+      wait_for_paint (stage);
+
+      full_pixels = read_onscreen_pixels (view);
+
+      g_assert_cmpmem (partial_pixels,
+                       cogl_framebuffer_get_width (onscreen) *
+                       cogl_framebuffer_get_height (onscreen) * 4,
+                       full_pixels,
+                       cogl_framebuffer_get_width (onscreen) *
+                       cogl_framebuffer_get_height (onscreen) * 4);
+
+      clutter_actor_destroy (actor);
+    }
+}
+
 static void
 on_before_tests (MetaContext *context)
 {
@@ -1356,6 +1460,8 @@ init_tests (void)
                    meta_test_timeline_actor_destroyed);
   g_test_add_func ("/stage-views/timeline/tree-clear",
                    meta_test_timeline_actor_tree_clear);
+  g_test_add_func ("/stage-views/transformed-partial-repaint",
+                   meta_test_stage_views_transformed_partial_repaint);
 }
 
 int
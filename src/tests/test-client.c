@@ -284,6 +284,37 @@ text_clear_func (GtkClipboard *clipboard,
   g_free (data);
 }
 
+static uint8_t
+get_pattern_byte (size_t offset)
+{
+  return (uint8_t) ((offset * 7) ^ (offset >> 12));
+}
+
+static void
+pattern_get_func (GtkClipboard     *clipboard,
+                  GtkSelectionData *selection_data,
+                  unsigned int      info,
+                  gpointer          data)
+{
+  size_t size = GPOINTER_TO_SIZE (data);
+  g_autofree uint8_t *pattern = NULL;
+  size_t i;
+
+  pattern = g_malloc (size);
+  for (i = 0; i < size; i++)
+    pattern[i] = get_pattern_byte (i);
+
+  gtk_selection_data_set (selection_data,
+                          gtk_selection_data_get_target (selection_data),
+                          8, pattern, size);
+}
+
+static void
+pattern_clear_func (GtkClipboard *clipboard,
+                    gpointer      data)
+{
+}
+
 static void
 calculate_anchors (const char *position,
                    GdkGravity *rect_anchor,
@@ -1179,6 +1210,86 @@ process_line (const char       *line,
                                    g_strdup (argv[2]));
       gtk_target_table_free (targets, n_targets);
     }
+  else if (strcmp (argv[0], "clipboard-set-pattern") == 0)
+    {
+      GtkClipboard *clipboard;
+      GtkTargetList *target_list;
+      GtkTargetEntry *targets;
+      int n_targets;
+      size_t size;
+
+      if (argc != 3)
+        {
+          g_print ("usage: clipboard-set-pattern <mimetype> <size>\n");
+          goto out;
+        }
+
+      size = g_ascii_strtoull (argv[2], NULL, 10);
+
+      clipboard = gtk_clipboard_get_for_display (display,
+                                                 GDK_SELECTION_CLIPBOARD);
+
+      target_list = gtk_target_list_new (NULL, 0);
+      gtk_target_list_add (target_list, gdk_atom_intern (argv[1], FALSE), 0, 0);
+
+      targets = gtk_target_table_new_from_list (target_list, &n_targets);
+      gtk_target_list_unref (target_list);
+
+      gtk_clipboard_set_with_data (clipboard,
+                                   targets, n_targets,
+                                   pattern_get_func, pattern_clear_func,
+                                   GSIZE_TO_POINTER (size));
+      gtk_target_table_free (targets, n_targets);
+    }
+  else if (strcmp (argv[0], "clipboard-check-pattern") == 0)
+    {
+      GtkClipboard *clipboard;
+      GtkSelectionData *selection_data;
+      const uint8_t *data;
+      int length;
+      size_t size;
+      int i;
+
+      if (argc != 3)
+        {
+          g_print ("usage: clipboard-check-pattern <mimetype> <size>\n");
+          goto out;
+        }
+
+      size = g_ascii_strtoull (argv[2], NULL, 10);
+
+      clipboard = gtk_clipboard_get_for_display (display,
+                                                 GDK_SELECTION_CLIPBOARD);
+      selection_data =
+        gtk_clipboard_wait_for_contents (clipboard,
+                                         gdk_atom_intern (argv[1], FALSE));
+      if (!selection_data)
+        {
+          g_print ("Failed to fetch clipboard contents\n");
+          goto out;
+        }
+
+      data = gtk_selection_data_get_data_with_length (selection_data, &length);
+      if (length < 0 || (size_t) length != size)
+        {
+          g_print ("Expected %zu bytes of clipboard contents, got %d\n",
+                   size, length);
+          gtk_selection_data_free (selection_data);
+          goto out;
+        }
+
+      for (i = 0; i < length; i++)
+        {
+          if (data[i] != get_pattern_byte (i))
+            {
+              g_print ("Clipboard contents differ at offset %d\n", i);
+              gtk_selection_data_free (selection_data);
+              goto out;
+            }
+        }
+
+      gtk_selection_data_free (selection_data);
+    }
   else if (strcmp (argv[0], "popup_at") == 0)
     {
       GtkWidget *parent;
@@ -361,6 +361,52 @@ test_case_assert_stacking (TestCase       *test,
   return *error == NULL;
 }
 
+static gboolean
+test_case_assert_tab_list (TestCase       *test,
+                           char          **expected_windows,
+                           MetaWorkspace  *workspace,
+                           GError        **error)
+{
+  MetaDisplay *display = meta_context_get_display (test->context);
+  g_autoptr (GList) tab_list = NULL;
+  g_autoptr (GString) tab_list_string = g_string_new (NULL);
+  g_autofree char *expected_string = NULL;
+  GList *l;
+
+  tab_list = meta_display_get_tab_list (display,
+                                        META_TAB_LIST_NORMAL_ALL_MRU,
+                                        workspace);
+  for (l = tab_list; l; l = l->next)
+    {
+      MetaWindow *window = l->data;
+
+      if (!window->title)
+        continue;
+
+      if (tab_list_string->len > 0)
+        g_string_append_c (tab_list_string, ' ');
+
+      if (g_str_has_prefix (window->title, "test/"))
+        g_string_append (tab_list_string, window->title + 5);
+      else
+        g_string_append_printf (tab_list_string, "(%s)", window->title);
+    }
+
+  expected_string = g_strjoinv (" ", expected_windows);
+
+  if (strcmp (expected_string, tab_list_string->str) != 0)
+    {
+      g_set_error (error,
+                   META_TEST_CLIENT_ERROR,
+                   META_TEST_CLIENT_ERROR_ASSERTION_FAILED,
+                   "tab list: expected='%s', actual='%s'",
+                   expected_string, tab_list_string->str);
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
 static gboolean
 test_case_assert_focused (TestCase    *test,
                           const char  *expected_window,
@@ -2492,6 +2538,32 @@ test_case_do (TestCase    *test,
       if (!test_case_check_xserver_stacking (test, error))
         return FALSE;
     }
+  else if (strcmp (argv[0], "assert_tab_list") == 0)
+    {
+      MetaWorkspace *workspace = NULL;
+
+      if (argc < 2)
+        BAD_COMMAND ("usage: %s <workspace-index>|all [<window-id1> ...]",
+                     argv[0]);
+
+      if (strcmp (argv[1], "all") != 0)
+        {
+          MetaDisplay *display = meta_context_get_display (test->context);
+          MetaWorkspaceManager *workspace_manager =
+            meta_display_get_workspace_manager (display);
+          int index = atoi (argv[1]);
+
+          if (index >= meta_workspace_manager_get_n_workspaces (workspace_manager))
+            BAD_COMMAND ("Invalid workspace index %d", index);
+
+          workspace =
+            meta_workspace_manager_get_workspace_by_index (workspace_manager,
+                                                           index);
+        }
+
+      if (!test_case_assert_tab_list (test, argv + 2, workspace, error))
+        return FALSE;
+    }
   else if (strcmp (argv[0], "window_to_workspace") == 0)
     {
       if (argc != 3)
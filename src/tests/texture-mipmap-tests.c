@@ -0,0 +1,342 @@
+/*
+ * Copyright (C) 2026 Red Hat Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <stdlib.h>
+
+#include "backends/meta-backend-private.h"
+#include "compositor/meta-texture-mipmap.h"
+#include "core/meta-context-private.h"
+#include "tests/meta-test/meta-context-test.h"
+
+/* Odd sizes, so the mipmap isn't exactly half the size */
+#define BASE_WIDTH 301
+#define BASE_HEIGHT 203
+
+static MetaContext *test_context;
+
+/* Fake monotonic clock driving the rate limiting of partial updates */
+static int64_t now_us = G_USEC_PER_SEC;
+
+static CoglContext *
+get_cogl_context (void)
+{
+  MetaBackend *backend = meta_context_get_backend (test_context);
+  ClutterBackend *clutter_backend = meta_backend_get_clutter_backend (backend);
+
+  return clutter_backend_get_cogl_context (clutter_backend);
+}
+
+static uint8_t *
+create_pattern (int     width,
+                int     height,
+                uint8_t seed)
+{
+  uint8_t *data;
+  int x, y;
+
+  data = g_malloc (width * height * 4);
+
+  for (y = 0; y < height; y++)
+    {
+      for (x = 0; x < width; x++)
+        {
+          uint8_t *p = data + (y * width + x) * 4;
+          gboolean checker = ((x / 3) + (y / 3)) % 2;
+
+          p[0] = (uint8_t) (checker ? 255 : x * 7 + seed);
+          p[1] = (uint8_t) (y * 5 + seed);
+          p[2] = (uint8_t) (checker ? seed : 255 - x);
+          p[3] = 255;
+        }
+    }
+
+  return data;
+}
+
+static MetaMultiTexture *
+create_base_texture (void)
+{
+  g_autofree uint8_t *data = NULL;
+  g_autoptr (GError) error = NULL;
+  CoglTexture *texture;
+
+  data = create_pattern (BASE_WIDTH, BASE_HEIGHT, 0);
+  texture = cogl_texture_2d_new_from_data (get_cogl_context (),
+                                           BASE_WIDTH, BASE_HEIGHT,
+                                           COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                                           BASE_WIDTH * 4,
+                                           data,
+                                           &error);
+  g_assert_no_error (error);
+
+  return meta_multi_texture_new_simple (texture);
+}
+
+static void
+damage_base_texture (MetaMultiTexture   *base_texture,
+                     const MtkRectangle *area,
+                     uint8_t             seed)
+{
+  CoglTexture *texture = meta_multi_texture_get_plane (base_texture, 0);
+  g_autofree uint8_t *data = NULL;
+
+  data = create_pattern (area->width, area->height, seed);
+  g_assert_true (cogl_texture_set_region (texture,
+                                          0, 0,
+                                          area->x, area->y,
+                                          area->width, area->height,
+                                          area->width, area->height,
+                                          COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                                          area->width * 4,
+                                          data));
+}
+
+static uint8_t *
+read_mipmap (MetaTextureMipmap *mipmap,
+             int               *width,
+             int               *height)
+{
+  MetaMultiTexture *paint_texture;
+  CoglTexture *texture;
+  uint8_t *data;
+
+  paint_texture = meta_texture_mipmap_get_paint_texture_at (mipmap, now_us);
+  g_assert_nonnull (paint_texture);
+
+  texture = meta_multi_texture_get_plane (paint_texture, 0);
+  *width = cogl_texture_get_width (texture);
+  *height = cogl_texture_get_height (texture);
+
+  data = g_malloc (*width * *height * 4);
+  cogl_texture_get_data (texture,
+                         COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                         *width * 4,
+                         data);
+
+  return data;
+}
+
+static void
+assert_pixels_equal (const uint8_t *data,
+                     const uint8_t *reference_data,
+                     int            width,
+                     int            height)
+{
+  int i;
+
+  for (i = 0; i < width * height * 4; i++)
+    {
+      if (abs (data[i] - reference_data[i]) > 1)
+        {
+          g_error ("Pixel %d,%d channel %d differs: %d, expected %d",
+                   (i / 4) % width, (i / 4) / width, i % 4,
+                   data[i], reference_data[i]);
+        }
+    }
+}
+
+static void
+assert_mipmap_matches_full_update (MetaTextureMipmap *mipmap,
+                                   MetaMultiTexture  *base_texture)
+{
+  MetaTextureMipmap *reference;
+  g_autofree uint8_t *data = NULL;
+  g_autofree uint8_t *reference_data = NULL;
+  int width, height;
+  int reference_width, reference_height;
+
+  reference = meta_texture_mipmap_new (get_cogl_context ());
+  meta_texture_mipmap_set_base_texture (reference, base_texture);
+
+  data = read_mipmap (mipmap, &width, &height);
+  reference_data = read_mipmap (reference, &reference_width, &reference_height);
+
+  g_assert_cmpint (width, ==, reference_width);
+  g_assert_cmpint (height, ==, reference_height);
+  assert_pixels_equal (data, reference_data, width, height);
+
+  meta_texture_mipmap_free (reference);
+}
+
+static void
+wait_for_update (MetaTextureMipmap *mipmap)
+{
+  int64_t update_time_us;
+
+  update_time_us = meta_texture_mipmap_get_next_update_time (mipmap);
+  if (update_time_us)
+    now_us = MAX (now_us, update_time_us);
+}
+
+static void
+meta_test_texture_mipmap_partial_update (void)
+{
+  g_autoptr (MetaMultiTexture) base_texture = NULL;
+  MetaTextureMipmap *mipmap;
+  const MtkRectangle damage[] = {
+    { 100, 50, 37, 21 },
+    { 0, 0, 1, 1 },
+    { 3, 7, 2, 3 },
+    { BASE_WIDTH - 1, BASE_HEIGHT - 1, 1, 1 },
+    { BASE_WIDTH - 64, 0, 64, BASE_HEIGHT },
+  };
+  int i;
+
+  base_texture = create_base_texture ();
+
+  mipmap = meta_texture_mipmap_new (get_cogl_context ());
+  meta_texture_mipmap_set_base_texture (mipmap, base_texture);
+  g_assert_nonnull (meta_texture_mipmap_get_paint_texture_at (mipmap, now_us));
+
+  for (i = 0; i < G_N_ELEMENTS (damage); i++)
+    {
+      damage_base_texture (base_texture, &damage[i], (uint8_t) (i * 50 + 1));
+      meta_texture_mipmap_invalidate_area (mipmap, &damage[i]);
+
+      wait_for_update (mipmap);
+      assert_mipmap_matches_full_update (mipmap, base_texture);
+    }
+
+  /* Damage accumulated over several updates */
+  for (i = 0; i < G_N_ELEMENTS (damage); i++)
+    {
+      damage_base_texture (base_texture, &damage[i], (uint8_t) (i * 30 + 7));
+      meta_texture_mipmap_invalidate_area (mipmap, &damage[i]);
+    }
+
+  wait_for_update (mipmap);
+  assert_mipmap_matches_full_update (mipmap, base_texture);
+
+  meta_texture_mipmap_free (mipmap);
+}
+
+static void
+meta_test_texture_mipmap_rate_limit (void)
+{
+  g_autoptr (MetaMultiTexture) base_texture = NULL;
+  g_autofree uint8_t *before = NULL;
+  g_autofree uint8_t *after = NULL;
+  MetaTextureMipmap *mipmap;
+  MtkRectangle area = { 20, 20, 40, 40 };
+  int64_t update_time_us;
+  int width, height;
+
+  base_texture = create_base_texture ();
+
+  mipmap = meta_texture_mipmap_new (get_cogl_context ());
+  meta_texture_mipmap_set_base_texture (mipmap, base_texture);
+  before = read_mipmap (mipmap, &width, &height);
+  g_assert_cmpint (meta_texture_mipmap_get_next_update_time (mipmap), ==, 0);
+
+  /* Right after an update, changes are held back for a bit */
+  damage_base_texture (base_texture, &area, 123);
+  meta_texture_mipmap_invalidate_area (mipmap, &area);
+
+  update_time_us = meta_texture_mipmap_get_next_update_time (mipmap);
+  g_assert_cmpint (update_time_us, >, now_us);
+  g_assert_cmpint (update_time_us, <=, now_us + G_USEC_PER_SEC);
+
+  after = read_mipmap (mipmap, &width, &height);
+  assert_pixels_equal (after, before, width, height);
+
+  /* Including right before it is time */
+  now_us = update_time_us - 1;
+  g_clear_pointer (&after, g_free);
+  after = read_mipmap (mipmap, &width, &height);
+  assert_pixels_equal (after, before, width, height);
+  g_assert_cmpint (meta_texture_mipmap_get_next_update_time (mipmap),
+                   ==, update_time_us);
+
+  /* And show up once it is time */
+  now_us = update_time_us;
+  assert_mipmap_matches_full_update (mipmap, base_texture);
+  g_assert_cmpint (meta_texture_mipmap_get_next_update_time (mipmap), ==, 0);
+
+  /* Full invalidations are never held back */
+  damage_base_texture (base_texture,
+                       &MTK_RECTANGLE_INIT (0, 0, BASE_WIDTH, BASE_HEIGHT),
+                       77);
+  meta_texture_mipmap_invalidate (mipmap);
+  g_assert_cmpint (meta_texture_mipmap_get_next_update_time (mipmap), ==, 0);
+  assert_mipmap_matches_full_update (mipmap, base_texture);
+
+  meta_texture_mipmap_free (mipmap);
+}
+
+static void
+meta_test_texture_mipmap_damage_while_cleared (void)
+{
+  g_autoptr (MetaMultiTexture) base_texture = NULL;
+  MetaTextureMipmap *mipmap;
+  MtkRectangle area = { 20, 20, 40, 40 };
+  int i;
+
+  base_texture = create_base_texture ();
+
+  mipmap = meta_texture_mipmap_new (get_cogl_context ());
+  meta_texture_mipmap_set_base_texture (mipmap, base_texture);
+  g_assert_nonnull (meta_texture_mipmap_get_paint_texture_at (mipmap, now_us));
+
+  /* Damage while there is no mipmap texture is not kept around, since
+   * the mipmap texture is rendered as a whole once it is created again */
+  meta_texture_mipmap_clear (mipmap);
+
+  for (i = 0; i < 100; i++)
+    {
+      area.x = (i * 3) % (BASE_WIDTH - area.width);
+      damage_base_texture (base_texture, &area, (uint8_t) i);
+      meta_texture_mipmap_invalidate_area (mipmap, &area);
+    }
+  g_assert_cmpint (meta_texture_mipmap_get_next_update_time (mipmap), ==, 0);
+
+  assert_mipmap_matches_full_update (mipmap, base_texture);
+  g_assert_cmpint (meta_texture_mipmap_get_next_update_time (mipmap), ==, 0);
+
+  meta_texture_mipmap_free (mipmap);
+}
+
+static void
+init_tests (void)
+{
+  g_test_add_func ("/compositor/texture-mipmap/partial-update",
+                   meta_test_texture_mipmap_partial_update);
+  g_test_add_func ("/compositor/texture-mipmap/rate-limit",
+                   meta_test_texture_mipmap_rate_limit);
+  g_test_add_func ("/compositor/texture-mipmap/damage-while-cleared",
+                   meta_test_texture_mipmap_damage_while_cleared);
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  g_autoptr (MetaContext) context = NULL;
+
+  context = meta_create_test_context (META_CONTEXT_TEST_TYPE_HEADLESS,
+                                      META_CONTEXT_TEST_FLAG_NO_X11);
+  g_assert (meta_context_configure (context, &argc, &argv, NULL));
+
+  test_context = context;
+
+  init_tests ();
+
+  return meta_context_test_run_tests (META_CONTEXT_TEST (context),
+                                      META_TEST_RUN_FLAG_NONE);
+}
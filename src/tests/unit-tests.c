@@ -199,12 +199,167 @@ meta_test_util_later_schedule_from_later (void)
   g_assert_cmpint (data.state, ==, META_TEST_LATER_FINISHED);
 }
 
+typedef struct _MetaTestLaterPriorityData
+{
+  GMainLoop *loop;
+  int n_invoked;
+  int n_updates;
+  int slow_update;
+  int low_priority_update;
+} MetaTestLaterPriorityData;
+
+typedef struct _MetaTestLaterPriorityCallbackData
+{
+  MetaTestLaterPriorityData *data;
+  int expected_order;
+} MetaTestLaterPriorityCallbackData;
+
+static gboolean
+test_later_priority_order_callback (gpointer user_data)
+{
+  MetaTestLaterPriorityCallbackData *callback_data = user_data;
+  MetaTestLaterPriorityData *data = callback_data->data;
+
+  g_assert_cmpint (data->n_invoked, ==, callback_data->expected_order);
+  data->n_invoked++;
+
+  if (data->n_invoked == 3)
+    g_main_loop_quit (data->loop);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+meta_test_util_later_priority_order (void)
+{
+  MetaDisplay *display = meta_context_get_display (test_context);
+  MetaCompositor *compositor = meta_display_get_compositor (display);
+  MetaLaters *laters = meta_compositor_get_laters (compositor);
+  MetaTestLaterPriorityData data = { 0 };
+  MetaTestLaterPriorityCallbackData callback_data[] = {
+    { &data, 2 },
+    { &data, 1 },
+    { &data, 0 },
+  };
+
+  data.loop = g_main_loop_new (NULL, FALSE);
+
+  /* Added from the lowest to the highest priority, and run the other way */
+  meta_laters_add_full (laters, META_LATER_BEFORE_REDRAW,
+                        META_LATER_PRIORITY_LOW,
+                        test_later_priority_order_callback,
+                        &callback_data[0],
+                        NULL);
+  meta_laters_add_full (laters, META_LATER_BEFORE_REDRAW,
+                        META_LATER_PRIORITY_DEFAULT,
+                        test_later_priority_order_callback,
+                        &callback_data[1],
+                        NULL);
+  meta_laters_add_full (laters, META_LATER_BEFORE_REDRAW,
+                        META_LATER_PRIORITY_HIGH,
+                        test_later_priority_order_callback,
+                        &callback_data[2],
+                        NULL);
+
+  g_main_loop_run (data.loop);
+  g_main_loop_unref (data.loop);
+
+  g_assert_cmpint (data.n_invoked, ==, 3);
+}
+
+static void
+on_after_update (ClutterStage              *stage,
+                 ClutterStageView          *stage_view,
+                 ClutterFrame              *frame,
+                 MetaTestLaterPriorityData *data)
+{
+  data->n_updates++;
+}
+
+static gboolean
+test_later_slow_callback (gpointer user_data)
+{
+  MetaTestLaterPriorityData *data = user_data;
+
+  /* Well past the deadline of any frame */
+  g_usleep (100 * 1000);
+  data->slow_update = data->n_updates;
+
+  return G_SOURCE_REMOVE;
+}
+
+static gboolean
+test_later_low_priority_callback (gpointer user_data)
+{
+  MetaTestLaterPriorityData *data = user_data;
+
+  data->low_priority_update = data->n_updates;
+  g_main_loop_quit (data->loop);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+meta_test_util_later_low_priority_deferred (void)
+{
+  MetaDisplay *display = meta_context_get_display (test_context);
+  MetaCompositor *compositor = meta_display_get_compositor (display);
+  MetaLaters *laters = meta_compositor_get_laters (compositor);
+  ClutterStage *stage = meta_compositor_get_stage (compositor);
+  MetaTestLaterPriorityData data = { 0 };
+  gulong after_update_handler_id;
+
+  data.loop = g_main_loop_new (NULL, FALSE);
+  data.slow_update = -1;
+  data.low_priority_update = -1;
+
+  after_update_handler_id = g_signal_connect (stage, "after-update",
+                                              G_CALLBACK (on_after_update),
+                                              &data);
+
+  /* A low priority later queued for the same frame as one that takes too
+   * long is run in the next frame instead */
+  meta_laters_add_full (laters, META_LATER_BEFORE_REDRAW,
+                        META_LATER_PRIORITY_LOW,
+                        test_later_low_priority_callback,
+                        &data,
+                        NULL);
+  meta_laters_add (laters, META_LATER_BEFORE_REDRAW,
+                   test_later_slow_callback,
+                   &data,
+                   NULL);
+
+  g_main_loop_run (data.loop);
+
+  g_assert_cmpint (data.slow_update, >=, 0);
+  g_assert_cmpint (data.low_priority_update, >, data.slow_update);
+
+  /* Without anything slow, it is not deferred */
+  meta_laters_add_full (laters, META_LATER_BEFORE_REDRAW,
+                        META_LATER_PRIORITY_LOW,
+                        test_later_low_priority_callback,
+                        &data,
+                        NULL);
+  data.slow_update = data.n_updates;
+
+  g_main_loop_run (data.loop);
+
+  g_assert_cmpint (data.low_priority_update, ==, data.slow_update);
+
+  g_signal_handler_disconnect (stage, after_update_handler_id);
+  g_main_loop_unref (data.loop);
+}
+
 static void
 init_tests (void)
 {
   g_test_add_func ("/util/meta-later/order", meta_test_util_later_order);
   g_test_add_func ("/util/meta-later/schedule-from-later",
                    meta_test_util_later_schedule_from_later);
+  g_test_add_func ("/util/meta-later/priority-order",
+                   meta_test_util_later_priority_order);
+  g_test_add_func ("/util/meta-later/low-priority-deferred",
+                   meta_test_util_later_low_priority_deferred);
 
   init_monitor_store_tests ();
   init_boxes_tests ();
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026 Red Hat Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <glib.h>
+#include <wayland-client.h>
+
+#include "wayland-test-client-utils.h"
+
+#define N_FLOOD_REQUESTS_PER_ROUND 5000
+#define N_MEASURED_FRAMES 30
+/* A handful of frames at 60 Hz, with some slack for slow test machines. */
+#define MAX_FRAME_LATENCY_US (100 * 1000)
+
+static void
+on_sync_event (WaylandDisplay *display,
+               uint32_t        serial,
+               gboolean       *stop)
+{
+  *stop = TRUE;
+}
+
+static void
+flood (WaylandDisplay *display)
+{
+  g_autoptr (WaylandSurface) surface = NULL;
+  gboolean stop = FALSE;
+  uint64_t n_requests = 0;
+
+  /* Make sure each round ends up in the compositor as one large chunk. */
+  wl_display_set_max_buffer_size (display->display, 1024 * 1024);
+
+  surface = wayland_surface_new (display, "flood",
+                                 100, 100, 0xffffffff);
+  wl_surface_commit (surface->wl_surface);
+  wait_for_window_shown (display, surface->wl_surface);
+
+  g_signal_connect (display, "sync-event", G_CALLBACK (on_sync_event), &stop);
+
+  test_driver_sync_point (display->test_driver, 0, surface->wl_surface);
+
+  while (!stop)
+    {
+      int i;
+
+      for (i = 0; i < N_FLOOD_REQUESTS_PER_ROUND; i++)
+        wl_surface_damage_buffer (surface->wl_surface, i % 100, 0, 1, 1);
+
+      n_requests += N_FLOOD_REQUESTS_PER_ROUND;
+      wl_display_roundtrip (display->display);
+    }
+
+  g_debug ("Sent %" G_GUINT64_FORMAT " damage requests", n_requests);
+}
+
+static void
+handle_frame_callback (void               *data,
+                       struct wl_callback *callback,
+                       uint32_t            time)
+{
+  gboolean *frame_done = data;
+
+  wl_callback_destroy (callback);
+  *frame_done = TRUE;
+}
+
+static const struct wl_callback_listener frame_listener = {
+  handle_frame_callback,
+};
+
+static void
+measure (WaylandDisplay *display)
+{
+  g_autoptr (WaylandSurface) surface = NULL;
+  int64_t max_latency_us = 0;
+  int i;
+
+  surface = wayland_surface_new (display, "measure",
+                                 100, 100, 0xff00ff00);
+  wl_surface_commit (surface->wl_surface);
+  wait_for_window_shown (display, surface->wl_surface);
+
+  test_driver_sync_point (display->test_driver, 1, surface->wl_surface);
+
+  for (i = 0; i < N_MEASURED_FRAMES; i++)
+    {
+      struct wl_callback *callback;
+      gboolean frame_done = FALSE;
+      int64_t commit_time_us;
+      int64_t latency_us;
+
+      draw_surface (display, surface->wl_surface,
+                    surface->width, surface->height,
+                    i % 2 ? 0xff00ff00 : 0xff0000ff);
+      wl_surface_damage_buffer (surface->wl_surface,
+                                0, 0, surface->width, surface->height);
+      callback = wl_surface_frame (surface->wl_surface);
+      wl_callback_add_listener (callback, &frame_listener, &frame_done);
+      wl_surface_commit (surface->wl_surface);
+
+      commit_time_us = g_get_monotonic_time ();
+      while (!frame_done)
+        wayland_display_dispatch (display);
+
+      latency_us = g_get_monotonic_time () - commit_time_us;
+      max_latency_us = MAX (max_latency_us, latency_us);
+    }
+
+  g_debug ("Max frame callback latency: %" G_GINT64_FORMAT " us",
+           max_latency_us);
+  g_assert_cmpint (max_latency_us, <, MAX_FRAME_LATENCY_US);
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  g_autoptr (WaylandDisplay) display = NULL;
+
+  g_assert_cmpint (argc, ==, 2);
+
+  display = wayland_display_new (WAYLAND_DISPLAY_CAPABILITY_TEST_DRIVER);
+
+  if (g_strcmp0 (argv[1], "flood") == 0)
+    flood (display);
+  else if (g_strcmp0 (argv[1], "measure") == 0)
+    measure (display);
+  else
+    g_assert_not_reached ();
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2026 Red Hat Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <glib.h>
+#include <wayland-client.h>
+
+#include "wayland-test-client-utils.h"
+
+#define N_STACKED_SURFACES 8
+
+/* Must match MUTTER_DEBUG_HIDDEN_FRAME_CALLBACK_INTERVAL_MS of the test. It
+ * is lower than the default to be done well before covered windows are
+ * suspended, after which they get no frame callbacks at all. */
+#define HIDDEN_FRAME_CALLBACK_INTERVAL_MS 250
+
+/* Refresh rate of the test monitor. */
+#define REFRESH_RATE_HZ 60
+
+#define SETTLE_TIME_MS 250
+#define MEASURE_TIME_MS 1000
+
+enum
+{
+  FRAME_CALLBACK_THROTTLING_COMMAND_ACTIVATE_WINDOW = 0,
+};
+
+typedef struct _AnimatedSurface
+{
+  WaylandSurface *surface;
+  int n_frame_callbacks;
+} AnimatedSurface;
+
+static void redraw (AnimatedSurface *animated_surface);
+
+static void
+handle_frame_callback (void               *data,
+                       struct wl_callback *callback,
+                       uint32_t            time)
+{
+  AnimatedSurface *animated_surface = data;
+
+  wl_callback_destroy (callback);
+
+  animated_surface->n_frame_callbacks++;
+  redraw (animated_surface);
+}
+
+static const struct wl_callback_listener frame_listener = {
+  handle_frame_callback,
+};
+
+static void
+redraw (AnimatedSurface *animated_surface)
+{
+  WaylandSurface *surface = animated_surface->surface;
+  struct wl_callback *callback;
+
+  draw_surface (surface->display, surface->wl_surface,
+                surface->width, surface->height,
+                animated_surface->n_frame_callbacks % 2 ?
+                surface->color : ~surface->color | 0xff000000);
+  wl_surface_damage_buffer (surface->wl_surface,
+                            0, 0, surface->width, surface->height);
+  callback = wl_surface_frame (surface->wl_surface);
+  wl_callback_add_listener (callback, &frame_listener, animated_surface);
+  wl_surface_commit (surface->wl_surface);
+}
+
+static void
+animated_surface_init (AnimatedSurface *animated_surface,
+                       WaylandDisplay  *display,
+                       const char      *title,
+                       uint32_t         color)
+{
+  WaylandSurface *surface;
+
+  surface = wayland_surface_new (display, title, 100, 100, color);
+  xdg_toplevel_set_maximized (surface->xdg_toplevel);
+  wl_surface_commit (surface->wl_surface);
+  wait_for_window_shown (display, surface->wl_surface);
+
+  animated_surface->surface = surface;
+  animated_surface->n_frame_callbacks = 0;
+  redraw (animated_surface);
+}
+
+static void
+timeout_cb (gpointer user_data)
+{
+  gboolean *done = user_data;
+
+  *done = TRUE;
+}
+
+static void
+wait_timeout_ms (int timeout_ms)
+{
+  gboolean done = FALSE;
+
+  g_timeout_add_once (timeout_ms, timeout_cb, &done);
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  g_autoptr (WaylandDisplay) display = NULL;
+  AnimatedSurface stacked[N_STACKED_SURFACES];
+  AnimatedSurface top;
+  int min_hidden_frame_callbacks;
+  int max_hidden_frame_callbacks;
+  int min_visible_frame_callbacks;
+  int i;
+
+  display = wayland_display_new (WAYLAND_DISPLAY_CAPABILITY_TEST_DRIVER);
+
+  for (i = 0; i < N_STACKED_SURFACES; i++)
+    {
+      g_autofree char *title = g_strdup_printf ("stacked-%d", i);
+
+      animated_surface_init (&stacked[i], display, title, 0xff00ff00);
+    }
+
+  animated_surface_init (&top, display, "top", 0xff0000ff);
+  test_driver_sync_point (display->test_driver,
+                          FRAME_CALLBACK_THROTTLING_COMMAND_ACTIVATE_WINDOW,
+                          top.surface->wl_surface);
+
+  wait_timeout_ms (SETTLE_TIME_MS);
+
+  for (i = 0; i < N_STACKED_SURFACES; i++)
+    stacked[i].n_frame_callbacks = 0;
+  top.n_frame_callbacks = 0;
+
+  wait_timeout_ms (MEASURE_TIME_MS);
+
+  /* Allow one callback more or less for a throttled emission falling right
+   * at the start or the end of the measurement. */
+  min_hidden_frame_callbacks =
+    MEASURE_TIME_MS / HIDDEN_FRAME_CALLBACK_INTERVAL_MS - 1;
+  max_hidden_frame_callbacks =
+    MEASURE_TIME_MS / HIDDEN_FRAME_CALLBACK_INTERVAL_MS + 1;
+
+  /* The visible surface should redraw at the refresh rate; only require half
+   * of it to not fail on slow test machines. */
+  min_visible_frame_callbacks =
+    MEASURE_TIME_MS * REFRESH_RATE_HZ / 1000 / 2;
+
+  g_debug ("Top surface received %d frame callbacks",
+           top.n_frame_callbacks);
+  g_assert_cmpint (top.n_frame_callbacks, >=, min_visible_frame_callbacks);
+
+  for (i = 0; i < N_STACKED_SURFACES; i++)
+    {
+      g_debug ("Stacked surface %d received %d frame callbacks",
+               i, stacked[i].n_frame_callbacks);
+      g_assert_cmpint (stacked[i].n_frame_callbacks, >=,
+                       min_hidden_frame_callbacks);
+      g_assert_cmpint (stacked[i].n_frame_callbacks, <=,
+                       max_hidden_frame_callbacks);
+    }
+
+  for (i = 0; i < N_STACKED_SURFACES; i++)
+    g_object_unref (stacked[i].surface);
+  g_object_unref (top.surface);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2026 Red Hat Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <glib.h>
+
+#include "wayland-test-client-utils.h"
+
+int
+main (int    argc,
+      char **argv)
+{
+  g_autoptr (WaylandDisplay) display = NULL;
+  g_autoptr (WaylandSurface) surface = NULL;
+  gboolean translucent;
+
+  g_assert_cmpint (argc, ==, 2);
+  translucent = g_strcmp0 (argv[1], "translucent") == 0;
+
+  display = wayland_display_new (WAYLAND_DISPLAY_CAPABILITY_TEST_DRIVER);
+  surface = wayland_surface_new (display, "overlay-candidate",
+                                 100, 100,
+                                 translucent ? 0x8000ff00 : 0xff00ff00);
+  surface->has_alpha = translucent;
+  wl_surface_commit (surface->wl_surface);
+  wait_for_window_shown (display, surface->wl_surface);
+
+  test_driver_sync_point (display->test_driver, 0, NULL);
+  wait_for_sync_event (display, 0);
+
+  return EXIT_SUCCESS;
+}
@@ -25,6 +25,7 @@
 #include "backends/native/meta-backend-native.h"
 #include "backends/native/meta-kms.h"
 #include "backends/native/meta-kms-device.h"
+#include "compositor/meta-compositor-view-native.h"
 #include "compositor/meta-window-actor-private.h"
 #include "core/display-private.h"
 #include "core/meta-workspace-manager-private.h"
@@ -1666,6 +1667,230 @@ toplevel_suspended (void)
   g_signal_handler_disconnect (test_driver, sync_point_id);
 }
 
+enum
+{
+  FRAME_CALLBACK_THROTTLING_COMMAND_ACTIVATE_WINDOW = 0,
+};
+
+static void
+on_frame_callback_throttling_sync_point (MetaWaylandTestDriver *driver,
+                                         unsigned int           sequence,
+                                         struct wl_resource    *surface_resource,
+                                         struct wl_client      *wl_client)
+{
+  MetaDisplay *display = meta_context_get_display (test_context);
+  MetaWaylandSurface *surface;
+  uint32_t now_ms;
+
+  switch (sequence)
+    {
+    case FRAME_CALLBACK_THROTTLING_COMMAND_ACTIVATE_WINDOW:
+      surface = wl_resource_get_user_data (surface_resource);
+      now_ms = meta_display_get_current_time_roundtrip (display);
+      meta_window_activate (meta_wayland_surface_get_window (surface), now_ms);
+      break;
+    default:
+      g_assert_not_reached ();
+    }
+}
+
+static void
+toplevel_hidden_frame_callback_throttling (void)
+{
+  MetaWaylandTestClient *wayland_test_client;
+  gulong sync_point_id;
+
+  sync_point_id =
+    g_signal_connect (test_driver, "sync-point",
+                      G_CALLBACK (on_frame_callback_throttling_sync_point),
+                      NULL);
+
+  wayland_test_client =
+    meta_wayland_test_client_new (test_context, "frame-callback-throttling");
+  meta_wayland_test_client_finish (wayland_test_client);
+
+  g_signal_handler_disconnect (test_driver, sync_point_id);
+}
+
+typedef struct
+{
+  MetaWaylandClient *flood_client;
+  MetaWaylandClient *measure_client;
+  uint64_t n_floods_before_measuring;
+} DispatchFairnessData;
+
+static void
+on_dispatch_fairness_sync_point (MetaWaylandTestDriver *driver,
+                                 unsigned int           sequence,
+                                 struct wl_resource    *surface_resource,
+                                 struct wl_client      *wl_client,
+                                 DispatchFairnessData  *data)
+{
+  switch (sequence)
+    {
+    case 0:
+      data->flood_client = meta_get_wayland_client (wl_client);
+      break;
+    case 1:
+      data->measure_client = meta_get_wayland_client (wl_client);
+      meta_wayland_client_get_request_stats (data->flood_client,
+                                             NULL,
+                                             NULL,
+                                             &data->n_floods_before_measuring);
+      break;
+    default:
+      g_assert_not_reached ();
+    }
+}
+
+static void
+client_dispatch_fairness (void)
+{
+  MetaWaylandTestClient *flood_test_client;
+  MetaWaylandTestClient *measure_test_client;
+  DispatchFairnessData data = { 0 };
+  uint64_t n_requests, n_bytes, n_floods;
+  gulong sync_point_id;
+
+  sync_point_id =
+    g_signal_connect (test_driver, "sync-point",
+                      G_CALLBACK (on_dispatch_fairness_sync_point),
+                      &data);
+
+  flood_test_client =
+    meta_wayland_test_client_new_with_args (test_context,
+                                            "client-dispatch-fairness",
+                                            "flood",
+                                            NULL);
+  while (!data.flood_client)
+    g_main_context_iteration (NULL, TRUE);
+
+  /* The measuring client asserts that its frame callbacks keep arriving
+   * within a bounded time while the other client floods. */
+  measure_test_client =
+    meta_wayland_test_client_new_with_args (test_context,
+                                            "client-dispatch-fairness",
+                                            "measure",
+                                            NULL);
+  meta_wayland_test_client_finish (measure_test_client);
+
+  g_signal_handler_disconnect (test_driver, sync_point_id);
+
+  g_assert_nonnull (data.measure_client);
+  meta_wayland_client_get_request_stats (data.measure_client,
+                                         NULL,
+                                         NULL,
+                                         &n_floods);
+  g_assert_cmpuint (n_floods, ==, 0);
+
+  /* The flooding client must have kept exceeding the threshold while the
+   * measuring client ran, or the latency bound was not tested. */
+  meta_wayland_client_get_request_stats (data.flood_client,
+                                         &n_requests,
+                                         &n_bytes,
+                                         &n_floods);
+  g_assert_cmpuint (n_requests, >, 0);
+  g_assert_cmpuint (n_bytes, >=, n_requests * 2 * sizeof (uint32_t));
+  g_assert_cmpuint (n_floods, >, data.n_floods_before_measuring);
+
+  emit_sync_event (0);
+  meta_wayland_test_client_finish (flood_test_client);
+}
+
+static MetaSurfaceActor *
+find_overlay_candidate (MetaWindow *window)
+{
+  MetaDisplay *display = meta_context_get_display (test_context);
+  MetaCompositor *compositor = meta_display_get_compositor (display);
+  MetaBackend *backend = meta_context_get_backend (test_context);
+  MetaRenderer *renderer = meta_backend_get_renderer (backend);
+  ClutterStageView *view;
+
+  view = CLUTTER_STAGE_VIEW (meta_renderer_get_views (renderer)->data);
+
+  return meta_compositor_view_native_find_overlay_surface_actor (
+    compositor, view, meta_window_actor_from_window (window));
+}
+
+static void
+overlay_candidate (void)
+{
+  MetaBackend *backend = meta_context_get_backend (test_context);
+  MetaCursorTracker *cursor_tracker = meta_backend_get_cursor_tracker (backend);
+  MetaWaylandTestClient *wayland_test_client;
+  MetaWindowActor *window_actor;
+  ClutterEffect *effect;
+  ClutterActor *chrome;
+  MtkRectangle frame_rect;
+  MetaWindow *window;
+
+  /* A software cursor on top of the window would disqualify it. */
+  meta_cursor_tracker_inhibit_cursor_visibility (cursor_tracker);
+
+  wayland_test_client =
+    meta_wayland_test_client_new_with_args (test_context,
+                                            "overlay-candidate",
+                                            "opaque",
+                                            NULL);
+  wait_for_sync_point (0);
+  window = find_client_window ("overlay-candidate");
+  meta_wait_for_effects (window);
+  meta_wait_for_paint (test_context);
+
+  g_assert_nonnull (find_overlay_candidate (window));
+
+  window_actor = meta_window_actor_from_window (window);
+
+  clutter_actor_set_opacity (CLUTTER_ACTOR (window_actor), 128);
+  g_assert_null (find_overlay_candidate (window));
+  clutter_actor_set_opacity (CLUTTER_ACTOR (window_actor), 255);
+
+  effect = clutter_desaturate_effect_new (1.0);
+  clutter_actor_add_effect (CLUTTER_ACTOR (window_actor), effect);
+  g_assert_null (find_overlay_candidate (window));
+  clutter_actor_remove_effect (CLUTTER_ACTOR (window_actor), effect);
+
+  g_assert_nonnull (find_overlay_candidate (window));
+
+  /* Anything painted above the surface, even outside of the window group,
+   * such as shell chrome, would be hidden behind the overlay plane. */
+  meta_window_get_frame_rect (window, &frame_rect);
+  chrome = clutter_actor_new ();
+  clutter_actor_set_background_color (chrome, &COGL_COLOR_INIT (255, 0, 0, 128));
+  clutter_actor_set_position (chrome, frame_rect.x, frame_rect.y);
+  clutter_actor_set_size (chrome, 10, 10);
+  clutter_actor_add_child (meta_backend_get_stage (backend), chrome);
+  meta_wait_for_paint (test_context);
+  g_assert_null (find_overlay_candidate (window));
+
+  clutter_actor_set_position (chrome,
+                              frame_rect.x + frame_rect.width + 10,
+                              frame_rect.y);
+  meta_wait_for_paint (test_context);
+  g_assert_nonnull (find_overlay_candidate (window));
+  clutter_actor_destroy (chrome);
+
+  emit_sync_event (0);
+  meta_wayland_test_client_finish (wayland_test_client);
+
+  wayland_test_client =
+    meta_wayland_test_client_new_with_args (test_context,
+                                            "overlay-candidate",
+                                            "translucent",
+                                            NULL);
+  wait_for_sync_point (0);
+  window = find_client_window ("overlay-candidate");
+  meta_wait_for_effects (window);
+  meta_wait_for_paint (test_context);
+
+  g_assert_null (find_overlay_candidate (window));
+
+  emit_sync_event (0);
+  meta_wayland_test_client_finish (wayland_test_client);
+
+  meta_cursor_tracker_uninhibit_cursor_visibility (cursor_tracker);
+}
+
 static void
 toplevel_tag (void)
 {
@@ -2101,10 +2326,16 @@ init_tests (void)
                    toplevel_show_states);
   g_test_add_func ("/wayland/toplevel/suspended",
                    toplevel_suspended);
+  g_test_add_func ("/wayland/toplevel/hidden-frame-callback-throttling",
+                   toplevel_hidden_frame_callback_throttling);
   g_test_add_func ("/wayland/cursor/shape",
                    cursor_shape);
   g_test_add_func ("/wayland/toplevel/tag",
                    toplevel_tag);
+  g_test_add_func ("/wayland/client/dispatch-fairness",
+                   client_dispatch_fairness);
+  g_test_add_func ("/wayland/compositor/overlay-candidate",
+                   overlay_candidate);
   g_test_add_func ("/wayland/toplevel/activation-before-mapped",
                    toplevel_activation_before_mapped);
   g_test_add_func ("/wayland/toplevel/fixed-size-fullscreen",
@@ -2125,6 +2356,10 @@ main (int   argc,
   MetaTestRunFlags test_run_flags;
 
   g_setenv ("MUTTER_DEBUG_SESSION_MANAGEMENT_PROTOCOL", "1", TRUE);
+  g_setenv ("MUTTER_DEBUG_WAYLAND_CLIENT_STATISTICS", "1", TRUE);
+  g_setenv ("MUTTER_DEBUG_HIDDEN_FRAME_CALLBACK_INTERVAL_MS", "250", TRUE);
+  /* Low enough for what libwayland reads from a client at once to exceed. */
+  g_setenv ("MUTTER_DEBUG_WAYLAND_FLOOD_THRESHOLD", "100", TRUE);
 
 #ifdef MUTTER_PRIVILEGED_TEST
   context = meta_create_test_context (META_CONTEXT_TEST_TYPE_VKMS,
@@ -0,0 +1,328 @@
+/*
+ * Copyright (C) 2026 Red Hat Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include "core/display-private.h"
+#include "core/meta-context-private.h"
+#include "core/stack.h"
+#include "core/window-private.h"
+#include "meta/meta-workspace-manager.h"
+#include "meta/workspace.h"
+#include "tests/meta-test-utils.h"
+#include "tests/meta-test/meta-context-test.h"
+
+/* With -m perf, the registry is exercised with as many windows as a heavy
+ * session might have */
+#define N_WINDOWS 50
+#define N_PERF_WINDOWS 500
+#define N_WORKSPACES 4
+#define N_ITERATIONS 1000
+
+static MetaContext *test_context;
+
+static int
+get_n_windows (void)
+{
+  return g_test_perf () ? N_PERF_WINDOWS : N_WINDOWS;
+}
+
+static MetaTestClient *
+create_windows (const char *client_id,
+                GPtrArray  *windows)
+{
+  MetaDisplay *display = meta_context_get_display (test_context);
+  MetaWorkspaceManager *workspace_manager =
+    meta_display_get_workspace_manager (display);
+  MetaTestClient *test_client;
+  g_autoptr (GError) error = NULL;
+  int i;
+
+  while (meta_workspace_manager_get_n_workspaces (workspace_manager) <
+         N_WORKSPACES)
+    {
+      meta_workspace_manager_append_new_workspace (workspace_manager, FALSE,
+                                                   META_CURRENT_TIME);
+    }
+
+  test_client = meta_test_client_new (test_context,
+                                      client_id,
+                                      META_WINDOW_CLIENT_TYPE_WAYLAND,
+                                      &error);
+  if (!test_client)
+    g_error ("Failed to launch test client: %s", error->message);
+
+  for (i = 0; i < get_n_windows (); i++)
+    {
+      g_autofree char *window_name = g_strdup_printf ("w%d", i);
+
+      if (!meta_test_client_do (test_client, &error,
+                                "create", window_name, NULL) ||
+          !meta_test_client_do (test_client, &error,
+                                "show", window_name, NULL))
+        g_error ("Failed to create window: %s", error->message);
+    }
+
+  if (!meta_test_client_wait (test_client, &error))
+    g_error ("Failed to wait for test client: %s", error->message);
+
+  for (i = 0; i < get_n_windows (); i++)
+    {
+      g_autofree char *window_name = g_strdup_printf ("w%d", i);
+      MetaWindow *window;
+
+      window = meta_test_client_find_window (test_client, window_name, &error);
+      if (!window)
+        g_error ("Failed to find window: %s", error->message);
+
+      meta_window_change_workspace_by_index (window, i % N_WORKSPACES, FALSE);
+      g_ptr_array_add (windows, window);
+    }
+
+  return test_client;
+}
+
+static void
+assert_registry_consistent (MetaDisplay *display,
+                            GPtrArray   *windows)
+{
+  g_autoptr (GHashTable) seen = NULL;
+  g_autoptr (GSList) sorted = NULL;
+  GSList *l;
+  guint32 last_user_time = G_MAXUINT32;
+  int i;
+
+  seen = g_hash_table_new (NULL, NULL);
+  sorted = meta_display_list_windows (display, META_LIST_SORTED);
+
+  for (l = sorted; l; l = l->next)
+    {
+      MetaWindow *window = l->data;
+
+      g_assert_false (g_hash_table_contains (seen, window));
+      g_hash_table_add (seen, window);
+
+      g_assert_false (window->unmanaging);
+      g_assert_cmpuint (meta_window_get_user_time (window),
+                        <=, last_user_time);
+      last_user_time = meta_window_get_user_time (window);
+    }
+
+  for (i = 0; i < windows->len; i++)
+    g_assert_true (g_hash_table_contains (seen, g_ptr_array_index (windows, i)));
+}
+
+static void
+assert_sorted_by_stacking (GSList *windows)
+{
+  GSList *l;
+
+  for (l = windows; l && l->next; l = l->next)
+    {
+      g_assert_cmpint (meta_window_stack_position_compare (l->data,
+                                                           l->next->data),
+                       <, 0);
+    }
+}
+
+static void
+meta_test_window_registry_consistency (void)
+{
+  MetaDisplay *display = meta_context_get_display (test_context);
+  g_autoptr (GPtrArray) windows = NULL;
+  g_autoptr (GSList) window_list = NULL;
+  g_autoptr (GSList) few_windows = NULL;
+  g_autoptr (GSList) stacked = NULL;
+  MetaTestClient *test_client;
+  MetaWindow *window;
+  guint32 timestamp;
+  int i;
+
+  windows = g_ptr_array_new ();
+  test_client = create_windows ("consistency", windows);
+
+  assert_registry_consistent (display, windows);
+
+  /* Activating a window makes it the most recently used one */
+  window = g_ptr_array_index (windows, windows->len / 2);
+  g_usleep (2 * G_USEC_PER_SEC / 1000);
+  timestamp = meta_display_get_current_time_roundtrip (display);
+  meta_window_activate (window, timestamp);
+
+  window_list = meta_display_list_windows (display, META_LIST_SORTED);
+  g_assert_true (window_list->data == window);
+  assert_registry_consistent (display, windows);
+
+  /* Both picking windows off the stack, and sorting a few of them */
+  for (i = 0; i < windows->len; i++)
+    stacked = g_slist_prepend (stacked, g_ptr_array_index (windows, i));
+  meta_stack_sort_windows_slist (display->stack, stacked);
+  assert_sorted_by_stacking (stacked);
+  g_assert_cmpuint (g_slist_length (stacked), ==, windows->len);
+
+  for (i = 0; i < 3; i++)
+    few_windows = g_slist_prepend (few_windows,
+                                   g_ptr_array_index (windows, i * 7));
+  meta_stack_sort_windows_slist (display->stack, few_windows);
+  assert_sorted_by_stacking (few_windows);
+
+  /* Unmanaged windows leave the registry */
+  meta_test_client_destroy (test_client);
+  meta_wait_for_update (test_context);
+
+  g_clear_pointer (&window_list, g_slist_free);
+  window_list = meta_display_list_windows (display, META_LIST_DEFAULT);
+  for (i = 0; i < windows->len; i++)
+    g_assert_null (g_slist_find (window_list, g_ptr_array_index (windows, i)));
+}
+
+static double
+time_iterations (void (* func) (MetaDisplay *display,
+                                GPtrArray   *windows),
+                 MetaDisplay *display,
+                 GPtrArray   *windows)
+{
+  g_autoptr (GTimer) timer = NULL;
+  int i;
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < N_ITERATIONS; i++)
+    func (display, windows);
+
+  return g_timer_elapsed (timer, NULL) * G_USEC_PER_SEC / N_ITERATIONS;
+}
+
+static void
+list_windows_sorted (MetaDisplay *display,
+                     GPtrArray   *windows)
+{
+  g_slist_free (meta_display_list_windows (display, META_LIST_SORTED));
+}
+
+static void
+iterate_windows (MetaDisplay *display,
+                 GPtrArray   *windows)
+{
+  MetaDisplayWindowIter iter;
+  MetaWindow *window;
+  int n_windows = 0;
+
+  meta_display_window_iter_init (&iter, display, META_LIST_SORTED);
+  while (meta_display_window_iter_next (&iter, &window))
+    n_windows++;
+
+  g_assert_cmpint (n_windows, >=, windows->len);
+}
+
+static void
+sort_windows_by_stacking (MetaDisplay *display,
+                          GPtrArray   *windows)
+{
+  GSList *window_list = NULL;
+  GSList *sorted;
+  int i;
+
+  for (i = 0; i < windows->len; i++)
+    window_list = g_slist_prepend (window_list, g_ptr_array_index (windows, i));
+
+  sorted = meta_display_sort_windows_by_stacking (display, window_list);
+
+  g_slist_free (sorted);
+  g_slist_free (window_list);
+}
+
+static void
+switch_workspace (MetaDisplay *display,
+                  GPtrArray   *windows)
+{
+  MetaWorkspaceManager *workspace_manager =
+    meta_display_get_workspace_manager (display);
+  MetaWorkspace *workspace;
+  int index;
+
+  index = meta_workspace_manager_get_active_workspace_index (workspace_manager);
+  workspace = meta_workspace_manager_get_workspace_by_index (workspace_manager,
+                                                             (index + 1) %
+                                                             N_WORKSPACES);
+  meta_workspace_activate (workspace,
+                           meta_display_get_current_time_roundtrip (display));
+}
+
+static void
+meta_test_window_registry_benchmark (void)
+{
+  MetaDisplay *display = meta_context_get_display (test_context);
+  g_autoptr (GPtrArray) windows = NULL;
+  MetaTestClient *test_client;
+  double list_time_us;
+  double iterate_time_us;
+  double stacking_time_us;
+  double switch_time_us;
+
+  windows = g_ptr_array_new ();
+  test_client = create_windows ("benchmark", windows);
+
+  list_time_us = time_iterations (list_windows_sorted, display, windows);
+  iterate_time_us = time_iterations (iterate_windows, display, windows);
+  stacking_time_us = time_iterations (sort_windows_by_stacking,
+                                      display, windows);
+  switch_time_us = time_iterations (switch_workspace, display, windows);
+
+  /* Let the queued visibility updates run */
+  meta_wait_for_update (test_context);
+
+  g_test_message ("%u windows on %d workspaces: "
+                  "list sorted %.2f us, iterate %.2f us, "
+                  "sort by stacking %.2f us, switch workspace %.2f us",
+                  windows->len, N_WORKSPACES,
+                  list_time_us, iterate_time_us,
+                  stacking_time_us, switch_time_us);
+  g_test_minimized_result (switch_time_us,
+                           "Workspace switch with %u windows: %.2f us",
+                           windows->len, switch_time_us);
+
+  meta_test_client_destroy (test_client);
+}
+
+static void
+init_tests (void)
+{
+  g_test_add_func ("/core/window-registry/consistency",
+                   meta_test_window_registry_consistency);
+  g_test_add_func ("/core/window-registry/benchmark",
+                   meta_test_window_registry_benchmark);
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  g_autoptr (MetaContext) context = NULL;
+
+  context = meta_create_test_context (META_CONTEXT_TEST_TYPE_HEADLESS,
+                                      META_CONTEXT_TEST_FLAG_NO_X11);
+  g_assert (meta_context_configure (context, &argc, &argv, NULL));
+
+  test_context = context;
+
+  init_tests ();
+
+  return meta_context_test_run_tests (META_CONTEXT_TEST (context),
+                                      META_TEST_RUN_FLAG_NONE);
+}
@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2026 Red Hat Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include "core/meta-context-private.h"
+#include "core/meta-workspace-manager-private.h"
+#include "meta/meta-workspace-manager.h"
+#include "meta/workspace.h"
+#include "tests/meta-test-utils.h"
+#include "tests/meta-test/meta-context-test.h"
+
+#define N_MONITORS 8
+#define N_WORKSPACES 4
+#define MONITOR_WIDTH 640
+#define MONITOR_HEIGHT 480
+#define PANEL_HEIGHT 32
+#define DOCK_HEIGHT 48
+#define SIDE_DOCK_WIDTH 64
+
+static MetaContext *test_context;
+
+typedef struct
+{
+  int dock_heights[N_MONITORS];
+  int side_dock_monitor;
+} StrutLayout;
+
+static MetaDisplay *
+get_display (void)
+{
+  return meta_context_get_display (test_context);
+}
+
+static MetaWorkspaceManager *
+get_workspace_manager (void)
+{
+  return meta_display_get_workspace_manager (get_display ());
+}
+
+static void
+dispatch (void)
+{
+  while (g_main_context_iteration (NULL, FALSE));
+}
+
+static void
+reset_stats (void)
+{
+  get_workspace_manager ()->work_area_stats = (MetaWorkAreaStats) { 0 };
+}
+
+/* A panel at the top and a dock at the bottom of every monitor, and
+ * optionally another dock on the left edge of the leftmost monitor
+ */
+static GSList *
+create_struts (const StrutLayout *layout)
+{
+  MetaDisplay *display = get_display ();
+  GSList *struts = NULL;
+  int i;
+
+  for (i = 0; i < meta_display_get_n_monitors (display); i++)
+    {
+      MtkRectangle rect;
+      MetaStrut *strut;
+
+      meta_display_get_monitor_geometry (display, i, &rect);
+
+      strut = g_new0 (MetaStrut, 1);
+      strut->side = META_SIDE_TOP;
+      strut->rect = MTK_RECTANGLE_INIT (rect.x, rect.y,
+                                        rect.width, PANEL_HEIGHT);
+      struts = g_slist_prepend (struts, strut);
+
+      strut = g_new0 (MetaStrut, 1);
+      strut->side = META_SIDE_BOTTOM;
+      strut->rect = MTK_RECTANGLE_INIT (rect.x,
+                                        rect.y + rect.height -
+                                        layout->dock_heights[i],
+                                        rect.width,
+                                        layout->dock_heights[i]);
+      struts = g_slist_prepend (struts, strut);
+
+      if (i == layout->side_dock_monitor)
+        {
+          strut = g_new0 (MetaStrut, 1);
+          strut->side = META_SIDE_LEFT;
+          strut->rect = MTK_RECTANGLE_INIT (rect.x, rect.y,
+                                            SIDE_DOCK_WIDTH, rect.height);
+          struts = g_slist_prepend (struts, strut);
+        }
+    }
+
+  return struts;
+}
+
+static void
+set_struts (MetaWorkspace     *workspace,
+            const StrutLayout *layout)
+{
+  g_autoslist (MetaStrut) struts = NULL;
+
+  struts = create_struts (layout);
+  meta_workspace_set_builtin_struts (workspace, struts);
+}
+
+static void
+set_struts_on_all_workspaces (const StrutLayout *layout)
+{
+  MetaWorkspaceManager *workspace_manager = get_workspace_manager ();
+  int i;
+
+  for (i = 0; i < N_WORKSPACES; i++)
+    {
+      set_struts (meta_workspace_manager_get_workspace_by_index (workspace_manager, i),
+                  layout);
+    }
+}
+
+static void
+assert_work_areas (MetaWorkspace     *workspace,
+                   const StrutLayout *layout)
+{
+  MetaDisplay *display = get_display ();
+  int i;
+
+  for (i = 0; i < meta_display_get_n_monitors (display); i++)
+    {
+      MtkRectangle rect;
+      MtkRectangle expected;
+      MtkRectangle work_area;
+
+      meta_display_get_monitor_geometry (display, i, &rect);
+
+      expected = MTK_RECTANGLE_INIT (rect.x, rect.y + PANEL_HEIGHT,
+                                     rect.width,
+                                     rect.height - PANEL_HEIGHT -
+                                     layout->dock_heights[i]);
+      if (i == layout->side_dock_monitor)
+        {
+          expected.x += SIDE_DOCK_WIDTH;
+          expected.width -= SIDE_DOCK_WIDTH;
+        }
+
+      meta_workspace_get_work_area_for_monitor (workspace, i, &work_area);
+      g_assert_true (mtk_rectangle_equal (&work_area, &expected));
+    }
+}
+
+static void
+assert_all_work_areas (const StrutLayout *layout)
+{
+  MetaWorkspaceManager *workspace_manager = get_workspace_manager ();
+  int i;
+
+  for (i = 0; i < N_WORKSPACES; i++)
+    {
+      assert_work_areas (meta_workspace_manager_get_workspace_by_index (workspace_manager, i),
+                         layout);
+    }
+}
+
+static void
+meta_test_work_area_incremental (void)
+{
+  MetaWorkspaceManager *workspace_manager = get_workspace_manager ();
+  MetaWorkAreaStats *stats = &workspace_manager->work_area_stats;
+  MetaVirtualMonitor *virtual_monitors[N_MONITORS];
+  StrutLayout layout = { .side_dock_monitor = -1 };
+  MetaWorkspace *workspace;
+  int i;
+
+  for (i = 0; i < N_MONITORS; i++)
+    {
+      virtual_monitors[i] = meta_create_test_monitor (test_context,
+                                                      MONITOR_WIDTH,
+                                                      MONITOR_HEIGHT,
+                                                      60.0);
+      layout.dock_heights[i] = DOCK_HEIGHT;
+    }
+  g_assert_cmpint (meta_display_get_n_monitors (get_display ()), ==, N_MONITORS);
+
+  while (meta_workspace_manager_get_n_workspaces (workspace_manager) <
+         N_WORKSPACES)
+    {
+      meta_workspace_manager_append_new_workspace (workspace_manager, FALSE,
+                                                   META_CURRENT_TIME);
+    }
+  dispatch ();
+
+  /* The same docks on all workspaces are only computed for once */
+  reset_stats ();
+  set_struts_on_all_workspaces (&layout);
+  assert_all_work_areas (&layout);
+
+  g_assert_cmpuint (stats->n_monitors_computed, ==, N_MONITORS);
+  g_assert_cmpuint (stats->n_monitors_shared, ==,
+                    N_MONITORS * (N_WORKSPACES - 1));
+  g_assert_cmpuint (stats->n_screen_computed, ==, 1);
+  g_assert_cmpuint (stats->n_screen_shared, ==, N_WORKSPACES - 1);
+
+  /* A dock changing size only affects the monitor it is on */
+  reset_stats ();
+  layout.dock_heights[3] = DOCK_HEIGHT * 2;
+  set_struts_on_all_workspaces (&layout);
+  assert_all_work_areas (&layout);
+
+  g_assert_cmpuint (stats->n_monitors_computed, ==, 1);
+  g_assert_cmpuint (stats->n_monitors_shared, ==, N_WORKSPACES - 1);
+  g_assert_cmpuint (stats->n_monitors_kept, ==,
+                    (N_MONITORS - 1) * N_WORKSPACES);
+  g_assert_cmpuint (stats->n_screen_computed, ==, 1);
+  g_assert_cmpuint (stats->n_screen_shared, ==, N_WORKSPACES - 1);
+
+  /* As does one only on one workspace, leaving the others alone */
+  reset_stats ();
+  layout.side_dock_monitor = 0;
+  workspace = meta_workspace_manager_get_workspace_by_index (workspace_manager,
+                                                             0);
+  set_struts (workspace, &layout);
+  assert_work_areas (workspace, &layout);
+
+  g_assert_cmpuint (stats->n_monitors_computed, ==, 1);
+  g_assert_cmpuint (stats->n_monitors_kept, ==, N_MONITORS - 1);
+  g_assert_cmpuint (stats->n_screen_computed, ==, 1);
+
+  reset_stats ();
+  layout.side_dock_monitor = -1;
+  for (i = 1; i < N_WORKSPACES; i++)
+    {
+      assert_work_areas (meta_workspace_manager_get_workspace_by_index (workspace_manager, i),
+                         &layout);
+    }
+  g_assert_cmpuint (stats->n_monitors_computed, ==, 0);
+  g_assert_cmpuint (stats->n_screen_computed, ==, 0);
+
+  /* Going back to what the other workspaces have shares their results */
+  reset_stats ();
+  set_struts (workspace, &layout);
+  assert_all_work_areas (&layout);
+
+  g_assert_cmpuint (stats->n_monitors_computed, ==, 0);
+  g_assert_cmpuint (stats->n_monitors_shared, ==, 1);
+  g_assert_cmpuint (stats->n_screen_computed, ==, 0);
+  g_assert_cmpuint (stats->n_screen_shared, ==, 1);
+
+  /* Monitors that remain in place keep their work areas when another one
+   * goes away */
+  reset_stats ();
+  g_clear_object (&virtual_monitors[N_MONITORS - 1]);
+  dispatch ();
+  g_assert_cmpint (meta_display_get_n_monitors (get_display ()), ==,
+                   N_MONITORS - 1);
+  assert_all_work_areas (&layout);
+
+  g_assert_cmpuint (stats->n_monitors_computed, ==, 0);
+  g_assert_cmpuint (stats->n_monitors_kept, ==,
+                    (N_MONITORS - 1) * N_WORKSPACES);
+
+  set_struts_on_all_workspaces (&(StrutLayout) { .side_dock_monitor = -1 });
+  for (i = 0; i < N_MONITORS - 1; i++)
+    g_object_unref (virtual_monitors[i]);
+  dispatch ();
+}
+
+static void
+init_tests (void)
+{
+  g_test_add_func ("/core/work-area/incremental",
+                   meta_test_work_area_incremental);
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  g_autoptr (MetaContext) context = NULL;
+
+  context = meta_create_test_context (META_CONTEXT_TEST_TYPE_HEADLESS,
+                                      META_CONTEXT_TEST_FLAG_NO_X11);
+  g_assert (meta_context_configure (context, &argc, &argv, NULL));
+
+  test_context = context;
+
+  init_tests ();
+
+  return meta_context_test_run_tests (META_CONTEXT_TEST (context),
+                                      META_TEST_RUN_FLAG_NONE);
+}
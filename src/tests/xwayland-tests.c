@@ -18,12 +18,28 @@
 
 #include "config.h"
 
+#include <gio/gunixinputstream.h>
+#include <gio/gunixoutputstream.h>
+#include <glib-unix.h>
+#include <time.h>
+
+#include "core/meta-selection-private.h"
 #include "meta/meta-selection.h"
+#include "meta/meta-selection-source-memory.h"
 #include "meta-test/meta-context-test.h"
+#include "mtk/mtk-x11.h"
 #include "tests/meta-test-utils.h"
 #include "wayland/meta-wayland.h"
 #include "wayland/meta-xwayland.h"
 #include "x11/meta-x11-display-private.h"
+#include "x11/window-x11.h"
+
+#define THROUGHPUT_MIMETYPE "application/mutter-test"
+#define THROUGHPUT_SIZE (128 * 1024 * 1024)
+#define READ_CHUNK_SIZE (64 * 1024)
+
+#define N_SYNCED_WINDOWS 32
+#define N_SYNCED_RESIZES 8
 
 static MetaContext *test_context;
 
@@ -300,6 +316,458 @@ meta_test_xwayland_compositor_selection (void)
   g_assert_nonnull (meta_display_get_x11_display (display));
 }
 
+static uint8_t
+get_pattern_byte (goffset offset)
+{
+  return (uint8_t) ((offset * 7) ^ (offset >> 12));
+}
+
+static void
+report_throughput (const char *description,
+                   size_t      size,
+                   int64_t     time_us)
+{
+  double size_mb = size / (1024.0 * 1024.0);
+  double mb_per_s = size_mb / (time_us / (double) G_USEC_PER_SEC);
+
+  g_test_message ("%s: %.0f MB in %.1f ms (%.1f MB/s)",
+                  description, size_mb, time_us / 1000.0, mb_per_s);
+  g_test_maximized_result (mb_per_s, "%s: %.1f MB/s", description, mb_per_s);
+}
+
+typedef struct
+{
+  GInputStream *input;
+  uint8_t buffer[READ_CHUNK_SIZE];
+  goffset offset;
+  gboolean eof;
+  gboolean transfer_done;
+} PatternReader;
+
+static void
+pattern_read_cb (GObject      *source_object,
+                 GAsyncResult *result,
+                 gpointer      user_data)
+{
+  PatternReader *reader = user_data;
+  g_autoptr (GError) error = NULL;
+  gssize n_read;
+  gssize i;
+
+  n_read = g_input_stream_read_finish (reader->input, result, &error);
+  g_assert_no_error (error);
+
+  if (n_read == 0)
+    {
+      reader->eof = TRUE;
+      return;
+    }
+
+  for (i = 0; i < n_read; i++)
+    {
+      if (reader->buffer[i] != get_pattern_byte (reader->offset + i))
+        g_error ("Transferred contents differ at offset %" G_GOFFSET_FORMAT,
+                 reader->offset + i);
+    }
+
+  reader->offset += n_read;
+
+  g_input_stream_read_async (reader->input,
+                             reader->buffer, sizeof (reader->buffer),
+                             G_PRIORITY_DEFAULT, NULL,
+                             pattern_read_cb, reader);
+}
+
+static void
+pattern_transfer_cb (GObject      *source_object,
+                     GAsyncResult *result,
+                     gpointer      user_data)
+{
+  PatternReader *reader = user_data;
+  g_autoptr (GError) error = NULL;
+
+  g_assert_true (meta_selection_transfer_finish (META_SELECTION (source_object),
+                                                 result, &error));
+  g_assert_no_error (error);
+
+  reader->transfer_done = TRUE;
+}
+
+static void
+transfer_pattern_from_x11 (MetaSelection *selection,
+                           size_t         chunk_size)
+{
+  g_autoptr (GOutputStream) output = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree PatternReader *reader = NULL;
+  g_autofree char *description = NULL;
+  int64_t start_us;
+  int fds[2];
+
+  meta_selection_set_transfer_chunk_size (selection, chunk_size);
+
+  g_assert_true (g_unix_open_pipe (fds, FD_CLOEXEC, &error));
+  g_assert_no_error (error);
+
+  reader = g_new0 (PatternReader, 1);
+  reader->input = g_unix_input_stream_new (fds[0], TRUE);
+  output = g_unix_output_stream_new (fds[1], TRUE);
+
+  start_us = g_get_monotonic_time ();
+
+  meta_selection_transfer_async (selection,
+                                 META_SELECTION_CLIPBOARD,
+                                 THROUGHPUT_MIMETYPE,
+                                 -1,
+                                 output,
+                                 NULL,
+                                 pattern_transfer_cb,
+                                 reader);
+  g_input_stream_read_async (reader->input,
+                             reader->buffer, sizeof (reader->buffer),
+                             G_PRIORITY_DEFAULT, NULL,
+                             pattern_read_cb, reader);
+
+  while (!reader->transfer_done || !reader->eof)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_cmpint (reader->offset, ==, THROUGHPUT_SIZE);
+
+  description = g_strdup_printf ("X11 client to compositor, %zu kB chunks",
+                                 chunk_size / 1024);
+  report_throughput (description, THROUGHPUT_SIZE,
+                     g_get_monotonic_time () - start_us);
+
+  g_object_unref (reader->input);
+}
+
+static void
+meta_test_xwayland_selection_throughput_from_x11 (void)
+{
+  MetaDisplay *display = meta_context_get_display (test_context);
+  MetaSelection *selection = meta_display_get_selection (display);
+  MetaX11Display *x11_display;
+  MetaTestClient *test_client;
+  g_autofree char *size = NULL;
+  g_autoptr (GError) error = NULL;
+
+  test_client = meta_test_client_new (test_context,
+                                      "selection-from-x11",
+                                      META_WINDOW_CLIENT_TYPE_X11,
+                                      &error);
+  if (!test_client)
+    g_error ("Failed to launch test client: %s", error->message);
+
+  ensure_xwayland (test_context);
+  x11_display = meta_display_get_x11_display (display);
+
+  g_assert_null (x11_display->selection.owners[META_SELECTION_CLIPBOARD]);
+
+  size = g_strdup_printf ("%d", THROUGHPUT_SIZE);
+  test_client_do_check (test_client,
+                        "create", "clipboard-window",
+                        NULL);
+  test_client_do_check (test_client,
+                        "clipboard-set-pattern", THROUGHPUT_MIMETYPE, size,
+                        NULL);
+  test_client_wait_check (test_client);
+
+  while (!x11_display->selection.owners[META_SELECTION_CLIPBOARD])
+    g_main_context_iteration (NULL, TRUE);
+
+  /* The contents come in INCR chunks, whatever the transfer chunk size */
+  transfer_pattern_from_x11 (selection, 64 * 1024);
+  transfer_pattern_from_x11 (selection, 1024 * 1024);
+  meta_selection_set_transfer_chunk_size (selection, 64 * 1024);
+
+  meta_test_client_destroy (test_client);
+}
+
+static void
+meta_test_xwayland_selection_throughput_to_x11 (void)
+{
+  MetaDisplay *display = meta_context_get_display (test_context);
+  MetaSelection *selection = meta_display_get_selection (display);
+  g_autoptr (MetaSelectionSource) source = NULL;
+  g_autoptr (GBytes) bytes = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree char *size = NULL;
+  MetaTestClient *test_client;
+  uint8_t *data;
+  int64_t start_us;
+  size_t i;
+
+  test_client = meta_test_client_new (test_context,
+                                      "selection-to-x11",
+                                      META_WINDOW_CLIENT_TYPE_X11,
+                                      &error);
+  if (!test_client)
+    g_error ("Failed to launch test client: %s", error->message);
+
+  ensure_xwayland (test_context);
+
+  test_client_do_check (test_client,
+                        "create", "clipboard-window",
+                        NULL);
+  test_client_wait_check (test_client);
+
+  data = g_malloc (THROUGHPUT_SIZE);
+  for (i = 0; i < THROUGHPUT_SIZE; i++)
+    data[i] = get_pattern_byte (i);
+  bytes = g_bytes_new_take (data, THROUGHPUT_SIZE);
+
+  source = meta_selection_source_memory_new (THROUGHPUT_MIMETYPE, bytes);
+  meta_selection_set_owner (selection, META_SELECTION_CLIPBOARD, source);
+
+  /* The client takes the contents through the X11 INCR protocol */
+  size = g_strdup_printf ("%d", THROUGHPUT_SIZE);
+  start_us = g_get_monotonic_time ();
+  test_client_do_check (test_client,
+                        "clipboard-check-pattern", THROUGHPUT_MIMETYPE, size,
+                        NULL);
+  report_throughput ("Compositor to X11 client", THROUGHPUT_SIZE,
+                     g_get_monotonic_time () - start_us);
+
+  meta_selection_unset_owner (selection, META_SELECTION_CLIPBOARD, source);
+  meta_test_client_destroy (test_client);
+}
+
+static int64_t
+get_thread_time_us (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_THREAD_CPUTIME_ID, &ts);
+
+  return ts.tv_sec * G_USEC_PER_SEC + ts.tv_nsec / 1000;
+}
+
+static gboolean
+sync_counters_ready (MetaWindow **windows)
+{
+  int i;
+
+  for (i = 0; i < N_SYNCED_WINDOWS; i++)
+    {
+      MetaSyncCounter *sync_counter =
+        meta_window_x11_get_sync_counter (windows[i]);
+
+      if (!meta_sync_counter_has_sync_alarm (sync_counter) ||
+          meta_sync_counter_is_waiting (sync_counter))
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+static void
+meta_test_xwayland_sync_counter_many_windows (void)
+{
+  g_autoptr (MetaVirtualMonitor) virtual_monitor = NULL;
+  g_autoptr (GError) error = NULL;
+  MetaTestClient *test_client;
+  MetaWindow *windows[N_SYNCED_WINDOWS];
+  int64_t start_time_us;
+  int64_t map_time_us;
+  int64_t resize_time_us;
+  int64_t last_serials[N_SYNCED_WINDOWS];
+  int i, j;
+
+  virtual_monitor = meta_create_test_monitor (test_context, 640, 480, 60.0);
+
+  test_client = meta_test_client_new (test_context, "synced",
+                                      META_WINDOW_CLIENT_TYPE_X11,
+                                      &error);
+  if (!test_client)
+    g_error ("Failed to launch test client: %s", error->message);
+
+  ensure_xwayland (test_context);
+
+  /* Mapping windows with extended sync request counters sets up the
+   * alarms without waiting for the X server */
+  start_time_us = get_thread_time_us ();
+
+  for (i = 0; i < N_SYNCED_WINDOWS; i++)
+    {
+      g_autofree char *id = g_strdup_printf ("%d", i);
+
+      test_client_do_check (test_client, "create", id, NULL);
+      test_client_do_check (test_client, "show", id, NULL);
+    }
+  test_client_wait_check (test_client);
+
+  for (i = 0; i < N_SYNCED_WINDOWS; i++)
+    {
+      g_autofree char *id = g_strdup_printf ("%d", i);
+
+      windows[i] = meta_test_client_find_window (test_client, id, &error);
+      g_assert_no_error (error);
+      g_assert_true (meta_window_x11_get_sync_counter (windows[i])->extended_sync_request_counter);
+    }
+
+  while (!sync_counters_ready (windows))
+    g_main_context_iteration (NULL, TRUE);
+
+  map_time_us = get_thread_time_us () - start_time_us;
+
+  /* All of them then go through a few frames, each resulting in frame
+   * drawn and frame timings messages */
+  start_time_us = get_thread_time_us ();
+
+  for (j = 0; j < N_SYNCED_RESIZES; j++)
+    {
+      for (i = 0; i < N_SYNCED_WINDOWS; i++)
+        {
+          g_autofree char *id = g_strdup_printf ("%d", i);
+          g_autofree char *width = g_strdup_printf ("%d", 100 + j * 10);
+          g_autofree char *height = g_strdup_printf ("%d", 80 + j * 10);
+
+          last_serials[i] =
+            meta_window_x11_get_sync_counter (windows[i])->sync_request_serial;
+          test_client_do_check (test_client, "resize", id, width, height,
+                                NULL);
+        }
+      test_client_wait_check (test_client);
+
+      for (i = 0; i < N_SYNCED_WINDOWS; i++)
+        {
+          MetaSyncCounter *sync_counter =
+            meta_window_x11_get_sync_counter (windows[i]);
+
+          while (sync_counter->sync_request_serial == last_serials[i] ||
+                 !sync_counters_ready (windows))
+            g_main_context_iteration (NULL, TRUE);
+        }
+    }
+
+  resize_time_us = get_thread_time_us () - start_time_us;
+
+  g_test_message ("%d synced windows: mapped in %.1f ms, "
+                  "%d frames each in %.1f ms of main thread time",
+                  N_SYNCED_WINDOWS, map_time_us / 1000.0,
+                  N_SYNCED_RESIZES, resize_time_us / 1000.0);
+  g_test_minimized_result (map_time_us / 1000.0,
+                           "map %d synced windows: %.1f ms",
+                           N_SYNCED_WINDOWS, map_time_us / 1000.0);
+  g_test_minimized_result (resize_time_us / 1000.0,
+                           "resize %d synced windows: %.1f ms",
+                           N_SYNCED_WINDOWS, resize_time_us / 1000.0);
+
+  meta_test_client_destroy (test_client);
+}
+
+static void
+set_sync_counter (MetaTestClient  *test_client,
+                  MetaSyncCounter *sync_counter,
+                  int64_t          value)
+{
+  g_autofree char *counter_str = NULL;
+  g_autofree char *value_str = NULL;
+
+  counter_str = g_strdup_printf ("%lu", sync_counter->sync_request_counter);
+  value_str = g_strdup_printf ("%" G_GINT64_FORMAT, value);
+  test_client_do_check (test_client, "set_counter", counter_str, value_str,
+                        NULL);
+  test_client_wait_check (test_client);
+
+  while (sync_counter->sync_request_serial != value)
+    g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+meta_test_xwayland_sync_counter_initial_value (void)
+{
+  g_autoptr (MetaVirtualMonitor) virtual_monitor = NULL;
+  g_autoptr (GError) error = NULL;
+  MetaTestClient *test_client;
+  MetaWindow *window;
+  MetaSyncCounter *sync_counter;
+  Display *xdisplay;
+  XSyncCounter counter;
+  unsigned long serial;
+  int64_t value;
+
+  virtual_monitor = meta_create_test_monitor (test_context, 640, 480, 60.0);
+
+  test_client = meta_test_client_new (test_context, "synced",
+                                      META_WINDOW_CLIENT_TYPE_X11,
+                                      &error);
+  if (!test_client)
+    g_error ("Failed to launch test client: %s", error->message);
+
+  ensure_xwayland (test_context);
+
+  test_client_do_check (test_client, "create", "1", NULL);
+  test_client_do_check (test_client, "show", "1", NULL);
+  test_client_wait_check (test_client);
+
+  window = meta_test_client_find_window (test_client, "1", &error);
+  g_assert_no_error (error);
+  sync_counter = meta_window_x11_get_sync_counter (window);
+  g_assert_true (sync_counter->extended_sync_request_counter);
+  xdisplay = window->display->x11_display->xdisplay;
+  counter = sync_counter->sync_request_counter;
+
+  while (!meta_sync_counter_has_sync_alarm (sync_counter) ||
+         meta_sync_counter_is_waiting (sync_counter))
+    g_main_context_iteration (NULL, TRUE);
+
+  /* Make the client appear to be in the middle of drawing a frame */
+  value = sync_counter->sync_request_serial + 1;
+  g_assert_true (value % 2 == 1);
+  set_sync_counter (test_client, sync_counter, value);
+  g_assert_true (meta_sync_counter_is_waiting (sync_counter));
+  g_assert_true (meta_window_updates_are_frozen (window));
+
+  /* Setting up the alarm, as done on map, doesn't wait for the X server,
+   * but holds back the window until the initial value is known */
+  serial = XNextRequest (xdisplay);
+  meta_sync_counter_destroy_sync_alarm (sync_counter);
+  meta_sync_counter_create_sync_alarm (sync_counter);
+  g_assert_cmpuint (LastKnownRequestProcessed (xdisplay), <, serial);
+  g_assert_true (sync_counter->initial_value_pending);
+  g_assert_true (meta_sync_counter_is_waiting (sync_counter));
+  g_assert_true (meta_window_updates_are_frozen (window));
+
+  while (sync_counter->initial_value_pending)
+    g_main_context_iteration (NULL, TRUE);
+
+  /* An odd initial value leaves the window frozen, with nothing to report
+   * until the client finishes the frame */
+  g_assert_cmpint (sync_counter->sync_request_serial, ==, value);
+  g_assert_true (meta_sync_counter_has_sync_alarm (sync_counter));
+  g_assert_true (meta_sync_counter_is_waiting (sync_counter));
+  g_assert_true (meta_window_updates_are_frozen (window));
+  g_assert_null (sync_counter->frames);
+  g_assert_false (sync_counter->needs_frame_drawn);
+
+  set_sync_counter (test_client, sync_counter, value + 1);
+  g_assert_false (meta_sync_counter_is_waiting (sync_counter));
+  g_assert_false (meta_window_updates_are_frozen (window));
+
+  /* An alarm that never delivers the initial value only holds back the
+   * window until the sync request timeout */
+  meta_sync_counter_set_counter (sync_counter, sync_counter->xwindow, TRUE);
+  g_assert_true (meta_sync_counter_is_waiting (sync_counter));
+
+  while (meta_sync_counter_is_waiting (sync_counter))
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_true (sync_counter->disabled);
+  g_assert_false (meta_window_updates_are_frozen (window));
+
+  /* Destroying the alarm on the bogus counter fails */
+  mtk_x11_error_trap_push (xdisplay);
+  meta_sync_counter_set_counter (sync_counter, counter, TRUE);
+  mtk_x11_error_trap_pop (xdisplay);
+
+  while (!meta_sync_counter_has_sync_alarm (sync_counter) ||
+         meta_sync_counter_is_waiting (sync_counter))
+    g_main_context_iteration (NULL, TRUE);
+
+  meta_test_client_destroy (test_client);
+}
+
 static void
 init_tests (void)
 {
@@ -311,6 +779,14 @@ init_tests (void)
                    meta_test_xwayland_crash_only_x11);
   g_test_add_func ("/backends/xwayland/crash/hammer-activate",
                    meta_test_hammer_activate);
+  g_test_add_func ("/backends/xwayland/selection/throughput-from-x11",
+                   meta_test_xwayland_selection_throughput_from_x11);
+  g_test_add_func ("/backends/xwayland/selection/throughput-to-x11",
+                   meta_test_xwayland_selection_throughput_to_x11);
+  g_test_add_func ("/backends/xwayland/sync-counter/many-windows",
+                   meta_test_xwayland_sync_counter_many_windows);
+  g_test_add_func ("/backends/xwayland/sync-counter/initial-value",
+                   meta_test_xwayland_sync_counter_initial_value);
 }
 
 int
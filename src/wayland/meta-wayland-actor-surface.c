@@ -42,6 +42,7 @@ struct _MetaWaylandActorSurfacePrivate
   gulong actor_destroyed_handler_id;
 
   struct wl_list frame_callback_list;
+  int64_t last_frame_callbacks_time_us;
 };
 
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (MetaWaylandActorSurface,
@@ -141,6 +142,8 @@ meta_wayland_actor_surface_emit_frame_callbacks (MetaWaylandActorSurface *actor_
   MetaWaylandActorSurfacePrivate *priv =
     meta_wayland_actor_surface_get_instance_private (actor_surface);
 
+  priv->last_frame_callbacks_time_us = g_get_monotonic_time ();
+
   while (!wl_list_empty (&priv->frame_callback_list))
     {
       MetaWaylandFrameCallback *callback =
@@ -151,6 +154,15 @@ meta_wayland_actor_surface_emit_frame_callbacks (MetaWaylandActorSurface *actor_
     }
 }
 
+int64_t
+meta_wayland_actor_surface_get_last_frame_callbacks_time (MetaWaylandActorSurface *actor_surface)
+{
+  MetaWaylandActorSurfacePrivate *priv =
+    meta_wayland_actor_surface_get_instance_private (actor_surface);
+
+  return priv->last_frame_callbacks_time_us;
+}
+
 int
 meta_wayland_actor_surface_get_geometry_scale (MetaWaylandActorSurface *actor_surface)
 {
@@ -47,3 +47,5 @@ void meta_wayland_actor_surface_queue_frame_callbacks (MetaWaylandActorSurface *
 
 void meta_wayland_actor_surface_emit_frame_callbacks (MetaWaylandActorSurface *actor_surface,
                                                       uint32_t                 timestamp_ms);
+
+int64_t meta_wayland_actor_surface_get_last_frame_callbacks_time (MetaWaylandActorSurface *actor_surface);
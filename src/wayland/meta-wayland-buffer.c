@@ -784,16 +784,21 @@ process_shm_buffer_damage (MetaWaylandBuffer *buffer,
   struct wl_shm_buffer *shm_buffer;
   int shm_offset[3] = { 0 };
   int shm_stride[3] = { 0 };
+  g_autofree MtkRectangle *plane_rects = NULL;
   const uint8_t *data;
   int stride;
+  int width;
   int height;
   uint32_t shm_format;
   int i, n_rectangles, n_planes;
 
   n_rectangles = mtk_region_num_rectangles (region);
+  if (n_rectangles == 0)
+    return TRUE;
 
   shm_buffer = buffer->shm.buffer;
   stride = wl_shm_buffer_get_stride (shm_buffer);
+  width = wl_shm_buffer_get_width (shm_buffer);
   height = wl_shm_buffer_get_height (shm_buffer);
   shm_format = wl_shm_buffer_get_format (shm_buffer);
 
@@ -804,6 +809,8 @@ process_shm_buffer_damage (MetaWaylandBuffer *buffer,
 
   get_offset_and_stride (format_info, stride, height, shm_offset, shm_stride);
 
+  plane_rects = g_new (MtkRectangle, n_rectangles);
+
   wl_shm_buffer_begin_access (shm_buffer);
   data = wl_shm_buffer_get_data (shm_buffer);
 
@@ -813,39 +820,56 @@ process_shm_buffer_damage (MetaWaylandBuffer *buffer,
       int plane_index = mt_format_info->plane_indices[i];
       int horizontal_factor = mt_format_info->hsub[i];
       int vertical_factor = mt_format_info->vsub[i];
-      CoglPixelFormat subformat;
-      int bpp;
-      const uint8_t *plane_data;
-      size_t plane_stride;
+      int plane_width = width / horizontal_factor;
+      int plane_height = height / vertical_factor;
+      int n_plane_rects = 0;
       int j;
 
-      plane_data = data + shm_offset[plane_index];
-      plane_stride = shm_stride[plane_index];
-
       cogl_texture = meta_multi_texture_get_plane (texture, i);
-      subformat = cogl_texture_get_format (cogl_texture);
-      bpp = cogl_pixel_format_get_bytes_per_pixel (subformat, 0);
 
       for (j = 0; j < n_rectangles; j++)
         {
           MtkRectangle rect;
-          const uint8_t *rect_data;
+          int x1, y1, x2, y2;
 
+          /* Round outwards, so that damage covering only part of a
+           * subsampled pixel still updates it. */
           rect = mtk_region_get_rectangle (region, j);
-          rect_data = plane_data + (rect.x * bpp / horizontal_factor) +
-                      (rect.y * plane_stride);
-
-          if (!_cogl_texture_set_region (cogl_texture,
-                                         rect.width / horizontal_factor,
-                                         rect.height / vertical_factor,
-                                         subformat,
-                                         plane_stride,
-                                         rect_data,
-                                         rect.x, rect.y,
-                                         0,
-                                         error))
-            goto fail;
+          x1 = rect.x / horizontal_factor;
+          y1 = rect.y / vertical_factor;
+          x2 = MIN ((rect.x + rect.width + horizontal_factor - 1) /
+                    horizontal_factor,
+                    plane_width);
+          y2 = MIN ((rect.y + rect.height + vertical_factor - 1) /
+                    vertical_factor,
+                    plane_height);
+
+          if (x2 <= x1 || y2 <= y1)
+            continue;
+
+          plane_rects[n_plane_rects++] = (MtkRectangle) {
+            .x = x1,
+            .y = y1,
+            .width = x2 - x1,
+            .height = y2 - y1,
+          };
         }
+
+      /* Upload all damaged rectangles of the plane in one go so the
+       * texture is bound and the pixel store set up only once. The whole
+       * buffer holds valid content, so nearby rectangles may be merged. */
+      if (!cogl_texture_set_regions (cogl_texture,
+                                     plane_width,
+                                     plane_height,
+                                     cogl_texture_get_format (cogl_texture),
+                                     shm_stride[plane_index],
+                                     data + shm_offset[plane_index],
+                                     0, 0,
+                                     plane_rects,
+                                     n_plane_rects,
+                                     COGL_TEXTURE_SET_REGIONS_FLAG_ALLOW_MERGE,
+                                     error))
+        goto fail;
     }
 
   wl_shm_buffer_end_access (shm_buffer);
@@ -960,6 +984,18 @@ scanout_destroyed (gpointer  data,
   g_object_unref (buffer);
 }
 
+static void
+track_scanout (MetaWaylandBuffer *buffer,
+               CoglScanout       *scanout)
+{
+  g_signal_connect (scanout, "scanout-failed",
+                    G_CALLBACK (on_scanout_failed), buffer);
+
+  g_object_ref (buffer);
+  meta_wayland_buffer_inc_use_count (buffer);
+  g_object_weak_ref (G_OBJECT (scanout), scanout_destroyed, buffer);
+}
+
 CoglScanout *
 meta_wayland_buffer_try_acquire_scanout (MetaWaylandBuffer     *buffer,
                                          CoglOnscreen          *onscreen,
@@ -1018,12 +1054,46 @@ meta_wayland_buffer_try_acquire_scanout (MetaWaylandBuffer     *buffer,
   if (!scanout)
     return NULL;
 
-  g_signal_connect (scanout, "scanout-failed",
-                    G_CALLBACK (on_scanout_failed), buffer);
+  track_scanout (buffer, scanout);
 
-  g_object_ref (buffer);
-  meta_wayland_buffer_inc_use_count (buffer);
-  g_object_weak_ref (G_OBJECT (scanout), scanout_destroyed, buffer);
+  return scanout;
+}
+
+CoglScanout *
+meta_wayland_buffer_try_acquire_overlay_scanout (MetaWaylandBuffer     *buffer,
+                                                 CoglOnscreen          *onscreen,
+                                                 ClutterStageView      *stage_view,
+                                                 const graphene_rect_t *src_rect,
+                                                 const MtkRectangle    *dst_rect)
+{
+  CoglScanout *scanout;
+
+  COGL_TRACE_BEGIN_SCOPED (MetaWaylandBufferTryOverlayScanout,
+                           "Meta::WaylandBuffer::try_acquire_overlay_scanout()");
+
+  if (buffer->tainted_scanout_onscreens &&
+      g_hash_table_lookup (buffer->tainted_scanout_onscreens, onscreen))
+    {
+      meta_topic (META_DEBUG_RENDER, "Buffer scanout capability tainted");
+      return NULL;
+    }
+
+  if (buffer->type != META_WAYLAND_BUFFER_TYPE_DMA_BUF)
+    {
+      meta_topic (META_DEBUG_RENDER,
+                  "Buffer type not overlay plane compatible");
+      return NULL;
+    }
+
+  scanout = meta_wayland_dma_buf_try_acquire_overlay_scanout (buffer,
+                                                              onscreen,
+                                                              stage_view,
+                                                              src_rect,
+                                                              dst_rect);
+  if (!scanout)
+    return NULL;
+
+  track_scanout (buffer, scanout);
 
   return scanout;
 }
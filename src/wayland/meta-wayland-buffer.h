@@ -111,5 +111,10 @@ CoglScanout *           meta_wayland_buffer_try_acquire_scanout (MetaWaylandBuff
                                                                  ClutterStageView      *stage_view,
                                                                  const graphene_rect_t *src_rect,
                                                                  const MtkRectangle    *dst_rect);
+CoglScanout *           meta_wayland_buffer_try_acquire_overlay_scanout (MetaWaylandBuffer     *buffer,
+                                                                         CoglOnscreen          *onscreen,
+                                                                         ClutterStageView      *stage_view,
+                                                                         const graphene_rect_t *src_rect,
+                                                                         const MtkRectangle    *dst_rect);
 
 void meta_wayland_init_shm (MetaWaylandCompositor *compositor);
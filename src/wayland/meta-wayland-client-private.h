@@ -36,6 +36,13 @@ typedef enum _MetaWaylandClientCaps
   META_WAYLAND_CLIENT_CAPS_X11_INTEROP = (1 << 0),
 } MetaWaylandClientCaps;
 
+typedef enum _MetaWaylandRequestAccounting
+{
+  META_WAYLAND_REQUEST_FIRST_IN_DISPATCH,
+  META_WAYLAND_REQUEST_BELOW_FLOOD_THRESHOLD,
+  META_WAYLAND_REQUEST_EXCEEDED_FLOOD_THRESHOLD,
+} MetaWaylandRequestAccounting;
+
 META_EXPORT_TEST
 MetaWaylandClient * meta_wayland_client_new_from_wl (MetaContext      *context,
                                                      struct wl_client *wayland_client);
@@ -81,4 +88,15 @@ MetaWaylandClient * meta_get_wayland_client (const struct wl_client *wl_client);
 void meta_wayland_client_set_window_tag (MetaWaylandClient *client,
                                          const char *window_tag);
 
-const char * meta_wayland_client_get_window_tag (MetaWaylandClient *client);
\ No newline at end of file
+const char * meta_wayland_client_get_window_tag (MetaWaylandClient *client);
+
+MetaWaylandRequestAccounting meta_wayland_client_account_request (MetaWaylandClient *client,
+                                                                  uint64_t           dispatch_serial,
+                                                                  size_t             size,
+                                                                  unsigned int       flood_threshold);
+
+META_EXPORT_TEST
+void meta_wayland_client_get_request_stats (MetaWaylandClient *client,
+                                            uint64_t          *n_requests,
+                                            uint64_t          *n_bytes,
+                                            uint64_t          *n_floods);
@@ -75,6 +75,15 @@ struct _MetaWaylandClient
   char *window_tag;
 
   pid_t pid;
+
+  struct {
+    uint64_t n_requests;
+    uint64_t n_bytes;
+    uint64_t n_floods;
+
+    uint64_t dispatch_serial;
+    unsigned int n_dispatch_requests;
+  } stats;
 };
 
 G_DEFINE_TYPE (MetaWaylandClient, meta_wayland_client, G_TYPE_OBJECT)
@@ -393,3 +402,49 @@ meta_wayland_client_get_pid (MetaWaylandClient *client)
 {
   return client->pid;
 }
+
+/*
+ * Accounts a request received from the client during the dispatch identified
+ * by @dispatch_serial, and returns where the request puts the client relative
+ * to @flood_threshold for that dispatch. Exceeding the threshold is only
+ * reported once per dispatch.
+ */
+MetaWaylandRequestAccounting
+meta_wayland_client_account_request (MetaWaylandClient *client,
+                                     uint64_t           dispatch_serial,
+                                     size_t             size,
+                                     unsigned int       flood_threshold)
+{
+  client->stats.n_requests++;
+  client->stats.n_bytes += size;
+
+  if (client->stats.dispatch_serial != dispatch_serial)
+    {
+      client->stats.dispatch_serial = dispatch_serial;
+      client->stats.n_dispatch_requests = 1;
+      return META_WAYLAND_REQUEST_FIRST_IN_DISPATCH;
+    }
+
+  client->stats.n_dispatch_requests++;
+
+  if (flood_threshold == 0 ||
+      client->stats.n_dispatch_requests != flood_threshold + 1)
+    return META_WAYLAND_REQUEST_BELOW_FLOOD_THRESHOLD;
+
+  client->stats.n_floods++;
+  return META_WAYLAND_REQUEST_EXCEEDED_FLOOD_THRESHOLD;
+}
+
+void
+meta_wayland_client_get_request_stats (MetaWaylandClient *client,
+                                       uint64_t          *n_requests,
+                                       uint64_t          *n_bytes,
+                                       uint64_t          *n_floods)
+{
+  if (n_requests)
+    *n_requests = client->stats.n_requests;
+  if (n_bytes)
+    *n_bytes = client->stats.n_bytes;
+  if (n_floods)
+    *n_floods = client->stats.n_floods;
+}
@@ -621,39 +621,48 @@ has_modifier (GArray   *modifiers,
 }
 
 #ifdef HAVE_NATIVE_BACKEND
+static gboolean
+plane_supports_modifier (MetaKmsPlane *plane,
+                         uint32_t      drm_format,
+                         uint64_t      drm_modifier)
+{
+  GArray *plane_modifiers;
+
+  plane_modifiers = meta_kms_plane_get_modifiers_for_format (plane, drm_format);
+  if (!plane_modifiers)
+    return FALSE;
+
+  if (drm_modifier == DRM_FORMAT_MOD_INVALID)
+    return TRUE;
+
+  return has_modifier (plane_modifiers, drm_modifier);
+}
+
 static gboolean
 crtc_supports_modifier (MetaCrtcKms *crtc_kms,
                         uint32_t     drm_format,
                         uint64_t     drm_modifier)
 {
   MetaKmsPlane *plane = meta_crtc_kms_get_assigned_primary_plane (crtc_kms);
-  GArray *crtc_modifiers;
 
   g_return_val_if_fail (plane, FALSE);
 
-  crtc_modifiers = meta_kms_plane_get_modifiers_for_format (plane, drm_format);
-  if (!crtc_modifiers)
-    return FALSE;
-
-  if (drm_modifier == DRM_FORMAT_MOD_INVALID)
-    return TRUE;
-
-  return has_modifier (crtc_modifiers, drm_modifier);
+  return plane_supports_modifier (plane, drm_format, drm_modifier);
 }
-#endif
 
-CoglScanout *
-meta_wayland_dma_buf_try_acquire_scanout (MetaWaylandBuffer     *buffer,
-                                          CoglOnscreen          *onscreen,
-                                          ClutterStageView      *stage_view,
-                                          const graphene_rect_t *src_rect,
-                                          const MtkRectangle    *dst_rect)
+static CoglScanout *
+try_acquire_plane_scanout (MetaWaylandBuffer     *buffer,
+                           CoglOnscreen          *onscreen,
+                           ClutterStageView      *stage_view,
+                           MetaKmsPlaneType       plane_type,
+                           const graphene_rect_t *src_rect,
+                           const MtkRectangle    *dst_rect)
 {
-#ifdef HAVE_NATIVE_BACKEND
   MetaWaylandDmaBufBuffer *dma_buf;
   MetaRendererView *renderer_view = META_RENDERER_VIEW (stage_view);
   MetaCrtc *crtc;
   MetaCrtcKms *crtc_kms;
+  MetaKmsPlane *plane;
   MetaContext *context;
   MetaBackend *backend;
   MetaRenderer *renderer;
@@ -678,28 +687,45 @@ meta_wayland_dma_buf_try_acquire_scanout (MetaWaylandBuffer     *buffer,
   g_return_val_if_fail (META_IS_CRTC_KMS (crtc), NULL);
   crtc_kms = META_CRTC_KMS (crtc);
 
+  switch (plane_type)
+    {
+    case META_KMS_PLANE_TYPE_PRIMARY:
+      plane = meta_crtc_kms_get_assigned_primary_plane (crtc_kms);
+      g_return_val_if_fail (plane, NULL);
+      break;
+    case META_KMS_PLANE_TYPE_OVERLAY:
+      plane = meta_crtc_kms_get_assigned_overlay_plane (crtc_kms);
+      if (!plane)
+        return NULL;
+      break;
+    case META_KMS_PLANE_TYPE_CURSOR:
+    default:
+      g_assert_not_reached ();
+    }
+
   format_info = meta_format_info_from_drm_format (dma_buf->drm_format);
   g_assert (format_info);
 
   if (format_info->opaque_substitute != DRM_FORMAT_INVALID &&
-      crtc_supports_modifier (crtc_kms,
-                              format_info->opaque_substitute,
-                              dma_buf->drm_modifier))
+      plane_supports_modifier (plane,
+                               format_info->opaque_substitute,
+                               dma_buf->drm_modifier))
     {
       drm_format = format_info->opaque_substitute;
     }
-  else if (crtc_supports_modifier (crtc_kms,
-                                   dma_buf->drm_format,
-                                   dma_buf->drm_modifier))
+  else if (plane_supports_modifier (plane,
+                                    dma_buf->drm_format,
+                                    dma_buf->drm_modifier))
     {
       drm_format = dma_buf->drm_format;
     }
   else
     {
       meta_topic (META_DEBUG_RENDER,
-                  "DRM format 0x%x (0x%lx) not supported by primary plane",
+                  "DRM format 0x%x (0x%lx) not supported by %s plane",
                   dma_buf->drm_format,
-                  dma_buf->drm_modifier);
+                  dma_buf->drm_modifier,
+                  meta_kms_plane_type_to_string (plane_type));
       return NULL;
     }
 
@@ -746,7 +772,19 @@ meta_wayland_dma_buf_try_acquire_scanout (MetaWaylandBuffer     *buffer,
                               dst_rect);
   cogl_scanout_set_src_rect (scanout, src_rect);
 
-  if (!meta_onscreen_native_is_buffer_scanout_compatible (onscreen, scanout))
+  if (plane_type == META_KMS_PLANE_TYPE_OVERLAY)
+    {
+      if (!meta_onscreen_native_is_buffer_overlay_compatible (onscreen,
+                                                              scanout))
+        {
+          meta_topic (META_DEBUG_RENDER,
+                      "Buffer not overlay plane compatible "
+                      "(see also KMS debug topic)");
+          return NULL;
+        }
+    }
+  else if (!meta_onscreen_native_is_buffer_scanout_compatible (onscreen,
+                                                               scanout))
     {
       meta_topic (META_DEBUG_RENDER,
                   "Buffer not scanout compatible (see also KMS debug topic)");
@@ -754,6 +792,42 @@ meta_wayland_dma_buf_try_acquire_scanout (MetaWaylandBuffer     *buffer,
     }
 
   return g_steal_pointer (&scanout);
+}
+#endif
+
+CoglScanout *
+meta_wayland_dma_buf_try_acquire_scanout (MetaWaylandBuffer     *buffer,
+                                          CoglOnscreen          *onscreen,
+                                          ClutterStageView      *stage_view,
+                                          const graphene_rect_t *src_rect,
+                                          const MtkRectangle    *dst_rect)
+{
+#ifdef HAVE_NATIVE_BACKEND
+  return try_acquire_plane_scanout (buffer,
+                                    onscreen,
+                                    stage_view,
+                                    META_KMS_PLANE_TYPE_PRIMARY,
+                                    src_rect,
+                                    dst_rect);
+#else
+  return NULL;
+#endif
+}
+
+CoglScanout *
+meta_wayland_dma_buf_try_acquire_overlay_scanout (MetaWaylandBuffer     *buffer,
+                                                  CoglOnscreen          *onscreen,
+                                                  ClutterStageView      *stage_view,
+                                                  const graphene_rect_t *src_rect,
+                                                  const MtkRectangle    *dst_rect)
+{
+#ifdef HAVE_NATIVE_BACKEND
+  return try_acquire_plane_scanout (buffer,
+                                    onscreen,
+                                    stage_view,
+                                    META_KMS_PLANE_TYPE_OVERLAY,
+                                    src_rect,
+                                    dst_rect);
 #else
   return NULL;
 #endif
@@ -76,3 +76,10 @@ meta_wayland_dma_buf_try_acquire_scanout (MetaWaylandBuffer     *buffer,
                                           ClutterStageView      *stage_view,
                                           const graphene_rect_t *src_rect,
                                           const MtkRectangle    *dst_rect);
+
+CoglScanout *
+meta_wayland_dma_buf_try_acquire_overlay_scanout (MetaWaylandBuffer     *buffer,
+                                                  CoglOnscreen          *onscreen,
+                                                  ClutterStageView      *stage_view,
+                                                  const graphene_rect_t *src_rect,
+                                                  const MtkRectangle    *dst_rect);
@@ -424,6 +424,10 @@ CoglScanout *       meta_wayland_surface_try_acquire_scanout (MetaWaylandSurface
                                                               CoglOnscreen       *onscreen,
                                                               ClutterStageView   *stage_view);
 
+CoglScanout *       meta_wayland_surface_try_acquire_overlay_scanout (MetaWaylandSurface *surface,
+                                                                      CoglOnscreen       *onscreen,
+                                                                      ClutterStageView   *stage_view);
+
 MetaCrtc * meta_wayland_surface_get_scanout_candidate (MetaWaylandSurface *surface);
 
 void meta_wayland_surface_set_scanout_candidate (MetaWaylandSurface *surface,
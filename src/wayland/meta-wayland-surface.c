@@ -2462,27 +2462,27 @@ meta_wayland_surface_get_buffer_height (MetaWaylandSurface *surface)
     return 0;
 }
 
-CoglScanout *
-meta_wayland_surface_try_acquire_scanout (MetaWaylandSurface *surface,
-                                          CoglOnscreen       *onscreen,
-                                          ClutterStageView   *stage_view)
+static gboolean
+calculate_scanout_rects (MetaWaylandSurface *surface,
+                         ClutterStageView   *stage_view,
+                         MtkRectangle       *crtc_dst_rect_out,
+                         graphene_rect_t    *src_rect_out,
+                         gboolean           *has_src_rect_out)
 {
   MetaSurfaceActor *surface_actor;
   MtkMonitorTransform view_transform;
   ClutterActorBox actor_box;
   MtkRectangle crtc_dst_rect;
-  graphene_rect_t *src_rect_ptr = NULL;
-  graphene_rect_t src_rect;
   MtkRectangle view_rect;
   float view_scale;
   int view_crtc_width;
   int view_crtc_height;
 
   if (!surface->buffer)
-    return NULL;
+    return FALSE;
 
   if (surface->buffer->use_count == 0)
-    return NULL;
+    return FALSE;
 
   view_transform = clutter_stage_view_get_transform (stage_view);
   if (view_transform != surface->buffer_transform)
@@ -2490,13 +2490,13 @@ meta_wayland_surface_try_acquire_scanout (MetaWaylandSurface *surface,
       meta_topic (META_DEBUG_RENDER,
                   "Surface can not be scanned out: buffer transform does not "
                   "match renderer-view transform");
-      return NULL;
+      return FALSE;
     }
 
   surface_actor = meta_wayland_surface_get_actor (surface);
   if (!surface_actor ||
       !clutter_actor_get_paint_box (CLUTTER_ACTOR (surface_actor), &actor_box))
-    return NULL;
+    return FALSE;
 
   clutter_stage_view_get_layout (stage_view, &view_rect);
   view_scale = clutter_stage_view_get_scale (stage_view);
@@ -2523,21 +2523,56 @@ meta_wayland_surface_try_acquire_scanout (MetaWaylandSurface *surface,
                            view_transform,
                            view_crtc_width,
                            view_crtc_height,
-                           &crtc_dst_rect);
+                           crtc_dst_rect_out);
 
+  *has_src_rect_out = surface->viewport.has_src_rect;
   if (surface->viewport.has_src_rect)
-    {
-      src_rect = surface->viewport.src_rect;
-      src_rect_ptr = &src_rect;
-    }
+    *src_rect_out = surface->viewport.src_rect;
+
+  return TRUE;
+}
+
+CoglScanout *
+meta_wayland_surface_try_acquire_scanout (MetaWaylandSurface *surface,
+                                          CoglOnscreen       *onscreen,
+                                          ClutterStageView   *stage_view)
+{
+  MtkRectangle crtc_dst_rect;
+  graphene_rect_t src_rect;
+  gboolean has_src_rect;
+
+  if (!calculate_scanout_rects (surface, stage_view,
+                                &crtc_dst_rect, &src_rect, &has_src_rect))
+    return NULL;
 
   return meta_wayland_buffer_try_acquire_scanout (surface->buffer,
                                                   onscreen,
                                                   stage_view,
-                                                  src_rect_ptr,
+                                                  has_src_rect ? &src_rect : NULL,
                                                   &crtc_dst_rect);
 }
 
+CoglScanout *
+meta_wayland_surface_try_acquire_overlay_scanout (MetaWaylandSurface *surface,
+                                                  CoglOnscreen       *onscreen,
+                                                  ClutterStageView   *stage_view)
+{
+  MtkRectangle crtc_dst_rect;
+  graphene_rect_t src_rect;
+  gboolean has_src_rect;
+
+  if (!calculate_scanout_rects (surface, stage_view,
+                                &crtc_dst_rect, &src_rect, &has_src_rect))
+    return NULL;
+
+  return meta_wayland_buffer_try_acquire_overlay_scanout (surface->buffer,
+                                                          onscreen,
+                                                          stage_view,
+                                                          has_src_rect ?
+                                                          &src_rect : NULL,
+                                                          &crtc_dst_rect);
+}
+
 MetaCrtc *
 meta_wayland_surface_get_scanout_candidate (MetaWaylandSurface *surface)
 {
@@ -36,7 +36,9 @@
 #include "clutter/clutter.h"
 #include "compositor/meta-surface-actor-wayland.h"
 #include "core/events.h"
+#include "core/meta-debug-control-private.h"
 #include "core/meta-context-private.h"
+#include "core/window-private.h"
 #include "wayland/meta-wayland-activation.h"
 #include "wayland/meta-wayland-buffer.h"
 #include "wayland/meta-wayland-client-private.h"
@@ -97,17 +99,39 @@ typedef struct _MetaWaylandCompositorPrivate
 {
   gboolean is_wayland_egl_display_bound;
 
+  struct wl_protocol_logger *request_logger;
+
   MetaWaylandFilterManager *filter_manager;
   GHashTable *frame_callback_sources;
+
+  unsigned int hidden_frame_callback_interval_ms;
+  guint hidden_frame_callback_timeout_id;
 } MetaWaylandCompositorPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (MetaWaylandCompositor, meta_wayland_compositor,
                             G_TYPE_OBJECT)
 
+/* Priority used for the dispatch following one where only clients that
+ * reached the flood threshold were dispatched; lower than redraw so that
+ * pending input events and stage updates are processed before continuing
+ * with their backlog. */
+#define META_PRIORITY_WAYLAND_DEFERRED (META_PRIORITY_REDRAW + 1)
+
+/* Interval at which frame callbacks are emitted for surfaces that are hidden
+ * or fully occluded, but whose window has not been suspended yet. */
+#define DEFAULT_HIDDEN_FRAME_CALLBACK_INTERVAL_MS 1000
+
 typedef struct
 {
   GSource source;
   struct wl_display *display;
+
+  uint64_t dispatch_serial;
+  unsigned int flood_threshold;
+  gboolean collect_statistics;
+
+  unsigned int n_dispatched_clients;
+  unsigned int n_flooding_clients;
 } WaylandEventSource;
 
 typedef struct
@@ -147,8 +171,25 @@ wayland_event_source_dispatch (GSource    *base,
   WaylandEventSource *source = (WaylandEventSource *)base;
   struct wl_event_loop *loop = wl_display_get_event_loop (source->display);
 
+  source->dispatch_serial++;
+  source->n_dispatched_clients = 0;
+  source->n_flooding_clients = 0;
+
   wl_event_loop_dispatch (loop, 0);
 
+  /* libwayland polls each client connection on its own, so the connection of
+   * a flooding client cannot be taken out of the loop. If every client we
+   * just dispatched reached the flood threshold, the only thing keeping the
+   * source busy is their backlog; let input and frame processing run before
+   * continuing with it. As soon as any other client has requests queued, it
+   * is dispatched again at full priority, with the flooding clients limited
+   * to what libwayland reads from them in one go. */
+  if (source->n_flooding_clients > 0 &&
+      source->n_flooding_clients == source->n_dispatched_clients)
+    g_source_set_priority (base, META_PRIORITY_WAYLAND_DEFERRED);
+  else if (g_source_get_priority (base) != META_PRIORITY_EVENTS + 1)
+    g_source_set_priority (base, META_PRIORITY_EVENTS + 1);
+
   return TRUE;
 }
 
@@ -160,6 +201,144 @@ static GSourceFuncs wayland_event_source_funcs =
   NULL
 };
 
+static unsigned int
+get_debug_env_uint (const char   *variable,
+                    unsigned int  default_value)
+{
+  const char *value_str;
+  int64_t value;
+
+  value_str = g_getenv (variable);
+  if (!value_str)
+    return default_value;
+
+  value = g_ascii_strtoll (value_str, NULL, 10);
+  if (value < 0 || value > G_MAXUINT)
+    {
+      g_warning ("Invalid value '%s' for %s", value_str, variable);
+      return default_value;
+    }
+
+  return (unsigned int) value;
+}
+
+static size_t
+align_to_word (size_t size)
+{
+  return (size + sizeof (uint32_t) - 1) & ~(sizeof (uint32_t) - 1);
+}
+
+static size_t
+get_request_size (const struct wl_protocol_logger_message *message)
+{
+  const char *signature = message->message->signature;
+  size_t size = 2 * sizeof (uint32_t);
+  int i = 0;
+
+  for (; *signature && i < message->arguments_count; signature++)
+    {
+      const union wl_argument *argument = &message->arguments[i];
+
+      switch (*signature)
+        {
+        case 'i':
+        case 'u':
+        case 'f':
+        case 'o':
+        case 'n':
+          size += sizeof (uint32_t);
+          break;
+        case 's':
+          size += sizeof (uint32_t);
+          if (argument->s)
+            size += align_to_word (strlen (argument->s) + 1);
+          break;
+        case 'a':
+          size += sizeof (uint32_t);
+          if (argument->a)
+            size += align_to_word (argument->a->size);
+          break;
+        case 'h':
+          /* File descriptors are passed out of band. */
+          break;
+        default:
+          /* Version and nullability markers. */
+          continue;
+        }
+
+      i++;
+    }
+
+  return size;
+}
+
+static void
+on_protocol_message (void                                    *user_data,
+                     enum wl_protocol_logger_type             type,
+                     const struct wl_protocol_logger_message *message)
+{
+  WaylandEventSource *source = user_data;
+  struct wl_client *wl_client;
+  MetaWaylandClient *client;
+
+  if (type != WL_PROTOCOL_LOGGER_REQUEST)
+    return;
+
+  wl_client = wl_resource_get_client (message->resource);
+  client = meta_get_wayland_client (wl_client);
+  if (!client)
+    return;
+
+  switch (meta_wayland_client_account_request (client,
+                                               source->dispatch_serial,
+                                               (source->collect_statistics ?
+                                                get_request_size (message) : 0),
+                                               source->flood_threshold))
+    {
+    case META_WAYLAND_REQUEST_FIRST_IN_DISPATCH:
+      source->n_dispatched_clients++;
+      break;
+    case META_WAYLAND_REQUEST_BELOW_FLOOD_THRESHOLD:
+      break;
+    case META_WAYLAND_REQUEST_EXCEEDED_FLOOD_THRESHOLD:
+      meta_topic (META_DEBUG_WAYLAND,
+                  "Client (pid %d) reached flood threshold of %u requests",
+                  meta_wayland_client_get_pid (client),
+                  source->flood_threshold);
+      source->n_flooding_clients++;
+      break;
+    }
+}
+
+static void
+update_request_logger (MetaWaylandCompositor *compositor)
+{
+  MetaWaylandCompositorPrivate *priv =
+    meta_wayland_compositor_get_instance_private (compositor);
+  WaylandEventSource *source = (WaylandEventSource *) compositor->source;
+  MetaDebugControl *debug_control =
+    meta_context_get_debug_control (compositor->context);
+
+  source->collect_statistics =
+    meta_debug_control_is_wayland_client_statistics_enabled (debug_control);
+
+  if (source->flood_threshold > 0 || source->collect_statistics)
+    {
+      if (!priv->request_logger)
+        {
+          priv->request_logger =
+            wl_display_add_protocol_logger (compositor->wayland_display,
+                                            on_protocol_message,
+                                            source);
+        }
+    }
+  else
+    {
+      g_clear_pointer (&priv->request_logger, wl_protocol_logger_destroy);
+      g_source_set_priority (compositor->source, META_PRIORITY_EVENTS + 1);
+    }
+}
+
 static GSource *
 wayland_event_source_new (struct wl_display *display)
 {
@@ -172,6 +351,13 @@ wayland_event_source_new (struct wl_display *display)
   g_source_set_name (source, "[mutter] Wayland events");
   wayland_source = (WaylandEventSource *) source;
   wayland_source->display = display;
+  /* Number of requests from a single client in one dispatch of the event
+   * source after which it counts as flooding. libwayland gives no way to
+   * stop reading from a single client, so flooding clients are not limited
+   * individually; the source only yields to input and frame processing
+   * when nothing but flooding clients was dispatched. Off by default. */
+  wayland_source->flood_threshold =
+    get_debug_env_uint ("MUTTER_DEBUG_WAYLAND_FLOOD_THRESHOLD", 0);
   g_source_add_unix_fd (&wayland_source->source,
                         wl_event_loop_get_fd (loop),
                         G_IO_IN | G_IO_ERR);
@@ -179,13 +365,115 @@ wayland_event_source_new (struct wl_display *display)
   return &wayland_source->source;
 }
 
+static gboolean
+is_surface_hidden (MetaWaylandSurface *surface)
+{
+  MetaSurfaceActor *actor;
+  MetaWindow *window;
+
+  actor = meta_wayland_surface_get_actor (surface);
+  if (!actor)
+    return FALSE;
+
+  /* Suspended windows were told to not draw, and don't get any frame
+   * callbacks until they are visible again. */
+  window = meta_wayland_surface_get_toplevel_window (surface);
+  if (window && meta_window_is_suspended (window))
+    return FALSE;
+
+  if (!clutter_actor_is_mapped (CLUTTER_ACTOR (actor)))
+    return TRUE;
+
+  return meta_surface_actor_is_effectively_obscured (actor);
+}
+
+static gboolean
+emit_hidden_frame_callbacks (gpointer user_data)
+{
+  MetaWaylandCompositor *compositor = META_WAYLAND_COMPOSITOR (user_data);
+  MetaWaylandCompositorPrivate *priv =
+    meta_wayland_compositor_get_instance_private (compositor);
+  int64_t interval_us = ms2us (priv->hidden_frame_callback_interval_ms);
+  gboolean has_hidden_surfaces = FALSE;
+  int64_t now_us;
+  GList *l;
+
+  now_us = g_get_monotonic_time ();
+
+  l = compositor->frame_callback_surfaces;
+  while (l)
+    {
+      GList *l_cur = l;
+      MetaWaylandSurface *surface = l->data;
+      MetaWaylandActorSurface *actor_surface;
+      int64_t last_time_us;
+
+      l = l->next;
+
+      if (!is_surface_hidden (surface))
+        continue;
+
+      actor_surface = META_WAYLAND_ACTOR_SURFACE (surface->role);
+      last_time_us =
+        meta_wayland_actor_surface_get_last_frame_callbacks_time (actor_surface);
+      if (now_us - last_time_us < interval_us)
+        {
+          has_hidden_surfaces = TRUE;
+          continue;
+        }
+
+      meta_wayland_actor_surface_emit_frame_callbacks (actor_surface,
+                                                       now_us / 1000);
+
+      compositor->frame_callback_surfaces =
+        g_list_delete_link (compositor->frame_callback_surfaces, l_cur);
+    }
+
+  /* Visible surfaces get their callbacks from the stage views; the timeout
+   * is armed again once a pending surface is found hidden. */
+  if (!has_hidden_surfaces)
+    {
+      priv->hidden_frame_callback_timeout_id = 0;
+      return G_SOURCE_REMOVE;
+    }
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+maybe_schedule_hidden_frame_callbacks (MetaWaylandCompositor *compositor)
+{
+  MetaWaylandCompositorPrivate *priv =
+    meta_wayland_compositor_get_instance_private (compositor);
+
+  if (priv->hidden_frame_callback_interval_ms == 0)
+    return;
+
+  if (priv->hidden_frame_callback_timeout_id)
+    return;
+
+  priv->hidden_frame_callback_timeout_id =
+    g_timeout_add (priv->hidden_frame_callback_interval_ms,
+                   emit_hidden_frame_callbacks,
+                   compositor);
+  g_source_set_name_by_id (priv->hidden_frame_callback_timeout_id,
+                           "[mutter] Hidden surface frame callbacks");
+}
+
 static void
 emit_frame_callbacks_for_stage_view (MetaWaylandCompositor *compositor,
                                      ClutterStageView      *stage_view)
 {
+  MetaWaylandCompositorPrivate *priv =
+    meta_wayland_compositor_get_instance_private (compositor);
+  gboolean check_hidden_surfaces;
+  gboolean has_hidden_surfaces = FALSE;
   GList *l;
   int64_t now_us;
 
+  check_hidden_surfaces = priv->hidden_frame_callback_interval_ms > 0 &&
+                          !priv->hidden_frame_callback_timeout_id;
+
   now_us = g_get_monotonic_time ();
 
   l = compositor->frame_callback_surfaces;
@@ -204,7 +492,11 @@ emit_frame_callbacks_for_stage_view (MetaWaylandCompositor *compositor,
 
       if (!meta_surface_actor_wayland_is_view_primary (actor,
                                                        stage_view))
-        continue;
+        {
+          if (check_hidden_surfaces && !has_hidden_surfaces)
+            has_hidden_surfaces = is_surface_hidden (surface);
+          continue;
+        }
 
       actor_surface = META_WAYLAND_ACTOR_SURFACE (surface->role);
       meta_wayland_actor_surface_emit_frame_callbacks (actor_surface,
@@ -213,6 +505,9 @@ emit_frame_callbacks_for_stage_view (MetaWaylandCompositor *compositor,
       compositor->frame_callback_surfaces =
         g_list_delete_link (compositor->frame_callback_surfaces, l_cur);
     }
+
+  if (has_hidden_surfaces)
+    maybe_schedule_hidden_frame_callbacks (compositor);
 }
 
 #ifdef HAVE_NATIVE_BACKEND
@@ -612,6 +907,9 @@ meta_wayland_compositor_add_frame_callback_surface (MetaWaylandCompositor *compo
 
   compositor->frame_callback_surfaces =
     g_list_prepend (compositor->frame_callback_surfaces, surface);
+
+  if (is_surface_hidden (surface))
+    maybe_schedule_hidden_frame_callbacks (compositor);
 }
 
 void
@@ -837,6 +1135,9 @@ meta_wayland_compositor_finalize (GObject *object)
 
   g_clear_pointer (&priv->filter_manager, meta_wayland_filter_manager_free);
   g_clear_pointer (&priv->frame_callback_sources, g_hash_table_destroy);
+  g_clear_handle_id (&priv->hidden_frame_callback_timeout_id, g_source_remove);
+
+  g_clear_pointer (&priv->request_logger, wl_protocol_logger_destroy);
 
   g_clear_pointer (&compositor->display_name, g_free);
   g_clear_pointer (&compositor->wayland_display, wl_display_destroy);
@@ -869,6 +1170,9 @@ meta_wayland_compositor_init (MetaWaylandCompositor *compositor)
   priv->frame_callback_sources =
     g_hash_table_new_full (NULL, NULL, NULL,
                            (GDestroyNotify) g_source_destroy);
+  priv->hidden_frame_callback_interval_ms =
+    get_debug_env_uint ("MUTTER_DEBUG_HIDDEN_FRAME_CALLBACK_INTERVAL_MS",
+                        DEFAULT_HIDDEN_FRAME_CALLBACK_INTERVAL_MS);
   compositor->timed_transactions = g_queue_new ();
 }
 
@@ -983,6 +1287,13 @@ meta_wayland_compositor_new (MetaContext *context)
   compositor->source = wayland_event_source;
   g_source_unref (wayland_event_source);
 
+  g_signal_connect_object (meta_context_get_debug_control (context),
+                           "notify::wayland-client-statistics",
+                           G_CALLBACK (update_request_logger),
+                           compositor,
+                           G_CONNECT_SWAPPED);
+  update_request_logger (compositor);
+
   g_signal_connect (stage, "before-update",
                     G_CALLBACK (on_before_update), compositor);
   g_signal_connect (stage, "after-update",
@@ -36,6 +36,10 @@
  * to a slower frame rate. In this case, frame_counter stays -1 until
  * send_frame_message_timeout() runs, at which point we send both the
  * _NET_WM_FRAME_DRAWN and _NET_WM_FRAME_TIMINGS messages.
+ *
+ * The messages are not flushed one by one; the X11 event source flushes
+ * the connection before going back to sleep, so the messages for all
+ * windows drawn in a frame are written out together.
  */
 typedef struct
 {
@@ -44,6 +48,30 @@ typedef struct
   int64_t frame_drawn_time;
 } FrameData;
 
+static void sync_request_timeout (gpointer data);
+
+static void
+start_sync_request_timeout (MetaSyncCounter *sync_counter)
+{
+  /* We give the window 1 sec to respond to _NET_WM_SYNC_REQUEST;
+   * if this time expires, we consider the window unresponsive
+   * and resize it unsynchonized.
+   */
+  g_clear_handle_id (&sync_counter->sync_request_timeout_id, g_source_remove);
+  sync_counter->sync_request_timeout_id = g_timeout_add_once (1000,
+                                                              sync_request_timeout,
+                                                              sync_counter);
+  g_source_set_name_by_id (sync_counter->sync_request_timeout_id,
+                           "[mutter] sync_request_timeout");
+}
+
+static gboolean
+is_initial_value_pending (MetaSyncCounter *sync_counter)
+{
+  /* Once waiting for it timed out, the window is not held back anymore */
+  return sync_counter->initial_value_pending && !sync_counter->disabled;
+}
+
 void
 meta_sync_counter_init (MetaSyncCounter *sync_counter,
                         MetaWindow      *window,
@@ -86,18 +114,56 @@ meta_sync_counter_set_counter (MetaSyncCounter *sync_counter,
     meta_sync_counter_create_sync_alarm (sync_counter);
 }
 
+static XSyncAlarm
+create_alarm (MetaSyncCounter *sync_counter,
+              XSyncValueType   value_type,
+              int64_t          wait_value,
+              int64_t          delta)
+{
+  MetaWindow *window = sync_counter->window;
+  MetaX11Display *x11_display = window->display->x11_display;
+  XSyncAlarmAttributes values;
+
+  values.trigger.counter = sync_counter->sync_request_counter;
+  values.trigger.test_type = XSyncPositiveComparison;
+  values.trigger.value_type = value_type;
+  XSyncIntsToValue (&values.trigger.wait_value,
+                    wait_value & G_GUINT64_CONSTANT (0xffffffff),
+                    wait_value >> 32);
+
+  /* After triggering, increment test_value by this until
+   * until the test condition is false */
+  XSyncIntToValue (&values.delta, delta);
+
+  /* we want events (on by default anyway) */
+  values.events = True;
+
+  return XSyncCreateAlarm (x11_display->xdisplay,
+                           XSyncCACounter |
+                           XSyncCAValueType |
+                           XSyncCAValue |
+                           XSyncCATestType |
+                           XSyncCADelta |
+                           XSyncCAEvents,
+                           &values);
+}
+
 void
 meta_sync_counter_create_sync_alarm (MetaSyncCounter *sync_counter)
 {
   MetaWindow *window = sync_counter->window;
   MetaX11Display *x11_display = window->display->x11_display;
-  XSyncAlarmAttributes values;
-  XSyncValue init;
 
   if (sync_counter->sync_request_counter == None ||
       sync_counter->sync_request_alarm != None)
     return;
 
+  /* Nothing here waits for a reply from the server: with many windows
+   * being mapped at once, the round trips add up. Errors, e.g. due to a
+   * bogus counter, are ignored; the alarm then never triggers, and the
+   * window ends up being resized without synchronization, as when a
+   * client does not respond.
+   */
   mtk_x11_error_trap_push (x11_display->xdisplay);
 
   /* In the new (extended style), the counter value is initialized by
@@ -106,60 +172,93 @@ meta_sync_counter_create_sync_alarm (MetaSyncCounter *sync_counter)
    */
   if (sync_counter->extended_sync_request_counter)
     {
-      if (!XSyncQueryCounter (x11_display->xdisplay,
-                              sync_counter->sync_request_counter,
-                              &init))
-        {
-          mtk_x11_error_trap_pop_with_return (x11_display->xdisplay);
-          sync_counter->sync_request_counter = None;
-          return;
-        }
+      /* Rather than querying the counter, create an alarm that triggers
+       * right away, delivering the current value, and then deactivates
+       * itself; it is rearmed in meta_sync_counter_update().
+       */
+      sync_counter->sync_request_alarm =
+        create_alarm (sync_counter, XSyncAbsolute, G_MININT64, 0);
+      sync_counter->sync_request_serial = 0;
+      sync_counter->initial_value_pending = TRUE;
 
-      sync_counter->sync_request_serial =
-        XSyncValueLow32 (init) + ((gint64) XSyncValueHigh32 (init) << 32);
+      /* Don't wait forever for it if the counter turns out to be bogus */
+      start_sync_request_timeout (sync_counter);
     }
   else
     {
+      XSyncValue init;
+
       XSyncIntToValue (&init, 0);
       XSyncSetCounter (x11_display->xdisplay,
                        sync_counter->sync_request_counter, init);
       sync_counter->sync_request_serial = 0;
+
+      /* Initialize to one greater than the current value */
+      sync_counter->sync_request_alarm =
+        create_alarm (sync_counter, XSyncRelative, 1, 1);
     }
 
-  values.trigger.counter = sync_counter->sync_request_counter;
-  values.trigger.test_type = XSyncPositiveComparison;
+  mtk_x11_error_trap_pop (x11_display->xdisplay);
 
-  /* Initialize to one greater than the current value */
-  values.trigger.value_type = XSyncRelative;
-  XSyncIntToValue (&values.trigger.wait_value, 1);
+  meta_x11_display_register_sync_alarm (x11_display,
+                                        &sync_counter->sync_request_alarm,
+                                        sync_counter);
+}
 
-  /* After triggering, increment test_value by this until
-   * until the test condition is false */
-  XSyncIntToValue (&values.delta, 1);
+static void
+handle_initial_value (MetaSyncCounter *sync_counter,
+                      int64_t          value)
+{
+  MetaWindow *window = sync_counter->window;
+  MetaX11Display *x11_display = window->display->x11_display;
+  XSyncAlarmAttributes values;
+  GList *l;
 
-  /* we want events (on by default anyway) */
-  values.events = True;
+  g_clear_handle_id (&sync_counter->sync_request_timeout_id, g_source_remove);
+  sync_counter->initial_value_pending = FALSE;
+  sync_counter->disabled = FALSE;
+  sync_counter->sync_request_serial = value;
 
-  sync_counter->sync_request_alarm = XSyncCreateAlarm (x11_display->xdisplay,
-                                                       XSyncCACounter |
-                                                       XSyncCAValueType |
-                                                       XSyncCAValue |
-                                                       XSyncCATestType |
-                                                       XSyncCADelta |
-                                                       XSyncCAEvents,
-                                                       &values);
+  /* Rearm the alarm to trigger for each following value. This is
+   * absolute, so that values set by the client in the meantime still
+   * trigger it.
+   */
+  values.trigger.value_type = XSyncAbsolute;
+  XSyncIntsToValue (&values.trigger.wait_value,
+                    (value + 1) & G_GUINT64_CONSTANT (0xffffffff),
+                    (value + 1) >> 32);
+  XSyncIntToValue (&values.delta, 1);
+
+  mtk_x11_error_trap_push (x11_display->xdisplay);
+  XSyncChangeAlarm (x11_display->xdisplay,
+                    sync_counter->sync_request_alarm,
+                    XSyncCAValueType | XSyncCAValue | XSyncCADelta,
+                    &values);
+  mtk_x11_error_trap_pop (x11_display->xdisplay);
 
-  if (mtk_x11_error_trap_pop_with_return (x11_display->xdisplay) == Success)
+  if (value % 2 == 0)
     {
-      meta_x11_display_register_sync_alarm (x11_display,
-                                            &sync_counter->sync_request_alarm,
-                                            sync_counter);
+      /* Frames queued before the value was known are for this value */
+      for (l = sync_counter->frames; l; l = l->next)
+        {
+          FrameData *frame = l->data;
+
+          frame->sync_request_serial = value;
+        }
     }
   else
     {
-      sync_counter->sync_request_alarm = None;
-      sync_counter->sync_request_counter = None;
+      /* The client is in the middle of drawing a frame, which is reported
+       * once the counter reaches the following even value */
+      g_clear_list (&sync_counter->frames, g_free);
+      sync_counter->needs_frame_drawn = FALSE;
     }
+
+  meta_compositor_sync_updates_frozen (window->display->compositor, window);
+
+  if (sync_counter->needs_frame_drawn)
+    meta_compositor_queue_frame_drawn (window->display->compositor, window,
+                                       FALSE);
 }
 
 void
@@ -177,12 +276,20 @@ meta_sync_counter_destroy_sync_alarm (MetaSyncCounter *sync_counter)
   XSyncDestroyAlarm (x11_display->xdisplay,
                      sync_counter->sync_request_alarm);
   sync_counter->sync_request_alarm = None;
+
+  if (sync_counter->initial_value_pending)
+    {
+      g_clear_handle_id (&sync_counter->sync_request_timeout_id,
+                         g_source_remove);
+      sync_counter->initial_value_pending = FALSE;
+    }
 }
 
 gboolean
 meta_sync_counter_has_sync_alarm (MetaSyncCounter *sync_counter)
 {
   return (!sync_counter->disabled &&
+          !sync_counter->initial_value_pending &&
           sync_counter->sync_request_alarm != None);
 }
 
@@ -206,6 +313,11 @@ sync_request_timeout (gpointer data)
   sync_counter->sync_request_wait_serial = 0;
   meta_compositor_sync_updates_frozen (window->display->compositor, window);
 
+  /* Frames held back for the initial counter value go out without it */
+  if (sync_counter->initial_value_pending && sync_counter->needs_frame_drawn)
+    meta_compositor_queue_frame_drawn (window->display->compositor, window,
+                                       FALSE);
+
   window_drag =
     meta_compositor_get_current_window_drag (window->display->compositor);
 
@@ -226,6 +338,7 @@ meta_sync_counter_send_request (MetaSyncCounter *sync_counter)
   if (sync_counter->sync_request_counter == None ||
       sync_counter->sync_request_alarm == None ||
       sync_counter->sync_request_timeout_id != 0 ||
+      sync_counter->initial_value_pending ||
       sync_counter->disabled)
     return;
 
@@ -261,15 +374,7 @@ meta_sync_counter_send_request (MetaSyncCounter *sync_counter)
   XSendEvent (x11_display->xdisplay,
 	      sync_counter->xwindow, False, 0, (XEvent*) &ev);
 
-  /* We give the window 1 sec to respond to _NET_WM_SYNC_REQUEST;
-   * if this time expires, we consider the window unresponsive
-   * and resize it unsynchonized.
-   */
-  sync_counter->sync_request_timeout_id = g_timeout_add_once (1000,
-                                                              sync_request_timeout,
-                                                              sync_counter);
-  g_source_set_name_by_id (sync_counter->sync_request_timeout_id,
-                           "[mutter] sync_request_timeout");
+  start_sync_request_timeout (sync_counter);
 
   meta_compositor_sync_updates_frozen (window->display->compositor, window);
 }
@@ -284,6 +389,12 @@ meta_sync_counter_update (MetaSyncCounter *sync_counter,
 
   COGL_TRACE_BEGIN_SCOPED (MetaWindowSyncRequestCounter, "Meta::SyncCounter::update()");
 
+  if (sync_counter->initial_value_pending)
+    {
+      handle_initial_value (sync_counter, new_counter_value);
+      return;
+    }
+
   if (sync_counter->extended_sync_request_counter && new_counter_value % 2 == 0)
     {
       needs_frame_drawn = TRUE;
@@ -333,6 +444,10 @@ meta_sync_counter_update (MetaSyncCounter *sync_counter,
 gboolean
 meta_sync_counter_is_waiting (MetaSyncCounter *sync_counter)
 {
+  /* The client may be in the middle of drawing a frame */
+  if (is_initial_value_pending (sync_counter))
+    return TRUE;
+
   if (sync_counter->extended_sync_request_counter &&
       sync_counter->sync_request_serial % 2 == 1)
     return TRUE;
@@ -379,7 +494,6 @@ do_send_frame_drawn (MetaSyncCounter *sync_counter,
 
   mtk_x11_error_trap_push (xdisplay);
   XSendEvent (xdisplay, ev.window, False, 0, (XEvent *) &ev);
-  XFlush (xdisplay);
   mtk_x11_error_trap_pop (xdisplay);
 
 #ifdef HAVE_PROFILER
@@ -439,7 +553,6 @@ do_send_frame_timings (MetaSyncCounter *sync_counter,
 
   mtk_x11_error_trap_push (xdisplay);
   XSendEvent (xdisplay, ev.window, False, 0, (XEvent *) &ev);
-  XFlush (xdisplay);
   mtk_x11_error_trap_pop (xdisplay);
 
 #ifdef HAVE_PROFILER
@@ -499,6 +612,10 @@ meta_sync_counter_assign_counter_to_frames (MetaSyncCounter *sync_counter,
 {
   GList *l;
 
+  /* Frames can only be reported once their serial is known */
+  if (is_initial_value_pending (sync_counter))
+    return;
+
   for (l = sync_counter->frames; l; l = l->next)
     {
       FrameData *frame = l->data;
@@ -546,6 +663,9 @@ meta_sync_counter_finish_incomplete (MetaSyncCounter *sync_counter)
 {
   GList *l;
 
+  if (is_initial_value_pending (sync_counter))
+    return;
+
   for (l = sync_counter->frames; l;)
     {
       GList *l_next = l->next;
@@ -571,7 +691,8 @@ meta_sync_counter_send_frame_drawn (MetaSyncCounter *sync_counter)
 {
   GList *l;
 
-  if (!sync_counter->needs_frame_drawn)
+  if (!sync_counter->needs_frame_drawn ||
+      is_initial_value_pending (sync_counter))
     return;
 
   for (l = sync_counter->frames; l; l = l->next)
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "core/util-private.h"
 #include "meta/window.h"
 
 #include <string.h>
@@ -44,6 +45,9 @@ typedef struct
    * also handles application frames */
   guint extended_sync_request_counter : 1;
   guint disabled : 1;
+  /* If set, the alarm was created, but the first alarm notification,
+   * carrying the initial counter value, has not been received yet */
+  guint initial_value_pending : 1;
   /* If set, the client needs to be sent a _NET_WM_FRAME_DRAWN
    * client message for one or more messages in ->frames */
   guint needs_frame_drawn : 1;
@@ -55,14 +59,18 @@ void meta_sync_counter_init (MetaSyncCounter *sync_counter,
 
 void meta_sync_counter_clear (MetaSyncCounter *sync_counter);
 
+META_EXPORT_TEST
 void meta_sync_counter_set_counter (MetaSyncCounter *sync_counter,
                                     XSyncCounter     counter,
                                     gboolean         extended);
 
+META_EXPORT_TEST
 void meta_sync_counter_create_sync_alarm (MetaSyncCounter *sync_counter);
 
+META_EXPORT_TEST
 void meta_sync_counter_destroy_sync_alarm (MetaSyncCounter *sync_counter);
 
+META_EXPORT_TEST
 gboolean meta_sync_counter_has_sync_alarm (MetaSyncCounter *sync_counter);
 
 void meta_sync_counter_send_request (MetaSyncCounter *sync_counter);
@@ -70,6 +78,7 @@ void meta_sync_counter_send_request (MetaSyncCounter *sync_counter);
 void meta_sync_counter_update (MetaSyncCounter *sync_counter,
                                int64_t          new_counter_value);
 
+META_EXPORT_TEST
 gboolean meta_sync_counter_is_waiting (MetaSyncCounter *sync_counter);
 
 gboolean meta_sync_counter_is_waiting_response (MetaSyncCounter *sync_counter);
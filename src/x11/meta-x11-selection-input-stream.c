@@ -26,6 +26,11 @@
 #include "mtk/mtk-x11.h"
 #include "x11/meta-x11-display-private.h"
 
+/* INCR chunks are only acknowledged, and so the next one only asked for,
+ * while less than this is waiting to be read.
+ */
+#define MAX_QUEUED_SIZE (1024 * 1024)
+
 typedef struct MetaX11SelectionInputStreamPrivate MetaX11SelectionInputStreamPrivate;
 
 struct _MetaX11SelectionInputStream
@@ -46,9 +51,14 @@ struct MetaX11SelectionInputStreamPrivate
   GTask *pending_task;
   uint8_t *pending_data;
   size_t pending_size;
+  GSource *pending_cancel_source;
+
+  /* Protected by the chunks queue lock */
+  size_t queued_size;
 
   guint complete : 1;
   guint incr : 1;
+  guint ack_pending : 1;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (MetaX11SelectionInputStream,
@@ -115,39 +125,123 @@ meta_x11_selection_input_stream_fill_buffer (MetaX11SelectionInputStream *stream
   if (bytes)
     g_async_queue_push_front_unlocked (priv->chunks, bytes);
 
+  priv->queued_size -= result;
+
   g_async_queue_unlock (priv->chunks);
 
   return result;
 }
 
 static void
-meta_x11_selection_input_stream_flush (MetaX11SelectionInputStream *stream)
+meta_x11_selection_input_stream_push_chunk (MetaX11SelectionInputStream *stream,
+                                            GBytes                      *bytes)
 {
   MetaX11SelectionInputStreamPrivate *priv =
     meta_x11_selection_input_stream_get_instance_private (stream);
-  Display *xdisplay = priv->x11_display->xdisplay;
-  gssize written;
+
+  g_async_queue_lock (priv->chunks);
+  priv->queued_size += g_bytes_get_size (bytes);
+  g_async_queue_push_unlocked (priv->chunks, bytes);
+  g_async_queue_unlock (priv->chunks);
+}
+
+static size_t
+meta_x11_selection_input_stream_get_queued_size (MetaX11SelectionInputStream *stream)
+{
+  MetaX11SelectionInputStreamPrivate *priv =
+    meta_x11_selection_input_stream_get_instance_private (stream);
+  size_t queued_size;
+
+  g_async_queue_lock (priv->chunks);
+  queued_size = priv->queued_size;
+  g_async_queue_unlock (priv->chunks);
+
+  return queued_size;
+}
+
+static void
+meta_x11_selection_input_stream_ack (MetaX11SelectionInputStream *stream)
+{
+  MetaX11SelectionInputStreamPrivate *priv =
+    meta_x11_selection_input_stream_get_instance_private (stream);
+  Display *xdisplay;
+
+  priv->ack_pending = FALSE;
+
+  if (!priv->x11_display)
+    return;
+
+  xdisplay = priv->x11_display->xdisplay;
 
   mtk_x11_error_trap_push (xdisplay);
   XDeleteProperty (xdisplay, priv->window, priv->xproperty);
   mtk_x11_error_trap_pop (xdisplay);
+}
 
-  if (!meta_x11_selection_input_stream_has_data (stream))
-    return;
+static void
+meta_x11_selection_input_stream_maybe_ack (MetaX11SelectionInputStream *stream)
+{
+  MetaX11SelectionInputStreamPrivate *priv =
+    meta_x11_selection_input_stream_get_instance_private (stream);
 
-  if (priv->pending_task == NULL)
-    return;
+  if (priv->ack_pending &&
+      meta_x11_selection_input_stream_get_queued_size (stream) < MAX_QUEUED_SIZE)
+    meta_x11_selection_input_stream_ack (stream);
+}
+
+static void
+meta_x11_selection_input_stream_clear_pending (MetaX11SelectionInputStream *stream)
+{
+  MetaX11SelectionInputStreamPrivate *priv =
+    meta_x11_selection_input_stream_get_instance_private (stream);
 
-  written = meta_x11_selection_input_stream_fill_buffer (stream,
-                                                         priv->pending_data,
-                                                         priv->pending_size);
-  g_task_return_int (priv->pending_task, written);
+  if (priv->pending_cancel_source)
+    {
+      g_source_destroy (priv->pending_cancel_source);
+      g_clear_pointer (&priv->pending_cancel_source, g_source_unref);
+    }
 
   g_clear_object (&priv->pending_task);
   priv->pending_data = NULL;
   priv->pending_size = 0;
 }
 
+static gboolean
+meta_x11_selection_input_stream_invoke_maybe_ack (gpointer data)
+{
+  meta_x11_selection_input_stream_maybe_ack (data);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+meta_x11_selection_input_stream_flush (MetaX11SelectionInputStream *stream)
+{
+  MetaX11SelectionInputStreamPrivate *priv =
+    meta_x11_selection_input_stream_get_instance_private (stream);
+  gssize written;
+
+  if (meta_x11_selection_input_stream_has_data (stream) &&
+      priv->pending_task != NULL)
+    {
+      written = meta_x11_selection_input_stream_fill_buffer (stream,
+                                                             priv->pending_data,
+                                                             priv->pending_size);
+      g_task_return_int (priv->pending_task, written);
+
+      meta_x11_selection_input_stream_clear_pending (stream);
+    }
+
+  /* Leave the owner waiting for its next chunk to be asked for while the
+   * reader is behind, the remaining contents stay with the owner.
+   */
+  if (priv->complete ||
+      meta_x11_selection_input_stream_get_queued_size (stream) < MAX_QUEUED_SIZE)
+    meta_x11_selection_input_stream_ack (stream);
+  else
+    priv->ack_pending = TRUE;
+}
+
 static void
 meta_x11_selection_input_stream_complete (MetaX11SelectionInputStream *stream)
 {
@@ -159,7 +253,7 @@ meta_x11_selection_input_stream_complete (MetaX11SelectionInputStream *stream)
 
   priv->complete = TRUE;
 
-  g_async_queue_push (priv->chunks, g_bytes_new (NULL, 0));
+  meta_x11_selection_input_stream_push_chunk (stream, g_bytes_new (NULL, 0));
   meta_x11_selection_input_stream_flush (stream);
 
   priv->x11_display->selection.input_streams =
@@ -177,8 +271,15 @@ meta_x11_selection_input_stream_read (GInputStream  *input_stream,
 {
   MetaX11SelectionInputStream *stream =
     META_X11_SELECTION_INPUT_STREAM (input_stream);
+  size_t size;
 
-  return meta_x11_selection_input_stream_fill_buffer (stream, buffer, count);
+  size = meta_x11_selection_input_stream_fill_buffer (stream, buffer, count);
+  g_main_context_invoke_full (NULL, G_PRIORITY_DEFAULT,
+                              meta_x11_selection_input_stream_invoke_maybe_ack,
+                              g_object_ref (stream),
+                              g_object_unref);
+
+  return size;
 }
 
 static gboolean
@@ -189,6 +290,24 @@ meta_x11_selection_input_stream_close (GInputStream  *stream,
   return TRUE;
 }
 
+static gboolean
+meta_x11_selection_input_stream_read_cancelled (GCancellable *cancellable,
+                                                gpointer      user_data)
+{
+  MetaX11SelectionInputStream *stream = user_data;
+  MetaX11SelectionInputStreamPrivate *priv =
+    meta_x11_selection_input_stream_get_instance_private (stream);
+
+  /* The owner may never send more, so don't leave the reader waiting */
+  if (priv->pending_task)
+    {
+      g_task_return_error_if_cancelled (priv->pending_task);
+      meta_x11_selection_input_stream_clear_pending (stream);
+    }
+
+  return G_SOURCE_REMOVE;
+}
+
 static void
 meta_x11_selection_input_stream_read_async (GInputStream        *input_stream,
                                             void                *buffer,
@@ -215,12 +334,23 @@ meta_x11_selection_input_stream_read_async (GInputStream        *input_stream,
       size = meta_x11_selection_input_stream_fill_buffer (stream, buffer, count);
       g_task_return_int (task, size);
       g_object_unref (task);
+
+      meta_x11_selection_input_stream_maybe_ack (stream);
     }
   else
     {
       priv->pending_data = buffer;
       priv->pending_size = count;
       priv->pending_task = task;
+
+      if (cancellable)
+        {
+          priv->pending_cancel_source = g_cancellable_source_new (cancellable);
+          g_source_set_callback (priv->pending_cancel_source,
+                                 G_SOURCE_FUNC (meta_x11_selection_input_stream_read_cancelled),
+                                 stream, NULL);
+          g_source_attach (priv->pending_cancel_source, NULL);
+        }
     }
 }
 
@@ -442,7 +572,7 @@ meta_x11_selection_input_stream_xevent (MetaX11SelectionInputStream *stream,
         }
       else
         {
-          g_async_queue_push (priv->chunks, bytes);
+          meta_x11_selection_input_stream_push_chunk (stream, bytes);
           meta_x11_selection_input_stream_flush (stream);
         }
       return FALSE;
@@ -499,7 +629,7 @@ meta_x11_selection_input_stream_xevent (MetaX11SelectionInputStream *stream,
                   }
                 else
                   {
-                    g_async_queue_push (priv->chunks, bytes);
+                    meta_x11_selection_input_stream_push_chunk (stream, bytes);
 
                     meta_x11_selection_input_stream_complete (stream);
                   }
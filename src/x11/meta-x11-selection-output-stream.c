@@ -50,6 +50,8 @@ struct _MetaX11SelectionOutputStreamPrivate
   guint flush_requested : 1;
 
   GTask *pending_task;
+  GTask *pending_write_task;
+  GSource *write_cancellable_source;
 
   guint incr : 1;
   guint delete_pending : 1;
@@ -178,6 +180,82 @@ get_element_size (int format)
     }
 }
 
+/* Whether the requestor is behind on INCR chunks, and writers should
+ * wait for it before handing over more data.
+ */
+static gboolean
+meta_x11_selection_output_stream_is_backed_up (MetaX11SelectionOutputStream *stream)
+{
+  MetaX11SelectionOutputStreamPrivate *priv =
+    meta_x11_selection_output_stream_get_instance_private (stream);
+  gboolean result;
+
+  g_mutex_lock (&priv->mutex);
+
+  result = priv->delete_pending &&
+    priv->data->len >= get_max_request_size (priv->x11_display);
+
+  g_mutex_unlock (&priv->mutex);
+
+  return result;
+}
+
+static GTask *
+meta_x11_selection_output_stream_steal_pending_write (MetaX11SelectionOutputStream *stream)
+{
+  MetaX11SelectionOutputStreamPrivate *priv =
+    meta_x11_selection_output_stream_get_instance_private (stream);
+
+  if (priv->write_cancellable_source)
+    {
+      g_source_destroy (priv->write_cancellable_source);
+      g_clear_pointer (&priv->write_cancellable_source, g_source_unref);
+    }
+
+  return g_steal_pointer (&priv->pending_write_task);
+}
+
+static void
+meta_x11_selection_output_stream_maybe_complete_write (MetaX11SelectionOutputStream *stream)
+{
+  MetaX11SelectionOutputStreamPrivate *priv =
+    meta_x11_selection_output_stream_get_instance_private (stream);
+  GTask *task;
+
+  if (!priv->pending_write_task)
+    return;
+
+  if (priv->pipe_error)
+    {
+      task = meta_x11_selection_output_stream_steal_pending_write (stream);
+      g_task_return_new_error (task,
+                               G_IO_ERROR,
+                               G_IO_ERROR_BROKEN_PIPE,
+                               "Connection with client was broken");
+      g_object_unref (task);
+    }
+  else if (!meta_x11_selection_output_stream_is_backed_up (stream))
+    {
+      task = meta_x11_selection_output_stream_steal_pending_write (stream);
+      g_task_return_int (task, GPOINTER_TO_SIZE (g_task_get_task_data (task)));
+      g_object_unref (task);
+    }
+}
+
+static gboolean
+meta_x11_selection_output_stream_write_cancelled (GCancellable *cancellable,
+                                                  gpointer      user_data)
+{
+  MetaX11SelectionOutputStream *stream = user_data;
+  GTask *task;
+
+  task = meta_x11_selection_output_stream_steal_pending_write (stream);
+  g_task_return_error_if_cancelled (task);
+  g_object_unref (task);
+
+  return G_SOURCE_REMOVE;
+}
+
 static gboolean
 meta_x11_selection_output_stream_check_pipe (MetaX11SelectionOutputStream  *stream,
                                              GError                       **error)
@@ -302,6 +380,8 @@ meta_x11_selection_output_stream_perform_flush (MetaX11SelectionOutputStream *st
       g_task_return_int (priv->pending_task, result);
       g_clear_object (&priv->pending_task);
     }
+
+  meta_x11_selection_output_stream_maybe_complete_write (stream);
 }
 
 static gboolean
@@ -381,20 +461,31 @@ meta_x11_selection_output_stream_write_async (GOutputStream       *output_stream
   g_byte_array_append (priv->data, buffer, count);
   g_mutex_unlock (&priv->mutex);
 
-  if (!meta_x11_selection_output_stream_needs_flush (stream))
+  if (meta_x11_selection_output_stream_needs_flush (stream) &&
+      meta_x11_selection_output_stream_can_flush (stream))
+    meta_x11_selection_output_stream_perform_flush (stream);
+
+  if (!meta_x11_selection_output_stream_is_backed_up (stream))
     {
       g_task_return_int (task, count);
       g_object_unref (task);
       return;
     }
-  else
-    {
-      if (meta_x11_selection_output_stream_can_flush (stream))
-        meta_x11_selection_output_stream_perform_flush (stream);
 
-      g_task_return_int (task, count);
-      g_object_unref (task);
-      return;
+  /* Hold the writer back until the requestor took enough of the
+   * buffered data, instead of buffering all of the contents.
+   */
+  g_assert (priv->pending_write_task == NULL);
+  g_task_set_task_data (task, GSIZE_TO_POINTER (count), NULL);
+  priv->pending_write_task = task;
+
+  if (cancellable)
+    {
+      priv->write_cancellable_source = g_cancellable_source_new (cancellable);
+      g_source_set_callback (priv->write_cancellable_source,
+                             (GSourceFunc) meta_x11_selection_output_stream_write_cancelled,
+                             stream, NULL);
+      g_source_attach (priv->write_cancellable_source, NULL);
     }
 }
 
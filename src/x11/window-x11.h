@@ -106,6 +106,7 @@ MetaFrame * meta_window_x11_get_frame (MetaWindow *window);
 
 gboolean meta_window_x11_can_unredirect          (MetaWindowX11 *window_x11);
 
+META_EXPORT_TEST
 MetaSyncCounter * meta_window_x11_get_sync_counter (MetaWindow *window);
 
 gboolean meta_window_x11_is_awaiting_sync_response (MetaWindow *window);